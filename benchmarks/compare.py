@@ -0,0 +1,132 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file benchmarks/compare.py
+# Compare two runs of nntile_bench or kernel_bench and flag regressions
+#
+# @version 1.0.0
+
+import argparse
+import json
+import math
+import sys
+
+# Read results of a run, indexed by name, shape and type
+def read_results(path):
+    with open(path) as fp:
+        data = json.load(fp)
+    return {(r["name"], r["shape"], r["dtype"]): r for r in data["results"]}
+
+# Continued fraction for the regularized incomplete beta function
+def _betacf(a, b, x, maxiter=300, eps=1e-12):
+    tiny = 1e-300
+    c = 1.0
+    d = 1 - (a+b)*x/(a+1)
+    d = 1 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, maxiter+1):
+        for aa in (m*(b-m)*x / ((a+2*m-1)*(a+2*m)), \
+                -(a+m)*(a+b+m)*x / ((a+2*m)*(a+2*m+1))):
+            d = 1 + aa*d
+            d = 1 / (d if abs(d) > tiny else tiny)
+            c = 1 + aa/c
+            c = c if abs(c) > tiny else tiny
+            h *= d * c
+        if abs(d*c-1) < eps:
+            break
+    return h
+
+# Regularized incomplete beta function I_x(a, b)
+def _betainc(a, b, x):
+    if x <= 0:
+        return 0.0
+    if x >= 1:
+        return 1.0
+    front = math.exp(math.lgamma(a+b) - math.lgamma(a) - math.lgamma(b) \
+            + a*math.log(x) + b*math.log(1-x))
+    if x < (a+1) / (a+b+2):
+        return front * _betacf(a, b, x) / a
+    return 1 - front*_betacf(b, a, 1-x)/b
+
+# Two-sided p-value of Welch's t-test for equal mean times of two runs
+def welch_pvalue(a, b):
+    na, nb = len(a), len(b)
+    ma, mb = sum(a)/na, sum(b)/nb
+    va = sum((x-ma)**2 for x in a) / (na-1)
+    vb = sum((x-mb)**2 for x in b) / (nb-1)
+    se2 = va/na + vb/nb
+    if se2 == 0:
+        return 1.0 if ma == mb else 0.0
+    t = (mb-ma) / math.sqrt(se2)
+    df = se2**2 / ((va/na)**2/(na-1) + (vb/nb)**2/(nb-1))
+    return _betainc(df/2, 0.5, df/(df+t*t))
+
+# Compare median times of benchmarks, present in both runs. A benchmark is a
+# regression (improvement), if its new median time is more (less) than the
+# old one by a given relative threshold and if the change is significant.
+# By default the change is significant if it is larger than variation of
+# timed runs, measured as the sum of standard deviations. With the Welch's
+# test the change is significant if the p-value of the test on times of
+# all timed runs is less than alpha.
+def compare(old, new, threshold, test="noise", alpha=0.01):
+    rows = []
+    for key in sorted(old.keys() & new.keys()):
+        t_old = old[key]["time_median"]
+        t_new = new[key]["time_median"]
+        ratio = t_new / t_old
+        times_old = old[key].get("times", [])
+        times_new = new[key].get("times", [])
+        pvalue = None
+        if test == "welch" and len(times_old) > 1 and len(times_new) > 1:
+            pvalue = welch_pvalue(times_old, times_new)
+            significant = pvalue < alpha
+        else:
+            noise = old[key]["time_stddev"] + new[key]["time_stddev"]
+            significant = abs(t_new-t_old) > noise
+        status = ""
+        if significant:
+            if ratio > 1+threshold:
+                status = "REGRESSION"
+            elif ratio < 1-threshold:
+                status = "improvement"
+        rows.append((key, t_old, t_new, ratio, pvalue, status))
+    return rows
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(prog="compare", \
+            description="Compare two JSON outputs of nntile_bench or " \
+            "kernel_bench")
+    parser.add_argument("old", help="baseline results")
+    parser.add_argument("new", help="new results")
+    parser.add_argument("--threshold", type=float, default=0.05, \
+            help="relative change of median time to report")
+    parser.add_argument("--test", choices=["noise", "welch"], \
+            default="noise", help="test of significance of a change")
+    parser.add_argument("--alpha", type=float, default=0.01, \
+            help="significance level of the Welch's test")
+    args = parser.parse_args(argv)
+    old = read_results(args.old)
+    new = read_results(args.new)
+    rows = compare(old, new, args.threshold, args.test, args.alpha)
+    print("{:<24} {:<16} {:<5} {:>12} {:>12} {:>7} {:>8}".format( \
+            "benchmark", "shape", "dtype", "old, ms", "new, ms", "ratio", \
+            "p-value"))
+    for (name, shape, dtype), t_old, t_new, ratio, pvalue, status in rows:
+        pvalue = "-" if pvalue is None else "{:.2e}".format(pvalue)
+        print("{:<24} {:<16} {:<5} {:>12.4f} {:>12.4f} {:>7.3f} {:>8} {}" \
+                .format(name, shape, dtype, t_old*1e3, t_new*1e3, ratio, \
+                pvalue, status))
+    for key in sorted(old.keys() - new.keys()):
+        print("Missing in new results: {} {} {}".format(*key))
+    nregressions = sum(row[5] == "REGRESSION" for row in rows)
+    print("{} benchmarks compared, {} regressions".format(len(rows), \
+            nregressions))
+    return 1 if nregressions > 0 else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
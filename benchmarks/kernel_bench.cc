@@ -0,0 +1,524 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file benchmarks/kernel_bench.cc
+ * Microbenchmark of CPU kernels, that are called directly without StarPU
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/kernel.hh"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace nntile;
+using namespace nntile::kernel;
+
+// Buffer of a kernel: number of elements and number of passes over it, that
+// is 1 for a buffer, which is only read or only written, and 2 for a buffer,
+// which is read and written
+struct Buffer
+{
+    Index nelems;
+    int npasses;
+};
+
+// Benchmark of a single kernel on buffers of a given type
+template<typename T>
+struct Bench
+{
+    std::string name;
+    std::vector<Buffer> buffers;
+    std::function<void(const std::vector<T *> &)> run;
+};
+
+// Sizes of a tile of a GPT-2 model. A tile of activations holds n_emb
+// embeddings of n_tok tokens, attention works with n_head heads at once.
+struct Sizes
+{
+    Index n_emb = 768, n_tok = 1024, n_ff = 3072, n_head = 12;
+};
+
+// All benchmarks for given sizes, that repeat kernels of nntile_bench
+template<typename T>
+std::vector<Bench<T>> make_benches(const Sizes &s)
+{
+    const Index E = s.n_emb, N = s.n_tok, F = s.n_ff, H = s.n_head;
+    const Index EN = E * N, FN = F * N;
+    std::vector<Bench<T>> res;
+    // Elementwise operations
+    res.push_back({"add", {{EN, 1}, {EN, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                add::cpu<T>(EN, 1.0, p[0], 1.0, p[1]);
+            }});
+    res.push_back({"prod", {{EN, 1}, {EN, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                prod::cpu<T>(EN, p[0], p[1]);
+            }});
+    res.push_back({"scal", {{EN, 1}, {EN, 1}},
+            [=](const std::vector<T *> &p)
+            {
+                scal::cpu<T>(EN, 2.0, p[0], p[1]);
+            }});
+    res.push_back({"fill", {{EN, 1}},
+            [=](const std::vector<T *> &p)
+            {
+                fill::cpu<T>(EN, 0.5, p[0]);
+            }});
+    res.push_back({"sqrt", {{EN, 1}, {EN, 1}},
+            [=](const std::vector<T *> &p)
+            {
+                sqrt::cpu<T>(EN, p[0], p[1]);
+            }});
+    res.push_back({"gelutanh", {{FN, 1}, {FN, 1}},
+            [=](const std::vector<T *> &p)
+            {
+                gelutanh::cpu<T>(FN, p[0], p[1]);
+            }});
+    res.push_back({"gelutanh_backward", {{FN, 1}, {FN, 1}, {FN, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                gelutanh_backward::cpu<T>(FN, p[0], p[1], p[2]);
+            }});
+    res.push_back({"transpose", {{EN, 1}, {EN, 1}},
+            [=](const std::vector<T *> &p)
+            {
+                transpose::cpu<T>(E, N, 1.0, p[0], p[1]);
+            }});
+    res.push_back({"adam_step", {{E*F, 1}, {E*F, 2}, {E*F, 2}, {E*F, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                adam_step::cpu<T>(2, E*F, 0.9, 0.999, 1e-8, 1e-4, 0.0, p[0],
+                        p[1], p[2], p[3]);
+            }});
+    // Broadcasts of bias and normalization factors
+    res.push_back({"add_fiber", {{E, 1}, {EN, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                add_fiber::cpu<T>(1, N, E, 1, 1.0, p[0], 1.0, p[1]);
+            }});
+    res.push_back({"add_slice", {{N, 1}, {EN, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                add_slice::cpu<T>(1, N, E, 1.0, p[0], 1.0, p[1]);
+            }});
+    res.push_back({"prod_fiber", {{E, 1}, {EN, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                prod_fiber::cpu<T>(1, N, E, 1.0, p[0], p[1]);
+            }});
+    res.push_back({"prod_slice", {{N, 1}, {EN, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                prod_slice::cpu<T>(1, N, E, 1.0, p[0], p[1]);
+            }});
+    // Reductions of layer normalization and gradients of bias
+    res.push_back({"sum_slice", {{EN, 1}, {N, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                sum_slice::cpu<T>(1, N, E, 1.0, p[0], 1.0, p[1]);
+            }});
+    res.push_back({"sum_fiber", {{EN, 1}, {E, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                sum_fiber::cpu<T>(1, N, E, 1, 1.0, p[0], 1.0, p[1]);
+            }});
+    res.push_back({"norm_slice", {{EN, 1}, {N, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                norm_slice::cpu<T>(1, N, E, 1.0, p[0], 1.0, p[1]);
+            }});
+    res.push_back({"sumnorm", {{EN, 1}, {2*N, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                sumnorm::cpu<T>(1, N, E, p[0], p[1]);
+            }});
+    res.push_back({"normalize", {{2, 1}, {2*N, 1}, {EN, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                normalize::cpu<T>(1, N, E, E, 1e-5, p[0], p[0]+1, p[1],
+                        p[2]);
+            }});
+    res.push_back({"sumprod_slice", {{EN, 1}, {EN, 1}, {N, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                sumprod_slice::cpu<T>(1, N, E, 1.0, p[0], p[1], 1.0, p[2]);
+            }});
+    res.push_back({"sumprod_fiber", {{EN, 1}, {EN, 1}, {E, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                sumprod_fiber::cpu<T>(1, N, E, 1.0, p[0], p[1], 1.0, p[2]);
+            }});
+    // Softmax of attention scores
+    res.push_back({"maxsumexp", {{N*N*H, 1}, {2*N*H, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                maxsumexp::cpu<T>(1, N*H, N, p[0], p[1]);
+            }});
+    res.push_back({"softmax_inplace", {{2*N*H, 1}, {N*N*H, 2}},
+            [=](const std::vector<T *> &p)
+            {
+                softmax_inplace::cpu<T>(1, N*H, N, p[0], 1.0, p[1]);
+            }});
+    return res;
+}
+
+// Options of the benchmark
+struct Options
+{
+    Sizes sizes;
+    Index repeat = 30;
+    double min_sample = 1e-3;
+    Index flush_mb = 64;
+    std::string dtype = "fp32";
+    std::vector<std::string> modes{"warm", "cold"};
+    std::vector<std::string> filter;
+    std::string output;
+};
+
+static std::vector<std::string> split(const std::string &str)
+{
+    std::vector<std::string> res;
+    std::stringstream ss(str);
+    std::string item;
+    while(std::getline(ss, item, ','))
+    {
+        if(!item.empty())
+        {
+            res.push_back(item);
+        }
+    }
+    return res;
+}
+
+static void usage(const char *exec)
+{
+    std::cout << "Usage: " << exec << " [options]\n"
+        "  --emb N           embedding size of a tile (default: 768)\n"
+        "  --tok N           number of tokens of a tile (default: 1024)\n"
+        "  --ff N            MLP hidden size of a tile (default: 3072)\n"
+        "  --head N          number of heads of a tile (default: 12)\n"
+        "  --repeat N        timed samples of each benchmark (default: 30)\n"
+        "  --min-sample-ms X minimal time of a warm sample (default: 1)\n"
+        "  --flush-mb N      size of a buffer to evict caches (default: 64)\n"
+        "  --modes A,B       warm and/or cold (default: warm,cold)\n"
+        "  --dtype T         fp32 or fp64 (default: fp32)\n"
+        "  --filter A,B      run benchmarks, whose names start with given "
+        "prefixes\n"
+        "  --output FILE     write results as JSON into a file\n";
+}
+
+static Options parse_args(int argc, char **argv)
+{
+    Options opt;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if(arg == "-h" or arg == "--help")
+        {
+            usage(argv[0]);
+            std::exit(0);
+        }
+        if(i+1 == argc)
+        {
+            throw std::runtime_error("Missing value of " + arg);
+        }
+        std::string val(argv[++i]);
+        if(arg == "--emb")
+        {
+            opt.sizes.n_emb = std::stoll(val);
+        }
+        else if(arg == "--tok")
+        {
+            opt.sizes.n_tok = std::stoll(val);
+        }
+        else if(arg == "--ff")
+        {
+            opt.sizes.n_ff = std::stoll(val);
+        }
+        else if(arg == "--head")
+        {
+            opt.sizes.n_head = std::stoll(val);
+        }
+        else if(arg == "--repeat")
+        {
+            opt.repeat = std::stoll(val);
+        }
+        else if(arg == "--min-sample-ms")
+        {
+            opt.min_sample = std::stod(val) * 1e-3;
+        }
+        else if(arg == "--flush-mb")
+        {
+            opt.flush_mb = std::stoll(val);
+        }
+        else if(arg == "--modes")
+        {
+            opt.modes = split(val);
+        }
+        else if(arg == "--dtype")
+        {
+            opt.dtype = val;
+        }
+        else if(arg == "--filter")
+        {
+            opt.filter = split(val);
+        }
+        else if(arg == "--output")
+        {
+            opt.output = val;
+        }
+        else
+        {
+            throw std::runtime_error("Unknown option " + arg);
+        }
+    }
+    // Confidence intervals need at least 2 samples
+    if(opt.repeat < 2)
+    {
+        throw std::runtime_error("Invalid number of samples");
+    }
+    if(opt.sizes.n_emb <= 0 or opt.sizes.n_tok <= 0 or opt.sizes.n_ff <= 0
+            or opt.sizes.n_head <= 0 or opt.flush_mb < 0)
+    {
+        throw std::runtime_error("Invalid sizes");
+    }
+    if(opt.dtype != "fp32" and opt.dtype != "fp64")
+    {
+        throw std::runtime_error("Unsupported dtype " + opt.dtype);
+    }
+    for(const auto &mode: opt.modes)
+    {
+        if(mode != "warm" and mode != "cold")
+        {
+            throw std::runtime_error("Unknown mode " + mode);
+        }
+    }
+    return opt;
+}
+
+static bool selected(const std::vector<std::string> &list,
+        const std::string &name)
+{
+    if(list.empty())
+    {
+        return true;
+    }
+    for(const auto &item: list)
+    {
+        if(name.compare(0, item.size(), item) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Quantile of level 0.975 of the Student's t-distribution, computed by the
+// Cornish-Fisher expansion for df >= 3
+static double t_quantile_975(Index df)
+{
+    if(df == 1)
+    {
+        return 12.706;
+    }
+    if(df == 2)
+    {
+        return 4.303;
+    }
+    const double z = 1.959964, z3 = z*z*z, z5 = z3*z*z;
+    return z + (z3+z)/(4.0*df) + (5*z5+16*z3+3*z)/(96.0*df*df);
+}
+
+// Result of a single benchmark
+struct Result
+{
+    std::string name, mode, shape, dtype;
+    double nbytes = 0;
+    // Number of calls of a kernel per sample
+    Index inner = 1;
+    // Time of a single call of a kernel for every sample in seconds
+    std::vector<double> times = {};
+    double median = 0, mean = 0, stddev = 0, ci95 = 0;
+};
+
+static void finalize(Result &r)
+{
+    std::vector<double> times(r.times);
+    std::sort(times.begin(), times.end());
+    Index n = times.size();
+    r.median = times[n/2];
+    r.mean = 0;
+    for(auto t: times)
+    {
+        r.mean += t;
+    }
+    r.mean /= n;
+    double var = 0;
+    for(auto t: times)
+    {
+        var += (t-r.mean) * (t-r.mean);
+    }
+    r.stddev = std::sqrt(var/(n-1));
+    // Half width of the 95% confidence interval of the mean time
+    r.ci95 = t_quantile_975(n-1) * r.stddev / std::sqrt(double(n));
+}
+
+// Data of this buffer is written between samples in the cold mode to evict
+// buffers of a kernel from all levels of caches
+static std::vector<unsigned char> flush_buffer;
+static volatile unsigned char flush_sink;
+
+static void flush_caches()
+{
+    static unsigned char value = 0;
+    if(flush_buffer.empty())
+    {
+        return;
+    }
+    std::memset(flush_buffer.data(), ++value, flush_buffer.size());
+    flush_sink = flush_buffer[flush_buffer.size()/2];
+}
+
+// Run all selected benchmarks
+template<typename T>
+void run_all(const Options &opt, std::vector<Result> &res)
+{
+    using clock = std::chrono::steady_clock;
+    const Sizes &s = opt.sizes;
+    std::string shape = std::to_string(s.n_emb) + "x"
+        + std::to_string(s.n_tok) + "x" + std::to_string(s.n_ff) + "x"
+        + std::to_string(s.n_head);
+    for(auto &b: make_benches<T>(s))
+    {
+        if(!selected(opt.filter, b.name))
+        {
+            continue;
+        }
+        // Allocate and initialize buffers with ones. They are valid inputs
+        // for all kernels and repeated calls do not lead to subnormal or
+        // infinite values, that are processed much slower
+        std::vector<std::vector<T>> buffers;
+        std::vector<T *> ptrs;
+        double nbytes = 0;
+        for(const auto &buf: b.buffers)
+        {
+            buffers.emplace_back(buf.nelems, T(1.0));
+            nbytes += double(sizeof(T)) * buf.nelems * buf.npasses;
+        }
+        for(auto &buf: buffers)
+        {
+            ptrs.push_back(buf.data());
+        }
+        for(const auto &mode: opt.modes)
+        {
+            bool cold = mode == "cold";
+            Result r{b.name+"/"+mode, mode, shape, opt.dtype, nbytes, 1};
+            // Untimed call to touch all pages of buffers
+            b.run(ptrs);
+            // Warm samples consist of several calls to be long enough for
+            // the resolution of the clock, cold samples of a single call
+            if(!cold)
+            {
+                auto start = clock::now();
+                b.run(ptrs);
+                std::chrono::duration<double> diff = clock::now() - start;
+                if(diff.count() < opt.min_sample)
+                {
+                    r.inner = std::ceil(opt.min_sample
+                            / std::max(diff.count(), 1e-9));
+                }
+            }
+            for(Index i = 0; i < opt.repeat; ++i)
+            {
+                if(cold)
+                {
+                    flush_caches();
+                }
+                auto start = clock::now();
+                for(Index j = 0; j < r.inner; ++j)
+                {
+                    b.run(ptrs);
+                }
+                std::chrono::duration<double> diff = clock::now() - start;
+                r.times.push_back(diff.count() / r.inner);
+            }
+            finalize(r);
+            std::cout << shape << " " << r.name << ": " << r.mean*1e3
+                << " +- " << r.ci95*1e3 << " ms, " << nbytes/r.median*1e-9
+                << " GB/s\n";
+            res.push_back(std::move(r));
+        }
+    }
+}
+
+static void write_json(const Options &opt, const std::vector<Result> &res,
+        std::ostream &os)
+{
+    os << "{\n  \"version\": 1,\n  \"flush_mb\": " << opt.flush_mb
+        << ",\n  \"results\": [";
+    os.precision(9);
+    for(std::size_t i = 0; i < res.size(); ++i)
+    {
+        const auto &r = res[i];
+        os << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name
+            << "\", \"mode\": \"" << r.mode << "\", \"shape\": \""
+            << r.shape << "\", \"dtype\": \"" << r.dtype
+            << "\",\n     \"nbytes\": " << r.nbytes << ", \"repeat\": "
+            << r.times.size() << ", \"inner\": " << r.inner
+            << ",\n     \"time_median\": " << r.median << ", \"time_mean\": "
+            << r.mean << ", \"time_stddev\": " << r.stddev
+            << ",\n     \"time_ci95_low\": " << r.mean-r.ci95
+            << ", \"time_ci95_high\": " << r.mean+r.ci95
+            << ", \"gbytes_per_sec\": " << r.nbytes/r.median*1e-9
+            << ",\n     \"times\": [";
+        for(std::size_t j = 0; j < r.times.size(); ++j)
+        {
+            os << (j == 0 ? "" : ", ") << r.times[j];
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+int main(int argc, char **argv)
+{
+    Options opt = parse_args(argc, argv);
+    flush_buffer.resize(opt.flush_mb << 20);
+    std::vector<Result> res;
+    if(opt.dtype == "fp32")
+    {
+        run_all<fp32_t>(opt, res);
+    }
+    else
+    {
+        run_all<fp64_t>(opt, res);
+    }
+    if(!opt.output.empty())
+    {
+        std::ofstream fout(opt.output);
+        write_json(opt, res, fout);
+        if(!fout)
+        {
+            throw std::runtime_error("Failed to write " + opt.output);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,818 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file benchmarks/nntile_bench.cc
+ * Benchmark of StarPU codelets on tiles of GPT-2 models
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu.hh"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace nntile;
+using namespace nntile::starpu;
+
+// Sizes of tiles of a GPT-2 model. A tile of activations holds n_emb
+// embeddings of n_tok tokens (sequence tile times batch tile), attention
+// works with n_head heads of size head_size at once, and logits hold n_voc
+// entries of the vocabulary for every token.
+struct Shape
+{
+    const char *name;
+    Index n_emb, n_tok, n_ff, n_head, head_size, n_voc;
+};
+
+// Tile configurations of GPT-2 small, medium, large and XL, where each tile
+// holds 1024 tokens, all the heads and the whole vocabulary
+static const Shape shapes[] =
+{
+    {"gpt2-small", 768, 1024, 3072, 12, 64, 50257},
+    {"gpt2-medium", 1024, 1024, 4096, 16, 64, 50257},
+    {"gpt2-large", 1280, 1024, 5120, 20, 64, 50257},
+    {"gpt2-xl", 1600, 1024, 6400, 25, 64, 50257},
+};
+
+// Buffer of a codelet: number of elements and access mode. Buffers of
+// values of the benchmarked type are filled with 0.5, while buffers of
+// other types (indices, masks, half precision) have a nonzero typesize and
+// all their bytes are set to a given value.
+struct Buffer
+{
+    Index nelems;
+    starpu_data_access_mode mode;
+    Index typesize = 0;
+    unsigned char byte = 0;
+};
+
+// Benchmark of a single codelet on a given shape. Number of floating point
+// operations is an estimate, that counts a transcendental function as a
+// single operation. Number of bytes counts reads and writes of all buffers.
+struct Bench
+{
+    std::string name;
+    std::vector<Buffer> buffers;
+    double nflops;
+    std::function<void(const std::vector<VariableHandle> &)> submit;
+};
+
+// All benchmarks for a given shape
+template<typename T>
+std::vector<Bench> make_benches(const Shape &s)
+{
+    const Index E = s.n_emb, N = s.n_tok, F = s.n_ff, H = s.n_head,
+          D = s.head_size, V = s.n_voc;
+    const Index EN = E * N, FN = F * N, NNH = N * N * H, VN = V * N;
+    // Tokens, labels and masks
+    const Index I = sizeof(Index);
+    const Index B = sizeof(bool_t);
+    // Number of candidates of top-k sampling
+    const Index topk = 50;
+    const TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+    std::vector<Bench> res;
+    // Linear layers of MLP and attention
+    res.push_back({"gemm/mlp_fc1", {{F*E, STARPU_R}, {EN, STARPU_R},
+            {FN, STARPU_W}}, 2.0*F*E*N,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                gemm::submit<T>(opN, opN, F, N, E, 1, 1.0, h[0], h[1], 0.0,
+                        h[2]);
+            }});
+    res.push_back({"gemm/mlp_fc2_grad", {{EN, STARPU_R}, {FN, STARPU_R},
+            {E*F, STARPU_RW}}, 2.0*E*F*N,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                gemm::submit<T>(opN, opT, E, F, N, 1, 1.0, h[0], h[1], 1.0,
+                        h[2]);
+            }});
+    res.push_back({"gemm/attn_qk", {{D*N*H, STARPU_R}, {D*N*H, STARPU_R},
+            {N*N*H, STARPU_W}}, 2.0*N*N*D*H,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                gemm::submit<T>(opT, opN, N, N, D, H, 1.0, h[0], h[1], 0.0,
+                        h[2]);
+            }});
+    // Elementwise operations
+    res.push_back({"add", {{EN, STARPU_R}, {EN, STARPU_RW}}, 3.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                add::submit<T>(EN, 1.0, h[0], 1.0, h[1]);
+            }});
+    res.push_back({"prod", {{EN, STARPU_R}, {EN, STARPU_RW}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                prod::submit<T>(EN, h[0], h[1]);
+            }});
+    res.push_back({"scal", {{EN, STARPU_R}, {EN, STARPU_W}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                scal::submit<T>(EN, 2.0, h[0], h[1]);
+            }});
+    res.push_back({"fill", {{EN, STARPU_W}}, 0.0,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                fill::submit<T>(EN, 1.0, h[0]);
+            }});
+    res.push_back({"gelutanh", {{FN, STARPU_R}, {FN, STARPU_W}}, 9.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                gelutanh::submit<T>(FN, h[0], h[1]);
+            }});
+    res.push_back({"gelutanh_backward", {{FN, STARPU_R}, {FN, STARPU_R},
+            {FN, STARPU_RW}}, 16.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                gelutanh_backward::submit<T>(FN, h[0], h[1], h[2]);
+            }});
+    res.push_back({"transpose", {{EN, STARPU_R}, {EN, STARPU_W}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                transpose::submit<T>(E, N, 1.0, h[0], h[1]);
+            }});
+    res.push_back({"adam_step", {{E*F, STARPU_R}, {E*F, STARPU_RW},
+            {E*F, STARPU_RW}, {E*F, STARPU_RW}}, 16.0*E*F,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                adam_step::submit<T>(2, E*F, 0.9, 0.999, 1e-8, 1e-4, 0.0,
+                        h[0], h[1], h[2], h[3]);
+            }});
+    // Broadcasts of bias and normalization factors
+    res.push_back({"add_fiber", {{E, STARPU_R}, {EN, STARPU_RW}}, 3.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                add_fiber::submit<T>(1, N, E, 1, 1.0, h[0], 1.0, h[1]);
+            }});
+    res.push_back({"add_slice", {{N, STARPU_R}, {EN, STARPU_RW}}, 3.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                add_slice::submit<T>(1, N, E, 1.0, h[0], 1.0, h[1]);
+            }});
+    res.push_back({"prod_fiber", {{E, STARPU_R}, {EN, STARPU_RW}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                prod_fiber::submit<T>(1, N, E, 1.0, h[0], h[1]);
+            }});
+    res.push_back({"prod_slice", {{N, STARPU_R}, {EN, STARPU_RW}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                prod_slice::submit<T>(1, N, E, 1.0, h[0], h[1]);
+            }});
+    // Reductions of layer normalization and gradients of bias
+    res.push_back({"sum_slice", {{EN, STARPU_R}, {N, STARPU_RW}}, 4.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                sum_slice::submit<T>(1, N, E, 1.0, h[0], 1.0, h[1]);
+            }});
+    res.push_back({"sum_fiber", {{EN, STARPU_R}, {E, STARPU_RW}}, 4.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                sum_fiber::submit<T>(1, N, E, 1, 1.0, h[0], 1.0, h[1]);
+            }});
+    res.push_back({"norm_slice", {{EN, STARPU_R}, {N, STARPU_RW}}, 2.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                norm_slice::submit<T>(1, N, E, 1.0, h[0], 1.0, h[1]);
+            }});
+    res.push_back({"sumnorm", {{EN, STARPU_R}, {2*N, STARPU_RW}}, 3.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                sumnorm::submit<T>(1, N, E, h[0], h[1]);
+            }});
+    res.push_back({"normalize", {{2*E, STARPU_R}, {2*N, STARPU_R},
+            {EN, STARPU_RW}}, 4.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                normalize::submit<T>(1, N, E, E, 1e-5, h[0], h[1], h[2]);
+            }});
+    res.push_back({"sumprod_slice", {{EN, STARPU_R}, {EN, STARPU_R},
+            {N, STARPU_RW}}, 2.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                sumprod_slice::submit<T>(1, N, E, 1.0, h[0], h[1], 1.0, h[2]);
+            }});
+    res.push_back({"sumprod_fiber", {{EN, STARPU_R}, {EN, STARPU_R},
+            {E, STARPU_RW}}, 2.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                sumprod_fiber::submit<T>(1, N, E, 1.0, h[0], h[1], 1.0, h[2]);
+            }});
+    // Softmax of attention scores
+    res.push_back({"maxsumexp", {{N*N*H, STARPU_R}, {2*N*H, STARPU_RW}},
+            3.0*N*N*H,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                maxsumexp::submit<T>(1, N*H, N, h[0], h[1]);
+            }});
+    res.push_back({"softmax_inplace", {{2*N*H, STARPU_R},
+            {N*N*H, STARPU_RW}}, 3.0*N*N*H,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                softmax_inplace::submit<T>(1, N*H, N, h[0], 1.0, h[1]);
+            }});
+    res.push_back({"softmax", {{2*N*H, STARPU_R}, {NNH, STARPU_R},
+            {NNH, STARPU_W}}, 3.0*NNH,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                softmax::submit<T>(1, N*H, N, h[0], h[1], 1.0, h[2]);
+            }});
+    res.push_back({"mask_scalar", {{N*N, STARPU_R, B, 1},
+            {NNH, STARPU_RW}}, 0.0,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                mask_scalar::submit<T>(N*N, H, h[0], -1.0, h[1]);
+            }});
+    res.push_back({"logsumexp", {{2*N*H, STARPU_R}, {N*H, STARPU_W}},
+            2.0*N*H,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                logsumexp::submit<T>(N*H, h[0], h[1]);
+            }});
+    // Reductions of partial results of tiles
+    res.push_back({"accumulate", {{EN, STARPU_R}, {EN, STARPU_RW}},
+            1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                accumulate::submit<T>(h[0], h[1]);
+            }});
+    res.push_back({"accumulate_hypot", {{EN, STARPU_R}, {EN, STARPU_RW}},
+            3.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                accumulate_hypot::submit<T>(h[0], h[1]);
+            }});
+    res.push_back({"accumulate_maxsumexp", {{2*N*H, STARPU_R},
+            {2*N*H, STARPU_RW}}, 5.0*N*H,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                accumulate_maxsumexp::submit<T>(h[0], h[1]);
+            }});
+    // Attention, that does not store the whole matrix of scores. Batch of
+    // heads is the batch of the flash kernels.
+    res.push_back({"flash_maxsumexp", {{D*N*H, STARPU_R}, {D*N*H, STARPU_R},
+            {N*N, STARPU_R, B, 1}, {2*N*H, STARPU_RW}, {NNH, STARPU_W}},
+            2.0*NNH*D+3.0*NNH,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                flash_maxsumexp::submit<T>(N, D, H, h[0], h[1], h[2], h[3],
+                        h[4]);
+            }});
+    res.push_back({"flash_softmax_gemm", {{D*N*H, STARPU_R},
+            {D*N*H, STARPU_R}, {N*N, STARPU_R, B, 1}, {2*N*H, STARPU_R},
+            {D*N*H, STARPU_R}, {D*N*H, STARPU_RW}, {NNH, STARPU_W}},
+            4.0*NNH*D,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                flash_softmax_gemm::submit<T>(N, D, H, h[0], h[1], h[2],
+                        h[3], h[4], h[5], h[6]);
+            }});
+    res.push_back({"flash_softmax_gemm_backward_sumprod_slice",
+            {{D*N*H, STARPU_R}, {D*N*H, STARPU_R}, {N*N, STARPU_R, B, 1},
+            {2*N*H, STARPU_R}, {D*N*H, STARPU_R}, {D*N*H, STARPU_R},
+            {D*N*H, STARPU_RW}, {N*H, STARPU_RW}, {NNH, STARPU_W},
+            {NNH, STARPU_W}}, 6.0*NNH*D,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                flash_softmax_gemm_backward_sumprod_slice::submit<T>(N, D, H,
+                        h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7], h[8],
+                        h[9]);
+            }});
+    res.push_back({"flash_softmax_gemm_backward_dq_dk",
+            {{D*N*H, STARPU_R}, {D*N*H, STARPU_R}, {N*N, STARPU_R, B, 1},
+            {2*N*H, STARPU_R}, {D*N*H, STARPU_R}, {D*N*H, STARPU_R},
+            {N*H, STARPU_R}, {D*N*H, STARPU_RW}, {D*N*H, STARPU_RW},
+            {NNH, STARPU_W}, {NNH, STARPU_W}}, 8.0*NNH*D,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                flash_softmax_gemm_backward_dq_dk::submit<T>(N, D, H, h[0],
+                        h[1], h[2], h[3], h[4], h[5], h[6], h[7], h[8], h[9],
+                        h[10]);
+            }});
+    // Other elementwise operations and activations
+    res.push_back({"add_slice3", {{N, STARPU_R}, {EN, STARPU_R},
+            {EN, STARPU_W}}, 3.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                add_slice3::submit<T>(1, N, E, 1.0, h[0], 1.0, h[1], h[2]);
+            }});
+    res.push_back({"prod_fiber3", {{E, STARPU_R}, {EN, STARPU_R},
+            {EN, STARPU_W}}, 2.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                prod_fiber3::submit<T>(1, N, E, 1.0, h[0], h[1], h[2]);
+            }});
+    res.push_back({"axpy", {{EN, STARPU_R}, {EN, STARPU_RW}}, 2.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                axpy::submit<T>(1.0, EN, h[0], h[1]);
+            }});
+    res.push_back({"scal_inplace", {{EN, STARPU_RW}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                scal_inplace::submit<T>(2.0, EN, h[0]);
+            }});
+    res.push_back({"add_scalar", {{EN, STARPU_RW}}, 2.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                add_scalar::submit<T>(EN, 1.0, 1.0, h[0]);
+            }});
+    res.push_back({"pow", {{EN, STARPU_RW}}, 2.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                pow::submit<T>(EN, 1.0, 2.0, h[0]);
+            }});
+    res.push_back({"sqrt", {{EN, STARPU_R}, {EN, STARPU_W}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                sqrt::submit<T>(EN, h[0], h[1]);
+            }});
+    res.push_back({"sqrt_inplace", {{EN, STARPU_RW}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                sqrt_inplace::submit<T>(EN, h[0]);
+            }});
+    res.push_back({"maximum", {{EN, STARPU_R}, {EN, STARPU_RW}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                maximum::submit<T>(EN, h[0], h[1]);
+            }});
+    res.push_back({"hypot", {{EN, STARPU_R}, {EN, STARPU_RW}}, 5.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                hypot::submit<T>(EN, 1.0, h[0], 1.0, h[1]);
+            }});
+    res.push_back({"hypot_scalar_inverse", {{EN, STARPU_RW}}, 4.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                hypot_scalar_inverse::submit<T>(EN, 1e-8, 1.0, h[0]);
+            }});
+    res.push_back({"addcdiv", {{EN, STARPU_R}, {EN, STARPU_R},
+            {EN, STARPU_RW}}, 3.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                addcdiv::submit<T>(1.0, 1e-8, EN, h[0], h[1], h[2]);
+            }});
+    res.push_back({"nrm2", {{EN, STARPU_R}, {1, STARPU_W}}, 2.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                nrm2::submit<T>(EN, h[0], h[1]);
+            }});
+    res.push_back({"gelu", {{FN, STARPU_RW}}, 5.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                gelu::submit<T>(FN, h[0]);
+            }});
+    res.push_back({"gelutanh_inplace", {{FN, STARPU_RW}}, 9.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                gelutanh_inplace::submit<T>(FN, h[0]);
+            }});
+    res.push_back({"dgelu", {{FN, STARPU_RW}}, 8.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                dgelu::submit<T>(FN, h[0]);
+            }});
+    res.push_back({"dgelutanh", {{FN, STARPU_RW}}, 14.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                dgelutanh::submit<T>(FN, h[0]);
+            }});
+    res.push_back({"gelu_backward", {{FN, STARPU_R}, {FN, STARPU_R},
+            {FN, STARPU_RW}}, 10.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                gelu_backward::submit<T>(FN, h[0], h[1], h[2]);
+            }});
+    res.push_back({"relu", {{FN, STARPU_RW}}, 1.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                relu::submit<T>(FN, h[0]);
+            }});
+    res.push_back({"drelu", {{FN, STARPU_RW}}, 1.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                drelu::submit<T>(FN, h[0]);
+            }});
+    res.push_back({"relu_forward", {{FN, STARPU_R}, {FN, STARPU_W}},
+            1.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                relu_forward::submit<T>(FN, h[0], h[1]);
+            }});
+    res.push_back({"relu_backward", {{FN, STARPU_R}, {FN, STARPU_R},
+            {FN, STARPU_RW}}, 2.0*FN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                relu_backward::submit<T>(FN, h[0], h[1], h[2]);
+            }});
+    res.push_back({"adamw_step", {{E*F, STARPU_R}, {E*F, STARPU_RW},
+            {E*F, STARPU_RW}, {E*F, STARPU_RW}}, 18.0*E*F,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                adamw_step::submit<T>(2, E*F, 0.9, 0.999, 1e-8, 1e-4, 0.01,
+                        h[0], h[1], h[2], h[3]);
+            }});
+    // Initialization and movement of data
+    res.push_back({"clear", {{EN, STARPU_W}}, 0.0,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                clear::submit(h[0]);
+            }});
+    res.push_back({"copy", {{EN, STARPU_R}, {EN, STARPU_W}}, 0.0,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                copy::submit(h[0], h[1]);
+            }});
+    res.push_back({"randn", {{EN, STARPU_W}, {4, STARPU_SCRATCH, I}},
+            4.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                randn::submit<T>(2, EN, 1000, 0.0, 1.0, {0, 0}, {E, N},
+                        {1, E}, {E, N}, h[0], h[1]);
+            }});
+    // Copy a half of a tile into a half of another one
+    res.push_back({"subcopy", {{EN, STARPU_R}, {EN, STARPU_RW},
+            {4, STARPU_SCRATCH, I}}, 0.0,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                subcopy::submit<T>(2, {0, 0}, {1, E}, {0, N/2}, {1, E},
+                        {E, N/2}, h[0], h[1], h[2], STARPU_RW);
+            }});
+    // Gather a tile from two halves
+    res.push_back({"retile", {{E*(N/2), STARPU_R}, {E*(N/2), STARPU_R},
+            {EN, STARPU_W}}, 0.0,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                retile::submit<T>(2, {1, E},
+                        {1, E, 0, 0, 0, 0, E, N/2, 1, E, 0, 0, 0, N/2, E,
+                        N/2}, {h[0], h[1]}, h[2]);
+            }});
+    if constexpr(std::is_same_v<T, fp32_t>)
+    {
+        res.push_back({"fp32_to_fp16", {{EN, STARPU_R},
+                {EN, STARPU_W, sizeof(fp16_t)}}, 0.0,
+                [=](const std::vector<VariableHandle> &h)
+                {
+                    fp32_to_fp16::submit(EN, h[0], h[1]);
+                }});
+        res.push_back({"fp16_to_fp32", {{EN, STARPU_R, sizeof(fp16_t)},
+                {EN, STARPU_W}}, 0.0,
+                [=](const std::vector<VariableHandle> &h)
+                {
+                    fp16_to_fp32::submit(EN, h[0], h[1]);
+                }});
+    }
+    // Embeddings of tokens, all tokens refer to the first one
+    res.push_back({"embedding", {{N, STARPU_R, I}, {E*V, STARPU_R},
+            {EN, STARPU_RW}}, 0.0,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                embedding::submit<T>(1, N, E, 0, E, h[0], h[1], h[2]);
+            }});
+    res.push_back({"embedding_backward", {{N, STARPU_R, I}, {EN, STARPU_R},
+            {E*V, STARPU_RW}}, 1.0*EN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                embedding_backward::submit<T>(1, N, E, 0, E, h[0], h[1],
+                        h[2]);
+            }});
+    // Cross entropy loss and its gradient
+    res.push_back({"total_sum_accum", {{N, STARPU_R}, {VN, STARPU_R},
+            {N, STARPU_R, I}, {1, STARPU_RW}}, 2.0*N,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                total_sum_accum::submit<T>(1.0, V, N, h[0], h[1], h[2],
+                        h[3]);
+            }});
+    res.push_back({"subtract_indexed_outputs", {{N, STARPU_R, I},
+            {VN, STARPU_RW}}, 1.0*N,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                subtract_indexed_outputs::submit<T>(V, N, 1.0, h[0], h[1]);
+            }});
+    // Generation of tokens with top-k sampling
+    res.push_back({"topk_maxsumexp", {{VN, STARPU_R}, {topk*N, STARPU_W},
+            {topk*N, STARPU_W, I}, {2*N, STARPU_W}}, 3.0*VN,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                topk_maxsumexp::submit<T>(V, N, topk, 0, 1.0, true, h[0],
+                        h[1], h[2], h[3]);
+            }});
+    res.push_back({"sample_topk", {{topk*N, STARPU_R},
+            {topk*N, STARPU_R, I}, {2*N, STARPU_R}, {N, STARPU_W, I}},
+            3.0*topk*N,
+            [=](const std::vector<VariableHandle> &h)
+            {
+                sample_topk::submit<T>(N, topk, topk, 0.9, 1000, 0, h[0],
+                        h[1], h[2], h[3]);
+            }});
+    return res;
+}
+
+// Options of the benchmark
+struct Options
+{
+    int ncpu = -1;
+    int ncuda = 0;
+    Index warmup = 2;
+    Index repeat = 10;
+    std::string dtype = "fp32";
+    std::vector<std::string> shapes;
+    std::vector<std::string> filter;
+    std::string output;
+};
+
+static std::vector<std::string> split(const std::string &str)
+{
+    std::vector<std::string> res;
+    std::stringstream ss(str);
+    std::string item;
+    while(std::getline(ss, item, ','))
+    {
+        if(!item.empty())
+        {
+            res.push_back(item);
+        }
+    }
+    return res;
+}
+
+static void usage(const char *exec)
+{
+    std::cout << "Usage: " << exec << " [options]\n"
+        "  --ncpu N          number of CPU workers (default: all)\n"
+        "  --ncuda N         number of CUDA workers (default: 0)\n"
+        "  --warmup N        untimed runs of each benchmark (default: 2)\n"
+        "  --repeat N        timed runs of each benchmark (default: 10)\n"
+        "  --dtype T         fp32 or fp64 (default: fp32)\n"
+        "  --shapes A,B      tile configurations (default: all)\n"
+        "  --filter A,B      run benchmarks, whose names start with given "
+        "prefixes\n"
+        "  --output FILE     write results as JSON into a file\n"
+        "Tile configurations:";
+    for(const auto &s: shapes)
+    {
+        std::cout << " " << s.name;
+    }
+    std::cout << "\n";
+}
+
+static Options parse_args(int argc, char **argv)
+{
+    Options opt;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if(arg == "-h" or arg == "--help")
+        {
+            usage(argv[0]);
+            std::exit(0);
+        }
+        if(i+1 == argc)
+        {
+            throw std::runtime_error("Missing value of " + arg);
+        }
+        std::string val(argv[++i]);
+        if(arg == "--ncpu")
+        {
+            opt.ncpu = std::stoi(val);
+        }
+        else if(arg == "--ncuda")
+        {
+            opt.ncuda = std::stoi(val);
+        }
+        else if(arg == "--warmup")
+        {
+            opt.warmup = std::stoll(val);
+        }
+        else if(arg == "--repeat")
+        {
+            opt.repeat = std::stoll(val);
+        }
+        else if(arg == "--dtype")
+        {
+            opt.dtype = val;
+        }
+        else if(arg == "--shapes")
+        {
+            opt.shapes = split(val);
+        }
+        else if(arg == "--filter")
+        {
+            opt.filter = split(val);
+        }
+        else if(arg == "--output")
+        {
+            opt.output = val;
+        }
+        else
+        {
+            throw std::runtime_error("Unknown option " + arg);
+        }
+    }
+    if(opt.repeat <= 0 or opt.warmup < 0)
+    {
+        throw std::runtime_error("Invalid number of runs");
+    }
+    if(opt.dtype != "fp32" and opt.dtype != "fp64")
+    {
+        throw std::runtime_error("Unsupported dtype " + opt.dtype);
+    }
+    return opt;
+}
+
+static bool selected(const std::vector<std::string> &list,
+        const std::string &name, bool prefix)
+{
+    if(list.empty())
+    {
+        return true;
+    }
+    for(const auto &item: list)
+    {
+        if(prefix ? name.compare(0, item.size(), item) == 0 : name == item)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Result of a single benchmark
+struct Result
+{
+    std::string name, shape, dtype;
+    double nflops, nbytes;
+    // Times of all timed runs in seconds
+    std::vector<double> times;
+};
+
+// Run all selected benchmarks on a given shape
+template<typename T>
+void run_shape(const Options &opt, const Shape &s, std::vector<Result> &res)
+{
+    for(auto &b: make_benches<T>(s))
+    {
+        if(!selected(opt.filter, b.name, true))
+        {
+            continue;
+        }
+        // Allocate and initialize buffers
+        std::vector<VariableHandle> handles;
+        double nbytes = 0;
+        for(const auto &buf: b.buffers)
+        {
+            Index typesize = buf.typesize ? buf.typesize : sizeof(T);
+            handles.emplace_back(typesize*buf.nelems, STARPU_RW);
+            if(buf.typesize == 0)
+            {
+                fill::submit<T>(buf.nelems, 0.5, handles.back());
+            }
+            else
+            {
+                auto local = handles.back().acquire(STARPU_W);
+                std::memset(local.get_ptr(), buf.byte, typesize*buf.nelems);
+                local.release();
+            }
+            nbytes += double(typesize) * buf.nelems
+                * (buf.mode == STARPU_RW ? 2 : 1);
+        }
+        starpu_task_wait_for_all();
+        // Untimed runs to calibrate performance models and warm up caches
+        for(Index i = 0; i < opt.warmup; ++i)
+        {
+            b.submit(handles);
+            starpu_task_wait_for_all();
+        }
+        // Timed runs
+        Result r{b.name, s.name, opt.dtype, b.nflops, nbytes, {}};
+        for(Index i = 0; i < opt.repeat; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            b.submit(handles);
+            starpu_task_wait_for_all();
+            auto end = std::chrono::steady_clock::now();
+            r.times.push_back(std::chrono::duration<double>(end-start)
+                    .count());
+        }
+        for(auto &h: handles)
+        {
+            h.unregister();
+        }
+        // Print a summary of the result
+        std::vector<double> times(r.times);
+        std::sort(times.begin(), times.end());
+        double median = times[times.size()/2];
+        std::cout << s.name << " " << r.name << ": " << median*1e3
+            << " ms, " << r.nbytes/median*1e-9 << " GB/s, "
+            << r.nflops/median*1e-9 << " GFLOP/s\n";
+        res.push_back(std::move(r));
+    }
+}
+
+static void write_json(const Options &opt, const std::vector<Result> &res,
+        std::ostream &os)
+{
+    os << "{\n  \"version\": 1,\n  \"ncpu\": "
+        << starpu_worker_get_count_by_type(STARPU_CPU_WORKER)
+        << ",\n  \"ncuda\": "
+        << starpu_worker_get_count_by_type(STARPU_CUDA_WORKER)
+        << ",\n  \"warmup\": " << opt.warmup << ",\n  \"results\": [";
+    os.precision(9);
+    for(std::size_t i = 0; i < res.size(); ++i)
+    {
+        const auto &r = res[i];
+        std::vector<double> times(r.times);
+        std::sort(times.begin(), times.end());
+        double median = times[times.size()/2], mean = 0, var = 0;
+        for(auto t: times)
+        {
+            mean += t;
+        }
+        mean /= times.size();
+        for(auto t: times)
+        {
+            var += (t-mean) * (t-mean);
+        }
+        double stddev = times.size() > 1
+            ? std::sqrt(var/(times.size()-1)) : 0.0;
+        os << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name
+            << "\", \"shape\": \"" << r.shape << "\", \"dtype\": \""
+            << r.dtype << "\",\n     \"nflops\": " << r.nflops
+            << ", \"nbytes\": " << r.nbytes << ", \"repeat\": "
+            << times.size() << ",\n     \"time_min\": " << times[0]
+            << ", \"time_median\": " << median << ", \"time_mean\": " << mean
+            << ", \"time_stddev\": " << stddev
+            << ",\n     \"gbytes_per_sec\": "
+            << r.nbytes/median*1e-9 << ", \"gflops_per_sec\": "
+            << r.nflops/median*1e-9 << ",\n     \"times\": [";
+        for(std::size_t j = 0; j < r.times.size(); ++j)
+        {
+            os << (j == 0 ? "" : ", ") << r.times[j];
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+int main(int argc, char **argv)
+{
+    Options opt = parse_args(argc, argv);
+    for(const auto &name: opt.shapes)
+    {
+        bool found = false;
+        for(const auto &s: shapes)
+        {
+            found = found or name == s.name;
+        }
+        if(!found)
+        {
+            throw std::runtime_error("Unknown tile configuration " + name);
+        }
+    }
+    // Init StarPU and all codelets
+    Config config(opt.ncpu, opt.ncuda, 0);
+    nntile::starpu::init();
+    std::vector<Result> res;
+    for(const auto &s: shapes)
+    {
+        if(!selected(opt.shapes, s.name, false))
+        {
+            continue;
+        }
+        if(opt.dtype == "fp32")
+        {
+            run_shape<fp32_t>(opt, s, res);
+        }
+        else
+        {
+            run_shape<fp64_t>(opt, s, res);
+        }
+    }
+    if(!opt.output.empty())
+    {
+        std::ofstream fout(opt.output);
+        write_json(opt, res, fout);
+        if(!fout)
+        {
+            throw std::runtime_error("Failed to write " + opt.output);
+        }
+    }
+    return 0;
+}
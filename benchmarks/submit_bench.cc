@@ -0,0 +1,343 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file benchmarks/submit_bench.cc
+ * Benchmark of throughput of submission of tasks by tensor operations
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu.hh"
+#include "nntile/tensor/add.hh"
+#include "nntile/tensor/clear.hh"
+#include "nntile/tensor/gemm.hh"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+// Tiles are tiny, so that time of a benchmark is dominated by submission.
+// Workers are paused while tasks are submitted, so that the submitting
+// threads do not compete with them for cores.
+static constexpr Index add_tile = 16;
+static constexpr Index gemm_tile = 4;
+
+// Options of the benchmark
+struct Options
+{
+    int ncpu = 1;
+    Index repeat = 5;
+    bool pause = true;
+    std::vector<int> threads{0, 1, 2, 4};
+    std::vector<Index> ntasks{1024, 4096, 16384, 65536, 262144};
+    std::vector<std::string> ops{"add", "gemm"};
+    std::string output;
+    // Required rate of submission of tasks by every operation, that is
+    // reached by at least one configuration (0 means no check)
+    double min_rate = 0;
+};
+
+static std::vector<std::string> split(const std::string &str)
+{
+    std::vector<std::string> res;
+    std::stringstream ss(str);
+    std::string item;
+    while(std::getline(ss, item, ','))
+    {
+        if(!item.empty())
+        {
+            res.push_back(item);
+        }
+    }
+    return res;
+}
+
+static void usage(const char *exec)
+{
+    std::cout << "Usage: " << exec << " [options]\n"
+        "  --ncpu N          number of CPU workers (default: 1)\n"
+        "  --repeat N        timed runs of each benchmark (default: 5)\n"
+        "  --pause 0|1       pause workers during submission (default: 1)\n"
+        "  --threads A,B     numbers of additional submitter threads "
+        "(default: 0,1,2,4)\n"
+        "  --tasks A,B       numbers of tasks of an operation "
+        "(default: 1024,...,262144)\n"
+        "  --ops A,B         add and/or gemm (default: add,gemm)\n"
+        "  --output FILE     write results as JSON into a file\n"
+        "  --min-rate R      fail if the best rate of any operation is "
+        "below R tasks/s\n"
+        "                    (default: 0, no check)\n";
+}
+
+static Options parse_args(int argc, char **argv)
+{
+    Options opt;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if(arg == "-h" or arg == "--help")
+        {
+            usage(argv[0]);
+            std::exit(0);
+        }
+        if(i+1 == argc)
+        {
+            throw std::runtime_error("Missing value of " + arg);
+        }
+        std::string val(argv[++i]);
+        if(arg == "--ncpu")
+        {
+            opt.ncpu = std::stoi(val);
+        }
+        else if(arg == "--repeat")
+        {
+            opt.repeat = std::stoll(val);
+        }
+        else if(arg == "--pause")
+        {
+            opt.pause = std::stoi(val) != 0;
+        }
+        else if(arg == "--threads")
+        {
+            opt.threads.clear();
+            for(const auto &item: split(val))
+            {
+                opt.threads.push_back(std::stoi(item));
+            }
+        }
+        else if(arg == "--tasks")
+        {
+            opt.ntasks.clear();
+            for(const auto &item: split(val))
+            {
+                opt.ntasks.push_back(std::stoll(item));
+            }
+        }
+        else if(arg == "--ops")
+        {
+            opt.ops = split(val);
+        }
+        else if(arg == "--output")
+        {
+            opt.output = val;
+        }
+        else if(arg == "--min-rate")
+        {
+            opt.min_rate = std::stod(val);
+        }
+        else
+        {
+            throw std::runtime_error("Unknown option " + arg);
+        }
+    }
+    if(opt.repeat <= 0)
+    {
+        throw std::runtime_error("Invalid number of runs");
+    }
+    if(opt.min_rate < 0)
+    {
+        throw std::runtime_error("Invalid required rate of submission");
+    }
+    for(const auto &op: opt.ops)
+    {
+        if(op != "add" and op != "gemm")
+        {
+            throw std::runtime_error("Unknown operation " + op);
+        }
+    }
+    return opt;
+}
+
+// Result of a single benchmark
+struct Result
+{
+    std::string op;
+    int nthreads;
+    Index ntiles, ntasks;
+    // Times of submission of all timed runs in seconds
+    std::vector<double> times;
+};
+
+// Time of submission of all tasks of an operation
+static double time_submit(const Options &opt,
+        const std::function<void()> &submit)
+{
+    if(opt.pause)
+    {
+        starpu_pause();
+    }
+    auto start = std::chrono::steady_clock::now();
+    submit();
+    auto end = std::chrono::steady_clock::now();
+    if(opt.pause)
+    {
+        starpu_resume();
+    }
+    starpu_task_wait_for_all();
+    return std::chrono::duration<double>(end-start).count();
+}
+
+// Benchmark an operation with a given number of tasks. Addition submits a
+// task per tile, while gemm of g-by-g grids of tiles submits g^3 tasks.
+static Result run(const Options &opt, const std::string &op, int nthreads,
+        Index ntasks)
+{
+    starpu_mpi_tag_t last_tag = 0;
+    Result r{op, nthreads, 0, 0, {}};
+    std::vector<Tensor<fp32_t>> tensors;
+    tensors.reserve(3);
+    std::function<void()> submit;
+    if(op == "add")
+    {
+        TensorTraits traits({ntasks*add_tile}, {add_tile});
+        std::vector<int> distr(traits.grid.nelems, 0);
+        for(int i = 0; i < 2; ++i)
+        {
+            tensors.emplace_back(traits, distr, last_tag);
+            clear_async<fp32_t>(tensors.back());
+        }
+        r.ntiles = ntasks;
+        r.ntasks = ntasks;
+        submit = [&tensors]()
+        {
+            add_async<fp32_t>(1.0, tensors[0], 1.0, tensors[1]);
+        };
+    }
+    else
+    {
+        Index g = std::max(Index(1), Index(std::cbrt(double(ntasks))+0.5));
+        TensorTraits traits({g*gemm_tile, g*gemm_tile},
+                {gemm_tile, gemm_tile});
+        std::vector<int> distr(traits.grid.nelems, 0);
+        for(int i = 0; i < 3; ++i)
+        {
+            tensors.emplace_back(traits, distr, last_tag);
+            clear_async<fp32_t>(tensors.back());
+        }
+        r.ntiles = g * g;
+        r.ntasks = g * g * g;
+        const TransOp opN(TransOp::NoTrans);
+        submit = [&tensors, opN]()
+        {
+            gemm_async<fp32_t>(1.0, opN, tensors[0], opN, tensors[1], 0.0,
+                    tensors[2], 1, 0, 0);
+        };
+    }
+    starpu_task_wait_for_all();
+    starpu::submitter::init(nthreads);
+    // Warmup run to fill caches of StarPU
+    time_submit(opt, submit);
+    for(Index i = 0; i < opt.repeat; ++i)
+    {
+        r.times.push_back(time_submit(opt, submit));
+    }
+    starpu::submitter::shutdown();
+    for(auto &t: tensors)
+    {
+        t.unregister();
+    }
+    return r;
+}
+
+static double median(std::vector<double> times)
+{
+    std::sort(times.begin(), times.end());
+    return times[times.size()/2];
+}
+
+static void write_json(const Options &opt, const std::vector<Result> &res,
+        std::ostream &os)
+{
+    os << "{\n  \"version\": 1,\n  \"ncpu\": "
+        << starpu_worker_get_count_by_type(STARPU_CPU_WORKER)
+        << ",\n  \"pause\": " << (opt.pause ? "true" : "false")
+        << ",\n  \"min_tasks\": " << starpu::submitter::get_min_tasks()
+        << ",\n  \"results\": [";
+    os.precision(9);
+    for(std::size_t i = 0; i < res.size(); ++i)
+    {
+        const auto &r = res[i];
+        double t = median(r.times);
+        os << (i == 0 ? "\n" : ",\n") << "    {\"op\": \"" << r.op
+            << "\", \"nthreads\": " << r.nthreads << ", \"ntiles\": "
+            << r.ntiles << ", \"ntasks\": " << r.ntasks
+            << ",\n     \"time_median\": " << t << ", \"tasks_per_sec\": "
+            << r.ntasks/t << ",\n     \"times\": [";
+        for(std::size_t j = 0; j < r.times.size(); ++j)
+        {
+            os << (j == 0 ? "" : ", ") << r.times[j];
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+int main(int argc, char **argv)
+{
+    Options opt = parse_args(argc, argv);
+    // Init StarPU and all codelets
+    starpu::Config config(opt.ncpu, 0, 0);
+    starpu::init();
+    std::vector<Result> res;
+    std::cout << "op\tthreads\ttiles\ttasks\tsubmit, ms\ttasks/s\n";
+    for(const auto &op: opt.ops)
+    {
+        for(auto ntasks: opt.ntasks)
+        {
+            for(auto nthreads: opt.threads)
+            {
+                auto r = run(opt, op, nthreads, ntasks);
+                double t = median(r.times);
+                std::cout << op << "\t" << nthreads << "\t" << r.ntiles
+                    << "\t" << r.ntasks << "\t" << t*1e3 << "\t"
+                    << r.ntasks/t << "\n";
+                res.push_back(std::move(r));
+            }
+        }
+    }
+    if(!opt.output.empty())
+    {
+        std::ofstream fout(opt.output);
+        write_json(opt, res, fout);
+        if(!fout)
+        {
+            throw std::runtime_error("Failed to write " + opt.output);
+        }
+    }
+    // Check the required rate by the best configuration of each operation
+    int status = 0;
+    for(const auto &op: opt.ops)
+    {
+        double best_rate = 0;
+        for(const auto &r: res)
+        {
+            if(r.op == op)
+            {
+                best_rate = std::max(best_rate, r.ntasks/median(r.times));
+            }
+        }
+        std::cout << op << ": best rate " << best_rate << " tasks/s\n";
+        if(best_rate < opt.min_rate)
+        {
+            std::cerr << "FAILED: " << op << " submits " << best_rate
+                << " tasks/s, required " << opt.min_rate << " tasks/s\n";
+            status = 1;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,532 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file examples/gpt2_blocks.cc
+ * Training throughput of GPT-2 transformer blocks without Python
+ *
+ * @version 1.0.0
+ * */
+
+#include <nntile.hh>
+#include <sys/resource.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace nntile;
+using namespace nntile::tensor;
+using T = fp32_t;
+
+// Sizes of the model and its tiles
+struct Sizes
+{
+    Index n_layer = 2;
+    Index n_emb = 768, n_emb_tile = 768;
+    Index n_head = 12, n_head_tile = 12;
+    Index n_ff = 3072, n_ff_tile = 3072;
+    Index n_seq = 1024, n_seq_tile = 1024;
+    Index n_batch = 4, n_batch_tile = 1;
+};
+
+// Allocates tensors on the root node and counts their total size
+struct Allocator
+{
+    starpu_mpi_tag_t last_tag = 0;
+    std::size_t nbytes = 0;
+    template<typename U=T>
+    Tensor<U> make(const std::vector<Index> &shape,
+            const std::vector<Index> &basetile)
+    {
+        TensorTraits traits(shape, basetile);
+        std::vector<int> distr(traits.grid.nelems, 0);
+        nbytes += sizeof(U) * traits.nelems;
+        return Tensor<U>(traits, distr, last_tag);
+    }
+};
+
+// Trainable parameter with its gradient and moments of Adam
+struct Param
+{
+    Tensor<T> value, grad, first_moment, second_moment;
+    Param(Allocator &alloc, const std::vector<Index> &shape,
+            const std::vector<Index> &basetile):
+        value(alloc.make(shape, basetile)),
+        grad(alloc.make(shape, basetile)),
+        first_moment(alloc.make(shape, basetile)),
+        second_moment(alloc.make(shape, basetile))
+    {
+    }
+};
+
+// Layer normalization over embeddings, the same as nntile.layer.LayerNorm
+struct LayerNorm
+{
+    Param gamma, beta;
+    Tensor<T> mean, inv_stddev, tmp_y_value, tmp_y_grad;
+    Index l;
+    T eps;
+    LayerNorm(Allocator &alloc, const Sizes &s):
+        gamma(alloc, {s.n_emb}, {s.n_emb_tile}),
+        beta(alloc, {s.n_emb}, {s.n_emb_tile}),
+        mean(alloc.make({s.n_seq, s.n_batch}, {s.n_seq_tile, s.n_batch_tile})),
+        inv_stddev(alloc.make({s.n_seq, s.n_batch},
+                    {s.n_seq_tile, s.n_batch_tile})),
+        tmp_y_value(alloc.make({s.n_emb, s.n_seq, s.n_batch},
+                    {s.n_emb_tile, s.n_seq_tile, s.n_batch_tile})),
+        tmp_y_grad(alloc.make({s.n_emb, s.n_seq, s.n_batch},
+                    {s.n_emb_tile, s.n_seq_tile, s.n_batch_tile})),
+        l(s.n_emb),
+        eps(std::sqrt(T(1e-5)))
+    {
+    }
+    void forward_async(const Tensor<T> &x, const Tensor<T> &y)
+    {
+        sum_slice_async<T>(1.0/l, x, 0.0, mean, 0);
+        add_slice3_async<T>(-1.0, mean, 1.0, x, tmp_y_value, 0);
+        norm_slice_async<T>(1.0/std::sqrt(T(l)), tmp_y_value, 0.0,
+                inv_stddev, 0);
+        hypot_scalar_inverse_async<T>(eps, 1.0, inv_stddev);
+        prod_slice_async<T>(inv_stddev, 1.0, tmp_y_value, 0);
+        prod_fiber3_async<T>(gamma.value, 1.0, tmp_y_value, y, 0);
+        add_fiber_async<T>(1.0, beta.value, 1.0, y, 0, 0);
+    }
+    // Gradient over input is accumulated into x_grad
+    void backward_async(const Tensor<T> &y_grad, const Tensor<T> &x_grad)
+    {
+        sum_fiber_async<T>(1.0, y_grad, 1.0, beta.grad, 0, 0);
+        sumprod_fiber_async<T>(1.0, y_grad, tmp_y_value, 1.0, gamma.grad, 0);
+        prod_fiber3_async<T>(gamma.value, 1.0, y_grad, tmp_y_grad, 0);
+        sumprod_slice_async<T>(-1.0/l, tmp_y_grad, tmp_y_value, 0.0, mean, 0);
+        prod_slice_async<T>(mean, 1.0, tmp_y_value, 0);
+        axpy_async<T>(1.0, tmp_y_grad, tmp_y_value);
+        sum_slice_async<T>(1.0/l, tmp_y_grad, 0.0, mean, 0);
+        add_slice_async<T>(-1.0, mean, 1.0, tmp_y_value, 0);
+        prod_slice_async<T>(inv_stddev, 1.0, tmp_y_value, 0);
+        axpy_async<T>(1.0, tmp_y_value, x_grad);
+    }
+    std::vector<Param *> params()
+    {
+        return {&gamma, &beta};
+    }
+};
+
+// Causal multi-head attention, the same as nntile.layer.Attention without
+// biases of queries, keys and values
+struct Attention
+{
+    Param w_q, w_k, w_v, w, out_bias;
+    Tensor<T> q_transposed, q, k_transposed, k, v_transposed, v, a,
+        a_maxsumexp, a_sumprod_slice, b, b_transposed;
+    Tensor<T> q_transposed_grad, q_grad, k_transposed_grad, k_grad,
+        v_transposed_grad, v_grad, a_grad, b_grad, b_transposed_grad;
+    Tensor<bool_t> mask;
+    T scale;
+    static Tensor<T> make_qkv_transposed(Allocator &alloc, const Sizes &s,
+            Index head_size)
+    {
+        return alloc.make({s.n_head, head_size, s.n_seq, s.n_batch},
+                {s.n_head_tile, head_size, s.n_seq_tile, s.n_batch_tile});
+    }
+    static Tensor<T> make_qkv(Allocator &alloc, const Sizes &s,
+            Index head_size)
+    {
+        return alloc.make({head_size, s.n_seq, s.n_batch, s.n_head},
+                {head_size, s.n_seq_tile, s.n_batch_tile, s.n_head_tile});
+    }
+    static Tensor<T> make_a(Allocator &alloc, const Sizes &s)
+    {
+        return alloc.make({s.n_seq, s.n_seq, s.n_batch, s.n_head},
+                {s.n_seq_tile, s.n_seq_tile, s.n_batch_tile, s.n_head_tile});
+    }
+    Attention(Allocator &alloc, const Sizes &s, Index head_size):
+        w_q(alloc, {s.n_head, head_size, s.n_emb},
+                {s.n_head_tile, head_size, s.n_emb_tile}),
+        w_k(alloc, {s.n_head, head_size, s.n_emb},
+                {s.n_head_tile, head_size, s.n_emb_tile}),
+        w_v(alloc, {s.n_head, head_size, s.n_emb},
+                {s.n_head_tile, head_size, s.n_emb_tile}),
+        w(alloc, {s.n_emb, s.n_head, head_size},
+                {s.n_emb_tile, s.n_head_tile, head_size}),
+        out_bias(alloc, {s.n_emb}, {s.n_emb_tile}),
+        q_transposed(make_qkv_transposed(alloc, s, head_size)),
+        q(make_qkv(alloc, s, head_size)),
+        k_transposed(make_qkv_transposed(alloc, s, head_size)),
+        k(make_qkv(alloc, s, head_size)),
+        v_transposed(make_qkv_transposed(alloc, s, head_size)),
+        v(make_qkv(alloc, s, head_size)),
+        a(make_a(alloc, s)),
+        a_maxsumexp(alloc.make({2, s.n_seq, s.n_batch, s.n_head},
+                    {2, s.n_seq_tile, s.n_batch_tile, s.n_head_tile})),
+        a_sumprod_slice(alloc.make({s.n_seq, s.n_batch, s.n_head},
+                    {s.n_seq_tile, s.n_batch_tile, s.n_head_tile})),
+        b(make_qkv(alloc, s, head_size)),
+        b_transposed(make_qkv_transposed(alloc, s, head_size)),
+        q_transposed_grad(make_qkv_transposed(alloc, s, head_size)),
+        q_grad(make_qkv(alloc, s, head_size)),
+        k_transposed_grad(make_qkv_transposed(alloc, s, head_size)),
+        k_grad(make_qkv(alloc, s, head_size)),
+        v_transposed_grad(make_qkv_transposed(alloc, s, head_size)),
+        v_grad(make_qkv(alloc, s, head_size)),
+        a_grad(make_a(alloc, s)),
+        b_grad(make_qkv(alloc, s, head_size)),
+        b_transposed_grad(make_qkv_transposed(alloc, s, head_size)),
+        mask(alloc.make<bool_t>({s.n_seq, s.n_seq},
+                    {s.n_seq_tile, s.n_seq_tile})),
+        scale(1.0/std::sqrt(T(head_size)))
+    {
+        // Causal mask allows a query to attend to keys up to its position
+        for(Index i = 0; i < mask.grid.nelems; ++i)
+        {
+            auto index = mask.grid.linear_to_index(i);
+            const auto &traits = mask.get_tile_traits(i);
+            auto tile = mask.get_tile(i);
+            auto tile_local = tile.acquire(STARPU_W);
+            for(Index j = 0; j < traits.shape[1]; ++j)
+            {
+                Index query = index[1]*mask.basetile_shape[1] + j;
+                for(Index k = 0; k < traits.shape[0]; ++k)
+                {
+                    Index key = index[0]*mask.basetile_shape[0] + k;
+                    tile_local[j*traits.shape[0]+k] = key <= query;
+                }
+            }
+            tile_local.release();
+        }
+    }
+    void forward_async(const Tensor<T> &x, const Tensor<T> &y)
+    {
+        const TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+        // Q, K and V of all heads
+        gemm_async<T>(1.0, opN, w_q.value, opN, x, 0.0, q_transposed, 1, 0);
+        transpose_async<T>(1.0, q_transposed, q, 1);
+        gemm_async<T>(1.0, opN, w_k.value, opN, x, 0.0, k_transposed, 1, 0);
+        transpose_async<T>(1.0, k_transposed, k, 1);
+        gemm_async<T>(1.0, opN, w_v.value, opN, x, 0.0, v_transposed, 1, 0);
+        transpose_async<T>(1.0, v_transposed, v, 1);
+        // A = softmax(mask(K^T Q / sqrt(head_size)))
+        gemm_async<T>(scale, opT, k, opN, q, 0.0, a, 1, 2);
+        clear_async<T>(a_maxsumexp);
+        mask_scalar_async<T>(mask, -std::numeric_limits<T>::infinity(), a,
+                2);
+        maxsumexp_async<T>(a, a_maxsumexp, 0);
+        softmax_inplace_async<T>(a_maxsumexp, 1.0, a, 0);
+        // Y = W (V A) + bias
+        gemm_async<T>(1.0, opN, v, opN, a, 0.0, b, 1, 2);
+        transpose_async<T>(1.0, b, b_transposed, 3);
+        gemm_async<T>(1.0, opN, w.value, opN, b_transposed, 0.0, y, 2, 0);
+        add_fiber_async<T>(1.0, out_bias.value, 1.0, y, 0, 0);
+    }
+    // Gradient over input is accumulated into x_grad
+    void backward_async(const Tensor<T> &x, const Tensor<T> &y_grad,
+            const Tensor<T> &x_grad)
+    {
+        const TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+        sum_fiber_async<T>(1.0, y_grad, 1.0, out_bias.grad, 0, 0);
+        gemm_async<T>(1.0, opN, y_grad, opT, b_transposed, 1.0, w.grad, 2,
+                0);
+        gemm_async<T>(1.0, opT, w.value, opN, y_grad, 0.0, b_transposed_grad,
+                1, 0);
+        transpose_async<T>(1.0, b_transposed_grad, b_grad, 1);
+        gemm_async<T>(1.0, opT, v, opN, b_grad, 0.0, a_grad, 1, 2);
+        gemm_async<T>(1.0, opN, b_grad, opT, a, 0.0, v_grad, 1, 2);
+        // Backward of softmax
+        sumprod_slice_async<T>(1.0, a, a_grad, 0.0, a_sumprod_slice, 0);
+        add_slice_async<T>(-1.0, a_sumprod_slice, 1.0, a_grad, 0);
+        prod_async<T>(a, a_grad);
+        mask_scalar_async<T>(mask, 0.0, a_grad, 2);
+        gemm_async<T>(scale, opN, q, opT, a_grad, 0.0, k_grad, 1, 2);
+        gemm_async<T>(scale, opN, k, opN, a_grad, 0.0, q_grad, 1, 2);
+        // Gradients of projections
+        const Tensor<T> *grads[3][3] = {
+            {&q_grad, &q_transposed_grad, &w_q.grad},
+            {&k_grad, &k_transposed_grad, &w_k.grad},
+            {&v_grad, &v_transposed_grad, &w_v.grad}};
+        const Tensor<T> *weights[3] = {&w_q.value, &w_k.value, &w_v.value};
+        for(int i = 0; i < 3; ++i)
+        {
+            transpose_async<T>(1.0, *grads[i][0], *grads[i][1], 3);
+            gemm_async<T>(1.0, opT, *weights[i], opN, *grads[i][1], 1.0,
+                    x_grad, 2, 0);
+            gemm_async<T>(1.0, opN, *grads[i][1], opT, x, 1.0,
+                    *grads[i][2], 2, 0);
+        }
+    }
+    std::vector<Param *> params()
+    {
+        return {&w_q, &w_k, &w_v, &w, &out_bias};
+    }
+};
+
+// MLP with approximate GeLU
+struct MLP
+{
+    Param w1, b1, w2, b2;
+    Tensor<T> h, g, h_grad, g_grad;
+    static Tensor<T> make_h(Allocator &alloc, const Sizes &s)
+    {
+        return alloc.make({s.n_ff, s.n_seq, s.n_batch},
+                {s.n_ff_tile, s.n_seq_tile, s.n_batch_tile});
+    }
+    MLP(Allocator &alloc, const Sizes &s):
+        w1(alloc, {s.n_ff, s.n_emb}, {s.n_ff_tile, s.n_emb_tile}),
+        b1(alloc, {s.n_ff}, {s.n_ff_tile}),
+        w2(alloc, {s.n_emb, s.n_ff}, {s.n_emb_tile, s.n_ff_tile}),
+        b2(alloc, {s.n_emb}, {s.n_emb_tile}),
+        h(make_h(alloc, s)),
+        g(make_h(alloc, s)),
+        h_grad(make_h(alloc, s)),
+        g_grad(make_h(alloc, s))
+    {
+    }
+    void forward_async(const Tensor<T> &x, const Tensor<T> &y)
+    {
+        const TransOp opN(TransOp::NoTrans);
+        gemm_async<T>(1.0, opN, w1.value, opN, x, 0.0, h, 1, 0);
+        add_fiber_async<T>(1.0, b1.value, 1.0, h, 0, 0);
+        gelutanh_async<T>(h, g);
+        gemm_async<T>(1.0, opN, w2.value, opN, g, 0.0, y, 1, 0);
+        add_fiber_async<T>(1.0, b2.value, 1.0, y, 0, 0);
+    }
+    // Gradient over input is accumulated into x_grad
+    void backward_async(const Tensor<T> &x, const Tensor<T> &y_grad,
+            const Tensor<T> &x_grad)
+    {
+        const TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+        sum_fiber_async<T>(1.0, y_grad, 1.0, b2.grad, 0, 0);
+        gemm_async<T>(1.0, opN, y_grad, opT, g, 1.0, w2.grad, 2, 0);
+        gemm_async<T>(1.0, opT, w2.value, opN, y_grad, 0.0, g_grad, 1, 0);
+        clear_async<T>(h_grad);
+        gelutanh_backward_async<T>(h, g_grad, h_grad);
+        sum_fiber_async<T>(1.0, h_grad, 1.0, b1.grad, 0, 0);
+        gemm_async<T>(1.0, opN, h_grad, opT, x, 1.0, w1.grad, 2, 0);
+        gemm_async<T>(1.0, opT, w1.value, opN, h_grad, 1.0, x_grad, 1, 0);
+    }
+    std::vector<Param *> params()
+    {
+        return {&w1, &b1, &w2, &b2};
+    }
+};
+
+// Pre-normalization transformer block of GPT-2:
+//      x2 = x + attn(ln1(x)),  y = x2 + mlp(ln2(x2))
+struct Block
+{
+    LayerNorm ln1, ln2;
+    Attention attn;
+    MLP mlp;
+    Tensor<T> y1, x2, y2, y1_grad, x2_grad, y2_grad;
+    static Tensor<T> make_x(Allocator &alloc, const Sizes &s)
+    {
+        return alloc.make({s.n_emb, s.n_seq, s.n_batch},
+                {s.n_emb_tile, s.n_seq_tile, s.n_batch_tile});
+    }
+    Block(Allocator &alloc, const Sizes &s):
+        ln1(alloc, s),
+        ln2(alloc, s),
+        attn(alloc, s, s.n_emb/s.n_head),
+        mlp(alloc, s),
+        y1(make_x(alloc, s)),
+        x2(make_x(alloc, s)),
+        y2(make_x(alloc, s)),
+        y1_grad(make_x(alloc, s)),
+        x2_grad(make_x(alloc, s)),
+        y2_grad(make_x(alloc, s))
+    {
+    }
+    void forward_async(const Tensor<T> &x, const Tensor<T> &y)
+    {
+        ln1.forward_async(x, y1);
+        attn.forward_async(y1, x2);
+        add_async<T>(1.0, x, 1.0, x2);
+        ln2.forward_async(x2, y2);
+        mlp.forward_async(y2, y);
+        add_async<T>(1.0, x2, 1.0, y);
+    }
+    // Gradient over input is overwritten
+    void backward_async(const Tensor<T> &y_grad, const Tensor<T> &x_grad)
+    {
+        clear_async<T>(y2_grad);
+        mlp.backward_async(y2, y_grad, y2_grad);
+        copy_async<T>(y_grad, x2_grad);
+        ln2.backward_async(y2_grad, x2_grad);
+        clear_async<T>(y1_grad);
+        attn.backward_async(y1, x2_grad, y1_grad);
+        copy_async<T>(x2_grad, x_grad);
+        ln1.backward_async(y1_grad, x_grad);
+    }
+    std::vector<Param *> params()
+    {
+        std::vector<Param *> res;
+        for(auto p: ln1.params())
+        {
+            res.push_back(p);
+        }
+        for(auto p: attn.params())
+        {
+            res.push_back(p);
+        }
+        for(auto p: ln2.params())
+        {
+            res.push_back(p);
+        }
+        for(auto p: mlp.params())
+        {
+            res.push_back(p);
+        }
+        return res;
+    }
+};
+
+static void usage(const char *exec)
+{
+    std::cout << "Usage: " << exec << " [options]\n"
+        "  --ncpu N, --ncuda N      number of workers (default: all)\n"
+        "  --warmup N, --iters N    untimed and timed steps (default: 2, 5)\n"
+        "  --layers N               number of blocks (default: 2)\n"
+        "  --emb N, --emb-tile N    embedding size (default: 768)\n"
+        "  --head N, --head-tile N  number of heads (default: 12)\n"
+        "  --ff N, --ff-tile N      hidden size of MLP (default: 3072)\n"
+        "  --seq N, --seq-tile N    sequence length (default: 1024)\n"
+        "  --batch N, --batch-tile N  batch size (default: 4, 1)\n"
+        "Tile sizes default to the corresponding sizes.\n";
+}
+
+int main(int argc, char **argv)
+{
+    Sizes s;
+    Index ncpu = -1, ncuda = -1, n_warmup = 2, n_iter = 5;
+    Index emb_tile = -1, head_tile = -1, ff_tile = -1, seq_tile = -1;
+    const std::map<std::string, Index *> options = {
+        {"--ncpu", &ncpu}, {"--ncuda", &ncuda}, {"--warmup", &n_warmup},
+        {"--iters", &n_iter}, {"--layers", &s.n_layer}, {"--emb", &s.n_emb},
+        {"--emb-tile", &emb_tile}, {"--head", &s.n_head},
+        {"--head-tile", &head_tile}, {"--ff", &s.n_ff},
+        {"--ff-tile", &ff_tile}, {"--seq", &s.n_seq},
+        {"--seq-tile", &seq_tile}, {"--batch", &s.n_batch},
+        {"--batch-tile", &s.n_batch_tile}};
+    for(int i = 1; i < argc; i += 2)
+    {
+        auto opt = options.find(argv[i]);
+        if(opt == options.end() or i+1 == argc)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        *opt->second = std::stoll(argv[i+1]);
+    }
+    s.n_emb_tile = emb_tile > 0 ? emb_tile : s.n_emb;
+    s.n_head_tile = head_tile > 0 ? head_tile : s.n_head;
+    s.n_ff_tile = ff_tile > 0 ? ff_tile : s.n_ff;
+    s.n_seq_tile = seq_tile > 0 ? seq_tile : s.n_seq;
+    if(s.n_emb % s.n_head != 0 or n_iter <= 0 or n_warmup < 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    // Initialize StarPU
+    starpu::Config starpu(ncpu, ncuda, 1);
+    starpu::init();
+    // Build the model
+    Allocator alloc;
+    std::vector<Tensor<T>> x, x_grad;
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::vector<Param *> params;
+    for(Index i = 0; i <= s.n_layer; ++i)
+    {
+        x.push_back(Block::make_x(alloc, s));
+        x_grad.push_back(Block::make_x(alloc, s));
+    }
+    for(Index i = 0; i < s.n_layer; ++i)
+    {
+        blocks.emplace_back(new Block(alloc, s));
+        for(auto p: blocks.back()->params())
+        {
+            params.push_back(p);
+        }
+    }
+    // Random input and parameters, unit gamma
+    unsigned long long seed = 0;
+    randn_async<T>(x[0], std::vector<Index>(3, 0), x[0].shape, ++seed, 0.0,
+            1.0);
+    for(auto p: params)
+    {
+        std::vector<Index> start(p->value.ndim, 0);
+        randn_async<T>(p->value, start, p->value.shape, ++seed, 0.0, 0.02);
+        clear_async<T>(p->first_moment);
+        clear_async<T>(p->second_moment);
+    }
+    for(auto &b: blocks)
+    {
+        fill_async<T>(1.0, b->ln1.gamma.value);
+        fill_async<T>(1.0, b->ln2.gamma.value);
+    }
+    starpu_task_wait_for_all();
+    // A single step of training of 0.5*||y||^2 with Adam
+    Index num_iter = 0;
+    auto step = [&]()
+    {
+        for(Index i = 0; i < s.n_layer; ++i)
+        {
+            blocks[i]->forward_async(x[i], x[i+1]);
+        }
+        copy_async<T>(x[s.n_layer], x_grad[s.n_layer]);
+        for(auto p: params)
+        {
+            clear_async<T>(p->grad);
+        }
+        for(Index i = s.n_layer-1; i >= 0; --i)
+        {
+            blocks[i]->backward_async(x_grad[i+1], x_grad[i]);
+        }
+        ++num_iter;
+        for(auto p: params)
+        {
+            adam_step_async<T>(num_iter, 0.9, 0.999, 1e-8, 1e-4, 0.0,
+                    p->grad, p->first_moment, p->second_moment, p->value);
+        }
+        starpu_task_wait_for_all();
+    };
+    for(Index i = 0; i < n_warmup; ++i)
+    {
+        step();
+    }
+    auto start = std::chrono::steady_clock::now();
+    for(Index i = 0; i < n_iter; ++i)
+    {
+        step();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double time = std::chrono::duration<double>(end-start).count();
+    // Forward pass takes 2 flops per weight per token and 4*n_seq*n_emb
+    // flops per token for attention scores and their product with values.
+    // Backward pass takes twice as many flops.
+    double n_tok = double(s.n_seq) * s.n_batch;
+    double nflops_fwd = s.n_layer * n_tok * (2.0*(4*s.n_emb*s.n_emb
+                + 2*s.n_emb*s.n_ff) + 4.0*s.n_seq*s.n_emb);
+    double nflops = 3 * nflops_fwd * n_iter;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "Blocks: " << s.n_layer << ", emb: " << s.n_emb << "/"
+        << s.n_emb_tile << ", heads: " << s.n_head << "/" << s.n_head_tile
+        << ", ff: " << s.n_ff << "/" << s.n_ff_tile << ", seq: " << s.n_seq
+        << "/" << s.n_seq_tile << ", batch: " << s.n_batch << "/"
+        << s.n_batch_tile << "\n";
+    std::cout << "Time per step: " << time/n_iter << " s\n";
+    std::cout << "Throughput: " << n_tok*n_iter/time << " tokens/s\n";
+    std::cout << "Performance: " << nflops/time*1e-9 << " GFLOP/s\n";
+    std::cout << "Memory of tensors: " << alloc.nbytes/double(1<<20)
+        << " MiB\n";
+    std::cout << "Peak resident memory: " << usage.ru_maxrss/1024.0
+        << " MiB\n";
+    return 0;
+}
@@ -66,6 +66,9 @@
 #include <nntile/kernel/adam_step.hh>
 #include <nntile/kernel/adamw_step.hh>
 #include <nntile/kernel/transpose.hh>
+#include <nntile/kernel/topk_maxsumexp.hh>
+#include <nntile/kernel/sample_topk.hh>
+#include <nntile/kernel/retile.hh>
 
 //! @namespace nntile::kernel
 /*! This namespace holds low-level routines for codelets
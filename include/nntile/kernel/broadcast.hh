@@ -0,0 +1,126 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/broadcast.hh
+ * CPU loop helper for six broadcast kernels
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile::kernel::broadcast
+{
+
+// CPU loop helper for broadcasting kernels. It is used by CPU kernels of
+// add_slice, add_slice3, add_fiber, prod_slice, prod_fiber and prod_fiber3,
+// while StarPU codelets, CUDA kernels and reductions keep their own code.
+//
+// Kernels of slices and fibers work on an m-by-k-by-n-by-batch index space,
+// where the output is a contiguous array of this shape. Every operand spans
+// a subset of axes of the index space, that is set at compile time by a
+// mask of the following values, and it is broadcasted along other axes. An
+// operand is stored as a contiguous array of the axes it spans, e.g. a slice
+// with mask M|N is a contiguous m-by-n array and a fiber with mask K|B is a
+// contiguous k-by-batch array.
+constexpr unsigned M = 1, K = 2, N = 4, B = 8;
+constexpr unsigned FULL = M | K | N | B;
+
+//! Operand of a broadcasting loop
+template<unsigned Axes, typename T>
+struct Operand
+{
+    //! Pointer to the element at the current position of outer loops
+    T *ptr;
+    //! Strides along K, N and B axes, zero for broadcasted axes
+    Index stride_k, stride_n, stride_b;
+
+    Operand(const Index (&shape)[4], T *ptr_):
+        ptr(ptr_)
+    {
+        Index stride = (Axes & M) ? shape[0] : 1;
+        stride_k = (Axes & K) ? stride : 0;
+        stride *= (Axes & K) ? shape[1] : 1;
+        stride_n = (Axes & N) ? stride : 0;
+        stride *= (Axes & N) ? shape[2] : 1;
+        stride_b = (Axes & B) ? stride : 0;
+    }
+
+    //! Operand, shifted to a given position of outer loops
+    Operand shift(Index i1, Index i2, Index i3) const
+    {
+        Operand res(*this);
+        res.ptr += i1*stride_k + i2*stride_n + i3*stride_b;
+        return res;
+    }
+
+    //! Element at a given position of the innermost loop
+    T &operator[](Index i0) const
+    {
+        // Stride along the innermost loop is a compile-time constant, so a
+        // broadcasted operand is read only once per fiber
+        return ptr[(Axes & M) ? i0 : 0];
+    }
+};
+
+//! Construct an operand with a given set of axes
+template<unsigned Axes, typename T>
+Operand<Axes, T> operand(const Index (&shape)[4], T *ptr)
+{
+    return Operand<Axes, T>(shape, ptr);
+}
+
+//! Innermost loop over the contiguous first axis
+template<typename F, typename Dst, typename... Src>
+void apply_fiber(Index m, F &f, const Dst &dst, const Src &...src)
+    noexcept
+{
+    for(Index i0 = 0; i0 < m; ++i0)
+    {
+        f(dst[i0], src[i0]...);
+    }
+}
+
+//! Apply elementwise functor to operands of a broadcasting expression
+/*! Performs the following operations:
+ *      f(dst[i0,i1,i2,i3], src[i0,i1,i2,i3]...)
+ * for all indices of the index space, where broadcasted axes of operands are
+ * ignored. The functor gets a reference to an element of dst and elements of
+ * all other operands. Outputs are contiguous along the innermost loop over
+ * the first axis, which lets the compiler vectorize it. If dst itself is
+ * broadcasted along some axes, the functor shall accumulate into it.
+ *
+ * @param[in] shape: Sizes m, k, n and batch of the index space
+ * @param[in] f: Elementwise functor
+ * @param[inout] dst: Output operand
+ * @param[in] src: Input operands
+ * */
+template<typename F, typename Dst, typename... Src>
+void apply(const Index (&shape)[4], F f, const Dst &dst, const Src &...src)
+    noexcept
+{
+    const Index m = shape[0], k = shape[1], n = shape[2], batch = shape[3];
+    // Cycle over batch
+    for(Index i3 = 0; i3 < batch; ++i3)
+    {
+        // Cycle over the last axis
+        for(Index i2 = 0; i2 < n; ++i2)
+        {
+            // Cycle over the middle axis
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                apply_fiber(m, f, dst.shift(i1, i2, i3),
+                        src.shift(i1, i2, i3)...);
+            }
+        }
+    }
+}
+
+} // namespace nntile::kernel::broadcast
@@ -0,0 +1,26 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/retile.hh
+ * Gathering of a tile from parts of other tiles low-level kernels
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/kernel/retile/cpu.hh>
+// No support for retile on CUDA
+
+//! @namespace nntile::kernel::retile
+/*! Low-level implementations of gathering a tile from parts of other tiles
+ * */
+namespace nntile::kernel::retile
+{
+
+} // namespace nntile::kernel::retile
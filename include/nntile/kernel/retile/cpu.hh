@@ -0,0 +1,28 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/retile/cpu.hh
+ * Gathering of a tile from parts of other tiles on CPU
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile::kernel::retile
+{
+
+// Gather destination tile from parts of several source tiles
+template<typename T>
+void cpu(Index ndim, Index nsrc, const Index *dst_stride, const Index *info,
+        const T *const *src, T *dst)
+    noexcept;
+
+} // namespace nntile::kernel::retile
@@ -0,0 +1,26 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/sample_topk.hh
+ * Sampling from top-k candidates low-level kernels
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/kernel/sample_topk/cpu.hh>
+// No support for sample_topk on CUDA
+
+//! @namespace nntile::kernel::sample_topk
+/*! Low-level implementations of sampling of tokens from top-k candidates
+ * */
+namespace nntile::kernel::sample_topk
+{
+
+} // namespace nntile::kernel::sample_topk
@@ -0,0 +1,29 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/sample_topk/cpu.hh
+ * Sampling from top-k candidates on CPU
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile::kernel::sample_topk
+{
+
+// Sample a token of each column from its top-k candidates
+template<typename T>
+void cpu(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, const T *topk_val,
+        const Index *topk_idx, const T *maxsumexp, Index *token)
+    noexcept;
+
+} // namespace nntile::kernel::sample_topk
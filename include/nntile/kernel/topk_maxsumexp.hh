@@ -0,0 +1,27 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/topk_maxsumexp.hh
+ * Top-k and max and sum of exponents of columns low-level kernels
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/kernel/topk_maxsumexp/cpu.hh>
+// No support for topk_maxsumexp on CUDA
+
+//! @namespace nntile::kernel::topk_maxsumexp
+/*! Low-level implementations of running top-k and max and sum of exponents
+ * of columns of a matrix
+ * */
+namespace nntile::kernel::topk_maxsumexp
+{
+
+} // namespace nntile::kernel::topk_maxsumexp
@@ -0,0 +1,28 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/topk_maxsumexp/cpu.hh
+ * Top-k and max and sum of exponents of columns on CPU
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile::kernel::topk_maxsumexp
+{
+
+// Update running top-k and max and sum of exponents of columns
+template<typename T>
+void cpu(Index m, Index n, Index k, Index offset, scal_t alpha, bool init,
+        const T *src, T *topk_val, Index *topk_idx, T *maxsumexp)
+    noexcept;
+
+} // namespace nntile::kernel::topk_maxsumexp
@@ -16,6 +16,12 @@
 
 // StarPU wrappers for data handles and config
 #include <nntile/starpu/config.hh>
+#include <nntile/starpu/ndarray.hh>
+#include <nntile/starpu/counters.hh>
+#include <nntile/starpu/trace.hh>
+#include <nntile/starpu/memory.hh>
+#include <nntile/starpu/submitter.hh>
+#include <nntile/starpu/perfmodel.hh>
 
 // StarPU wrappers for low-level kernels
 #include <nntile/starpu/accumulate.hh>
@@ -83,6 +89,10 @@
 #include <nntile/starpu/adam_step.hh>
 #include <nntile/starpu/adamw_step.hh>
 #include <nntile/starpu/transpose.hh>
+#include <nntile/starpu/topk_maxsumexp.hh>
+#include <nntile/starpu/sample_topk.hh>
+#include <nntile/starpu/tile_io.hh>
+#include <nntile/starpu/retile.hh>
 
 //! @namespace nntile::starpu
 /*! This namespace holds StarPU wrappers
@@ -158,6 +168,10 @@ void init()
     adam_step::init();
     adamw_step::init();
     transpose::init();
+    topk_maxsumexp::init();
+    sample_topk::init();
+    tile_io::init();
+    retile::init();
 }
 
 // Restrict StarPU codelets to certain computational units
@@ -228,6 +242,10 @@ void restrict_where(uint32_t where)
     adam_step::restrict_where(where);
     adamw_step::restrict_where(where);
     transpose::restrict_where(where);
+    topk_maxsumexp::restrict_where(where);
+    sample_topk::restrict_where(where);
+    tile_io::restrict_where(where);
+    retile::restrict_where(where);
 }
 
 // Restore computational units for StarPU codelets
@@ -298,6 +316,10 @@ void restore_where()
     adam_step::restore_where();
     adamw_step::restore_where();
     transpose::restore_where();
+    topk_maxsumexp::restore_where();
+    sample_topk::restore_where();
+    tile_io::restore_where();
+    retile::restore_where();
 }
 
 } // namespace nntile::starpu
@@ -19,10 +19,13 @@
 #include <memory>
 #include <cstring>
 #include <iostream>
+#include <cstdint>
 #include <starpu.h>
 // Disabled MPI for now
 //#include <starpu_mpi.h>
 #include <nntile/defs.h>
+#include <nntile/starpu/memory.hh>
+#include <nntile/starpu/submitter.hh>
 
 namespace nntile
 {
@@ -105,6 +108,8 @@ public:
     }
     void shutdown()
     {
+        // No tasks can be submitted after StarPU is shut down
+        submitter::shutdown();
 #ifdef NNTILE_USE_CUDA
         if(cublas != 0)
         {
@@ -177,6 +182,7 @@ class Handle
         // All the tasks using given starpu data handle shall be finished
         // before unregistering the handle
         //std::cerr << "[nntile] unregister\n";
+        memory::untrack(ptr);
         starpu_data_unregister(ptr);
     }
     static void _deleter_no_coherency(starpu_data_handle_t ptr)
@@ -185,6 +191,7 @@ class Handle
         // All the tasks using given starpu data handle shall be finished
         // before unregistering the handle
         //std::cerr << "[nntile] unregister_no_coherency\n";
+        memory::untrack(ptr);
         starpu_data_unregister_no_coherency(ptr);
     }
     static void _deleter_temporary(starpu_data_handle_t ptr)
@@ -194,6 +201,7 @@ class Handle
         // starpu as it will be deallocated during actual unregistering and at
         // the time of submission.
         //std::cerr << "[nntile] unregister_submit\n";
+        memory::untrack(ptr);
         starpu_data_unregister_submit(ptr);
     }
     static std::shared_ptr<_starpu_data_state> _get_shared_ptr(
@@ -380,6 +388,13 @@ class VariableHandle: public Handle
                 reinterpret_cast<uintptr_t>(ptr), size);
         return tmp;
     }
+protected:
+    //! Constructor for data, registered with another compatible interface
+    explicit VariableHandle(starpu_data_handle_t handle_,
+            starpu_data_access_mode mode):
+        Handle(handle_, mode)
+    {
+    }
 public:
     //! Constructor for variable that is (de)allocated by StarPU
     explicit VariableHandle(size_t size, starpu_data_access_mode mode):
@@ -399,7 +414,23 @@ class Codelet: public starpu_codelet, public starpu_perfmodel
 {
 private:
     uint32_t where_default = STARPU_NOWHERE; // uninitialized value
+    // Actual implementations, called through counting wrappers
+    starpu_cpu_func_t cpu_funcs_real[STARPU_MAXIMPLEMENTATIONS];
+    starpu_cuda_func_t cuda_funcs_real[STARPU_MAXIMPLEMENTATIONS];
+    // Wrappers of implementations, that update counters of the codelet
+    static void cpu_wrapper(void *buffers[], void *cl_args);
+    static void cuda_wrapper(void *buffers[], void *cl_args);
+    // Add codelet to the list of codelets with counters
+    static void register_counters(Codelet *codelet);
 public:
+    //! Number of executed tasks, guarded by a mutex of counters
+    std::uint64_t ntasks;
+    //! Total floating point operations, set by STARPU_FLOPS of tasks
+    double flops;
+    //! Estimated number of bytes, read and written by tasks
+    double bytes;
+    //! Total execution time of tasks in seconds
+    double seconds;
     //! Zero-initialize codelet
     Codelet()
     {
@@ -434,8 +465,9 @@ public:
 //#ifdef STARPU_SIMGRID // Put fake function address in case of simulation
 //                    starpu_codelet::cpu_funcs[i] = (starpu_cpu_func_t)0;
 //#else // Put real function address
-                    starpu_codelet::cpu_funcs[i] = *it;
+                    starpu_codelet::cpu_funcs[i] = cpu_wrapper;
 //#endif
+                    cpu_funcs_real[i] = *it;
                     starpu_codelet::where = where_default = STARPU_CPU;
                 }
             }
@@ -455,14 +487,16 @@ public:
 //#ifdef STARPU_SIMGRID // Put fake function address in case of simulation
 //                    starpu_codelet::cuda_funcs[i] = (starpu_cuda_func_t)0;
 //#else // Put real function address
-                    starpu_codelet::cuda_funcs[i] = *it;
+                    starpu_codelet::cuda_funcs[i] = cuda_wrapper;
 //#endif
+                    cuda_funcs_real[i] = *it;
                     starpu_codelet::cuda_flags[i] = STARPU_CUDA_ASYNC;
                     where_default = where_default | STARPU_CUDA;
                     starpu_codelet::where = where_default;
                 }
             }
         }
+        register_counters(this);
     }
     void restrict_where(uint32_t where_)
     {
@@ -0,0 +1,58 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/counters.hh
+ * Aggregate counters of FLOPs, bytes and time of executed tasks
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/starpu/config.hh>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace nntile::starpu::counters
+{
+
+//! Accumulated counters of a single codelet
+struct Record
+{
+    //! Name of the codelet
+    std::string name;
+    //! Number of executed tasks
+    std::uint64_t ntasks;
+    //! Total floating point operations
+    double flops;
+    //! Estimated number of bytes, read and written by tasks
+    double bytes;
+    //! Total execution time of tasks in seconds
+    double seconds;
+};
+
+//! Start accumulation of counters by executed tasks
+void enable();
+
+//! Stop accumulation of counters
+void disable();
+
+//! Check if counters are accumulated
+bool is_enabled();
+
+//! Set all counters to zero
+void reset();
+
+//! Get counters of all codelets, that executed at least one task
+std::vector<Record> get();
+
+//! Get all initialized codelets
+std::vector<Codelet *> get_codelets();
+
+} // namespace nntile::starpu::counters
@@ -0,0 +1,94 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/memory.hh
+ * Accounting of memory of registered data by categories
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <starpu.h>
+#include <vector>
+
+namespace nntile::starpu::memory
+{
+
+//! Categories of tracked data
+enum Category: int
+{
+    OTHER = 0,
+    PARAMETER,
+    GRAD,
+    ACTIVATION,
+    OPTIMIZER,
+    SCRATCH,
+    NCATEGORIES
+};
+
+//! Name of a category
+const char *category_name(int category);
+
+//! Live and peak bytes of tracked data
+struct Stats
+{
+    //! Live bytes of each category
+    Index live[NCATEGORIES];
+    //! Peak live bytes of each category
+    Index peak[NCATEGORIES];
+    //! Total live bytes
+    Index live_total;
+    //! Peak of total live bytes, that is not a sum of peaks of categories
+    Index peak_total;
+};
+
+//! Sample of live bytes at some moment
+struct Sample
+{
+    //! Seconds since the timeline was enabled
+    double time;
+    //! Live bytes of each category
+    Index live[NCATEGORIES];
+};
+
+//! Track registered data of a given size with the default category
+void track(starpu_data_handle_t handle, Index nbytes);
+
+//! Stop tracking of data, that is being unregistered
+/*! Does nothing if data is not tracked, so it is safe to call it for any
+ * handle.
+ * */
+void untrack(starpu_data_handle_t handle);
+
+//! Move tracked data into another category
+void set_category(starpu_data_handle_t handle, int category);
+
+//! Set category of data, tracked from now on
+void set_default_category(int category);
+
+//! Get category of data, tracked from now on
+int get_default_category();
+
+//! Get live and peak bytes
+Stats get_stats();
+
+//! Set peaks to current live bytes, e.g. at the start of a training step
+void reset_peak();
+
+//! Start recording live bytes at every change
+void timeline_enable();
+
+//! Stop recording live bytes, recorded samples are kept
+void timeline_disable();
+
+//! Get recorded samples and drop them
+std::vector<Sample> timeline_get();
+
+} // namespace nntile::starpu::memory
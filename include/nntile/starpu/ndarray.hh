@@ -0,0 +1,195 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/ndarray.hh
+ * StarPU data interface for multidimensional arrays
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <vector>
+
+namespace nntile::starpu
+{
+
+//! Maximal number of dimensions of an array
+constexpr Index NDARRAY_MAX_NDIM = 8;
+
+//! Interface of a multidimensional array in a Fortran order
+/*! The interface extends the variable interface by a shape and strides of
+ * the array, so the first fields are the same and all the codelets, that
+ * treat buffers as VariableInterface, accept contiguous arrays as is. The
+ * elemsize field of the base interface is a size of all the elements of the
+ * array in bytes. Arrays, registered with leading dimensions, and blocks of
+ * partitioned arrays may be non-contiguous. Such arrays are accepted only by
+ * codelets, that follow strides (see ndarray_for_each_block). Copies of an
+ * array on other memory nodes are always contiguous.
+ * */
+class NDArrayInterface: public starpu_variable_interface
+{
+public:
+    //! Size of a single element in bytes
+    Index typesize;
+    //! Number of dimensions
+    Index ndim;
+    //! Shape of the array
+    Index shape[NDARRAY_MAX_NDIM];
+    //! Strides of the array in elements
+    Index stride[NDARRAY_MAX_NDIM];
+    //! No constructor
+    NDArrayInterface() = delete;
+    //! No destructor
+    ~NDArrayInterface() = delete;
+    //! Get pointer of a proper type
+    template<typename T>
+    T *get_ptr() const
+    {
+        return reinterpret_cast<T *>(ptr);
+    }
+    //! Check if elements are stored without gaps
+    bool is_contiguous() const
+    {
+        Index nelems = 1;
+        for(Index i = 0; i < ndim; ++i)
+        {
+            if(stride[i] != nelems and shape[i] != 1)
+            {
+                return false;
+            }
+            nelems *= shape[i];
+        }
+        return true;
+    }
+};
+
+// Operations of the interface
+extern starpu_data_interface_ops ndarray_ops;
+
+//! Check if a buffer of a codelet is a multidimensional array
+inline bool is_ndarray(const void *interface)
+{
+    return reinterpret_cast<const starpu_variable_interface *>(interface)->id
+        == ndarray_ops.interfaceid;
+}
+
+//! Call func(offset_a, offset_b, nelems) for all contiguous blocks
+/*! Two arrays of the same shape, but with different strides, are traversed
+ * in a Fortran order. Leading dimensions, that are contiguous in both
+ * arrays, are merged into a single block. Offsets are in elements.
+ * */
+template<typename F>
+void ndarray_for_each_block(Index ndim, const Index *shape,
+        const Index *stride_a, const Index *stride_b, F &&func)
+{
+    Index nelems = 1, start = 0;
+    while(start < ndim and (shape[start] == 1 or (stride_a[start] == nelems
+                    and stride_b[start] == nelems)))
+    {
+        nelems *= shape[start];
+        ++start;
+    }
+    Index index[NDARRAY_MAX_NDIM] = {0};
+    Index offset_a = 0, offset_b = 0;
+    while(true)
+    {
+        func(offset_a, offset_b, nelems);
+        // Go to the next block
+        Index i = start;
+        for(; i < ndim; ++i)
+        {
+            ++index[i];
+            offset_a += stride_a[i];
+            offset_b += stride_b[i];
+            if(index[i] < shape[i])
+            {
+                break;
+            }
+            offset_a -= shape[i] * stride_a[i];
+            offset_b -= shape[i] * stride_b[i];
+            index[i] = 0;
+        }
+        if(i == ndim)
+        {
+            break;
+        }
+    }
+}
+
+//! Strides of a contiguous array of a given shape
+void ndarray_contiguous_stride(Index ndim, const Index *shape,
+        Index *stride);
+
+// Register array with the interface
+void ndarray_data_register(starpu_data_handle_t *handle, int home_node,
+        uintptr_t ptr, const std::vector<Index> &shape, Index typesize,
+        const std::vector<Index> &stride={});
+
+//! Filter, that splits an array into blocks along a single axis
+/*! The axis is provided by filter_arg field and the number of blocks by
+ * nchildren field of the filter. Blocks of all axes but the last one are
+ * non-contiguous.
+ * */
+void ndarray_filter_block(void *father_interface, void *child_interface,
+        starpu_data_filter *f, unsigned id, unsigned nparts);
+
+//! Plan partitioning of an array into blocks along an axis
+/*! Blocks are registered handles, that are used after
+ * starpu_data_partition_submit() and until
+ * starpu_data_unpartition_submit(). Only blocks are transferred between
+ * memory nodes while the array is partitioned. The plan is removed by
+ * starpu_data_partition_clean().
+ * */
+std::vector<starpu_data_handle_t> ndarray_partition_plan(
+        starpu_data_handle_t handle, Index axis, Index nparts);
+
+//! Convenient registration and deregistration of arrays
+class NDArrayHandle: public VariableHandle
+{
+    //! Register array for StarPU-owned memory
+    static starpu_data_handle_t _reg_data(const std::vector<Index> &shape,
+            Index typesize)
+    {
+        starpu_data_handle_t tmp;
+        ndarray_data_register(&tmp, -1, 0, shape, typesize);
+        return tmp;
+    }
+    //! Register array
+    static starpu_data_handle_t _reg_data(void *ptr,
+            const std::vector<Index> &shape, Index typesize,
+            const std::vector<Index> &stride)
+    {
+        starpu_data_handle_t tmp;
+        ndarray_data_register(&tmp, STARPU_MAIN_RAM,
+                reinterpret_cast<uintptr_t>(ptr), shape, typesize, stride);
+        return tmp;
+    }
+public:
+    //! Constructor for array that is (de)allocated by StarPU
+    explicit NDArrayHandle(const std::vector<Index> &shape, Index typesize,
+            starpu_data_access_mode mode):
+        VariableHandle(_reg_data(shape, typesize), mode)
+    {
+    }
+    //! Constructor for array that is (de)allocated by user
+    /*! Empty stride means a contiguous array. Otherwise, stride[i] is a
+     * distance in elements between neighbours along i-th axis, e.g.,
+     * {1, ld} for a matrix with a leading dimension ld.
+     * */
+    explicit NDArrayHandle(void *ptr, const std::vector<Index> &shape,
+            Index typesize, starpu_data_access_mode mode,
+            const std::vector<Index> &stride={}):
+        VariableHandle(_reg_data(ptr, shape, typesize, stride), mode)
+    {
+    }
+};
+
+} // namespace nntile::starpu
@@ -0,0 +1,65 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/perfmodel.hh
+ * Access to history-based performance models of codelets
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <starpu.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nntile::starpu::perfmodel
+{
+
+//! Footprint of tasks of a codelet, i.e., a hash of shapes of its buffers
+struct Entry
+{
+    //! Symbol of the performance model, that is the name of the codelet
+    std::string symbol;
+    //! Footprint of a task
+    std::uint32_t footprint;
+};
+
+//! Get symbols of performance models of all initialized codelets
+std::vector<std::string> get_symbols();
+
+//! Get path to the file of a performance model on this host
+/*! StarPU reads and writes a history-based performance model in a file,
+ * that is named after the symbol of the model and the host name.
+ * */
+std::string get_path(const std::string &symbol);
+
+//! Start recording of footprints of executed tasks
+void record_enable();
+
+//! Stop recording of footprints
+void record_disable();
+
+//! Check if footprints of executed tasks are recorded
+bool record_is_enabled();
+
+//! Add a footprint of a task, called by workers
+void record(starpu_task *task);
+
+//! Get unique recorded footprints and clear them
+std::vector<Entry> record_get();
+
+//! Find footprints, that are not calibrated
+/*! Performance models are read from files on this host. A footprint is
+ * calibrated if the history of its model has enough samples for every
+ * architecture of workers of StarPU.
+ * */
+std::vector<Entry> find_missing(const std::vector<Entry> &entries);
+
+} // namespace nntile::starpu::perfmodel
@@ -0,0 +1,80 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/retile.hh
+ * Gathering of a tile from parts of other tiles with StarPU buffers
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <vector>
+
+namespace nntile::starpu::retile
+{
+
+// Gather destination tile from parts of source tiles on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+extern Codelet codelet_fp32, codelet_fp64, codelet_int64, codelet_bool,
+       codelet_fp32_fast_tf32;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_fast_tf32_t>()
+{
+    return &codelet_fp32_fast_tf32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+template<>
+constexpr Codelet *codelet<Index>()
+{
+    return &codelet_int64;
+}
+
+template<>
+constexpr Codelet *codelet<bool_t>()
+{
+    return &codelet_bool;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index ndim, const std::vector<Index> &dst_stride,
+        const std::vector<Index> &info, const std::vector<Handle> &src,
+        Handle dst);
+
+} // namespace nntile::starpu::retile
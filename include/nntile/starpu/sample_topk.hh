@@ -0,0 +1,77 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/sample_topk.hh
+ * StarPU wrappers for sampling from top-k candidates
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+
+namespace nntile::starpu::sample_topk
+{
+
+//! Structure for arguments
+struct args_t
+{
+    Index n;
+    Index k;
+    Index top_k;
+    scal_t top_p;
+    unsigned long long seed;
+    Index offset;
+};
+
+// Sample a token of each column from top-k candidates on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+extern Codelet codelet_fp32, codelet_fp64, codelet_fp32_fast_tf32;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_fast_tf32_t>()
+{
+    return &codelet_fp32_fast_tf32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, Handle topk_val,
+        Handle topk_idx, Handle maxsumexp, Handle token);
+
+} // namespace nntile::starpu::sample_topk
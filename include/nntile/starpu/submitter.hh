@@ -0,0 +1,68 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/submitter.hh
+ * Pool of threads to submit tasks of a single tensor operation in parallel
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <functional>
+
+namespace nntile::starpu::submitter
+{
+
+//! Start a pool of submitter threads
+/*! Tasks of a tensor operation are submitted by the calling thread together
+ * with nthreads threads of the pool. Zero nthreads stops the pool, so that
+ * all tasks are submitted serially by the calling thread.
+ *
+ * @param[in] nthreads: Number of additional submitter threads
+ * */
+void init(int nthreads);
+
+//! Stop all threads of the pool
+void shutdown();
+
+//! Get number of additional submitter threads
+int get_nthreads();
+
+//! Set minimal number of tasks of an operation to submit it in parallel
+void set_min_tasks(Index min_tasks);
+
+//! Get minimal number of tasks of an operation to submit it in parallel
+Index get_min_tasks();
+
+//! Submit tasks of iterations of a loop in parallel
+/*! Iterations [0,n) are split into contiguous chunks and func(begin, end)
+ * is called for every chunk by the calling thread or by a thread of the
+ * pool. StarPU infers dependencies from the order of submission, so
+ * iterations must submit tasks that write into different data, e.g. into
+ * different tiles of an output tensor. All the tasks of a single output tile
+ * are submitted by a single thread in the order of the loop. The function
+ * returns only when all chunks are submitted, so tasks of the next
+ * operation depend on the tasks of this one as in the serial case.
+ *
+ * The loop is executed serially by the calling thread, if the pool is
+ * stopped, if the estimated number of tasks n*ntasks_per_iter is less than
+ * get_min_tasks(), if there are several MPI processes (to keep the order of
+ * MPI transfers deterministic) or if the call is nested into another
+ * parallel loop. An exception, thrown by func, is rethrown by the calling
+ * thread after all the threads finish the loop.
+ *
+ * @param[in] n: Number of iterations
+ * @param[in] ntasks_per_iter: Estimated number of tasks of an iteration
+ * @param[in] func: Function to submit tasks of iterations [begin,end)
+ * */
+void parallel_for(Index n, Index ntasks_per_iter,
+        const std::function<void(Index, Index)> &func);
+
+} // namespace nntile::starpu::submitter
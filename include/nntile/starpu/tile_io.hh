@@ -0,0 +1,55 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/tile_io.hh
+ * Write StarPU buffers into a file and read them back
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+
+namespace nntile::starpu::tile_io
+{
+
+//! Structure for arguments
+struct args_t
+{
+    int fd;
+    Index offset;
+};
+
+// Write a StarPU buffer into a file on CPU
+void cpu_save(void *buffers[], void *cl_args)
+    noexcept;
+
+// Read a StarPU buffer from a file on CPU
+void cpu_load(void *buffers[], void *cl_args)
+    noexcept;
+
+extern Codelet codelet_save, codelet_load;
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+// Number of failed reads and writes since initialization
+Index get_nerrors();
+
+//! Insert task to write buffer into a file at a given offset
+void submit_save(int fd, Index offset, Handle data);
+
+//! Insert task to read buffer from a file at a given offset
+void submit_load(int fd, Index offset, Handle data);
+
+} // namespace nntile::starpu::tile_io
@@ -0,0 +1,58 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/trace.hh
+ * Lightweight tracer of executed tasks with Chrome trace output
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <chrono>
+#include <string>
+
+namespace nntile::starpu::trace
+{
+
+//! Clock of all trace events
+using clock = std::chrono::steady_clock;
+
+//! Start recording of executed tasks
+/*! Every worker gets its own ring buffer of a given number of events, so
+ * workers record events without locks. If a buffer overflows, the oldest
+ * events of the worker are overwritten. Previously recorded events are
+ * dropped. If tracing was enabled before, all submitted tasks are waited
+ * for, as running tasks may still record events, so workers shall not be
+ * paused.
+ *
+ * @param[in] capacity: Number of events per worker
+ * */
+void enable(Index capacity);
+
+//! Stop recording of executed tasks, recorded events are kept
+void disable();
+
+//! Check if tasks are recorded
+bool is_enabled();
+
+//! Record execution of the current task by the current worker
+void record(starpu_task *task, clock::time_point start,
+        clock::time_point end);
+
+//! Write recorded events in the Chrome trace event format
+/*! Output can be opened by chrome://tracing or https://ui.perfetto.dev.
+ * Shall be called when no tasks are executed, e.g., after wait_for_all.
+ *
+ * @param[in] filename: Name of the output JSON file
+ * */
+void dump(const std::string &filename);
+
+} // namespace nntile::starpu::trace
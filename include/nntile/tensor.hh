@@ -83,6 +83,11 @@
 #include <nntile/tensor/adam_step.hh>
 #include <nntile/tensor/adamw_step.hh>
 #include <nntile/tensor/transpose.hh>
+#include <nntile/tensor/paged_attention.hh>
+#include <nntile/tensor/topk_sample.hh>
+#include <nntile/tensor/tile_io.hh>
+#include <nntile/tensor/retile.hh>
+#include <nntile/tensor/view.hh>
 
 //! @namespace nntile::tensor
 /*! This namespace holds high-level routines for Tensor<T>
@@ -29,4 +29,19 @@ void adamw_step(Index num_iter, scal_t beta_1, scal_t beta_2, scal_t eps, scal_t
     const Tensor<T> &grad, const Tensor<T> &first_moment, const Tensor<T> &second_moment,
                    const Tensor<T> &p);
 
+//! Asynchronous tensor-wise AdamW step with sharded optimizer state
+/*! Tiles of moments may be stored on other ranks, than tiles of parameters.
+ * A tile, whose moments are stored together with the parameter tile, is
+ * updated in place. Otherwise, the gradient tile is sent to the owner of
+ * moments, that updates its master copy of the parameter tile in p_shard and
+ * sends the result back to the owner of the parameter tile. Tiles of p_shard
+ * are used only for such tiles and the master copy is taken from p if
+ * sync_shard is true.
+ * */
+template<typename T>
+void adamw_step_sharded_async(Index num_iter, scal_t beta_1, scal_t beta_2,
+        scal_t eps, scal_t lr, scal_t weight_decay, const Tensor<T> &grad,
+        const Tensor<T> &first_moment, const Tensor<T> &second_moment,
+        const Tensor<T> &p, const Tensor<T> &p_shard, bool sync_shard);
+
 } // namespace nntile::tensor
@@ -15,7 +15,10 @@
 #pragma once
 
 #include <nntile/base_types.hh>
+#include <nntile/constants.hh>
+#include <nntile/tensor/traits.hh>
 #include <vector>
+#include <utility>
 
 namespace nntile::tensor::distributions
 {
@@ -23,4 +26,64 @@ namespace nntile::tensor::distributions
 std::vector<int> block_cyclic(const std::vector<Index> &tensor_grid,
         const std::vector<int> &mpi_grid, int start_rank, int max_rank);
 
+//! Block-cyclic distribution along selected axes of a grid of tiles
+/*! All tiles, that differ only in indices along non-selected axes, belong to
+ * the same rank. This way, a tensor is distributed by rows or by columns,
+ * while the remaining axes are kept on the same node.
+ * */
+std::vector<int> block_cyclic_axes(const std::vector<Index> &tensor_grid,
+        const std::vector<Index> &axes, const std::vector<int> &mpi_grid,
+        int start_rank, int max_rank);
+
+//! 2D block-cyclic distribution of a tensor, viewed as a matrix of tiles
+/*! The first ndim_rows dimensions of the grid of tiles are rows of the
+ * matrix, while the remaining dimensions are columns of the matrix.
+ * */
+std::vector<int> matrix_block_cyclic(const std::vector<Index> &tensor_grid,
+        Index ndim_rows, int p, int q, int start_rank, int max_rank);
+
+//! 2.5D block-cyclic distribution of a tensor, viewed as a matrix of tiles
+/*! Ranks form a p-by-q-by-c grid. Index of a tile along a contraction
+ * dimension (rows if layer_dim is 0, columns if layer_dim is 1) defines a
+ * layer of the grid, while the rest of the index is distributed in a 2D
+ * block-cyclic manner within that layer.
+ * */
+std::vector<int> matrix_block_cyclic_2_5d(
+        const std::vector<Index> &tensor_grid, Index ndim_rows, int p, int q,
+        int c, Index layer_dim, int start_rank, int max_rank);
+
+//! Distributions of gemm operands A and B, aligned with distribution of C
+/*! Tile A(i,l,b) is placed on the owner of C(i,l%n,b) and tile B(l,j,b) is
+ * placed on the owner of C(l%m,j,b), where m, n and k define grid of tiles
+ * of the gemm_async loop. Every tile of A and B is therefore already present
+ * on at least one of the nodes, that update C with it.
+ * */
+std::pair<std::vector<int>, std::vector<int>> gemm_owner_compute(
+        const TransOp &transA, const TensorTraits &A, const TransOp &transB,
+        const TensorTraits &B, const TensorTraits &C,
+        const std::vector<int> &C_distr, Index ndim, Index batch_ndim);
+
+//! Number of bytes, received by each rank within gemm_async
+/*! Every tile of A or B is received by a node, that owns a tile of C, at most
+ * once, as StarPU-MPI caches received data.
+ * */
+std::vector<Index> gemm_transfer_bytes(const TransOp &transA,
+        const TensorTraits &A, const std::vector<int> &A_distr,
+        const TransOp &transB, const TensorTraits &B,
+        const std::vector<int> &B_distr, const TensorTraits &C,
+        const std::vector<int> &C_distr, Index ndim, Index batch_ndim,
+        Index elem_size, int max_rank);
+
+//! Number of bytes, received by each rank for a tile-wise operation
+/*! Tile-wise operations (like add_async or copy_async) execute on the owner
+ * of destination tile and require the corresponding source tile.
+ * */
+std::vector<Index> tilewise_transfer_bytes(const TensorTraits &traits,
+        const std::vector<int> &src_distr, const std::vector<int> &dst_distr,
+        Index elem_size, int max_rank);
+
+//! Number of bytes, stored by each rank
+std::vector<Index> memory_bytes(const TensorTraits &traits,
+        const std::vector<int> &distr, Index elem_size, int max_rank);
+
 } // namespace nntile::tensor::distributions
@@ -0,0 +1,49 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/paged_attention.hh
+ * Attention of new positions to keys and values, stored in paged caches
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <vector>
+
+namespace nntile::tensor
+{
+
+// Asynchronous store of new keys or values into blocks of a paged cache
+template<typename T>
+void paged_kv_store_async(const Tensor<T> &src, const Tensor<T> &pool,
+        const std::vector<Index> &block, const std::vector<Index> &offset);
+
+// Blocking version of store into blocks of a paged cache
+template<typename T>
+void paged_kv_store(const Tensor<T> &src, const Tensor<T> &pool,
+        const std::vector<Index> &block, const std::vector<Index> &offset);
+
+// Asynchronous attention to keys and values, stored in paged caches
+template<typename T>
+void paged_attention_async(scal_t alpha, const Tensor<T> &Q,
+        const Tensor<T> &K_pool, const Tensor<T> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<T> &A, const Tensor<T> &maxsumexp, const Tensor<T> &B);
+
+// Blocking version of attention to keys and values in paged caches
+template<typename T>
+void paged_attention(scal_t alpha, const Tensor<T> &Q,
+        const Tensor<T> &K_pool, const Tensor<T> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<T> &A, const Tensor<T> &maxsumexp, const Tensor<T> &B);
+
+} // namespace nntile::tensor
@@ -0,0 +1,30 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/retile.hh
+ * Conversion of a tensor into another tiling
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile::tensor
+{
+
+// Asynchronous conversion of a tensor into another tiling
+template<typename T>
+void retile_async(const Tensor<T> &src, const Tensor<T> &dst);
+
+// Blocking version of conversion of a tensor into another tiling
+template<typename T>
+void retile(const Tensor<T> &src, const Tensor<T> &dst);
+
+} // namespace nntile::tensor
@@ -84,8 +84,12 @@ public:
             // Generate traits for the tile
             tile_traits.emplace_back(tile_shape);
             // Set StarPU-managed handle
-            tile_handles.emplace_back(sizeof(T)*tile_traits[i].nelems,
-                    STARPU_R);
+            tile_handles.push_back(tile::Tile<T>::register_handle(
+                        tile_traits[i]));
+            // Account memory of the tile
+            starpu::memory::track(
+                    static_cast<starpu_data_handle_t>(tile_handles[i]),
+                    tile_traits[i].nelems*sizeof(T));
             // Register tile with MPI
             //starpu_mpi_data_register(
             //        static_cast<starpu_data_handle_t>(tile_handles[i]),
@@ -94,6 +98,38 @@ public:
         }
         next_tag = last_tag;
     }
+    //! Constructor of a view, that shares given tiles of another tensor
+    /*! Handles are not registered again, so no data is copied and the view
+     * shall be used only while tiles of the other tensor are registered. The
+     * i-th handle is interpreted as the i-th tile of the view, so it shall
+     * contain the same number of elements.
+     * */
+    explicit Tensor(const TensorTraits &traits,
+            const std::vector<starpu::VariableHandle> &handles,
+            const std::vector<int> &distribution,
+            starpu_mpi_tag_t next_tag_):
+        TensorTraits(traits),
+        tile_handles(handles),
+        tile_distr(distribution),
+        next_tag(next_tag_)
+    {
+        // Check handles and distribution
+        if(handles.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong number of handles");
+        }
+        if(distribution.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong distribution");
+        }
+        tile_traits.reserve(grid.nelems);
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            const auto tile_index = grid.linear_to_index(i);
+            tile_traits.emplace_back(TensorTraits::get_tile_shape(
+                        tile_index));
+        }
+    }
     tile::Tile<T> get_tile(Index linear_offset) const
     {
         if(linear_offset < 0 or linear_offset >= grid.nelems)
@@ -137,6 +173,16 @@ public:
             tile_handles[i].unregister();
         }
     }
+    //! Account memory of all tiles in a given category
+    void set_memory_category(int category) const
+    {
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            starpu::memory::set_category(
+                    static_cast<starpu_data_handle_t>(tile_handles[i]),
+                    category);
+        }
+    }
     //! Invalidate tensor values
     void invalidate_submit() const
     {
@@ -158,6 +204,31 @@ public:
             starpu_data_wont_use(tmp);
         }
     }
+    //! Wait for all submitted tasks, that access local tiles of the tensor
+    /*! Tiles are not transferred anywhere, so it is a cheap way to wait for
+     * a single tensor instead of all tasks. It shall not be called from
+     * tasks or callbacks.
+     * */
+    void wait() const
+    {
+        int mpi_rank = starpu_mpi_world_rank();
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            auto handle = get_tile_handle(i);
+            if(handle.mpi_get_rank() != mpi_rank)
+            {
+                continue;
+            }
+            auto tmp = static_cast<starpu_data_handle_t>(handle);
+            int ret = starpu_data_acquire_on_node(tmp,
+                    STARPU_ACQUIRE_NO_NODE, STARPU_RW);
+            if(ret != 0)
+            {
+                throw std::runtime_error("Error in starpu_data_acquire");
+            }
+            starpu_data_release_on_node(tmp, STARPU_ACQUIRE_NO_NODE);
+        }
+    }
     //! Flush tensor from MPI caches
     void mpi_flush() const
     {
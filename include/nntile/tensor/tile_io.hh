@@ -0,0 +1,47 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/tile_io.hh
+ * Write tiles of a tensor into a file and read them back
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <vector>
+
+namespace nntile::tensor
+{
+
+// Offsets of tiles of a tensor, stored in a file one after another
+std::vector<Index> tile_offsets(const TensorTraits &traits,
+        Index elemsize, Index offset, Index alignment);
+
+// Asynchronous write of tiles into a file
+template<typename T>
+void save_tiles_async(const Tensor<T> &src, int fd,
+        const std::vector<Index> &offsets);
+
+// Blocking version of write of tiles into a file
+template<typename T>
+void save_tiles(const Tensor<T> &src, int fd,
+        const std::vector<Index> &offsets);
+
+// Asynchronous read of tiles from a file
+template<typename T>
+void load_tiles_async(const Tensor<T> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+// Blocking version of read of tiles from a file
+template<typename T>
+void load_tiles(const Tensor<T> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+} // namespace nntile::tensor
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/topk_sample.hh
+ * Sample tokens from logits through running top-k candidates
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile::tensor
+{
+
+// Asynchronous sampling of tokens from top-k candidates of logits
+template<typename T>
+void topk_sample_async(scal_t alpha, const Tensor<T> &logits,
+        const Tensor<T> &topk_val, const Tensor<Index> &topk_idx,
+        const Tensor<T> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens);
+
+// Blocking version of sampling of tokens from top-k candidates of logits
+template<typename T>
+void topk_sample(scal_t alpha, const Tensor<T> &logits,
+        const Tensor<T> &topk_val, const Tensor<Index> &topk_idx,
+        const Tensor<T> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens);
+
+} // namespace nntile::tensor
@@ -0,0 +1,32 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/view.hh
+ * Views of tensors, that share tiles without copying data
+ *
+ * @version 1.0.0
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile::tensor
+{
+
+// View of a slice of a tensor, aligned to borders of tiles
+template<typename T>
+Tensor<T> slice_view(const Tensor<T> &src, const std::vector<Index> &begin,
+        const std::vector<Index> &end);
+
+// View of a tensor with split or merged dimensions
+template<typename T>
+Tensor<T> reshape_view(const Tensor<T> &src, const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape);
+
+} // namespace nntile::tensor
@@ -16,6 +16,7 @@
 
 #include <nntile/tile/traits.hh>
 #include <nntile/starpu/config.hh>
+#include <nntile/starpu/ndarray.hh>
 
 namespace nntile::tile
 {
@@ -26,7 +27,8 @@ class TileLocalData;
 
 //! Many-dimensional tensor, stored contiguously in a Fortran order
 /*! Underlying StarPU data is variable, as we need only address and size of a
- * contiguous memory.
+ * contiguous memory. Alternatively, it is a multidimensional array, that is
+ * compatible with variable and also describes shape of the tile.
  * */
 template<typename T>
 class Tile: public TileTraits, public starpu::VariableHandle
@@ -49,7 +51,29 @@ class Tile: public TileTraits, public starpu::VariableHandle
         }
         return size;
     }
+    // Register provided memory buffer with a configured StarPU interface
+    starpu::VariableHandle _register(T *ptr, Index ptr_nelems)
+    {
+#ifdef NNTILE_USE_NDARRAY
+        _get_size(ptr_nelems);
+        return starpu::NDArrayHandle(ptr, shape, sizeof(T), STARPU_RW);
+#else // NNTILE_USE_NDARRAY
+        return starpu::VariableHandle(ptr, _get_size(ptr_nelems), STARPU_RW);
+#endif // NNTILE_USE_NDARRAY
+    }
 public:
+    //! Register a tile, allocated by StarPU, with a configured interface
+    /*! Tiles are flat variables by default. Multidimensional arrays carry
+     * shape and strides of tiles and are enabled by USE_NDARRAY option.
+     * */
+    static starpu::VariableHandle register_handle(const TileTraits &traits)
+    {
+#ifdef NNTILE_USE_NDARRAY
+        return starpu::NDArrayHandle(traits.shape, sizeof(T), STARPU_R);
+#else // NNTILE_USE_NDARRAY
+        return starpu::VariableHandle(traits.nelems*sizeof(T), STARPU_R);
+#endif // NNTILE_USE_NDARRAY
+    }
     //! Construct a tile from traits and StarPU handle
     Tile(const TileTraits &traits_, const starpu::VariableHandle &handle_):
         TileTraits(traits_),
@@ -59,25 +83,25 @@ public:
     //! Construct a tile, allocated/deallocated by StarPU
     explicit Tile(const std::vector<Index> &shape_):
         TileTraits(shape_),
-        starpu::VariableHandle(nelems*sizeof(T), STARPU_R)
+        starpu::VariableHandle(register_handle(*this))
     {
     }
     //! Construct a tile, allocated/deallocated by StarPU
     explicit Tile(const TileTraits &traits):
         TileTraits(traits),
-        starpu::VariableHandle(nelems*sizeof(T), STARPU_R)
+        starpu::VariableHandle(register_handle(traits))
     {
     }
     //! Construct a tile out of provided contiguous memory buffer
     Tile(const std::vector<Index> &shape_, T *ptr, Index ptr_nelems):
         TileTraits(shape_),
-        starpu::VariableHandle(ptr, _get_size(ptr_nelems), STARPU_RW)
+        starpu::VariableHandle(_register(ptr, ptr_nelems))
     {
     }
     //! Construct a tile out of provided contiguous memory buffer
     Tile(const TileTraits &traits, T *ptr, Index ptr_nelems):
         TileTraits(traits),
-        starpu::VariableHandle(ptr, _get_size(ptr_nelems), STARPU_RW)
+        starpu::VariableHandle(_register(ptr, ptr_nelems))
     {
     }
     TileLocalData<T> acquire(starpu_data_access_mode mode)
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/add_fiber/cpu.hh"
+#include "nntile/kernel/broadcast.hh"
 
 namespace nntile::kernel::add_fiber
 {
@@ -36,43 +37,20 @@ void cpu(Index m, Index n, Index k, Index batch, T alpha, const T *src, T beta,
  * @param[inout] dst: Input and output contiguous m-by-k-by-n array
  * */
 {
+    using namespace broadcast;
+    const Index shape[4] = {m, k, n, batch};
     constexpr T zero = 0.0;
-    // Cycle over batch
-    for(Index b = 0; b < batch; ++b)
+    auto src_ = operand<K|B>(shape, src);
+    auto dst_ = operand<FULL>(shape, dst);
+    // Overwrite or update output depending on beta
+    if(beta == zero)
     {
-        // Cycle over input fiber src
-        for(Index i2 = 0; i2 < k; ++i2)
-        {
-            // Value to add to the output slice
-            const T src_val = alpha * src[i2+b*k];
-            // Cycle over the third axis of output buffer dst
-            for(Index i1 = 0; i1 < n; ++i1)
-            {
-                // Output fiber to be updated
-                T *dst_fiber = dst + ((i1+b*n)*k+i2)*m;
-                // Overwrite or update output depending on beta
-                if(beta == zero)
-                {
-                    // Cycle over output fiber elements
-                    for(Index i0 = 0; i0 < m; ++i0)
-                    {
-                        // Set output value
-                        dst_fiber[i0] = src_val;
-                    }
-                }
-                else
-                {
-                    // Cycle over output fiber elements
-                    for(Index i0 = 0; i0 < m; ++i0)
-                    {
-                        // Read value from the output
-                        T &dst_val = dst_fiber[i0];
-                        // And update it
-                        dst_val = beta*dst_val + src_val;
-                    }
-                }
-            }
-        }
+        apply(shape, [alpha](T &y, T x){ y = alpha * x; }, dst_, src_);
+    }
+    else
+    {
+        apply(shape, [alpha, beta](T &y, T x){ y = beta*y + alpha*x; },
+                dst_, src_);
     }
 }
 
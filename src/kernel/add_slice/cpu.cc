@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/add_slice/cpu.hh"
+#include "nntile/kernel/broadcast.hh"
 
 namespace nntile::kernel::add_slice
 {
@@ -33,40 +34,20 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src, T beta, T *dst)
  * @param[inout] dst: Input and output contiguous m-by-k-by-n array
  * */
 {
-    const Index mk = m * k;
+    using namespace broadcast;
+    const Index shape[4] = {m, k, n, 1};
     constexpr T zero = 0.0;
-    // Cycle over column of the output buffer dst
-    for(Index i2 = 0; i2 < n; ++i2)
+    auto src_ = operand<M|N>(shape, src);
+    auto dst_ = operand<FULL>(shape, dst);
+    // Overwrite or update output depending on beta
+    if(beta == zero)
     {
-        // Cycle over row of the output buffer dst
-        for(Index i1 = 0; i1 < m; ++i1)
-        {
-            // Pointer to a corresponding fiber of the output array dst
-            T *dst_fiber = dst + i2*mk + i1;
-            // Value to add to the output fiber
-            const T src_val = alpha * src[i2*m+i1];
-            // Overwrite or update output depending on beta
-            if(beta == zero)
-            {
-                // Cycle over output fiber elements
-                for(Index i0 = 0; i0 < k; ++i0)
-                {
-                    // Set output value
-                    dst_fiber[i0*m] = src_val;
-                }
-            }
-            else
-            {
-                // Cycle over output fiber elements
-                for(Index i0 = 0; i0 < k; ++i0)
-                {
-                    // Read value from the output
-                    T &dst_val = dst_fiber[i0*m];
-                    // And update it
-                    dst_val = beta*dst_val + src_val;
-                }
-            }
-        }
+        apply(shape, [alpha](T &y, T x){ y = alpha * x; }, dst_, src_);
+    }
+    else
+    {
+        apply(shape, [alpha, beta](T &y, T x){ y = beta*y + alpha*x; },
+                dst_, src_);
     }
 }
 
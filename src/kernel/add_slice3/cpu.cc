@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/add_slice3/cpu.hh"
+#include "nntile/kernel/broadcast.hh"
 
 namespace nntile::kernel::add_slice3
 {
@@ -35,40 +36,21 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src1, T beta,
  * @param[out] dst: Output contiguous m-by-k-by-n array
  * */
 {
-    const Index mk = m * k;
+    using namespace broadcast;
+    const Index shape[4] = {m, k, n, 1};
     constexpr T zero = 0.0;
-    // Cycle over column of the output buffer dst
-    for(Index i2 = 0; i2 < n; ++i2)
+    auto src1_ = operand<M|N>(shape, src1);
+    auto src2_ = operand<FULL>(shape, src2);
+    auto dst_ = operand<FULL>(shape, dst);
+    // Overwrite or update output depending on beta
+    if(beta == zero)
     {
-        // Cycle over row of the output buffer dst
-        for(Index i1 = 0; i1 < m; ++i1)
-        {
-            // Pointer to a corresponding fiber of the input array src2
-            const T *src2_fiber = src2 + i2*mk + i1;
-            // Pointer to a corresponding fiber of the output array dst
-            T *dst_fiber = dst + i2*mk + i1;
-            // Value to add to the output fiber
-            const T src1_val = alpha * src1[i2*m+i1];
-            // Overwrite or update output depending on beta
-            if(beta == zero)
-            {
-                // Cycle over output fiber elements
-                for(Index i0 = 0; i0 < k; ++i0)
-                {
-                    // Set output value
-                    dst_fiber[i0*m] = src1_val;
-                }
-            }
-            else
-            {
-                // Cycle over output fiber elements
-                for(Index i0 = 0; i0 < k; ++i0)
-                {
-                    // And update it
-                    dst_fiber[i0*m] = beta*src2_fiber[i0*m] + src1_val;
-                }
-            }
-        }
+        apply(shape, [alpha](T &y, T x1){ y = alpha * x1; }, dst_, src1_);
+    }
+    else
+    {
+        apply(shape, [alpha, beta](T &y, T x1, T x2)
+                { y = beta*x2 + alpha*x1; }, dst_, src1_, src2_);
     }
 }
 
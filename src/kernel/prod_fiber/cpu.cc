@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/prod_fiber/cpu.hh"
+#include "nntile/kernel/broadcast.hh"
 
 namespace nntile::kernel::prod_fiber
 {
@@ -33,23 +34,10 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src, T *dst)
  * @param[inout] dst: Input and output contiguous m-by-k-by-n array
  * */
 {
-    // Cycle over input src vector
-    for(Index i2 = 0; i2 < k; ++i2)
-    {
-        const T src_val = alpha * src[i2];
-        // Cycle over the third axis of output buffer
-        for(Index i1 = 0; i1 < n; ++i1)
-        {
-            // Output fiber to be updated
-            T *dst_fiber = dst + (i1*k+i2)*m;
-            // Cycle over the output fiber
-            for(Index i0 = 0; i0 < m; ++i0)
-            {
-                // Update output value
-                dst_fiber[i0] *= src_val;
-            }
-        }
-    }
+    using namespace broadcast;
+    const Index shape[4] = {m, k, n, 1};
+    apply(shape, [alpha](T &y, T x){ y *= alpha * x; },
+            operand<FULL>(shape, dst), operand<K>(shape, src));
 }
 
 // Explicit instantiation
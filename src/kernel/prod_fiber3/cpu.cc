@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/prod_fiber3/cpu.hh"
+#include "nntile/kernel/broadcast.hh"
 
 namespace nntile::kernel::prod_fiber3
 {
@@ -35,25 +36,11 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src1, const T *src2,
  * @param[out] dst: Output contiguous m-by-k-by-n array
  * */
 {
-    // Cycle over input src vector
-    for(Index i2 = 0; i2 < k; ++i2)
-    {
-        const T src1_val = alpha * src1[i2];
-        // Cycle over the third axis of output buffer
-        for(Index i1 = 0; i1 < n; ++i1)
-        {
-            // Input fiber to be used
-            const T *src2_fiber = src2 + (i1*k+i2)*m;
-            // Output fiber to be updated
-            T *dst_fiber = dst + (i1*k+i2)*m;
-            // Cycle over the output fiber
-            for(Index i0 = 0; i0 < m; ++i0)
-            {
-                // Update output value
-                dst_fiber[i0] = src1_val * src2_fiber[i0];
-            }
-        }
-    }
+    using namespace broadcast;
+    const Index shape[4] = {m, k, n, 1};
+    apply(shape, [alpha](T &y, T x1, T x2){ y = alpha * x1 * x2; },
+            operand<FULL>(shape, dst), operand<K>(shape, src1),
+            operand<FULL>(shape, src2));
 }
 
 // Explicit instantiation
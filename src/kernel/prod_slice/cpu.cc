@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/prod_slice/cpu.hh"
+#include "nntile/kernel/broadcast.hh"
 
 namespace nntile::kernel::prod_slice
 {
@@ -32,25 +33,10 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src, T *dst)
  * @param[inout] dst: Input and output contiguous m-by-k-by-n array
  * */
 {
-    const Index mk = m * k;
-    // Cycle over column of the output buffer dst
-    for(Index i2 = 0; i2 < n; ++i2)
-    {
-        // Cycle over row of the output buffer dst
-        for(Index i1 = 0; i1 < m; ++i1)
-        {
-            // Pointer to a corresponding fiber of the output array dst
-            T *dst_fiber = dst + i2*mk + i1;
-            // Value to multiply by the output fiber
-            const T src_val = alpha * src[i2*m+i1];
-            // Cycle over output fiber elements
-            for(Index i0 = 0; i0 < k; ++i0)
-            {
-                // Update output value
-                dst_fiber[i0*m] *= src_val;
-            }
-        }
-    }
+    using namespace broadcast;
+    const Index shape[4] = {m, k, n, 1};
+    apply(shape, [alpha](T &y, T x){ y *= alpha * x; },
+            operand<FULL>(shape, dst), operand<M|N>(shape, src));
 }
 
 // Explicit instantiation
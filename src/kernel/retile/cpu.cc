@@ -0,0 +1,105 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/retile/cpu.cc
+ * Gathering of a tile from parts of other tiles on CPU
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/kernel/retile/cpu.hh"
+#include <algorithm>
+
+namespace nntile::kernel::retile
+{
+
+template<typename T>
+void cpu(Index ndim, Index nsrc, const Index *dst_stride, const Index *info,
+        const T *const *src, T *dst)
+    noexcept
+//! Gather destination tile from parts of several source tiles
+/*! Each source tile provides a box of elements, described by 4*ndim values
+ * of the info array: strides of the source tile, start of the box in the
+ * source tile, start of the box in the destination tile and shape of the
+ * box. Boxes are copied by contiguous runs, where leading dimensions, that
+ * are covered entirely in both tiles, are merged into a single run.
+ *
+ * @param[in] ndim: Dimensionality of tiles
+ * @param[in] nsrc: Number of source tiles
+ * @param[in] dst_stride: Strides of the destination tile
+ * @param[in] info: Strides, starts and shapes of boxes of all source tiles.
+ *      Contains 4*ndim*nsrc values.
+ * @param[in] src: Pointers to source tiles
+ * @param[inout] dst: Pointer to destination tile
+ * */
+{
+    for(Index i = 0; i < nsrc; ++i)
+    {
+        const Index *src_stride = info + 4*ndim*i;
+        const Index *src_start = src_stride + ndim;
+        const Index *dst_start = src_start + ndim;
+        const Index *copy_shape = dst_start + ndim;
+        // Merge leading dimensions into a single contiguous run
+        Index run = 1, first = 0;
+        while(first < ndim and run == src_stride[first]
+                and run == dst_stride[first])
+        {
+            run *= copy_shape[first];
+            ++first;
+        }
+        // Number of runs
+        Index nruns = 1;
+        for(Index j = first; j < ndim; ++j)
+        {
+            nruns *= copy_shape[j];
+        }
+        // Offsets of the first element of the box
+        Index src_offset = 0, dst_offset = 0;
+        for(Index j = 0; j < ndim; ++j)
+        {
+            src_offset += src_start[j] * src_stride[j];
+            dst_offset += dst_start[j] * dst_stride[j];
+        }
+        for(Index r = 0; r < nruns; ++r)
+        {
+            // Get offsets of the current run
+            Index src_run = src_offset, dst_run = dst_offset, rem = r;
+            for(Index j = first; j < ndim; ++j)
+            {
+                Index index = rem % copy_shape[j];
+                rem /= copy_shape[j];
+                src_run += index * src_stride[j];
+                dst_run += index * dst_stride[j];
+            }
+            std::copy_n(src[i]+src_run, run, dst+dst_run);
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index ndim, Index nsrc, const Index *dst_stride,
+        const Index *info, const fp32_t *const *src, fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index ndim, Index nsrc, const Index *dst_stride,
+        const Index *info, const fp64_t *const *src, fp64_t *dst)
+    noexcept;
+
+template
+void cpu<Index>(Index ndim, Index nsrc, const Index *dst_stride,
+        const Index *info, const Index *const *src, Index *dst)
+    noexcept;
+
+template
+void cpu<bool_t>(Index ndim, Index nsrc, const Index *dst_stride,
+        const Index *info, const bool_t *const *src, bool_t *dst)
+    noexcept;
+
+} // namespace nntile::kernel::retile
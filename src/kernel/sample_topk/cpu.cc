@@ -0,0 +1,107 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/sample_topk/cpu.cc
+ * Sampling from top-k candidates on CPU
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/kernel/sample_topk/cpu.hh"
+#include <cmath>
+#include "../external/random.h" // from external
+
+namespace nntile::kernel::sample_topk
+{
+
+template<typename T>
+void cpu(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, const T *topk_val,
+        const Index *topk_idx, const T *maxsumexp, Index *token)
+    noexcept
+//! Sample a token of each column from its top-k candidates on CPU
+/*! Candidates of each column are produced by topk_maxsumexp kernel. Their
+ * probabilities are exp(val-max)/sum, where max and sum are the maximum and
+ * the sum of exponents over the entire column, so they are exact and not
+ * renormalized within candidates. Only the first top_k candidates are
+ * allowed, and among them only the shortest prefix, whose total probability
+ * reaches top_p (nucleus sampling). A token is then drawn from the allowed
+ * candidates with probabilities, proportional to their original ones.
+ * top_k=1 or non-positive top_p mean greedy choice. Column j uses random
+ * number of index offset+j of a sequence, defined by the seed, so results do
+ * not depend on tiling of columns. Column without candidates gets token -1.
+ *
+ * @param[in] n: Number of columns
+ * @param[in] k: Number of candidates of each column
+ * @param[in] top_k: Number of allowed candidates, non-positive or larger
+ *      than k values mean k
+ * @param[in] top_p: Probability of nucleus
+ * @param[in] seed: Random seed
+ * @param[in] offset: Index of the first column in a larger matrix
+ * @param[in] topk_val: Contiguous k-by-n array of values of candidates in
+ *      descending order
+ * @param[in] topk_idx: Contiguous k-by-n array of indices of candidates
+ * @param[in] maxsumexp: Contiguous 2-by-n array of maximums and sums of
+ *      exponents of columns
+ * @param[out] token: Sampled index for each column
+ * */
+{
+    Index nallowed = (top_k > 0 and top_k < k) ? top_k : k;
+    for(Index j = 0; j < n; ++j)
+    {
+        const T *val = topk_val + j*k;
+        const Index *idx = topk_idx + j*k;
+        const T *mse = maxsumexp + 2*j;
+        // Greedy choice
+        if(nallowed == 1 or top_p <= 0 or idx[0] < 0)
+        {
+            token[j] = idx[0];
+            continue;
+        }
+        // Find nucleus among allowed candidates
+        double max = mse[0], sum = mse[1], total = 0;
+        Index ncand = 0;
+        while(ncand < nallowed and idx[ncand] >= 0)
+        {
+            total += std::exp(double(val[ncand])-max) / sum;
+            ++ncand;
+            if(total >= top_p)
+            {
+                break;
+            }
+        }
+        // Draw a candidate. Each column owns a pair of random numbers, and
+        // the first one of the pair is skipped, as it is the state itself
+        unsigned long long state = CORE_rnd64_jump(offset+j, seed);
+        CORE_dlaran(&state);
+        double u = CORE_dlaran(&state) * total;
+        Index l = 0;
+        double cum = std::exp(double(val[0])-max) / sum;
+        while(l+1 < ncand and cum <= u)
+        {
+            ++l;
+            cum += std::exp(double(val[l])-max) / sum;
+        }
+        token[j] = idx[l];
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, const fp32_t *topk_val,
+        const Index *topk_idx, const fp32_t *maxsumexp, Index *token)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, const fp64_t *topk_val,
+        const Index *topk_idx, const fp64_t *maxsumexp, Index *token)
+    noexcept;
+
+} // namespace nntile::kernel::sample_topk
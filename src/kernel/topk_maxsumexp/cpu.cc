@@ -0,0 +1,136 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/topk_maxsumexp/cpu.cc
+ * Top-k and max and sum of exponents of columns on CPU
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/kernel/topk_maxsumexp/cpu.hh"
+#include <cmath>
+#include <limits>
+
+namespace nntile::kernel::topk_maxsumexp
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, Index offset, scal_t alpha, bool init,
+        const T *src, T *topk_val, Index *topk_idx, T *maxsumexp)
+    noexcept
+//! Running top-k and max and sum of exponents of columns on CPU
+/*! For a provided m-by-n input array src, that holds rows [offset,
+ * offset+m) of a larger matrix, update k largest values of alpha*src of each
+ * column together with their row indices in the larger matrix, and the
+ * maximum and the sum of exponents of alpha*src of each column. This way,
+ * the larger matrix is processed tile by tile without being stored at once.
+ *
+ * Top-k values of each column are kept in descending order. If two values
+ * are equal, the one with smaller row index goes first. Missing candidates
+ * have index -1 and value -inf. Values -inf of src are ignored, as they come
+ * from a mask.
+ *
+ * @param[in] m: Number of rows of src
+ * @param[in] n: Number of columns of src
+ * @param[in] k: Number of candidates to keep for each column
+ * @param[in] offset: Index of the first row of src in the larger matrix
+ * @param[in] alpha: Scaling factor for src, that is inverse of temperature
+ * @param[in] init: Whether previous values of outputs are ignored
+ * @param[in] src: Input contiguous m-by-n array
+ * @param[inout] topk_val: Contiguous k-by-n array of top-k values
+ * @param[inout] topk_idx: Contiguous k-by-n array of row indices of top-k
+ *      values
+ * @param[inout] maxsumexp: Contiguous 2-by-n array of maximums and sums of
+ *      exponents. Zero sum means there was no value yet.
+ * */
+{
+    constexpr T zero = 0, one = 1;
+    constexpr T minus_inf = -std::numeric_limits<T>::infinity();
+    for(Index j = 0; j < n; ++j)
+    {
+        const T *src_col = src + j*m;
+        T *val = topk_val + j*k;
+        Index *idx = topk_idx + j*k;
+        T *mse = maxsumexp + 2*j;
+        if(init)
+        {
+            for(Index l = 0; l < k; ++l)
+            {
+                val[l] = minus_inf;
+                idx[l] = -1;
+            }
+            mse[0] = zero;
+            mse[1] = zero;
+        }
+        // Number of already found candidates
+        Index nfound = 0;
+        while(nfound < k and idx[nfound] >= 0)
+        {
+            ++nfound;
+        }
+        T max = mse[0], sum = mse[1];
+        for(Index i = 0; i < m; ++i)
+        {
+            T v = alpha * src_col[i];
+            // Ignore -inf value, which comes from mask
+            if(v == minus_inf)
+            {
+                continue;
+            }
+            // Update max and sum of exponents
+            if(sum == zero)
+            {
+                max = v;
+                sum = one;
+            }
+            else if(max < v)
+            {
+                sum = sum*std::exp(max-v) + one;
+                max = v;
+            }
+            else
+            {
+                sum += std::exp(v-max);
+            }
+            // Insert new candidate, shifting smaller ones to the end
+            if(nfound < k or val[k-1] < v)
+            {
+                Index pos = nfound < k ? nfound : k-1;
+                while(pos > 0 and val[pos-1] < v)
+                {
+                    val[pos] = val[pos-1];
+                    idx[pos] = idx[pos-1];
+                    --pos;
+                }
+                val[pos] = v;
+                idx[pos] = offset + i;
+                if(nfound < k)
+                {
+                    ++nfound;
+                }
+            }
+        }
+        mse[0] = max;
+        mse[1] = sum;
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, Index offset, scal_t alpha,
+        bool init, const fp32_t *src, fp32_t *topk_val, Index *topk_idx,
+        fp32_t *maxsumexp)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, Index offset, scal_t alpha,
+        bool init, const fp64_t *src, fp64_t *topk_val, Index *topk_idx,
+        fp64_t *maxsumexp)
+    noexcept;
+
+} // namespace nntile::kernel::topk_maxsumexp
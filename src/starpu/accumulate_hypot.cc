@@ -127,11 +127,15 @@ void submit(Handle src, Handle dst)
  * throws an std::runtime_error() exception.
  * */
 {
+    // Number of elements is defined by the size of the destination buffer
+    Index nelems = starpu_data_get_size(
+            static_cast<starpu_data_handle_t>(dst)) / sizeof(T);
+    fp64_t nflops = 4 * nelems;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_RW|STARPU_COMMUTE, static_cast<starpu_data_handle_t>(dst),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            // STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
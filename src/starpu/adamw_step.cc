@@ -130,7 +130,6 @@ void submit(Index num_iter, Index num_elems, scal_t beta_1, scal_t beta_2, scal_
     args->eps = eps;
     args->lr = lr;
     args->weight_decay = weight_decay;
-    //fp64_t nflops = 5 * nelems;
     // Submit task
     enum starpu_data_access_mode moments_mode;
     if (num_iter == 1)
@@ -141,12 +140,14 @@ void submit(Index num_iter, Index num_elems, scal_t beta_1, scal_t beta_2, scal_
     {
         moments_mode = STARPU_RW;
     }
+    fp64_t nflops = 16 * num_elems;
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(grad),
             moments_mode, static_cast<starpu_data_handle_t>(first_moment),
             moments_mode, static_cast<starpu_data_handle_t>(second_moment),
             STARPU_RW, static_cast<starpu_data_handle_t>(p),
             STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
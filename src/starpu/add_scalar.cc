@@ -121,11 +121,13 @@ void submit(Index num_elements, T alpha, T beta, Handle dst)
     args->num_elements = num_elements;
     args->alpha = alpha;
     args->beta = beta;
+    fp64_t nflops = 2 * num_elements;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_CL_ARGS, args, sizeof(*args),
-            STARPU_RW, static_cast<starpu_data_handle_t>(dst), 0);
-            // STARPU_FLOPS, nflops);
+            STARPU_RW, static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
+            0);
     // Check submission
     if(ret != 0)
     {
@@ -121,14 +121,14 @@ void submit(scal_t val, scal_t eps, Index nelems, Handle nom, Handle denom, Hand
     args->val = val;
     args->eps = eps;
     args->nelems = nelems;
-    //fp64_t nflops = 5 * nelems;
+    fp64_t nflops = 4 * nelems;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(nom),
             STARPU_R, static_cast<starpu_data_handle_t>(denom),
             STARPU_RW, static_cast<starpu_data_handle_t>(src),
             STARPU_CL_ARGS, args, sizeof(*args),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
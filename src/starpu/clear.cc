@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/starpu/clear.hh"
+#include "nntile/starpu/ndarray.hh"
 #include <cstring>
 #ifndef STARPU_SIMGRID
 #   ifdef NNTILE_USE_CUDA
@@ -35,6 +36,23 @@ void cpu(void *buffers[], void *cl_args)
     auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
     std::size_t size = interfaces[0]->elemsize;
     void *data = interfaces[0]->get_ptr<void>();
+    // Clear only elements of a non-contiguous array
+    if(is_ndarray(interfaces[0]))
+    {
+        auto array = reinterpret_cast<NDArrayInterface *>(interfaces[0]);
+        if(!array->is_contiguous())
+        {
+            auto ptr = array->get_ptr<char>();
+            Index typesize = array->typesize;
+            ndarray_for_each_block(array->ndim, array->shape, array->stride,
+                    array->stride, [&](Index offset, Index, Index nelems)
+                    {
+                        std::memset(ptr+offset*typesize, 0,
+                                nelems*typesize);
+                    });
+            return;
+        }
+    }
     // Clear buffer
     std::memset(data, 0, size);
 #endif // STARPU_SIMGRID
@@ -53,6 +71,23 @@ void cuda(void *buffers[], void *cl_args)
     void *data = interfaces[0]->get_ptr<void>();
     // Get CUDA stream
     cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Clear only elements of a non-contiguous array
+    if(is_ndarray(interfaces[0]))
+    {
+        auto array = reinterpret_cast<NDArrayInterface *>(interfaces[0]);
+        if(!array->is_contiguous())
+        {
+            auto ptr = array->get_ptr<char>();
+            Index typesize = array->typesize;
+            ndarray_for_each_block(array->ndim, array->shape, array->stride,
+                    array->stride, [&](Index offset, Index, Index nelems)
+                    {
+                        cudaMemsetAsync(ptr+offset*typesize, 0,
+                                nelems*typesize, stream);
+                    });
+            return;
+        }
+    }
     // Clear buffer
     cudaMemsetAsync(data, 0, size, stream);
 #endif // STARPU_SIMGRID
@@ -13,12 +13,63 @@
  * */
 
 #include "nntile/starpu/copy.hh"
+#include "nntile/starpu/ndarray.hh"
+#include <algorithm>
 #include <cstring>
 
 //! StarPU wrappers for copy operation
 namespace nntile::starpu::copy
 {
 
+// Layout of buffers for a block-by-block copy
+struct StridedCopy
+{
+    const NDArrayInterface *array;
+    Index src_stride[NDARRAY_MAX_NDIM], dst_stride[NDARRAY_MAX_NDIM];
+};
+
+// Get layout of buffers, if any of them is a non-contiguous array. A plain
+// variable is treated as a contiguous array of the same shape as the other
+// buffer.
+static bool get_strided_copy(VariableInterface **interfaces,
+        StridedCopy &copy)
+    noexcept
+{
+    const NDArrayInterface *src = nullptr, *dst = nullptr;
+    if(is_ndarray(interfaces[0]))
+    {
+        src = reinterpret_cast<const NDArrayInterface *>(interfaces[0]);
+    }
+    if(is_ndarray(interfaces[1]))
+    {
+        dst = reinterpret_cast<const NDArrayInterface *>(interfaces[1]);
+    }
+    if((!src or src->is_contiguous()) and (!dst or dst->is_contiguous()))
+    {
+        return false;
+    }
+    copy.array = src ? src : dst;
+    const Index ndim = copy.array->ndim;
+    const Index *shape = copy.array->shape;
+    if(src)
+    {
+        std::copy_n(src->stride, ndim, copy.src_stride);
+    }
+    else
+    {
+        ndarray_contiguous_stride(ndim, shape, copy.src_stride);
+    }
+    if(dst)
+    {
+        std::copy_n(dst->stride, ndim, copy.dst_stride);
+    }
+    else
+    {
+        ndarray_contiguous_stride(ndim, shape, copy.dst_stride);
+    }
+    return true;
+}
+
 //! Copy StarPU buffers on CPU
 void cpu(void *buffers[], void *cl_args)
     noexcept
@@ -30,6 +81,22 @@ void cpu(void *buffers[], void *cl_args)
     std::size_t size = interfaces[0]->elemsize;
     const void *src = interfaces[0]->get_ptr<void>();
     void *dst = interfaces[1]->get_ptr<void>();
+    // Copy elements of arrays with different strides block by block
+    StridedCopy copy;
+    if(get_strided_copy(interfaces, copy))
+    {
+        auto src_ptr = reinterpret_cast<const char *>(src);
+        auto dst_ptr = reinterpret_cast<char *>(dst);
+        Index typesize = copy.array->typesize;
+        ndarray_for_each_block(copy.array->ndim, copy.array->shape,
+                copy.src_stride, copy.dst_stride,
+                [&](Index src_offset, Index dst_offset, Index nelems)
+                {
+                    std::memcpy(dst_ptr+dst_offset*typesize,
+                            src_ptr+src_offset*typesize, nelems*typesize);
+                });
+        return;
+    }
     // Launch kernel
     std::memcpy(dst, src, size);
 #endif // STARPU_SIMGRID
@@ -49,6 +116,23 @@ void cuda(void *buffers[], void *cl_args)
     void *dst = interfaces[1]->get_ptr<void>();
     // Get CUDA stream
     cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Copy elements of arrays with different strides block by block
+    StridedCopy copy;
+    if(get_strided_copy(interfaces, copy))
+    {
+        auto src_ptr = reinterpret_cast<const char *>(src);
+        auto dst_ptr = reinterpret_cast<char *>(dst);
+        Index typesize = copy.array->typesize;
+        ndarray_for_each_block(copy.array->ndim, copy.array->shape,
+                copy.src_stride, copy.dst_stride,
+                [&](Index src_offset, Index dst_offset, Index nelems)
+                {
+                    cudaMemcpyAsync(dst_ptr+dst_offset*typesize,
+                            src_ptr+src_offset*typesize, nelems*typesize,
+                            cudaMemcpyDeviceToDevice, stream);
+                });
+        return;
+    }
     // Launch kernel
     cudaMemcpyAsync(dst, src, size, cudaMemcpyDeviceToDevice, stream);
 #endif // STARPU_SIMGRID
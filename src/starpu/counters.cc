@@ -0,0 +1,205 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/counters.cc
+ * Aggregate counters of FLOPs, bytes and time of executed tasks
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu/counters.hh"
+#include "nntile/starpu/trace.hh"
+#include "nntile/starpu/perfmodel.hh"
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+namespace nntile::starpu
+{
+
+namespace counters
+{
+
+// Counters are accumulated only if this flag is set
+static std::atomic<bool> enabled{false};
+
+// Mutex to guard counters of all codelets
+static std::mutex mutex;
+
+// All initialized codelets
+static std::vector<Codelet *> codelets;
+
+// Estimate number of bytes, moved by a task. Every buffer is read in case of
+// STARPU_R mode and written in case of STARPU_W mode, so a buffer in
+// STARPU_RW mode is counted twice. Scratch buffers are ignored.
+static double task_bytes(starpu_task *task)
+{
+    double bytes = 0;
+    int nbuffers = STARPU_TASK_GET_NBUFFERS(task);
+    for(int i = 0; i < nbuffers; ++i)
+    {
+        starpu_data_access_mode mode = STARPU_TASK_GET_MODE(task, i);
+        if((mode & STARPU_SCRATCH) != 0)
+        {
+            continue;
+        }
+        double size = starpu_data_get_size(STARPU_TASK_GET_HANDLE(task, i));
+        if((mode & STARPU_R) != 0)
+        {
+            bytes += size;
+        }
+        if((mode & STARPU_W) != 0)
+        {
+            bytes += size;
+        }
+    }
+    return bytes;
+}
+
+// Add a finished task to counters of its codelet
+static void update(Codelet *codelet, starpu_task *task, double seconds)
+{
+    double bytes = task_bytes(task);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++codelet->ntasks;
+    codelet->flops += task->flops;
+    codelet->bytes += bytes;
+    codelet->seconds += seconds;
+}
+
+void enable()
+{
+    enabled = true;
+}
+
+void disable()
+{
+    enabled = false;
+}
+
+bool is_enabled()
+{
+    return enabled;
+}
+
+void reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto codelet: codelets)
+    {
+        codelet->ntasks = 0;
+        codelet->flops = 0;
+        codelet->bytes = 0;
+        codelet->seconds = 0;
+    }
+}
+
+std::vector<Record> get()
+{
+    std::vector<Record> res;
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto codelet: codelets)
+    {
+        if(codelet->ntasks > 0)
+        {
+            res.push_back({codelet->starpu_codelet::name, codelet->ntasks,
+                    codelet->flops, codelet->bytes, codelet->seconds});
+        }
+    }
+    return res;
+}
+
+std::vector<Codelet *> get_codelets()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return codelets;
+}
+
+} // namespace counters
+
+void Codelet::register_counters(Codelet *codelet)
+{
+    std::lock_guard<std::mutex> lock(counters::mutex);
+    auto &codelets = counters::codelets;
+    if(std::find(codelets.begin(), codelets.end(), codelet)
+            == codelets.end())
+    {
+        codelets.push_back(codelet);
+    }
+}
+
+void Codelet::cpu_wrapper(void *buffers[], void *cl_args)
+{
+    starpu_task *task = starpu_task_get_current();
+    // StarPU codelet is the first base of the Codelet class
+    Codelet *codelet = static_cast<Codelet *>(task->cl);
+    auto func = codelet->cpu_funcs_real[starpu_task_get_implementation(task)];
+    if(perfmodel::record_is_enabled())
+    {
+        perfmodel::record(task);
+    }
+    bool count = counters::enabled, trace = trace::is_enabled();
+    if(!count and !trace)
+    {
+        func(buffers, cl_args);
+        return;
+    }
+    auto start = trace::clock::now();
+    func(buffers, cl_args);
+    auto end = trace::clock::now();
+    if(count)
+    {
+        std::chrono::duration<double> diff = end - start;
+        counters::update(codelet, task, diff.count());
+    }
+    if(trace)
+    {
+        trace::record(task, start, end);
+    }
+}
+
+void Codelet::cuda_wrapper(void *buffers[], void *cl_args)
+{
+    starpu_task *task = starpu_task_get_current();
+    Codelet *codelet = static_cast<Codelet *>(task->cl);
+    auto func = codelet->cuda_funcs_real[
+        starpu_task_get_implementation(task)];
+    if(perfmodel::record_is_enabled())
+    {
+        perfmodel::record(task);
+    }
+    bool count = counters::enabled, trace = trace::is_enabled();
+    if(!count and !trace)
+    {
+        func(buffers, cl_args);
+        return;
+    }
+#ifdef NNTILE_USE_CUDA
+    // CUDA kernels are asynchronous, so the stream is synchronized to time
+    // the task. This serializes CUDA tasks of a worker, which is acceptable
+    // only while counters or tracing are enabled.
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    cudaStreamSynchronize(stream);
+    auto start = trace::clock::now();
+    func(buffers, cl_args);
+    cudaStreamSynchronize(stream);
+    auto end = trace::clock::now();
+    if(count)
+    {
+        std::chrono::duration<double> diff = end - start;
+        counters::update(codelet, task, diff.count());
+    }
+    if(trace)
+    {
+        trace::record(task, start, end);
+    }
+#endif // NNTILE_USE_CUDA
+}
+
+} // namespace nntile::starpu
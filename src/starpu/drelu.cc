@@ -97,11 +97,11 @@ template<typename T>
 void submit(Index nelems, Handle data)
 {
     Index *nelems_ = new Index{nelems};
-    //fp64_t nflops = 5 * nelems;
+    fp64_t nflops = nelems;
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(data),
             STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
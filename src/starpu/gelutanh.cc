@@ -114,12 +114,12 @@ void submit(Index nelems, Handle src, Handle dst)
     // Codelet arguments
     Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
     *nelems_ = nelems;
-    //fp64_t nflops = 5 * nelems;
+    fp64_t nflops = 11 * nelems;
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
             STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
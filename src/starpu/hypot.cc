@@ -156,12 +156,14 @@ void submit(Index nelems, scal_t alpha, Handle src, scal_t beta, Handle dst)
     args->nelems = nelems;
     args->alpha = alpha;
     args->beta = beta;
+    fp64_t nflops = 6 * nelems;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_CL_ARGS, args, sizeof(*args),
-            dst_mode, static_cast<starpu_data_handle_t>(dst), 0);
-            // STARPU_FLOPS, nflops);
+            dst_mode, static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
+            0);
     // Check submission
     if(ret != 0)
     {
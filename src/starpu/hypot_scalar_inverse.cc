@@ -122,10 +122,12 @@ void submit(Index nelems, scal_t eps, scal_t alpha, Handle dst)
     args->nelems = nelems;
     args->eps = eps;
     args->alpha = alpha;
+    fp64_t nflops = 6 * nelems;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
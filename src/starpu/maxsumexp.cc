@@ -138,7 +138,6 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst, int redux)
     args->m = m;
     args->n = n;
     args->k = k;
-    //fp64_t nflops = m * n * k;
     // Access mode for the dst handle
     enum starpu_data_access_mode dst_mode;
     if(redux != 0)
@@ -150,12 +149,13 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst, int redux)
     {
         dst_mode = Config::STARPU_RW_COMMUTE;
     }
+    fp64_t nflops = 4 * m * n * k;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_CL_ARGS, args, sizeof(*args),
             dst_mode, static_cast<starpu_data_handle_t>(dst),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -0,0 +1,181 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/memory.cc
+ * Accounting of memory of registered data by categories
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu/memory.hh"
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+#include <cstring>
+
+namespace nntile::starpu::memory
+{
+
+// Size and category of tracked data
+struct Record
+{
+    Index nbytes;
+    int category;
+};
+
+// Mutex to guard all the state below
+static std::mutex mutex;
+
+// All tracked data
+static std::unordered_map<starpu_data_handle_t, Record> records;
+
+// Live and peak bytes
+static Stats stats;
+
+// Category of data, tracked from now on
+static int default_category = OTHER;
+
+// Recorded samples and a flag if new samples are recorded
+static bool timeline_enabled = false;
+static std::vector<Sample> timeline;
+static std::chrono::steady_clock::time_point timeline_epoch;
+
+static void check_category(int category)
+{
+    if(category < 0 or category >= NCATEGORIES)
+    {
+        throw std::runtime_error("Invalid memory category");
+    }
+}
+
+// Add bytes to a category, mutex shall be locked
+static void add(int category, Index nbytes)
+{
+    stats.live[category] += nbytes;
+    stats.live_total += nbytes;
+    if(stats.peak[category] < stats.live[category])
+    {
+        stats.peak[category] = stats.live[category];
+    }
+    if(stats.peak_total < stats.live_total)
+    {
+        stats.peak_total = stats.live_total;
+    }
+}
+
+// Record live bytes into the timeline, mutex shall be locked
+static void sample()
+{
+    if(!timeline_enabled)
+    {
+        return;
+    }
+    Sample res;
+    std::chrono::duration<double> diff = std::chrono::steady_clock::now()
+        - timeline_epoch;
+    res.time = diff.count();
+    std::memcpy(res.live, stats.live, sizeof(res.live));
+    timeline.push_back(res);
+}
+
+const char *category_name(int category)
+{
+    static const char *names[NCATEGORIES] = {"other", "parameter", "grad",
+        "activation", "optimizer", "scratch"};
+    check_category(category);
+    return names[category];
+}
+
+void track(starpu_data_handle_t handle, Index nbytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    records[handle] = {nbytes, default_category};
+    add(default_category, nbytes);
+    sample();
+}
+
+void untrack(starpu_data_handle_t handle)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = records.find(handle);
+    if(it == records.end())
+    {
+        return;
+    }
+    add(it->second.category, -it->second.nbytes);
+    records.erase(it);
+    sample();
+}
+
+void set_category(starpu_data_handle_t handle, int category)
+{
+    check_category(category);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = records.find(handle);
+    if(it == records.end() or it->second.category == category)
+    {
+        return;
+    }
+    add(it->second.category, -it->second.nbytes);
+    it->second.category = category;
+    add(category, it->second.nbytes);
+    sample();
+}
+
+void set_default_category(int category)
+{
+    check_category(category);
+    std::lock_guard<std::mutex> lock(mutex);
+    default_category = category;
+}
+
+int get_default_category()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return default_category;
+}
+
+Stats get_stats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void reset_peak()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::memcpy(stats.peak, stats.live, sizeof(stats.peak));
+    stats.peak_total = stats.live_total;
+}
+
+void timeline_enable()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!timeline_enabled)
+    {
+        timeline_enabled = true;
+        timeline_epoch = std::chrono::steady_clock::now();
+    }
+}
+
+void timeline_disable()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    timeline_enabled = false;
+}
+
+std::vector<Sample> timeline_get()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Sample> res;
+    res.swap(timeline);
+    return res;
+}
+
+} // namespace nntile::starpu::memory
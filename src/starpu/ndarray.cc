@@ -0,0 +1,412 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/ndarray.cc
+ * StarPU data interface for multidimensional arrays
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu/ndarray.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace nntile::starpu
+{
+
+void ndarray_contiguous_stride(Index ndim, const Index *shape, Index *stride)
+{
+    Index nelems = 1;
+    for(Index i = 0; i < ndim; ++i)
+    {
+        stride[i] = nelems;
+        nelems *= shape[i];
+    }
+}
+
+//! Register array on all memory nodes
+static
+void register_ndarray(starpu_data_handle_t handle, unsigned home_node,
+        void *data_interface)
+{
+    auto src = reinterpret_cast<NDArrayInterface *>(data_interface);
+    for(unsigned node = 0; node < STARPU_MAXNODES; ++node)
+    {
+        auto local = reinterpret_cast<NDArrayInterface *>(
+                starpu_data_get_interface_on_node(handle, node));
+        // Data is present only on the home node
+        if(node == home_node)
+        {
+            local->ptr = src->ptr;
+            local->dev_handle = src->dev_handle;
+            local->offset = src->offset;
+        }
+        else
+        {
+            local->ptr = 0;
+            local->dev_handle = 0;
+            local->offset = 0;
+        }
+        local->id = src->id;
+        local->elemsize = src->elemsize;
+        local->typesize = src->typesize;
+        local->ndim = src->ndim;
+        for(Index i = 0; i < src->ndim; ++i)
+        {
+            local->shape[i] = src->shape[i];
+        }
+        // Only user memory on the home node can have gaps
+        if(node == home_node)
+        {
+            for(Index i = 0; i < src->ndim; ++i)
+            {
+                local->stride[i] = src->stride[i];
+            }
+        }
+        else
+        {
+            ndarray_contiguous_stride(local->ndim, local->shape,
+                    local->stride);
+        }
+    }
+}
+
+//! Allocate contiguous array on a memory node
+static
+starpu_ssize_t allocate_ndarray(void *data_interface, unsigned node)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(data_interface);
+    uintptr_t ptr = starpu_malloc_on_node(node, interface->elemsize);
+    if(!ptr)
+    {
+        return -ENOMEM;
+    }
+    interface->ptr = ptr;
+    interface->dev_handle = ptr;
+    interface->offset = 0;
+    ndarray_contiguous_stride(interface->ndim, interface->shape,
+            interface->stride);
+    return interface->elemsize;
+}
+
+//! Free array on a memory node
+static
+void free_ndarray(void *data_interface, unsigned node)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(data_interface);
+    starpu_free_on_node(node, interface->dev_handle, interface->elemsize);
+    interface->ptr = 0;
+    interface->dev_handle = 0;
+}
+
+//! Copy array between any memory nodes
+static
+int copy_ndarray(void *src_interface, unsigned src_node,
+        void *dst_interface, unsigned dst_node, void *async_data)
+{
+    auto src = reinterpret_cast<NDArrayInterface *>(src_interface);
+    auto dst = reinterpret_cast<NDArrayInterface *>(dst_interface);
+    // Contiguous blocks are copied one by one, that is a single copy for
+    // contiguous arrays
+    int ret = 0;
+    Index typesize = src->typesize;
+    ndarray_for_each_block(src->ndim, src->shape, src->stride, dst->stride,
+            [&](Index src_offset, Index dst_offset, Index nelems)
+            {
+                if(starpu_interface_copy(src->dev_handle,
+                            src->offset+src_offset*typesize, src_node,
+                            dst->dev_handle, dst->offset+dst_offset*typesize,
+                            dst_node, nelems*typesize, async_data))
+                {
+                    ret = -EAGAIN;
+                }
+            });
+    return ret;
+}
+
+static const starpu_data_copy_methods ndarray_copy_methods = []()
+{
+    starpu_data_copy_methods methods;
+    std::memset(&methods, 0, sizeof(methods));
+    methods.any_to_any = copy_ndarray;
+    return methods;
+}();
+
+//! Pointer to the array on a memory node
+static
+void *ndarray_handle_to_pointer(starpu_data_handle_t handle, unsigned node)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(handle, node));
+    return reinterpret_cast<void *>(interface->ptr);
+}
+
+//! Size of the array in bytes
+static
+size_t ndarray_get_size(starpu_data_handle_t handle)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(handle, STARPU_MAIN_RAM));
+    return interface->elemsize;
+}
+
+//! Footprint depends on the shape of the array
+static
+uint32_t ndarray_footprint(starpu_data_handle_t handle)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(handle, STARPU_MAIN_RAM));
+    uint32_t hash = starpu_hash_crc32c_be(interface->typesize, 0);
+    return starpu_hash_crc32c_be_n(interface->shape,
+            interface->ndim*sizeof(Index), hash);
+}
+
+//! Allocations of the same size can be reused by arrays of any shape
+static
+int ndarray_compare(void *data_interface_a, void *data_interface_b)
+{
+    auto a = reinterpret_cast<NDArrayInterface *>(data_interface_a);
+    auto b = reinterpret_cast<NDArrayInterface *>(data_interface_b);
+    return a->elemsize == b->elemsize;
+}
+
+//! Print shape of the array
+static
+void ndarray_display(starpu_data_handle_t handle, FILE *f)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(handle, STARPU_MAIN_RAM));
+    for(Index i = 0; i < interface->ndim; ++i)
+    {
+        std::fprintf(f, "%ld\t", long(interface->shape[i]));
+    }
+}
+
+//! Describe the array by its shape
+static
+starpu_ssize_t ndarray_describe(void *data_interface, char *buf, size_t size)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(data_interface);
+    starpu_ssize_t len = std::snprintf(buf, size, "N");
+    for(Index i = 0; i < interface->ndim; ++i)
+    {
+        len += std::snprintf(buf+len, len < starpu_ssize_t(size) ?
+                size-len : 0, "%s%ld", i == 0 ? "" : "x",
+                long(interface->shape[i]));
+    }
+    return len;
+}
+
+//! Pack array into a contiguous buffer for MPI transfers
+static
+int ndarray_pack(starpu_data_handle_t handle, unsigned node, void **ptr,
+        starpu_ssize_t *count)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(handle, node));
+    *count = interface->elemsize;
+    if(ptr != nullptr)
+    {
+        *ptr = reinterpret_cast<void *>(starpu_malloc_on_node_flags(node,
+                    *count, 0));
+        // Gather elements into a contiguous buffer
+        Index stride[NDARRAY_MAX_NDIM];
+        ndarray_contiguous_stride(interface->ndim, interface->shape, stride);
+        auto src = reinterpret_cast<const char *>(interface->ptr);
+        auto dst = reinterpret_cast<char *>(*ptr);
+        Index typesize = interface->typesize;
+        ndarray_for_each_block(interface->ndim, interface->shape,
+                interface->stride, stride,
+                [&](Index src_offset, Index dst_offset, Index nelems)
+                {
+                    std::memcpy(dst+dst_offset*typesize,
+                            src+src_offset*typesize, nelems*typesize);
+                });
+    }
+    return 0;
+}
+
+//! Unpack array from a contiguous buffer after MPI transfers
+static
+int ndarray_unpack(starpu_data_handle_t handle, unsigned node, void *ptr,
+        size_t count)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(handle, node));
+    // Scatter elements of a contiguous buffer
+    Index stride[NDARRAY_MAX_NDIM];
+    ndarray_contiguous_stride(interface->ndim, interface->shape, stride);
+    auto src = reinterpret_cast<const char *>(ptr);
+    auto dst = reinterpret_cast<char *>(interface->ptr);
+    Index typesize = interface->typesize;
+    ndarray_for_each_block(interface->ndim, interface->shape, stride,
+            interface->stride,
+            [&](Index src_offset, Index dst_offset, Index nelems)
+            {
+                std::memcpy(dst+dst_offset*typesize, src+src_offset*typesize,
+                        nelems*typesize);
+            });
+    starpu_free_on_node_flags(node, reinterpret_cast<uintptr_t>(ptr), count,
+            0);
+    return 0;
+}
+
+starpu_data_interface_ops ndarray_ops = []()
+{
+    starpu_data_interface_ops ops;
+    std::memset(&ops, 0, sizeof(ops));
+    ops.register_data_handle = register_ndarray;
+    ops.allocate_data_on_node = allocate_ndarray;
+    ops.free_data_on_node = free_ndarray;
+    ops.copy_methods = &ndarray_copy_methods;
+    ops.handle_to_pointer = ndarray_handle_to_pointer;
+    ops.get_size = ndarray_get_size;
+    ops.footprint = ndarray_footprint;
+    ops.compare = ndarray_compare;
+    ops.display = ndarray_display;
+    ops.describe = ndarray_describe;
+    ops.interfaceid = STARPU_UNKNOWN_INTERFACE_ID;
+    ops.interface_size = sizeof(NDArrayInterface);
+    ops.pack_data = ndarray_pack;
+    ops.unpack_data = ndarray_unpack;
+    ops.name = const_cast<char *>("NNTILE_NDARRAY_INTERFACE");
+    return ops;
+}();
+
+//! Register array with the interface
+/*! @param[out] handle: Registered handle
+ * @param[in] home_node: Memory node of the provided pointer or -1 if memory
+ *      shall be allocated by StarPU
+ * @param[in] ptr: Pointer to the array in a Fortran order
+ * @param[in] shape: Shape of the array
+ * @param[in] typesize: Size of a single element in bytes
+ * @param[in] stride: Strides of the array in elements. Empty for a
+ *      contiguous array. Elements shall not overlap, i.e., stride[i] shall
+ *      be at least stride[i-1]*shape[i-1].
+ * */
+void ndarray_data_register(starpu_data_handle_t *handle, int home_node,
+        uintptr_t ptr, const std::vector<Index> &shape, Index typesize,
+        const std::vector<Index> &stride)
+{
+    Index ndim = shape.size();
+    if(ndim > NDARRAY_MAX_NDIM)
+    {
+        throw std::runtime_error("Too many dimensions of array");
+    }
+    if(!stride.empty())
+    {
+        if(Index(stride.size()) != ndim)
+        {
+            throw std::runtime_error("Wrong number of strides");
+        }
+        if(home_node < 0)
+        {
+            throw std::runtime_error("Strides require user memory");
+        }
+        Index min_stride = 1;
+        for(Index i = 0; i < ndim; ++i)
+        {
+            if(stride[i] < min_stride)
+            {
+                throw std::runtime_error("Elements of array overlap");
+            }
+            min_stride = stride[i] * shape[i];
+        }
+    }
+    // Get identifier of the interface
+    if(ndarray_ops.interfaceid == STARPU_UNKNOWN_INTERFACE_ID)
+    {
+        ndarray_ops.interfaceid = static_cast<starpu_data_interface_id>(
+                starpu_data_interface_get_next_id());
+    }
+    NDArrayInterface *interface = reinterpret_cast<NDArrayInterface *>(
+            std::calloc(1, sizeof(NDArrayInterface)));
+    interface->id = ndarray_ops.interfaceid;
+    interface->ptr = ptr;
+    interface->dev_handle = ptr;
+    interface->offset = 0;
+    interface->typesize = typesize;
+    interface->ndim = ndim;
+    Index nelems = 1;
+    for(Index i = 0; i < ndim; ++i)
+    {
+        if(shape[i] <= 0)
+        {
+            std::free(interface);
+            throw std::runtime_error("Zero size is not supported");
+        }
+        interface->shape[i] = shape[i];
+        interface->stride[i] = stride.empty() ? nelems : stride[i];
+        nelems *= shape[i];
+    }
+    interface->elemsize = nelems * typesize;
+    starpu_data_register(handle, home_node, interface, &ndarray_ops);
+    std::free(interface);
+}
+
+//! Filter, that splits an array into blocks along a single axis
+/*! Blocks have sizes, that differ by at most one, and share strides of the
+ * array.
+ * */
+void ndarray_filter_block(void *father_interface, void *child_interface,
+        starpu_data_filter *f, unsigned id, unsigned nparts)
+{
+    auto father = reinterpret_cast<NDArrayInterface *>(father_interface);
+    auto child = reinterpret_cast<NDArrayInterface *>(child_interface);
+    Index axis = f->filter_arg;
+    Index size = father->shape[axis];
+    Index start = id*(size/nparts) + std::min<Index>(id, size%nparts);
+    Index nelems = 1;
+    std::memcpy(child, father, sizeof(NDArrayInterface));
+    child->shape[axis] = size/nparts + (Index(id) < size%nparts ? 1 : 0);
+    for(Index i = 0; i < child->ndim; ++i)
+    {
+        nelems *= child->shape[i];
+    }
+    child->elemsize = nelems * child->typesize;
+    // Block starts with an offset within the memory of the array, that is
+    // not yet allocated on some memory nodes
+    Index offset = start * father->stride[axis] * father->typesize;
+    if(father->dev_handle)
+    {
+        if(father->ptr)
+        {
+            child->ptr = father->ptr + offset;
+        }
+        child->offset = father->offset + offset;
+    }
+}
+
+std::vector<starpu_data_handle_t> ndarray_partition_plan(
+        starpu_data_handle_t handle, Index axis, Index nparts)
+{
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(handle, STARPU_MAIN_RAM));
+    if(axis < 0 or axis >= interface->ndim)
+    {
+        throw std::runtime_error("Wrong axis of partitioning");
+    }
+    if(nparts <= 0 or nparts > interface->shape[axis])
+    {
+        throw std::runtime_error("Wrong number of blocks");
+    }
+    starpu_data_filter f;
+    std::memset(&f, 0, sizeof(f));
+    f.filter_func = ndarray_filter_block;
+    f.nchildren = nparts;
+    f.filter_arg = axis;
+    std::vector<starpu_data_handle_t> children(nparts);
+    starpu_data_partition_plan(handle, &f, &children[0]);
+    return children;
+}
+
+} // namespace nntile::starpu
@@ -164,11 +164,13 @@ void submit(Index m, Index n, Index k, scal_t alpha, Handle src, scal_t beta,
     args->k = k;
     args->alpha = alpha;
     args->beta = beta;
+    fp64_t nflops = m * n * (2*k+3);
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_CL_ARGS, args, sizeof(*args),
             dst_mode, static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
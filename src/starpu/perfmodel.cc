@@ -0,0 +1,154 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/perfmodel.cc
+ * Access to history-based performance models of codelets
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu/perfmodel.hh"
+#include "nntile/starpu/counters.hh"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+
+namespace nntile::starpu::perfmodel
+{
+
+// Footprints are recorded only if this flag is set
+static std::atomic<bool> recording{false};
+
+// Mutex to guard recorded footprints
+static std::mutex mutex;
+
+// Unique recorded footprints
+static std::set<std::pair<std::string, std::uint32_t>> recorded;
+
+std::vector<std::string> get_symbols()
+{
+    std::vector<std::string> res;
+    for(auto codelet: counters::get_codelets())
+    {
+        res.push_back(codelet->starpu_perfmodel::symbol);
+    }
+    return res;
+}
+
+std::string get_path(const std::string &symbol)
+{
+    char path[1024];
+    starpu_perfmodel_get_model_path(symbol.c_str(), path, sizeof(path));
+    return path;
+}
+
+void record_enable()
+{
+    recording = true;
+}
+
+void record_disable()
+{
+    recording = false;
+}
+
+bool record_is_enabled()
+{
+    return recording;
+}
+
+void record(starpu_task *task)
+{
+    if(task->cl == nullptr or task->cl->model == nullptr)
+    {
+        return;
+    }
+    // History of a model is indexed by the footprint function of the
+    // codelet, if it is set, e.g., gemm hashes its sizes and transpositions
+    auto model = task->cl->model;
+    std::uint32_t footprint = model->footprint ? model->footprint(task)
+        : starpu_task_data_footprint(task);
+    std::lock_guard<std::mutex> lock(mutex);
+    recorded.emplace(model->symbol, footprint);
+}
+
+std::vector<Entry> record_get()
+{
+    std::vector<Entry> res;
+    std::lock_guard<std::mutex> lock(mutex);
+    for(const auto &item: recorded)
+    {
+        res.push_back({item.first, item.second});
+    }
+    recorded.clear();
+    return res;
+}
+
+std::vector<Entry> find_missing(const std::vector<Entry> &entries)
+{
+    // Architectures of all workers, each one is taken only once
+    std::vector<starpu_perfmodel_arch *> archs;
+    std::set<std::string> arch_names;
+    unsigned nworkers = starpu_worker_get_count();
+    for(unsigned i = 0; i < nworkers; ++i)
+    {
+        auto arch = starpu_worker_get_perf_archtype(i,
+                STARPU_NMAX_SCHED_CTXS);
+        char name[256];
+        starpu_perfmodel_get_arch_name(arch, name, sizeof(name), 0);
+        if(arch_names.insert(name).second)
+        {
+            archs.push_back(arch);
+        }
+    }
+    // Group footprints by symbols to read every model only once
+    std::map<std::string, std::vector<std::uint32_t>> footprints;
+    for(const auto &entry: entries)
+    {
+        footprints[entry.symbol].push_back(entry.footprint);
+    }
+    std::vector<Entry> res;
+    for(const auto &item: footprints)
+    {
+        starpu_perfmodel model;
+        std::memset(&model, 0, sizeof(model));
+        // Model is not loaded if there is no file for this host
+        bool loaded = starpu_perfmodel_load_symbol(item.first.c_str(),
+                &model) == 0;
+        for(auto footprint: item.second)
+        {
+            bool calibrated = loaded;
+            for(auto arch: archs)
+            {
+                if(!calibrated)
+                {
+                    break;
+                }
+                // Expected time is NaN without enough samples in history
+                double time = starpu_perfmodel_history_based_expected_perf(
+                        &model, arch, footprint);
+                calibrated = !std::isnan(time);
+            }
+            if(!calibrated)
+            {
+                res.push_back({item.first, footprint});
+            }
+        }
+        if(loaded)
+        {
+            starpu_perfmodel_unload_model(&model);
+        }
+    }
+    return res;
+}
+
+} // namespace nntile::starpu::perfmodel
@@ -106,10 +106,12 @@ void submit(Index nelems, T alpha, T exp, Handle data)
     args->nelems = nelems;
     args->alpha = alpha;
     args->exp = exp;
+    fp64_t nflops = 2 * nelems;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(data),
             STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
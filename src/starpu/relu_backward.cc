@@ -113,11 +113,13 @@ void submit(Index nelems, Handle x, Handle dy, Handle dx)
 {
     Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
     *nelems_ = nelems;
+    fp64_t nflops = 2 * nelems;
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(x),
             STARPU_R, static_cast<starpu_data_handle_t>(dy),
             STARPU_RW, static_cast<starpu_data_handle_t>(dx),
             STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
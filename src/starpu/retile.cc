@@ -0,0 +1,185 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/retile.cc
+ * Gathering of a tile from parts of other tiles with StarPU buffers
+ *
+ * @version 1.0.0
+ * */
+
+#ifndef STARPU_SIMGRID
+#include "nntile/kernel/retile.hh"
+#endif // STARPU_SIMGRID
+#include "nntile/starpu/retile.hh"
+#include <cstdlib>
+#include <cstring>
+
+namespace nntile::starpu::retile
+{
+
+// Arguments are packed into a single buffer of ndim, nsrc, dst_stride[ndim]
+// and info[4*ndim*nsrc] values, followed by nsrc slots for pointers to
+// source tiles, that are filled by a worker
+static
+Index args_size(Index ndim, Index nsrc)
+{
+    return (2+ndim+4*ndim*nsrc)*sizeof(Index) + nsrc*sizeof(void *);
+}
+
+//! Gather destination tile from parts of source tiles on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+#ifndef STARPU_SIMGRID // Run the code only if this is not a simulation
+    // Get arguments
+    auto args = reinterpret_cast<Index *>(cl_args);
+    Index ndim = args[0], nsrc = args[1];
+    const Index *dst_stride = args + 2;
+    const Index *info = dst_stride + ndim;
+    auto src = reinterpret_cast<const T **>(args + 2 + ndim + 4*ndim*nsrc);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    for(Index i = 0; i < nsrc; ++i)
+    {
+        src[i] = interfaces[i]->get_ptr<T>();
+    }
+    T *dst = interfaces[nsrc]->get_ptr<T>();
+    // Launch kernel
+    kernel::retile::cpu<T>(ndim, nsrc, dst_stride, info, src, dst);
+#endif // STARPU_SIMGRID
+}
+
+//! Footprint for retile tasks, that depends on shapes of all the parts
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<Index *>(task->cl_arg);
+    Index ndim = args[0], nsrc = args[1];
+    return starpu_hash_crc32c_be_n(args, (2+ndim+4*ndim*nsrc)*sizeof(Index),
+            0);
+}
+
+Codelet codelet_fp32, codelet_fp64, codelet_int64, codelet_bool,
+        codelet_fp32_fast_tf32;
+
+// No CUDA implementation, as data is redistributed on CPU like in subcopy
+void init()
+{
+    codelet_fp32.init("nntile_retile_fp32",
+            footprint,
+            {cpu<fp32_t>},
+            {});
+
+    codelet_fp32_fast_tf32.init("nntile_retile_fp32_fast_tf32",
+            footprint,
+            {cpu<fp32_t>},
+            {});
+
+    codelet_fp64.init("nntile_retile_fp64",
+            footprint,
+            {cpu<fp64_t>},
+            {});
+
+    codelet_int64.init("nntile_retile_int64",
+            footprint,
+            {cpu<Index>},
+            {});
+
+    codelet_bool.init("nntile_retile_bool",
+            footprint,
+            {cpu<bool_t>},
+            {});
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp32_fast_tf32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+    codelet_int64.restrict_where(where);
+    codelet_bool.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp32_fast_tf32.restore_where();
+    codelet_fp64.restore_where();
+    codelet_int64.restore_where();
+    codelet_bool.restore_where();
+}
+
+template<typename T>
+void submit(Index ndim, const std::vector<Index> &dst_stride,
+        const std::vector<Index> &info, const std::vector<Handle> &src,
+        Handle dst)
+//! Insert retile task into StarPU pool of tasks
+/*! A single task reads all the source tiles and overwrites the destination
+ * tile. No argument checking is performed. If task submission fails, this
+ * routines throws an std::runtime_error() exception.
+ * */
+{
+    Index nsrc = src.size();
+    // Codelet arguments
+    Index size = args_size(ndim, nsrc);
+    Index *args = (Index *)std::malloc(size);
+    args[0] = ndim;
+    args[1] = nsrc;
+    std::memcpy(args+2, dst_stride.data(), ndim*sizeof(Index));
+    std::memcpy(args+2+ndim, info.data(), 4*ndim*nsrc*sizeof(Index));
+    // Access modes of all the buffers
+    std::vector<starpu_data_descr> descrs(nsrc+1);
+    for(Index i = 0; i < nsrc; ++i)
+    {
+        descrs[i].handle = static_cast<starpu_data_handle_t>(src[i]);
+        descrs[i].mode = STARPU_R;
+    }
+    descrs[nsrc].handle = static_cast<starpu_data_handle_t>(dst);
+    descrs[nsrc].mode = STARPU_W;
+    // Submit task
+    int ret = starpu_task_insert(codelet<T>(),
+            STARPU_DATA_MODE_ARRAY, &descrs[0], int(nsrc+1),
+            STARPU_CL_ARGS, args, size,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in retile task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index ndim, const std::vector<Index> &dst_stride,
+        const std::vector<Index> &info, const std::vector<Handle> &src,
+        Handle dst);
+
+template
+void submit<fp32_fast_tf32_t>(Index ndim,
+        const std::vector<Index> &dst_stride,
+        const std::vector<Index> &info, const std::vector<Handle> &src,
+        Handle dst);
+
+template
+void submit<fp64_t>(Index ndim, const std::vector<Index> &dst_stride,
+        const std::vector<Index> &info, const std::vector<Handle> &src,
+        Handle dst);
+
+template
+void submit<Index>(Index ndim, const std::vector<Index> &dst_stride,
+        const std::vector<Index> &info, const std::vector<Handle> &src,
+        Handle dst);
+
+template
+void submit<bool_t>(Index ndim, const std::vector<Index> &dst_stride,
+        const std::vector<Index> &info, const std::vector<Handle> &src,
+        Handle dst);
+
+} // namespace nntile::starpu::retile
@@ -0,0 +1,142 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/sample_topk.cc
+ * StarPU wrappers for sampling from top-k candidates
+ *
+ * @version 1.0.0
+ * */
+
+#ifndef STARPU_SIMGRID
+#include "nntile/kernel/sample_topk.hh"
+#endif // STARPU_SIMGRID
+#include "nntile/starpu/sample_topk.hh"
+#include <cstdlib>
+
+namespace nntile::starpu::sample_topk
+{
+
+//! Sample a token of each column from top-k candidates on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+#ifndef STARPU_SIMGRID // Run the code only if this is not a simulation
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *topk_val = interfaces[0]->get_ptr<T>();
+    const Index *topk_idx = interfaces[1]->get_ptr<Index>();
+    const T *maxsumexp = interfaces[2]->get_ptr<T>();
+    Index *token = interfaces[3]->get_ptr<Index>();
+    // Launch kernel
+    kernel::sample_topk::cpu<T>(args->n, args->k, args->top_k, args->top_p,
+            args->seed, args->offset, topk_val, topk_idx, maxsumexp, token);
+#endif // STARPU_SIMGRID
+}
+
+//! Footprint for sample_topk tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64, codelet_fp32_fast_tf32;
+
+// No CUDA implementation, as this operation processes a tiny amount of data
+void init()
+{
+    codelet_fp32.init("nntile_sample_topk_fp32",
+            footprint,
+            {cpu<fp32_t>},
+            {});
+
+    codelet_fp32_fast_tf32.init("nntile_sample_topk_fp32_fast_tf32",
+            footprint,
+            {cpu<fp32_t>},
+            {});
+
+    codelet_fp64.init("nntile_sample_topk_fp64",
+            footprint,
+            {cpu<fp64_t>},
+            {});
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp32_fast_tf32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp32_fast_tf32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, Handle topk_val,
+        Handle topk_idx, Handle maxsumexp, Handle token)
+//! Insert sample_topk task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args->n = n;
+    args->k = k;
+    args->top_k = top_k;
+    args->top_p = top_p;
+    args->seed = seed;
+    args->offset = offset;
+    fp64_t nflops = 4 * n * top_k;
+    // Submit task
+    int ret = starpu_task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(topk_val),
+            STARPU_R, static_cast<starpu_data_handle_t>(topk_idx),
+            STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
+            STARPU_W, static_cast<starpu_data_handle_t>(token),
+            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in sample_topk task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, Handle topk_val,
+        Handle topk_idx, Handle maxsumexp, Handle token);
+
+template
+void submit<fp32_fast_tf32_t>(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, Handle topk_val,
+        Handle topk_idx, Handle maxsumexp, Handle token);
+
+template
+void submit<fp64_t>(Index n, Index k, Index top_k, scal_t top_p,
+        unsigned long long seed, Index offset, Handle topk_val,
+        Handle topk_idx, Handle maxsumexp, Handle token);
+
+} // namespace nntile::starpu::sample_topk
@@ -139,12 +139,13 @@ void submit(Index m, Index n, Index k, Handle maxsumexp, scal_t alpha, Handle ds
     args->n = n;
     args->k = k;
     args->alpha = alpha;
+    fp64_t nflops = 4 * m * n * k;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             STARPU_CL_ARGS, args, sizeof(*args),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
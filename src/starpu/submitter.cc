@@ -0,0 +1,220 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/submitter.cc
+ * Pool of threads to submit tasks of a single tensor operation in parallel
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu/submitter.hh"
+#include "nntile/starpu/config.hh"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nntile::starpu::submitter
+{
+
+// A single parallel loop, processed by all threads of the pool and the
+// calling thread. Threads take chunks of iterations one by one.
+struct Job
+{
+    const std::function<void(Index, Index)> *func;
+    Index n;
+    Index chunk;
+    std::atomic<Index> next;
+    // Number of threads of the pool, that did not finish the loop yet
+    Index nactive;
+    // The first exception, thrown by any of the threads
+    std::exception_ptr error;
+};
+
+// Only one parallel loop is processed at a time
+static std::mutex loop_mutex;
+
+// Mutex and condition variables to guard the pool and the current job
+static std::mutex mutex;
+static std::condition_variable cv_start, cv_done;
+static std::vector<std::thread> threads;
+static std::atomic<int> nthreads{0};
+static Job *job = nullptr;
+static std::uint64_t generation = 0;
+static bool stop = false;
+
+// Loops with less tasks are submitted serially
+static std::atomic<Index> min_tasks{1024};
+
+// Set for threads, that are processing a parallel loop
+static thread_local bool inside_loop = false;
+
+// Process chunks of a job until there are no more of them
+static void run_chunks(Job &cur)
+{
+    inside_loop = true;
+    try
+    {
+        while(true)
+        {
+            Index begin = cur.next.fetch_add(cur.chunk);
+            if(begin >= cur.n)
+            {
+                break;
+            }
+            (*cur.func)(begin, std::min(begin+cur.chunk, cur.n));
+        }
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!cur.error)
+        {
+            cur.error = std::current_exception();
+        }
+        // Other threads shall not take new chunks
+        cur.next = cur.n;
+    }
+    inside_loop = false;
+}
+
+// Main loop of a thread of the pool. Generation of the last job is passed
+// from init(), as a job can start before the thread locks the mutex.
+static void worker(std::uint64_t seen)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true)
+    {
+        cv_start.wait(lock, [&seen](){return stop or generation != seen;});
+        if(stop)
+        {
+            return;
+        }
+        seen = generation;
+        Job *cur = job;
+        lock.unlock();
+        run_chunks(*cur);
+        lock.lock();
+        if(--cur->nactive == 0)
+        {
+            cv_done.notify_all();
+        }
+    }
+}
+
+// Pool is stopped at exit, as joinable threads cannot be destroyed
+struct Finalizer
+{
+    ~Finalizer()
+    {
+        shutdown();
+    }
+};
+
+static Finalizer finalizer;
+
+void init(int nthreads_)
+{
+    if(nthreads_ < 0)
+    {
+        throw std::runtime_error("nthreads < 0");
+    }
+    shutdown();
+    std::lock_guard<std::mutex> loop_lock(loop_mutex);
+    std::lock_guard<std::mutex> lock(mutex);
+    for(int i = 0; i < nthreads_; ++i)
+    {
+        threads.emplace_back(worker, generation);
+    }
+    nthreads = nthreads_;
+}
+
+void shutdown()
+{
+    std::lock_guard<std::mutex> loop_lock(loop_mutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        nthreads = 0;
+    }
+    cv_start.notify_all();
+    for(auto &thread: threads)
+    {
+        thread.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.clear();
+    stop = false;
+}
+
+int get_nthreads()
+{
+    return nthreads;
+}
+
+void set_min_tasks(Index min_tasks_)
+{
+    if(min_tasks_ < 0)
+    {
+        throw std::runtime_error("min_tasks < 0");
+    }
+    min_tasks = min_tasks_;
+}
+
+Index get_min_tasks()
+{
+    return min_tasks;
+}
+
+void parallel_for(Index n, Index ntasks_per_iter,
+        const std::function<void(Index, Index)> &func)
+{
+    if(n <= 0)
+    {
+        return;
+    }
+    if(n == 1 or inside_loop or nthreads == 0
+            or n*ntasks_per_iter < min_tasks
+            or starpu_mpi_world_size() != 1)
+    {
+        func(0, n);
+        return;
+    }
+    std::lock_guard<std::mutex> loop_lock(loop_mutex);
+    Job cur;
+    cur.func = &func;
+    cur.n = n;
+    // Several chunks per thread balance time of submission between threads
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Index nchunks = 4 * (Index(threads.size())+1);
+        cur.chunk = std::max(Index(1), (n+nchunks-1) / nchunks);
+        cur.next = 0;
+        cur.nactive = threads.size();
+        job = &cur;
+        ++generation;
+    }
+    cv_start.notify_all();
+    run_chunks(cur);
+    // Wait for all threads of the pool to finish the job
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv_done.wait(lock, [&cur](){return cur.nactive == 0;});
+        job = nullptr;
+    }
+    if(cur.error)
+    {
+        std::rethrow_exception(cur.error);
+    }
+}
+
+} // namespace nntile::starpu::submitter
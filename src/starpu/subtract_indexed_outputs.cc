@@ -137,13 +137,14 @@ void submit(Index n_labels, Index n_outputs, scal_t val, Handle labels, Handle d
     args->n_labels = n_labels;
     args->n_outputs = n_outputs;
     args->value = val;
+    fp64_t nflops = n_labels;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(labels),
             STARPU_CL_ARGS, args, sizeof(*args),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             //Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(dst),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
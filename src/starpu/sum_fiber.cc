@@ -165,11 +165,13 @@ void submit(Index m, Index n, Index k, Index batch, scal_t alpha, Handle src,
     args->batch = batch;
     args->alpha = alpha;
     args->beta = beta;
+    fp64_t nflops = batch * k * (m*n+2);
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_CL_ARGS, args, sizeof(*args),
             dst_mode, static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
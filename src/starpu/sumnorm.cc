@@ -125,13 +125,13 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst)
         .n = n,
         .k = k
     };
-    //fp64_t nflops = m * n * k;
+    fp64_t nflops = 3 * m * n * k;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_CL_ARGS, args, sizeof(*args),
             Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(dst),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
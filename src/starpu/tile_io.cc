@@ -0,0 +1,165 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/tile_io.cc
+ * Write StarPU buffers into a file and read them back
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu/tile_io.hh"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <unistd.h>
+
+namespace nntile::starpu::tile_io
+{
+
+//! Counter of failed reads and writes
+/*! Codelets can not throw exceptions, so failures are counted and checked by
+ * blocking operations after all the tasks are finished.
+ * */
+static std::atomic<Index> nerrors(0);
+
+//! Write a StarPU buffer into a file on CPU
+void cpu_save(void *buffers[], void *cl_args)
+    noexcept
+{
+#ifndef STARPU_SIMGRID // Run the code only if this is not a simulation
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    std::size_t size = interfaces[0]->elemsize;
+    const char *data = interfaces[0]->get_ptr<char>();
+    // Write until the entire buffer is written
+    std::size_t done = 0;
+    while(done < size)
+    {
+        ssize_t ret = ::pwrite(args->fd, data+done, size-done,
+                args->offset+done);
+        if(ret <= 0)
+        {
+            std::cerr << "[nntile] tile_io: failed to write " << size
+                << " bytes at offset " << args->offset << "\n";
+            ++nerrors;
+            return;
+        }
+        done += ret;
+    }
+#endif // STARPU_SIMGRID
+}
+
+//! Read a StarPU buffer from a file on CPU
+void cpu_load(void *buffers[], void *cl_args)
+    noexcept
+{
+#ifndef STARPU_SIMGRID // Run the code only if this is not a simulation
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    std::size_t size = interfaces[0]->elemsize;
+    char *data = interfaces[0]->get_ptr<char>();
+    // Read until the entire buffer is read
+    std::size_t done = 0;
+    while(done < size)
+    {
+        ssize_t ret = ::pread(args->fd, data+done, size-done,
+                args->offset+done);
+        if(ret <= 0)
+        {
+            std::cerr << "[nntile] tile_io: failed to read " << size
+                << " bytes at offset " << args->offset << "\n";
+            ++nerrors;
+            return;
+        }
+        done += ret;
+    }
+#endif // STARPU_SIMGRID
+}
+
+Codelet codelet_save, codelet_load;
+
+// Files are accessed only from CPU, as data is anyway transferred through
+// the host memory
+void init()
+{
+    codelet_save.init("nntile_tile_io_save",
+            nullptr,
+            {cpu_save},
+            {}
+            );
+    codelet_save.nbuffers = 1;
+    codelet_save.modes[0] = STARPU_R;
+    codelet_load.init("nntile_tile_io_load",
+            nullptr,
+            {cpu_load},
+            {}
+            );
+    codelet_load.nbuffers = 1;
+    codelet_load.modes[0] = STARPU_W;
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_save.restrict_where(where);
+    codelet_load.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_save.restore_where();
+    codelet_load.restore_where();
+}
+
+Index get_nerrors()
+{
+    return nerrors.load();
+}
+
+//! Insert task to write buffer into a file at a given offset
+void submit_save(int fd, Index offset, Handle data)
+{
+    // Codelet arguments
+    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args->fd = fd;
+    args->offset = offset;
+    // Submit task
+    int ret = starpu_task_insert(&codelet_save,
+            STARPU_R, static_cast<starpu_data_handle_t>(data),
+            STARPU_CL_ARGS, args, sizeof(*args),
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in tile_io save task submission");
+    }
+}
+
+//! Insert task to read buffer from a file at a given offset
+void submit_load(int fd, Index offset, Handle data)
+{
+    // Codelet arguments
+    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args->fd = fd;
+    args->offset = offset;
+    // Submit task
+    int ret = starpu_task_insert(&codelet_load,
+            STARPU_W, static_cast<starpu_data_handle_t>(data),
+            STARPU_CL_ARGS, args, sizeof(*args),
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in tile_io load task submission");
+    }
+}
+
+} // namespace nntile::starpu::tile_io
@@ -0,0 +1,145 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/topk_maxsumexp.cc
+ * StarPU wrappers for running top-k and max and sum of exponents
+ *
+ * @version 1.0.0
+ * */
+
+#ifndef STARPU_SIMGRID
+#include "nntile/kernel/topk_maxsumexp.hh"
+#endif // STARPU_SIMGRID
+#include "nntile/starpu/topk_maxsumexp.hh"
+#include <cstdlib>
+
+namespace nntile::starpu::topk_maxsumexp
+{
+
+//! Running top-k and max and sum of exponents of columns on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+#ifndef STARPU_SIMGRID // Run the code only if this is not a simulation
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    T *topk_val = interfaces[1]->get_ptr<T>();
+    Index *topk_idx = interfaces[2]->get_ptr<Index>();
+    T *maxsumexp = interfaces[3]->get_ptr<T>();
+    // Launch kernel
+    kernel::topk_maxsumexp::cpu<T>(args->m, args->n, args->k, args->offset,
+            args->alpha, args->init, src, topk_val, topk_idx, maxsumexp);
+#endif // STARPU_SIMGRID
+}
+
+//! Footprint for topk_maxsumexp tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64, codelet_fp32_fast_tf32;
+
+// No CUDA implementation, as this operation processes a tiny amount of data
+void init()
+{
+    codelet_fp32.init("nntile_topk_maxsumexp_fp32",
+            footprint,
+            {cpu<fp32_t>},
+            {});
+
+    codelet_fp32_fast_tf32.init("nntile_topk_maxsumexp_fp32_fast_tf32",
+            footprint,
+            {cpu<fp32_t>},
+            {});
+
+    codelet_fp64.init("nntile_topk_maxsumexp_fp64",
+            footprint,
+            {cpu<fp64_t>},
+            {});
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp32_fast_tf32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp32_fast_tf32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, Index offset, scal_t alpha,
+        bool init, Handle src, Handle topk_val, Handle topk_idx,
+        Handle maxsumexp)
+//! Insert topk_maxsumexp task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->offset = offset;
+    args->alpha = alpha;
+    args->init = init;
+    // Outputs are overwritten by the first tile of a column
+    enum starpu_data_access_mode mode = init ? STARPU_W : STARPU_RW;
+    fp64_t nflops = m * n * (k+4);
+    // Submit task
+    int ret = starpu_task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            mode, static_cast<starpu_data_handle_t>(topk_val),
+            mode, static_cast<starpu_data_handle_t>(topk_idx),
+            mode, static_cast<starpu_data_handle_t>(maxsumexp),
+            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in topk_maxsumexp task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, Index k, Index offset, scal_t alpha,
+        bool init, Handle src, Handle topk_val, Handle topk_idx,
+        Handle maxsumexp);
+
+template
+void submit<fp32_fast_tf32_t>(Index m, Index n, Index k, Index offset,
+        scal_t alpha, bool init, Handle src, Handle topk_val, Handle topk_idx,
+        Handle maxsumexp);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, Index offset, scal_t alpha,
+        bool init, Handle src, Handle topk_val, Handle topk_idx,
+        Handle maxsumexp);
+
+} // namespace nntile::starpu::topk_maxsumexp
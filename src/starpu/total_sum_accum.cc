@@ -143,6 +143,7 @@ void submit(scal_t alpha, Index n_labels, Index n_outputs, Handle logsumexp, Han
     args->alpha = alpha;
     args->n_labels = n_labels;
     args->n_outputs = n_outputs;
+    fp64_t nflops = 2 * n_labels;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(logsumexp),
@@ -150,6 +151,7 @@ void submit(scal_t alpha, Index n_labels, Index n_outputs, Handle logsumexp, Han
             STARPU_R, static_cast<starpu_data_handle_t>(class_labels),
             STARPU_CL_ARGS, args, sizeof(*args),
             STARPU_RW | STARPU_COMMUTE, static_cast<starpu_data_handle_t>(val),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -0,0 +1,180 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/trace.cc
+ * Lightweight tracer of executed tasks with Chrome trace output
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu/trace.hh"
+#include <atomic>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+
+namespace nntile::starpu::trace
+{
+
+// Maximal number of buffers of a task with stored sizes
+constexpr int EVENT_MAX_BUFFERS = 4;
+
+// Execution of a single task
+struct Event
+{
+    // Name of the codelet, that lives as long as the codelet itself
+    const char *name;
+    // Start and end of execution in nanoseconds since enable()
+    std::int64_t start, end;
+    // Floating point operations of the task
+    double flops;
+    // Number of buffers and sizes of the first of them in bytes
+    int nbuffers;
+    std::int64_t size[EVENT_MAX_BUFFERS];
+};
+
+// Ring buffer of events of a single worker. Only the worker itself writes
+// into its buffer, so the counter of events needs no atomic increments.
+struct WorkerEvents
+{
+    std::vector<Event> events;
+    std::atomic<std::uint64_t> nevents{0};
+};
+
+// Events are recorded only if this flag is set
+static std::atomic<bool> enabled{false};
+
+// Start of recording
+static clock::time_point epoch;
+
+// Buffers of all workers
+static std::vector<WorkerEvents> workers;
+
+void enable(Index capacity)
+{
+    if(capacity <= 0)
+    {
+        throw std::runtime_error("Capacity of trace buffers must be "
+                "positive");
+    }
+    enabled.store(false, std::memory_order_release);
+    // Tasks, that found recording enabled before they started, may still
+    // write into the buffers, so they are finished before buffers are reset
+    if(!workers.empty())
+    {
+        starpu_task_wait_for_all();
+    }
+    // Buffers are allocated once and reallocated only if their size changes
+    std::size_t nworkers = starpu_worker_get_count();
+    if(workers.size() != nworkers
+            or Index(workers[0].events.size()) != capacity)
+    {
+        std::vector<WorkerEvents> new_workers(nworkers);
+        for(auto &worker: new_workers)
+        {
+            worker.events.resize(capacity);
+        }
+        workers.swap(new_workers);
+    }
+    for(auto &worker: workers)
+    {
+        worker.nevents.store(0, std::memory_order_relaxed);
+    }
+    epoch = clock::now();
+    // Buffers and epoch are published to workers, that check is_enabled()
+    enabled.store(true, std::memory_order_release);
+}
+
+void disable()
+{
+    enabled.store(false, std::memory_order_release);
+}
+
+bool is_enabled()
+{
+    return enabled.load(std::memory_order_acquire);
+}
+
+void record(starpu_task *task, clock::time_point start,
+        clock::time_point end)
+{
+    int worker_id = starpu_worker_get_id();
+    if(worker_id < 0 or worker_id >= Index(workers.size()))
+    {
+        return;
+    }
+    auto &worker = workers[worker_id];
+    std::uint64_t i = worker.nevents.load(std::memory_order_relaxed);
+    Event &event = worker.events[i % worker.events.size()];
+    event.name = task->cl->name;
+    event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            start-epoch).count();
+    event.end = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            end-epoch).count();
+    event.flops = task->flops;
+    event.nbuffers = STARPU_TASK_GET_NBUFFERS(task);
+    for(int j = 0; j < event.nbuffers and j < EVENT_MAX_BUFFERS; ++j)
+    {
+        event.size[j] = starpu_data_get_size(
+                STARPU_TASK_GET_HANDLE(task, j));
+    }
+    // Publish the event for dump()
+    worker.nevents.store(i+1, std::memory_order_release);
+}
+
+void dump(const std::string &filename)
+{
+    std::ofstream out(filename);
+    if(!out)
+    {
+        throw std::runtime_error("Cannot open trace file " + filename);
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\": [\n";
+    bool first = true;
+    for(Index worker_id = 0; worker_id < Index(workers.size()); ++worker_id)
+    {
+        // Name of a timeline of the worker
+        char worker_name[64];
+        starpu_worker_get_name(worker_id, worker_name, sizeof(worker_name));
+        out << (first ? "" : ",\n") << "{\"name\": \"thread_name\", "
+            "\"ph\": \"M\", \"pid\": 0, \"tid\": " << worker_id
+            << ", \"args\": {\"name\": \"" << worker_name << "\"}}";
+        first = false;
+        // Only the last events are kept in case of overflow
+        const auto &worker = workers[worker_id];
+        std::uint64_t nevents = worker.nevents.load(
+                std::memory_order_acquire);
+        std::uint64_t capacity = worker.events.size();
+        std::uint64_t begin = nevents > capacity ? nevents-capacity : 0;
+        for(std::uint64_t i = begin; i < nevents; ++i)
+        {
+            const Event &event = worker.events[i % capacity];
+            // Chrome trace expects timestamps in microseconds
+            out << ",\n{\"name\": \"" << event.name << "\", \"cat\": "
+                "\"task\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+                << worker_id << ", \"ts\": " << event.start*1e-3
+                << ", \"dur\": " << (event.end-event.start)*1e-3
+                << ", \"args\": {\"flops\": " << event.flops
+                << ", \"bytes\": [";
+            for(int j = 0; j < event.nbuffers and j < EVENT_MAX_BUFFERS;
+                    ++j)
+            {
+                out << (j == 0 ? "" : ", ") << event.size[j];
+            }
+            out << "]}}";
+        }
+    }
+    out << "\n]}\n";
+    if(!out)
+    {
+        throw std::runtime_error("Cannot write trace file " + filename);
+    }
+}
+
+} // namespace nntile::starpu::trace
@@ -135,12 +135,13 @@ void submit(Index m, Index n, scal_t alpha, Handle src, Handle dst)
     args->m = m;
     args->n = n;
     args->alpha = alpha;
+    fp64_t nflops = m * n;
     // Submit task
     int ret = starpu_task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
             STARPU_CL_ARGS, args, sizeof(*args),
-            // STARPU_FLOPS, nflops);
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -14,6 +14,7 @@
 
 #include "nntile/tensor/adam_step.hh"
 #include "nntile/starpu/adam_step.hh"
+#include "nntile/starpu/copy.hh"
 
 namespace nntile::tensor
 {
@@ -71,6 +72,88 @@ void adam_step_async(Index num_iter, scal_t beta_1, scal_t beta_2, scal_t eps, s
     }
 }
 
+//! Asynchronous tensor-wise Adam step with sharded optimizer state
+template<typename T>
+void adam_step_sharded_async(Index num_iter, scal_t beta_1, scal_t beta_2,
+        scal_t eps, scal_t lr, scal_t weight_decay, const Tensor<T> &grad,
+        const Tensor<T> &first_moment, const Tensor<T> &second_moment,
+        const Tensor<T> &p, const Tensor<T> &p_shard, bool sync_shard)
+{
+    if(p.shape != grad.shape or p.shape != first_moment.shape
+            or p.shape != second_moment.shape or p.shape != p_shard.shape)
+    {
+        throw std::runtime_error("Shapes of parameter, gradient, moments and "
+                "shard shall be equal");
+    }
+    if(p.basetile_shape != grad.basetile_shape
+            or p.basetile_shape != first_moment.basetile_shape
+            or p.basetile_shape != second_moment.basetile_shape
+            or p.basetile_shape != p_shard.basetile_shape)
+    {
+        throw std::runtime_error("Base tiles of parameter, gradient, moments "
+                "and shard shall be equal");
+    }
+    if(first_moment.tile_distr != second_moment.tile_distr
+            or first_moment.tile_distr != p_shard.tile_distr)
+    {
+        throw std::runtime_error("Moments and shard shall have the same "
+                "distribution");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < p.grid.nelems; ++i)
+    {
+        auto p_tile_handle = p.get_tile_handle(i);
+        auto grad_tile_handle = grad.get_tile_handle(i);
+        auto first_moment_tile_handle = first_moment.get_tile_handle(i);
+        auto second_moment_tile_handle = second_moment.get_tile_handle(i);
+        int p_tile_rank = p_tile_handle.mpi_get_rank();
+        int state_tile_rank = first_moment_tile_handle.mpi_get_rank();
+        auto traits = p.get_tile_traits(i);
+        // Update the parameter tile in place if moments are stored with it
+        if(state_tile_rank == p_tile_rank)
+        {
+            grad_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            if(mpi_rank == p_tile_rank)
+            {
+                starpu::adam_step::submit<T>(num_iter, traits.nelems,
+                        beta_1, beta_2, eps, lr, weight_decay,
+                        grad_tile_handle, first_moment_tile_handle,
+                        second_moment_tile_handle, p_tile_handle);
+            }
+            p_tile_handle.mpi_flush();
+            continue;
+        }
+        // Otherwise update the master copy on the owner of moments
+        auto shard_tile_handle = p_shard.get_tile_handle(i);
+        if(sync_shard)
+        {
+            p_tile_handle.mpi_transfer(state_tile_rank, mpi_rank);
+            if(mpi_rank == state_tile_rank)
+            {
+                starpu::copy::submit(p_tile_handle, shard_tile_handle);
+            }
+        }
+        grad_tile_handle.mpi_transfer(state_tile_rank, mpi_rank);
+        if(mpi_rank == state_tile_rank)
+        {
+            starpu::adam_step::submit<T>(num_iter, traits.nelems, beta_1,
+                    beta_2, eps, lr, weight_decay, grad_tile_handle,
+                    first_moment_tile_handle, second_moment_tile_handle,
+                    shard_tile_handle);
+        }
+        // Send the updated tile back and drop cached copies of gradient and
+        // master copy
+        shard_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        if(mpi_rank == p_tile_rank)
+        {
+            starpu::copy::submit(shard_tile_handle, p_tile_handle);
+        }
+        grad_tile_handle.mpi_flush();
+        shard_tile_handle.mpi_flush();
+        p_tile_handle.mpi_flush();
+    }
+}
+
 //! Blocking version of tensor-wise addcdiv operation
 template<typename T>
 void adam_step(Index num_iter, scal_t beta_1, scal_t beta_2, scal_t eps, scal_t lr, scal_t weight_decay,
@@ -114,4 +197,25 @@ void adam_step<fp64_t>(Index num_iter, scal_t beta_1, scal_t beta_2, scal_t eps,
     const Tensor<fp64_t> &grad, const Tensor<fp64_t> &first_moment, const Tensor<fp64_t> &second_moment,
                    const Tensor<fp64_t> &p);
 
+template
+void adam_step_sharded_async<fp32_t>(Index num_iter, scal_t beta_1,
+        scal_t beta_2, scal_t eps, scal_t lr, scal_t weight_decay,
+        const Tensor<fp32_t> &grad, const Tensor<fp32_t> &first_moment,
+        const Tensor<fp32_t> &second_moment, const Tensor<fp32_t> &p,
+        const Tensor<fp32_t> &p_shard, bool sync_shard);
+
+template
+void adam_step_sharded_async<fp32_fast_tf32_t>(Index num_iter, scal_t beta_1,
+        scal_t beta_2, scal_t eps, scal_t lr, scal_t weight_decay,
+        const Tensor<fp32_fast_tf32_t> &grad, const Tensor<fp32_fast_tf32_t> &first_moment,
+        const Tensor<fp32_fast_tf32_t> &second_moment, const Tensor<fp32_fast_tf32_t> &p,
+        const Tensor<fp32_fast_tf32_t> &p_shard, bool sync_shard);
+
+template
+void adam_step_sharded_async<fp64_t>(Index num_iter, scal_t beta_1,
+        scal_t beta_2, scal_t eps, scal_t lr, scal_t weight_decay,
+        const Tensor<fp64_t> &grad, const Tensor<fp64_t> &first_moment,
+        const Tensor<fp64_t> &second_moment, const Tensor<fp64_t> &p,
+        const Tensor<fp64_t> &p_shard, bool sync_shard);
+
 } // namespace nntile::tensor
@@ -14,6 +14,7 @@
 
 #include "nntile/tensor/add.hh"
 #include "nntile/starpu/add.hh"
+#include "nntile/starpu/submitter.hh"
 
 namespace nntile::tensor
 {
@@ -45,27 +46,32 @@ void add_async(scal_t alpha, const Tensor<T> &src, scal_t beta, const Tensor<T>
     {
         return;
     }
-    // Apply per-tile add asynchronously as needed
+    // Apply per-tile add asynchronously as needed. Tiles are independent, so
+    // they may be submitted by several threads.
     int mpi_rank = starpu_mpi_world_rank();
-    for(Index i = 0; i < src.grid.nelems; ++i)
+    auto submit_tiles = [&](Index tile_begin, Index tile_end)
     {
-        // Get handle for corresponding tiles of src and dst
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
-        // MPI rank of the destination tile
-        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
-        // Transfer data
-        src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
-        // Execute only on destination node
-        if(mpi_rank == dst_tile_rank)
+        for(Index i = tile_begin; i < tile_end; ++i)
         {
-            auto traits = src.get_tile_traits(i);
-            starpu::add::submit<T>(traits.nelems, alpha, src_tile_handle, beta,
-                    dst_tile_handle);
+            // Get handle for corresponding tiles of src and dst
+            auto src_tile_handle = src.get_tile_handle(i);
+            auto dst_tile_handle = dst.get_tile_handle(i);
+            // MPI rank of the destination tile
+            int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+            // Transfer data
+            src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            // Execute only on destination node
+            if(mpi_rank == dst_tile_rank)
+            {
+                auto traits = src.get_tile_traits(i);
+                starpu::add::submit<T>(traits.nelems, alpha, src_tile_handle,
+                        beta, dst_tile_handle);
+            }
+            // Flush cache for the output tile on every node
+            dst_tile_handle.mpi_flush();
         }
-        // Flush cache for the output tile on every node
-        dst_tile_handle.mpi_flush();
-    }
+    };
+    starpu::submitter::parallel_for(src.grid.nelems, 1, submit_tiles);
 }
 
 //! Tensor-wise add operation
@@ -434,6 +434,18 @@ void copy_intersection_async<Index>(const Tensor<Index> &src,
         const std::vector<Index> &src_offset, const Tensor<Index> &dst,
         const std::vector<Index> &dst_offset);
 
+template
+void copy_intersection_async<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<bool_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection_async<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &src,
+        const std::vector<Index> &src_offset,
+        const Tensor<fp32_fast_tf32_t> &dst,
+        const std::vector<Index> &dst_offset);
+
 // Explicit instantiation
 template
 void copy_intersection<fp32_t>(const Tensor<fp32_t> &src,
@@ -450,4 +462,16 @@ void copy_intersection<Index>(const Tensor<Index> &src,
         const std::vector<Index> &src_offset, const Tensor<Index> &dst,
         const std::vector<Index> &dst_offset);
 
+template
+void copy_intersection<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<bool_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &src,
+        const std::vector<Index> &src_offset,
+        const Tensor<fp32_fast_tf32_t> &dst,
+        const std::vector<Index> &dst_offset);
+
 } // namespace nntile::tensor
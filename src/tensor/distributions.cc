@@ -13,7 +13,9 @@
  * */
 
 #include "nntile/tensor/distributions.hh"
+#include "nntile/tensor/gemm.hh"
 #include "nntile/tile/traits.hh"
+#include <array>
 
 namespace nntile::tensor::distributions
 {
@@ -56,4 +58,293 @@ std::vector<int> block_cyclic(const std::vector<Index> &tensor_grid,
     return ranks;
 }
 
+std::vector<int> block_cyclic_axes(const std::vector<Index> &tensor_grid,
+        const std::vector<Index> &axes, const std::vector<int> &mpi_grid,
+        int start_rank, int max_rank)
+{
+    // Check if dimensions of mpi grid and selected axes match
+    if(axes.size() != mpi_grid.size())
+    {
+        throw std::runtime_error("Wrong number of dimensions");
+    }
+    const Index ndim = tensor_grid.size();
+    for(Index j = 0; j < axes.size(); ++j)
+    {
+        if(axes[j] < 0 or axes[j] >= ndim)
+        {
+            throw std::runtime_error("Invalid axis");
+        }
+    }
+    // Grid of tiles, reduced to the selected axes only
+    std::vector<Index> axes_grid(axes.size());
+    for(Index j = 0; j < axes.size(); ++j)
+    {
+        axes_grid[j] = tensor_grid[axes[j]];
+    }
+    // Block-cyclic distribution of the reduced grid checks all other inputs
+    auto axes_ranks = block_cyclic(axes_grid, mpi_grid, start_rank,
+            max_rank);
+    const tile::TileTraits traits(tensor_grid),
+          axes_traits(axes_grid);
+    // Each tile inherits rank of its projection onto selected axes
+    std::vector<int> ranks(traits.nelems, -1);
+    std::vector<Index> axes_index(axes.size());
+    for(Index i = 0; i < traits.nelems; ++i)
+    {
+        auto index = traits.linear_to_index(i);
+        for(Index j = 0; j < axes.size(); ++j)
+        {
+            axes_index[j] = index[axes[j]];
+        }
+        ranks[i] = axes_ranks[axes_traits.index_to_linear(axes_index)];
+    }
+    return ranks;
+}
+
+//! Get shape of a grid of tiles as a matrix
+static std::array<Index, 2> matrix_grid_shape(
+        const std::vector<Index> &tensor_grid, Index ndim_rows)
+{
+    if(ndim_rows < 0 or ndim_rows > tensor_grid.size())
+    {
+        throw std::runtime_error("Invalid ndim_rows");
+    }
+    std::array<Index, 2> shape{1, 1};
+    for(Index j = 0; j < ndim_rows; ++j)
+    {
+        shape[0] *= tensor_grid[j];
+    }
+    for(Index j = ndim_rows; j < tensor_grid.size(); ++j)
+    {
+        shape[1] *= tensor_grid[j];
+    }
+    return shape;
+}
+
+std::vector<int> matrix_block_cyclic(const std::vector<Index> &tensor_grid,
+        Index ndim_rows, int p, int q, int start_rank, int max_rank)
+{
+    // Distribution of a tensor is the same as for its matrix view, since
+    // tiles of both are enumerated in the same Fortran order
+    auto shape = matrix_grid_shape(tensor_grid, ndim_rows);
+    return block_cyclic({shape[0], shape[1]}, {p, q}, start_rank, max_rank);
+}
+
+std::vector<int> matrix_block_cyclic_2_5d(
+        const std::vector<Index> &tensor_grid, Index ndim_rows, int p, int q,
+        int c, Index layer_dim, int start_rank, int max_rank)
+{
+    auto shape = matrix_grid_shape(tensor_grid, ndim_rows);
+    // Check parameters of the grid of ranks
+    if(p <= 0 or q <= 0 or c <= 0)
+    {
+        throw std::runtime_error("Invalid grid of ranks");
+    }
+    if(layer_dim != 0 and layer_dim != 1)
+    {
+        throw std::runtime_error("Invalid layer_dim");
+    }
+    if(start_rank < 0 or start_rank >= max_rank)
+    {
+        throw std::runtime_error("Invalid starting rank");
+    }
+    std::vector<int> ranks(shape[0]*shape[1], -1);
+    for(Index j = 0; j < shape[1]; ++j)
+    {
+        for(Index i = 0; i < shape[0]; ++i)
+        {
+            // Index within a layer and index of the layer itself
+            std::array<Index, 2> index{i, j};
+            Index layer = index[layer_dim] % c;
+            index[layer_dim] /= c;
+            int mpi_rank = (layer*q+index[1]%q)*p + index[0]%p;
+            ranks[j*shape[0]+i] = (mpi_rank+start_rank) % max_rank;
+        }
+    }
+    return ranks;
+}
+
+//! Geometry of the gemm_async loop over tiles
+struct gemm_grid_t
+{
+    Index m, n, k, batch;
+    std::array<Index, 2> opA_stride, opB_stride;
+    gemm_grid_t(const TransOp &transA, const TensorTraits &A,
+            const TransOp &transB, const TensorTraits &C, Index ndim,
+            Index batch_ndim)
+    {
+        m = C.grid.matrix_shape[A.ndim-batch_ndim-ndim][0];
+        batch = C.grid.matrix_shape[C.ndim-batch_ndim][1];
+        n = C.grid.matrix_shape[A.ndim-batch_ndim-ndim][1] / batch;
+        switch(transA.value)
+        {
+            case TransOp::NoTrans:
+                k = A.grid.matrix_shape[A.ndim-batch_ndim-ndim][1] / batch;
+                opA_stride = {1, m};
+                break;
+            case TransOp::Trans:
+                k = A.grid.matrix_shape[ndim][0];
+                opA_stride = {k, 1};
+                break;
+        }
+        switch(transB.value)
+        {
+            case TransOp::NoTrans:
+                opB_stride = {1, k};
+                break;
+            case TransOp::Trans:
+                opB_stride = {n, 1};
+                break;
+        }
+    }
+    Index A_offset(Index i, Index l, Index b) const
+    {
+        return opA_stride[0]*i + opA_stride[1]*l + b*m*k;
+    }
+    Index B_offset(Index l, Index j, Index b) const
+    {
+        return opB_stride[0]*l + opB_stride[1]*j + b*n*k;
+    }
+    Index C_offset(Index i, Index j, Index b) const
+    {
+        return (b*n+j)*m + i;
+    }
+};
+
+//! Check if distribution fits a grid of tiles and a number of ranks
+static void check_distr(const TensorTraits &traits,
+        const std::vector<int> &distr, int max_rank)
+{
+    if(distr.size() != traits.grid.nelems)
+    {
+        throw std::runtime_error("Wrong distribution");
+    }
+    for(Index i = 0; i < distr.size(); ++i)
+    {
+        if(distr[i] < 0 or distr[i] >= max_rank)
+        {
+            throw std::runtime_error("Invalid rank in distribution");
+        }
+    }
+}
+
+//! Number of elements of a tile with given linear offset
+static Index tile_nelems(const TensorTraits &traits, Index offset)
+{
+    auto tile_shape = traits.get_tile_shape(traits.grid.linear_to_index(
+                offset));
+    Index nelems = 1;
+    for(Index j = 0; j < traits.ndim; ++j)
+    {
+        nelems *= tile_shape[j];
+    }
+    return nelems;
+}
+
+std::pair<std::vector<int>, std::vector<int>> gemm_owner_compute(
+        const TransOp &transA, const TensorTraits &A, const TransOp &transB,
+        const TensorTraits &B, const TensorTraits &C,
+        const std::vector<int> &C_distr, Index ndim, Index batch_ndim)
+{
+    gemm_check(transA, A, transB, B, C, ndim, batch_ndim);
+    if(C_distr.size() != C.grid.nelems)
+    {
+        throw std::runtime_error("Wrong distribution");
+    }
+    gemm_grid_t g(transA, A, transB, C, ndim, batch_ndim);
+    std::vector<int> A_distr(A.grid.nelems, -1), B_distr(B.grid.nelems, -1);
+    for(Index b = 0; b < g.batch; ++b)
+    {
+        for(Index l = 0; l < g.k; ++l)
+        {
+            for(Index i = 0; i < g.m; ++i)
+            {
+                A_distr[g.A_offset(i, l, b)] = C_distr[g.C_offset(i, l%g.n,
+                        b)];
+            }
+            for(Index j = 0; j < g.n; ++j)
+            {
+                B_distr[g.B_offset(l, j, b)] = C_distr[g.C_offset(l%g.m, j,
+                        b)];
+            }
+        }
+    }
+    return {A_distr, B_distr};
+}
+
+std::vector<Index> gemm_transfer_bytes(const TransOp &transA,
+        const TensorTraits &A, const std::vector<int> &A_distr,
+        const TransOp &transB, const TensorTraits &B,
+        const std::vector<int> &B_distr, const TensorTraits &C,
+        const std::vector<int> &C_distr, Index ndim, Index batch_ndim,
+        Index elem_size, int max_rank)
+{
+    gemm_check(transA, A, transB, B, C, ndim, batch_ndim);
+    check_distr(A, A_distr, max_rank);
+    check_distr(B, B_distr, max_rank);
+    check_distr(C, C_distr, max_rank);
+    gemm_grid_t g(transA, A, transB, C, ndim, batch_ndim);
+    // Flags if a tile of A or B is already cached by a rank
+    std::vector<bool> A_cached(A.grid.nelems*max_rank, false),
+        B_cached(B.grid.nelems*max_rank, false);
+    std::vector<Index> bytes(max_rank, 0);
+    for(Index b = 0; b < g.batch; ++b)
+    {
+        for(Index j = 0; j < g.n; ++j)
+        {
+            for(Index i = 0; i < g.m; ++i)
+            {
+                int C_rank = C_distr[g.C_offset(i, j, b)];
+                for(Index l = 0; l < g.k; ++l)
+                {
+                    Index A_offset = g.A_offset(i, l, b);
+                    Index B_offset = g.B_offset(l, j, b);
+                    if(A_distr[A_offset] != C_rank
+                            and !A_cached[A_offset*max_rank+C_rank])
+                    {
+                        A_cached[A_offset*max_rank+C_rank] = true;
+                        bytes[C_rank] += elem_size * tile_nelems(A, A_offset);
+                    }
+                    if(B_distr[B_offset] != C_rank
+                            and !B_cached[B_offset*max_rank+C_rank])
+                    {
+                        B_cached[B_offset*max_rank+C_rank] = true;
+                        bytes[C_rank] += elem_size * tile_nelems(B, B_offset);
+                    }
+                }
+            }
+        }
+    }
+    return bytes;
+}
+
+std::vector<Index> tilewise_transfer_bytes(const TensorTraits &traits,
+        const std::vector<int> &src_distr, const std::vector<int> &dst_distr,
+        Index elem_size, int max_rank)
+{
+    check_distr(traits, src_distr, max_rank);
+    check_distr(traits, dst_distr, max_rank);
+    std::vector<Index> bytes(max_rank, 0);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        if(src_distr[i] != dst_distr[i])
+        {
+            bytes[dst_distr[i]] += elem_size * tile_nelems(traits, i);
+        }
+    }
+    return bytes;
+}
+
+std::vector<Index> memory_bytes(const TensorTraits &traits,
+        const std::vector<int> &distr, Index elem_size, int max_rank)
+{
+    check_distr(traits, distr, max_rank);
+    std::vector<Index> bytes(max_rank, 0);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        bytes[distr[i]] += elem_size * tile_nelems(traits, i);
+    }
+    return bytes;
+}
+
 } // namespace nntile::tensor::distributions
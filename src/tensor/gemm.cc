@@ -14,6 +14,7 @@
 
 #include "nntile/tensor/gemm.hh"
 #include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/submitter.hh"
 
 namespace nntile::tensor
 {
@@ -375,99 +376,102 @@ void gemm_async(scal_t alpha, const TransOp &transA, const Tensor<T> &A,
             opB_stride = {n, 1};
             break;
     }
-    // All per-tile starpu gemm calls shall appear here
-    for(Index b = 0; b < batch; ++b)
+    // All per-tile starpu gemm calls shall appear here. Tiles of C are
+    // independent, so their tasks may be submitted by several threads, while
+    // all k tasks of a single tile of C are submitted by a single thread.
+    auto submit_tiles = [&](Index C_tile_begin, Index C_tile_end)
     {
-        for(Index j = 0; j < n; ++j)
+        for(Index C_tile_offset = C_tile_begin; C_tile_offset < C_tile_end;
+                ++C_tile_offset)
         {
-            for(Index i = 0; i < m; ++i)
+            Index i = C_tile_offset % m;
+            Index j = C_tile_offset / m % n;
+            Index b = C_tile_offset / (m*n);
+            auto C_tile_handle = C.get_tile_handle(C_tile_offset);
+            auto C_tile_traits = C.get_tile_traits(C_tile_offset);
+            int C_tile_rank = C_tile_handle.mpi_get_rank();
+            Index tile_m = C_tile_traits.matrix_shape[
+                A.ndim-batch_ndim-ndim][0];
+            Index tile_batch = C_tile_traits.matrix_shape[
+                C.ndim-batch_ndim][1];
+            Index tile_n = C_tile_traits.matrix_shape[
+                A.ndim-batch_ndim-ndim][1] / tile_batch;
+            // initialize C(i,j,b) = a*opA(i,0,b)*opB(0,j,b) + b*C(i,j,b)
+            Index A_tile_offset = opA_stride[0]*i + b*m*k;
+            Index B_tile_offset = opB_stride[1]*j + b*n*k;
+            auto A_first_tile_handle = A.get_tile_handle(A_tile_offset);
+            auto B_first_tile_handle = B.get_tile_handle(B_tile_offset);
+            int A_first_tile_rank = A_first_tile_handle.mpi_get_rank();
+            int B_first_tile_rank = B_first_tile_handle.mpi_get_rank();
+            // Transfer first tile A on node with tile C
+            A_first_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            // Transfer first tile B on node with tile C
+            B_first_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            // Execute on node with tile C
+            if(mpi_rank == C_tile_rank)
             {
-                Index C_tile_offset = (b*n+j)*m + i;
-                auto C_tile_handle = C.get_tile_handle(C_tile_offset);
-                auto C_tile_traits = C.get_tile_traits(C_tile_offset);
-                int C_tile_rank = C_tile_handle.mpi_get_rank();
-                Index tile_m = C_tile_traits.matrix_shape[
-                    A.ndim-batch_ndim-ndim][0];
-                Index tile_batch = C_tile_traits.matrix_shape[
-                    C.ndim-batch_ndim][1];
-                Index tile_n = C_tile_traits.matrix_shape[
-                    A.ndim-batch_ndim-ndim][1] / tile_batch;
-                // initialize C(i,j,b) = a*opA(i,0,b)*opB(0,j,b) + b*C(i,j,b)
-                Index A_tile_offset = opA_stride[0]*i + b*m*k;
-                Index B_tile_offset = opB_stride[1]*j + b*n*k;
-                auto A_first_tile_handle = A.get_tile_handle(A_tile_offset);
-                auto B_first_tile_handle = B.get_tile_handle(B_tile_offset);
-                int A_first_tile_rank = A_first_tile_handle.mpi_get_rank();
-                int B_first_tile_rank = B_first_tile_handle.mpi_get_rank();
-                // Transfer first tile A on node with tile C
-                A_first_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
-                // Transfer first tile B on node with tile C
-                B_first_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+                Index tile_k;
+                auto A_first_tile_traits = A.get_tile_traits(
+                        A_tile_offset);
+                switch(transA.value)
+                {
+                    case TransOp::NoTrans:
+                        tile_k = A_first_tile_traits.matrix_shape[
+                            A.ndim-batch_ndim-ndim][1] / tile_batch;
+                        break;
+                        // This parameter was already checked
+                        //case TransOp::Trans:
+                    default:
+                        tile_k = A_first_tile_traits.matrix_shape[ndim][0];
+                        break;
+                }
+                starpu::gemm::submit<T>(transA, transB, tile_m,
+                        tile_n,
+                        tile_k, tile_batch, alpha, A_first_tile_handle,
+                        B_first_tile_handle, beta, C_tile_handle, redux);
+            }
+            // all other l>0
+            for(Index l = 1; l < k; ++l)
+            {
+                // accumulate C(i,j,b) = a*opA(i,l,b)*opB(l,j,b) + C(i,j,b)
+                A_tile_offset += opA_stride[1];
+                B_tile_offset += opB_stride[0];
+                auto A_tile_handle = A.get_tile_handle(A_tile_offset);
+                auto B_tile_handle = B.get_tile_handle(B_tile_offset);
+                int A_tile_rank = A_tile_handle.mpi_get_rank();
+                int B_tile_rank = B_tile_handle.mpi_get_rank();
+                // Transfer tile A on node with tile C
+                A_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+                // Transfer tile B on node with tile C
+                B_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
                 // Execute on node with tile C
                 if(mpi_rank == C_tile_rank)
                 {
                     Index tile_k;
-                    auto A_first_tile_traits = A.get_tile_traits(
-                            A_tile_offset);
+                    auto A_tile_traits = A.get_tile_traits(A_tile_offset);
                     switch(transA.value)
                     {
                         case TransOp::NoTrans:
-                            tile_k = A_first_tile_traits.matrix_shape[
+                            tile_k = A_tile_traits.matrix_shape[
                                 A.ndim-batch_ndim-ndim][1] / tile_batch;
                             break;
                             // This parameter was already checked
                             //case TransOp::Trans:
                         default:
-                            tile_k = A_first_tile_traits.matrix_shape[ndim][0];
+                            tile_k = A_tile_traits.matrix_shape[ndim][0];
                             break;
                     }
                     starpu::gemm::submit<T>(transA, transB, tile_m,
                             tile_n,
-                            tile_k, tile_batch, alpha, A_first_tile_handle,
-                            B_first_tile_handle, beta, C_tile_handle, redux);
+                            tile_k, tile_batch, alpha, A_tile_handle,
+                            B_tile_handle, one, C_tile_handle, redux);
                 }
-                // all other l>0
-                for(Index l = 1; l < k; ++l)
-                {
-                    // accumulate C(i,j,b) = a*opA(i,l,b)*opB(l,j,b) + C(i,j,b)
-                    A_tile_offset += opA_stride[1];
-                    B_tile_offset += opB_stride[0];
-                    auto A_tile_handle = A.get_tile_handle(A_tile_offset);
-                    auto B_tile_handle = B.get_tile_handle(B_tile_offset);
-                    int A_tile_rank = A_tile_handle.mpi_get_rank();
-                    int B_tile_rank = B_tile_handle.mpi_get_rank();
-                    // Transfer tile A on node with tile C
-                    A_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
-                    // Transfer tile B on node with tile C
-                    B_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
-                    // Execute on node with tile C
-                    if(mpi_rank == C_tile_rank)
-                    {
-                        Index tile_k;
-                        auto A_tile_traits = A.get_tile_traits(A_tile_offset);
-                        switch(transA.value)
-                        {
-                            case TransOp::NoTrans:
-                                tile_k = A_tile_traits.matrix_shape[
-                                    A.ndim-batch_ndim-ndim][1] / tile_batch;
-                                break;
-                                // This parameter was already checked
-                                //case TransOp::Trans:
-                            default:
-                                tile_k = A_tile_traits.matrix_shape[ndim][0];
-                                break;
-                        }
-                        starpu::gemm::submit<T>(transA, transB, tile_m,
-                                tile_n,
-                                tile_k, tile_batch, alpha, A_tile_handle,
-                                B_tile_handle, one, C_tile_handle, redux);
-                    }
-                }
-                // Flush cache for the output tile on every node
-                C_tile_handle.mpi_flush();
             }
+            // Flush cache for the output tile on every node
+            C_tile_handle.mpi_flush();
         }
-    }
+    };
+    starpu::submitter::parallel_for(batch*n*m, k, submit_tiles);
 }
 
 //! Blocking version of tensor-wise gemm operation
@@ -0,0 +1,476 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/paged_attention.cc
+ * Attention of new positions to keys and values, stored in paged caches
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/paged_attention.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/starpu/clear.hh"
+#include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/mask_scalar.hh"
+#include "nntile/starpu/maxsumexp.hh"
+#include "nntile/starpu/softmax_inplace.hh"
+#include <limits>
+
+namespace nntile::tensor
+{
+
+// Check that pool of blocks has shape (head_size, block_size, n_blocks,
+// n_head) with a single tile per block and a given tiling of heads
+template<typename T>
+static void check_pool(const Tensor<T> &pool, Index head_size, Index n_head,
+        Index n_head_tile)
+{
+    if(pool.ndim != 4)
+    {
+        throw std::runtime_error("pool.ndim != 4");
+    }
+    if(pool.shape[0] != head_size)
+    {
+        throw std::runtime_error("pool.shape[0] != head_size");
+    }
+    if(pool.shape[3] != n_head)
+    {
+        throw std::runtime_error("pool.shape[3] != n_head");
+    }
+    if(pool.basetile_shape[0] != pool.shape[0])
+    {
+        throw std::runtime_error("pool.basetile_shape[0] != pool.shape[0]");
+    }
+    if(pool.basetile_shape[1] != pool.shape[1])
+    {
+        throw std::runtime_error("pool.basetile_shape[1] != pool.shape[1]");
+    }
+    if(pool.basetile_shape[2] != 1)
+    {
+        throw std::runtime_error("pool.basetile_shape[2] != 1");
+    }
+    if(pool.basetile_shape[3] != n_head_tile)
+    {
+        throw std::runtime_error("pool.basetile_shape[3] != n_head_tile");
+    }
+}
+
+// Check that a tensor has shape (head_size, 1, n_batch, n_head) with a single
+// tile per sequence
+template<typename T>
+static void check_new_positions(const Tensor<T> &X)
+{
+    if(X.ndim != 4)
+    {
+        throw std::runtime_error("X.ndim != 4");
+    }
+    if(X.shape[1] != 1)
+    {
+        throw std::runtime_error("X.shape[1] != 1");
+    }
+    if(X.basetile_shape[0] != X.shape[0])
+    {
+        throw std::runtime_error("X.basetile_shape[0] != X.shape[0]");
+    }
+    if(X.basetile_shape[2] != 1)
+    {
+        throw std::runtime_error("X.basetile_shape[2] != 1");
+    }
+}
+
+//! Asynchronous store of new keys or values into blocks of a paged cache
+/*! Pool of a paged cache is a (head_size, block_size, n_blocks, n_head)
+ * tensor, whose tiles are blocks of block_size positions of a range of
+ * heads. Key (or value) of a new position of sequence b is stored at
+ * position offset[b] of block block[b]. Negative block means the sequence
+ * is not stored.
+ *
+ * @param[in] src: Tensor of shape (head_size, 1, n_batch, n_head)
+ * @param[inout] pool: Pool of blocks
+ * @param[in] block: Block for each sequence of a batch
+ * @param[in] offset: Position within the block for each sequence of a batch
+ * */
+template<typename T>
+void paged_kv_store_async(const Tensor<T> &src, const Tensor<T> &pool,
+        const std::vector<Index> &block, const std::vector<Index> &offset)
+{
+    // Check inputs
+    check_new_positions(src);
+    check_pool(pool, src.shape[0], src.shape[3], src.basetile_shape[3]);
+    Index n_batch = src.shape[2], n_blocks = pool.shape[2],
+          block_size = pool.shape[1];
+    if(block.size() != n_batch)
+    {
+        throw std::runtime_error("block.size() != n_batch");
+    }
+    if(offset.size() != n_batch)
+    {
+        throw std::runtime_error("offset.size() != n_batch");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    // Temporary buffer for indexing, that is allocated per-worker when needed
+    starpu::VariableHandle scratch(2*4*sizeof(Index), STARPU_SCRATCH);
+    std::vector<Index> src_start{0, 0, 0, 0}, dst_start{0, 0, 0, 0};
+    for(Index b = 0; b < n_batch; ++b)
+    {
+        // Skip sequences, that are not stored
+        if(block[b] < 0)
+        {
+            continue;
+        }
+        if(block[b] >= n_blocks)
+        {
+            throw std::runtime_error("block[b] >= n_blocks");
+        }
+        if(offset[b] < 0 or offset[b] >= block_size)
+        {
+            throw std::runtime_error("offset[b] is out of block");
+        }
+        dst_start[1] = offset[b];
+        for(Index h = 0; h < src.grid.shape[3]; ++h)
+        {
+            std::vector<Index> src_tile_index{0, 0, b, h},
+                dst_tile_index{0, 0, block[b], h};
+            auto src_tile_handle = src.get_tile_handle(src_tile_index);
+            auto src_tile_traits = src.get_tile_traits(src_tile_index);
+            auto dst_tile_handle = pool.get_tile_handle(dst_tile_index);
+            auto dst_tile_traits = pool.get_tile_traits(dst_tile_index);
+            int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+            // Transfer source tile to dest node
+            src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            // Execute on destination node
+            if(mpi_rank == dst_tile_rank)
+            {
+                starpu::subcopy::submit<T>(4, src_start,
+                        src_tile_traits.stride, dst_start,
+                        dst_tile_traits.stride, src_tile_traits.shape,
+                        src_tile_handle, dst_tile_handle, scratch, STARPU_RW);
+            }
+            // Flush cache for the output tile on every node
+            dst_tile_handle.mpi_flush();
+        }
+    }
+}
+
+//! Blocking version of store into blocks of a paged cache
+template<typename T>
+void paged_kv_store(const Tensor<T> &src, const Tensor<T> &pool,
+        const std::vector<Index> &block, const std::vector<Index> &offset)
+{
+    paged_kv_store_async<T>(src, pool, block, offset);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronous attention to keys and values, stored in paged caches
+/*! A single new position of each sequence b attends to positions of blocks
+ * block_table[b] of pools of keys and values, that are allowed by the mask
+ * of filled positions of blocks. Only blocks of a sequence take part in
+ * computations, so the amount of work and memory is proportional to the
+ * actual length of the sequence instead of the capacity of caches. Softmax
+ * is computed over all the blocks of a sequence at once, as maximums and
+ * sums of exponents are accumulated block by block. Output of a sequence
+ * with an empty block table is set to zero.
+ *
+ * @param[in] alpha: Scaling factor of scores, usually 1/sqrt(head_size)
+ * @param[in] Q: Queries of shape (head_size, 1, n_batch, n_head)
+ * @param[in] K_pool: Pool of blocks of keys of shape (head_size, block_size,
+ *      n_blocks, n_head)
+ * @param[in] V_pool: Pool of blocks of values of the same shape
+ * @param[in] block_mask: Filled positions of blocks of shape (block_size,
+ *      n_blocks)
+ * @param[in] block_table: Blocks of each sequence of a batch
+ * @param[scratch] A: Scores of shape (block_size, 1, max_blocks, n_batch,
+ *      n_head)
+ * @param[scratch] maxsumexp: Maximums and sums of exponents of scores of
+ *      shape (2, 1, n_batch, n_head)
+ * @param[out] B: Output of shape (head_size, 1, n_batch, n_head)
+ * */
+template<typename T>
+void paged_attention_async(scal_t alpha, const Tensor<T> &Q,
+        const Tensor<T> &K_pool, const Tensor<T> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<T> &A, const Tensor<T> &maxsumexp, const Tensor<T> &B)
+{
+    // Check inputs
+    check_new_positions(Q);
+    check_new_positions(B);
+    if(Q.shape != B.shape)
+    {
+        throw std::runtime_error("Q.shape != B.shape");
+    }
+    if(Q.basetile_shape != B.basetile_shape)
+    {
+        throw std::runtime_error("Q.basetile_shape != B.basetile_shape");
+    }
+    Index head_size = Q.shape[0], n_batch = Q.shape[2], n_head = Q.shape[3],
+          n_head_tile = Q.basetile_shape[3];
+    check_pool(K_pool, head_size, n_head, n_head_tile);
+    check_pool(V_pool, head_size, n_head, n_head_tile);
+    if(K_pool.shape != V_pool.shape)
+    {
+        throw std::runtime_error("K_pool.shape != V_pool.shape");
+    }
+    Index block_size = K_pool.shape[1], n_blocks = K_pool.shape[2];
+    if(block_mask.ndim != 2)
+    {
+        throw std::runtime_error("block_mask.ndim != 2");
+    }
+    if(block_mask.shape[0] != block_size)
+    {
+        throw std::runtime_error("block_mask.shape[0] != block_size");
+    }
+    if(block_mask.shape[1] != n_blocks)
+    {
+        throw std::runtime_error("block_mask.shape[1] != n_blocks");
+    }
+    if(block_mask.basetile_shape[0] != block_size)
+    {
+        throw std::runtime_error("block_mask.basetile_shape[0] != "
+                "block_size");
+    }
+    if(block_mask.basetile_shape[1] != 1)
+    {
+        throw std::runtime_error("block_mask.basetile_shape[1] != 1");
+    }
+    std::vector<Index> A_shape{block_size, 1, A.shape[2], n_batch, n_head},
+        A_basetile{block_size, 1, 1, 1, n_head_tile};
+    if(A.ndim != 5)
+    {
+        throw std::runtime_error("A.ndim != 5");
+    }
+    if(A.shape != A_shape)
+    {
+        throw std::runtime_error("Invalid shape of A");
+    }
+    if(A.basetile_shape != A_basetile)
+    {
+        throw std::runtime_error("Invalid basetile shape of A");
+    }
+    Index max_blocks = A.shape[2];
+    std::vector<Index> maxsumexp_shape{2, 1, n_batch, n_head},
+        maxsumexp_basetile{2, 1, 1, n_head_tile};
+    if(maxsumexp.shape != maxsumexp_shape)
+    {
+        throw std::runtime_error("Invalid shape of maxsumexp");
+    }
+    if(maxsumexp.basetile_shape != maxsumexp_basetile)
+    {
+        throw std::runtime_error("Invalid basetile shape of maxsumexp");
+    }
+    if(block_table.size() != n_batch)
+    {
+        throw std::runtime_error("block_table.size() != n_batch");
+    }
+    for(Index b = 0; b < n_batch; ++b)
+    {
+        if(block_table[b].size() > max_blocks)
+        {
+            throw std::runtime_error("block_table[b].size() > max_blocks");
+        }
+        for(Index blk: block_table[b])
+        {
+            if(blk < 0 or blk >= n_blocks)
+            {
+                throw std::runtime_error("Invalid block in block_table");
+            }
+        }
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    TransOp opT(TransOp::Trans), opN(TransOp::NoTrans);
+    constexpr scal_t zero = 0.0, one = 1.0;
+    constexpr scal_t minus_inf = -std::numeric_limits<scal_t>::infinity();
+    for(Index b = 0; b < n_batch; ++b)
+    {
+        Index nblocks_b = block_table[b].size();
+        for(Index h = 0; h < Q.grid.shape[3]; ++h)
+        {
+            std::vector<Index> tile_index{0, 0, b, h};
+            auto Q_tile_handle = Q.get_tile_handle(tile_index);
+            auto B_tile_handle = B.get_tile_handle(tile_index);
+            auto maxsumexp_tile_handle = maxsumexp.get_tile_handle(
+                    tile_index);
+            int B_tile_rank = B_tile_handle.mpi_get_rank();
+            int maxsumexp_tile_rank = maxsumexp_tile_handle.mpi_get_rank();
+            Index batch = Q.get_tile_traits(tile_index).shape[3];
+            // Sequence without blocks gets zero output
+            if(nblocks_b == 0)
+            {
+                if(mpi_rank == B_tile_rank)
+                {
+                    starpu::clear::submit(B_tile_handle);
+                }
+                B_tile_handle.mpi_flush();
+                continue;
+            }
+            if(mpi_rank == maxsumexp_tile_rank)
+            {
+                starpu::clear::submit(maxsumexp_tile_handle);
+            }
+            // Scores of each block and their maximums and sums of exponents
+            for(Index j = 0; j < nblocks_b; ++j)
+            {
+                Index blk = block_table[b][j];
+                auto K_tile_handle = K_pool.get_tile_handle({0, 0, blk, h});
+                auto mask_tile_handle = block_mask.get_tile_handle({0, blk});
+                auto A_tile_handle = A.get_tile_handle({0, 0, j, b, h});
+                int A_tile_rank = A_tile_handle.mpi_get_rank();
+                K_tile_handle.mpi_transfer(A_tile_rank, mpi_rank);
+                Q_tile_handle.mpi_transfer(A_tile_rank, mpi_rank);
+                mask_tile_handle.mpi_transfer(A_tile_rank, mpi_rank);
+                if(mpi_rank == A_tile_rank)
+                {
+                    starpu::gemm::submit<T>(opT, opN, block_size, 1,
+                            head_size, batch, alpha, K_tile_handle,
+                            Q_tile_handle, zero, A_tile_handle);
+                    starpu::mask_scalar::submit<T>(block_size, batch,
+                            mask_tile_handle, minus_inf, A_tile_handle);
+                }
+                A_tile_handle.mpi_transfer(maxsumexp_tile_rank, mpi_rank);
+                if(mpi_rank == maxsumexp_tile_rank)
+                {
+                    starpu::maxsumexp::submit<T>(1, batch, block_size,
+                            A_tile_handle, maxsumexp_tile_handle);
+                }
+            }
+            // Softmax of scores of each block and its product with values
+            for(Index j = 0; j < nblocks_b; ++j)
+            {
+                Index blk = block_table[b][j];
+                auto V_tile_handle = V_pool.get_tile_handle({0, 0, blk, h});
+                auto A_tile_handle = A.get_tile_handle({0, 0, j, b, h});
+                int A_tile_rank = A_tile_handle.mpi_get_rank();
+                maxsumexp_tile_handle.mpi_transfer(A_tile_rank, mpi_rank);
+                if(mpi_rank == A_tile_rank)
+                {
+                    starpu::softmax_inplace::submit<T>(1, batch, block_size,
+                            maxsumexp_tile_handle, one, A_tile_handle);
+                }
+                V_tile_handle.mpi_transfer(B_tile_rank, mpi_rank);
+                A_tile_handle.mpi_transfer(B_tile_rank, mpi_rank);
+                if(mpi_rank == B_tile_rank)
+                {
+                    starpu::gemm::submit<T>(opN, opN, head_size, 1,
+                            block_size, batch, one, V_tile_handle,
+                            A_tile_handle, j == 0 ? zero : one,
+                            B_tile_handle);
+                }
+                A_tile_handle.mpi_flush();
+            }
+            // Flush cache for the output tiles on every node
+            maxsumexp_tile_handle.mpi_flush();
+            B_tile_handle.mpi_flush();
+        }
+    }
+}
+
+//! Blocking version of attention to keys and values in paged caches
+template<typename T>
+void paged_attention(scal_t alpha, const Tensor<T> &Q,
+        const Tensor<T> &K_pool, const Tensor<T> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<T> &A, const Tensor<T> &maxsumexp, const Tensor<T> &B)
+{
+    paged_attention_async<T>(alpha, Q, K_pool, V_pool, block_mask,
+            block_table, A, maxsumexp, B);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void paged_kv_store_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &pool, const std::vector<Index> &block,
+        const std::vector<Index> &offset);
+
+template
+void paged_kv_store_async<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &src,
+        const Tensor<fp32_fast_tf32_t> &pool, const std::vector<Index> &block,
+        const std::vector<Index> &offset);
+
+template
+void paged_kv_store_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &pool, const std::vector<Index> &block,
+        const std::vector<Index> &offset);
+
+// Explicit instantiation
+template
+void paged_kv_store<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &pool, const std::vector<Index> &block,
+        const std::vector<Index> &offset);
+
+template
+void paged_kv_store<fp32_fast_tf32_t>(const Tensor<fp32_fast_tf32_t> &src,
+        const Tensor<fp32_fast_tf32_t> &pool, const std::vector<Index> &block,
+        const std::vector<Index> &offset);
+
+template
+void paged_kv_store<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &pool, const std::vector<Index> &block,
+        const std::vector<Index> &offset);
+
+// Explicit instantiation
+template
+void paged_attention_async<fp32_t>(scal_t alpha, const Tensor<fp32_t> &Q,
+        const Tensor<fp32_t> &K_pool, const Tensor<fp32_t> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<fp32_t> &A, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &B);
+
+template
+void paged_attention_async<fp32_fast_tf32_t>(scal_t alpha,
+        const Tensor<fp32_fast_tf32_t> &Q,
+        const Tensor<fp32_fast_tf32_t> &K_pool,
+        const Tensor<fp32_fast_tf32_t> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<fp32_fast_tf32_t> &A,
+        const Tensor<fp32_fast_tf32_t> &maxsumexp,
+        const Tensor<fp32_fast_tf32_t> &B);
+
+template
+void paged_attention_async<fp64_t>(scal_t alpha, const Tensor<fp64_t> &Q,
+        const Tensor<fp64_t> &K_pool, const Tensor<fp64_t> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<fp64_t> &A, const Tensor<fp64_t> &maxsumexp,
+        const Tensor<fp64_t> &B);
+
+// Explicit instantiation
+template
+void paged_attention<fp32_t>(scal_t alpha, const Tensor<fp32_t> &Q,
+        const Tensor<fp32_t> &K_pool, const Tensor<fp32_t> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<fp32_t> &A, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &B);
+
+template
+void paged_attention<fp32_fast_tf32_t>(scal_t alpha,
+        const Tensor<fp32_fast_tf32_t> &Q,
+        const Tensor<fp32_fast_tf32_t> &K_pool,
+        const Tensor<fp32_fast_tf32_t> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<fp32_fast_tf32_t> &A,
+        const Tensor<fp32_fast_tf32_t> &maxsumexp,
+        const Tensor<fp32_fast_tf32_t> &B);
+
+template
+void paged_attention<fp64_t>(scal_t alpha, const Tensor<fp64_t> &Q,
+        const Tensor<fp64_t> &K_pool, const Tensor<fp64_t> &V_pool,
+        const Tensor<bool_t> &block_mask,
+        const std::vector<std::vector<Index>> &block_table,
+        const Tensor<fp64_t> &A, const Tensor<fp64_t> &maxsumexp,
+        const Tensor<fp64_t> &B);
+
+} // namespace nntile::tensor
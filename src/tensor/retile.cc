@@ -0,0 +1,212 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/retile.cc
+ * Conversion of a tensor into another tiling
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/retile.hh"
+#include "nntile/starpu/retile.hh"
+#include <algorithm>
+
+namespace nntile::tensor
+{
+
+//! Asynchronous conversion of a tensor into another tiling
+/*! Source and destination tensors have the same shape, but may have
+ * different base tiles and distributions. Intersections of tiles are found
+ * independently for each dimension, so the work is proportional to the
+ * number of destination tiles times the number of their overlaps with
+ * source tiles. Each destination tile is gathered by a single task on its
+ * owner node from all the source tiles, that overlap it. A destination tile,
+ * that coincides with a source tile, is simply copied.
+ *
+ * @param[in] src: Source tensor
+ * @param[out] dst: Destination tensor
+ * */
+template<typename T>
+void retile_async(const Tensor<T> &src, const Tensor<T> &dst)
+{
+    // Check shapes
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    Index ndim = src.ndim;
+    // Overlap of a destination tile with a source tile along a dimension
+    struct part_t
+    {
+        Index src_index;
+        Index src_start;
+        Index dst_start;
+        Index size;
+    };
+    // Overlaps of all destination tiles along each dimension
+    std::vector<std::vector<std::vector<part_t>>> parts(ndim);
+    for(Index k = 0; k < ndim; ++k)
+    {
+        Index src_tile = src.basetile_shape[k];
+        Index dst_tile = dst.basetile_shape[k];
+        parts[k].resize(dst.grid.shape[k]);
+        for(Index j = 0; j < dst.grid.shape[k]; ++j)
+        {
+            Index begin = j * dst_tile;
+            Index end = std::min(begin+dst_tile, dst.shape[k]);
+            for(Index s = begin / src_tile; s*src_tile < end; ++s)
+            {
+                Index lo = std::max(begin, s*src_tile);
+                Index hi = std::min(end, (s+1)*src_tile);
+                parts[k][j].push_back({s, lo-s*src_tile, lo-begin, hi-lo});
+            }
+        }
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    int ret;
+    std::vector<Index> dst_tile_index(ndim), part_index(ndim),
+        src_tile_index(ndim);
+    std::vector<Index> info;
+    std::vector<starpu::Handle> src_tile_handles;
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        auto dst_tile_handle = dst.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        auto dst_tile_traits = dst.get_tile_traits(i);
+        // Number of overlapping source tiles
+        Index nsrc = 1;
+        for(Index k = 0; k < ndim; ++k)
+        {
+            nsrc *= parts[k][dst_tile_index[k]].size();
+            part_index[k] = 0;
+        }
+        info.resize(4*ndim*nsrc);
+        src_tile_handles.resize(nsrc);
+        bool same_tile = false;
+        // Cycle through all overlapping source tiles
+        for(Index j = 0; j < nsrc; ++j)
+        {
+            Index *src_stride = info.data() + 4*ndim*j;
+            Index *src_start = src_stride + ndim;
+            Index *dst_start = src_start + ndim;
+            Index *copy_shape = dst_start + ndim;
+            for(Index k = 0; k < ndim; ++k)
+            {
+                const auto &part = parts[k][dst_tile_index[k]][part_index[k]];
+                src_tile_index[k] = part.src_index;
+                src_start[k] = part.src_start;
+                dst_start[k] = part.dst_start;
+                copy_shape[k] = part.size;
+            }
+            Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
+            auto src_tile_traits = src.get_tile_traits(src_tile_offset);
+            std::copy(src_tile_traits.stride.cbegin(),
+                    src_tile_traits.stride.cend(), src_stride);
+            src_tile_handles[j] = src.get_tile_handle(src_tile_offset);
+            same_tile = nsrc == 1 and src_tile_traits.shape
+                == dst_tile_traits.shape;
+            // Transfer source tile to dest node
+            src_tile_handles[j].mpi_transfer(dst_tile_rank, mpi_rank);
+            // Get next overlapping source tile
+            for(Index k = 0; k < ndim; ++k)
+            {
+                ++part_index[k];
+                if(part_index[k] < Index(parts[k][dst_tile_index[k]].size()))
+                {
+                    break;
+                }
+                part_index[k] = 0;
+            }
+        }
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            // Simple copy of coinciding tiles
+            if(same_tile)
+            {
+                ret = starpu_data_cpy(
+                        static_cast<starpu_data_handle_t>(dst_tile_handle),
+                        static_cast<starpu_data_handle_t>(
+                            src_tile_handles[0]),
+                        1, nullptr, nullptr);
+                if(ret != 0)
+                {
+                    throw std::runtime_error("Error in starpu_data_cpy");
+                }
+            }
+            else
+            {
+                starpu::retile::submit<T>(ndim, dst_tile_traits.stride, info,
+                        src_tile_handles, dst_tile_handle);
+            }
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+        // Get next destination tile
+        for(Index k = 0; k < ndim; ++k)
+        {
+            ++dst_tile_index[k];
+            if(dst_tile_index[k] < dst.grid.shape[k])
+            {
+                break;
+            }
+            dst_tile_index[k] = 0;
+        }
+    }
+}
+
+//! Blocking version of conversion of a tensor into another tiling
+/*! @param[in] src: Source tensor
+ * @param[out] dst: Destination tensor
+ * */
+template<typename T>
+void retile(const Tensor<T> &src, const Tensor<T> &dst)
+{
+    retile_async<T>(src, dst);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void retile_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst);
+
+template
+void retile_async<fp32_fast_tf32_t>(const Tensor<fp32_fast_tf32_t> &src,
+        const Tensor<fp32_fast_tf32_t> &dst);
+
+template
+void retile_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst);
+
+template
+void retile_async<Index>(const Tensor<Index> &src, const Tensor<Index> &dst);
+
+template
+void retile_async<bool_t>(const Tensor<bool_t> &src,
+        const Tensor<bool_t> &dst);
+
+// Explicit instantiation
+template
+void retile<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst);
+
+template
+void retile<fp32_fast_tf32_t>(const Tensor<fp32_fast_tf32_t> &src,
+        const Tensor<fp32_fast_tf32_t> &dst);
+
+template
+void retile<fp64_t>(const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst);
+
+template
+void retile<Index>(const Tensor<Index> &src, const Tensor<Index> &dst);
+
+template
+void retile<bool_t>(const Tensor<bool_t> &src, const Tensor<bool_t> &dst);
+
+} // namespace nntile::tensor
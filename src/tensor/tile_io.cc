@@ -0,0 +1,257 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/tile_io.cc
+ * Write tiles of a tensor into a file and read them back
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/tile_io.hh"
+#include "nntile/starpu/tile_io.hh"
+
+namespace nntile::tensor
+{
+
+//! Offsets of tiles of a tensor, stored in a file one after another
+/*! Tiles are stored in the order of the grid of tiles, each tile starting at
+ * an offset, aligned to a given number of bytes, so that tiles can be
+ * accessed by different nodes and threads independently and memory mapped.
+ *
+ * @param[in] traits: Shape and tiling of a tensor
+ * @param[in] elemsize: Size of a single element in bytes
+ * @param[in] offset: Offset of the first tile, that shall be aligned
+ * @param[in] alignment: Alignment of tiles in bytes
+ * @return Vector of grid.nelems+1 values, where the last value is the end of
+ *      the last tile, aligned to the alignment
+ * */
+std::vector<Index> tile_offsets(const TensorTraits &traits,
+        Index elemsize, Index offset, Index alignment)
+{
+    if(elemsize <= 0)
+    {
+        throw std::runtime_error("elemsize <= 0");
+    }
+    if(alignment <= 0)
+    {
+        throw std::runtime_error("alignment <= 0");
+    }
+    if(offset % alignment != 0)
+    {
+        throw std::runtime_error("offset % alignment != 0");
+    }
+    std::vector<Index> offsets(traits.grid.nelems+1);
+    offsets[0] = offset;
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        auto tile_index = traits.grid.linear_to_index(i);
+        auto tile_shape = traits.get_tile_shape(tile_index);
+        Index nbytes = elemsize;
+        for(Index j = 0; j < traits.ndim; ++j)
+        {
+            nbytes *= tile_shape[j];
+        }
+        offsets[i+1] = offsets[i] + (nbytes-1)/alignment*alignment
+            + alignment;
+    }
+    return offsets;
+}
+
+//! Check that offsets of tiles are consistent with the tensor
+template<typename T>
+static void check_offsets(const Tensor<T> &tensor,
+        const std::vector<Index> &offsets)
+{
+    if(Index(offsets.size()) != tensor.grid.nelems+1)
+    {
+        throw std::runtime_error("offsets.size() != grid.nelems+1");
+    }
+    for(Index i = 0; i < tensor.grid.nelems; ++i)
+    {
+        Index nbytes = tensor.get_tile_traits(i).nelems * sizeof(T);
+        if(offsets[i]+nbytes > offsets[i+1])
+        {
+            throw std::runtime_error("Tiles overlap in the file");
+        }
+    }
+}
+
+//! Write tiles of a tensor into a file
+/*! Each tile is written by a StarPU task on the node, that owns the tile, so
+ * that tiles are written in parallel without gathering them. All the nodes
+ * shall open the same file.
+ *
+ * @param[in] src: Source tensor
+ * @param[in] fd: Descriptor of a file, opened for writing
+ * @param[in] offsets: Offsets of tiles, computed by tile_offsets()
+ * */
+template<typename T>
+void save_tiles_async(const Tensor<T> &src, int fd,
+        const std::vector<Index> &offsets)
+{
+    check_offsets<T>(src, offsets);
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        auto tile_handle = src.get_tile_handle(i);
+        // Execute on source node
+        if(mpi_rank == tile_handle.mpi_get_rank())
+        {
+            starpu::tile_io::submit_save(fd, offsets[i], tile_handle);
+        }
+    }
+}
+
+//! Blocking version of write of tiles into a file
+/*! Throws an exception if any of the tiles failed to be written. */
+template<typename T>
+void save_tiles(const Tensor<T> &src, int fd,
+        const std::vector<Index> &offsets)
+{
+    Index nerrors = starpu::tile_io::get_nerrors();
+    save_tiles_async<T>(src, fd, offsets);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+    if(starpu::tile_io::get_nerrors() != nerrors)
+    {
+        throw std::runtime_error("Failed to write tiles");
+    }
+}
+
+//! Read tiles of a tensor from a file
+/*! Each tile is read directly into the buffer of the tile by a StarPU task
+ * on the node, that owns the tile, without any intermediate copies.
+ *
+ * @param[out] dst: Destination tensor
+ * @param[in] fd: Descriptor of a file, opened for reading
+ * @param[in] offsets: Offsets of tiles, computed by tile_offsets()
+ * */
+template<typename T>
+void load_tiles_async(const Tensor<T> &dst, int fd,
+        const std::vector<Index> &offsets)
+{
+    check_offsets<T>(dst, offsets);
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        auto tile_handle = dst.get_tile_handle(i);
+        // Execute on destination node
+        if(mpi_rank == tile_handle.mpi_get_rank())
+        {
+            starpu::tile_io::submit_load(fd, offsets[i], tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of read of tiles from a file
+/*! Throws an exception if any of the tiles failed to be read. */
+template<typename T>
+void load_tiles(const Tensor<T> &dst, int fd,
+        const std::vector<Index> &offsets)
+{
+    Index nerrors = starpu::tile_io::get_nerrors();
+    load_tiles_async<T>(dst, fd, offsets);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+    if(starpu::tile_io::get_nerrors() != nerrors)
+    {
+        throw std::runtime_error("Failed to read tiles");
+    }
+}
+
+// Explicit instantiation
+template
+void save_tiles_async<fp32_t>(const Tensor<fp32_t> &src, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void save_tiles_async<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &src, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void save_tiles_async<fp64_t>(const Tensor<fp64_t> &src, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void save_tiles_async<Index>(const Tensor<Index> &src, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void save_tiles_async<bool_t>(const Tensor<bool_t> &src, int fd,
+        const std::vector<Index> &offsets);
+
+// Explicit instantiation
+template
+void save_tiles<fp32_t>(const Tensor<fp32_t> &src, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void save_tiles<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &src, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void save_tiles<fp64_t>(const Tensor<fp64_t> &src, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void save_tiles<Index>(const Tensor<Index> &src, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void save_tiles<bool_t>(const Tensor<bool_t> &src, int fd,
+        const std::vector<Index> &offsets);
+
+// Explicit instantiation
+template
+void load_tiles_async<fp32_t>(const Tensor<fp32_t> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void load_tiles_async<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void load_tiles_async<fp64_t>(const Tensor<fp64_t> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void load_tiles_async<Index>(const Tensor<Index> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void load_tiles_async<bool_t>(const Tensor<bool_t> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+// Explicit instantiation
+template
+void load_tiles<fp32_t>(const Tensor<fp32_t> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void load_tiles<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void load_tiles<fp64_t>(const Tensor<fp64_t> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void load_tiles<Index>(const Tensor<Index> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+template
+void load_tiles<bool_t>(const Tensor<bool_t> &dst, int fd,
+        const std::vector<Index> &offsets);
+
+} // namespace nntile::tensor
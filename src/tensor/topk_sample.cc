@@ -0,0 +1,232 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/topk_sample.cc
+ * Sample tokens from logits through running top-k candidates
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/topk_sample.hh"
+#include "nntile/starpu/topk_maxsumexp.hh"
+#include "nntile/starpu/sample_topk.hh"
+
+namespace nntile::tensor
+{
+
+//! Sample tokens from logits through running top-k candidates
+/*! Logits of shape [vocab, ...] are consumed tile by tile along the first
+ * axis, updating k largest values of alpha*logits of each column with their
+ * indices together with the maximum and the sum of exponents of the column.
+ * A token of each column is then sampled from the candidates (see
+ * kernel::sample_topk), so that logits never leave the nodes, that own
+ * them, and only indices of tokens are gathered.
+ *
+ * @param[in] alpha: Inverse of temperature
+ * @param[in] logits: Input tensor of shape [vocab, ...]
+ * @param[out] topk_val: Candidate values of shape [k, ...]
+ * @param[out] topk_idx: Candidate indices of shape [k, ...]
+ * @param[out] maxsumexp: Maximums and sums of exponents of shape [2, ...]
+ * @param[in] top_k: Number of allowed candidates, non-positive means k
+ * @param[in] top_p: Probability of nucleus, non-positive means greedy choice
+ * @param[in] seed: Random seed
+ * @param[out] tokens: Sampled tokens of shape [...]
+ * */
+template<typename T>
+void topk_sample_async(scal_t alpha, const Tensor<T> &logits,
+        const Tensor<T> &topk_val, const Tensor<Index> &topk_idx,
+        const Tensor<T> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens)
+{
+    // Check dimensions
+    if(logits.ndim < 2)
+    {
+        throw std::runtime_error("logits.ndim < 2");
+    }
+    if(logits.ndim != topk_val.ndim)
+    {
+        throw std::runtime_error("logits.ndim != topk_val.ndim");
+    }
+    if(logits.ndim != topk_idx.ndim)
+    {
+        throw std::runtime_error("logits.ndim != topk_idx.ndim");
+    }
+    if(logits.ndim != maxsumexp.ndim)
+    {
+        throw std::runtime_error("logits.ndim != maxsumexp.ndim");
+    }
+    if(logits.ndim != tokens.ndim+1)
+    {
+        throw std::runtime_error("logits.ndim != tokens.ndim+1");
+    }
+    // Check shapes
+    if(topk_val.shape[0] != topk_val.basetile_shape[0])
+    {
+        throw std::runtime_error("topk_val.shape[0] != "
+                "topk_val.basetile_shape[0]");
+    }
+    if(topk_val.shape[0] != topk_idx.shape[0])
+    {
+        throw std::runtime_error("topk_val.shape[0] != topk_idx.shape[0]");
+    }
+    if(topk_idx.basetile_shape[0] != topk_idx.shape[0])
+    {
+        throw std::runtime_error("topk_idx.basetile_shape[0] != "
+                "topk_idx.shape[0]");
+    }
+    if(maxsumexp.shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.shape[0] != 2");
+    }
+    if(maxsumexp.basetile_shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.basetile_shape[0] != 2");
+    }
+    for(Index i = 1; i < logits.ndim; ++i)
+    {
+        if(logits.shape[i] != tokens.shape[i-1]
+                or topk_val.shape[i] != tokens.shape[i-1]
+                or topk_idx.shape[i] != tokens.shape[i-1]
+                or maxsumexp.shape[i] != tokens.shape[i-1])
+        {
+            throw std::runtime_error("Inconsistent shapes of columns");
+        }
+        if(logits.basetile_shape[i] != tokens.basetile_shape[i-1]
+                or topk_val.basetile_shape[i] != tokens.basetile_shape[i-1]
+                or topk_idx.basetile_shape[i] != tokens.basetile_shape[i-1]
+                or maxsumexp.basetile_shape[i] != tokens.basetile_shape[i-1])
+        {
+            throw std::runtime_error("Inconsistent basetile shapes of "
+                    "columns");
+        }
+    }
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    Index k = topk_val.shape[0];
+    for(Index i = 0; i < tokens.grid.nelems; ++i)
+    {
+        auto tokens_tile_index = tokens.grid.linear_to_index(i);
+        auto tokens_tile_traits = tokens.get_tile_traits(i);
+        // Candidates of the column tile are gathered on owner of topk_val
+        std::vector<Index> tile_index(logits.ndim);
+        for(Index j = 1; j < logits.ndim; ++j)
+        {
+            tile_index[j] = tokens_tile_index[j-1];
+        }
+        tile_index[0] = 0;
+        Index cand_offset = topk_val.grid.index_to_linear(tile_index);
+        auto val_handle = topk_val.get_tile_handle(cand_offset);
+        auto idx_handle = topk_idx.get_tile_handle(cand_offset);
+        auto mse_handle = maxsumexp.get_tile_handle(cand_offset);
+        int cand_rank = val_handle.mpi_get_rank();
+        if(idx_handle.mpi_get_rank() != cand_rank
+                or mse_handle.mpi_get_rank() != cand_rank)
+        {
+            throw std::runtime_error("Tiles of candidates shall be owned by "
+                    "the same node");
+        }
+        Index n = tokens_tile_traits.nelems;
+        for(Index j = 0; j < logits.grid.shape[0]; ++j)
+        {
+            tile_index[0] = j;
+            Index src_offset = logits.grid.index_to_linear(tile_index);
+            auto src_handle = logits.get_tile_handle(src_offset);
+            // Transfer data
+            src_handle.mpi_transfer(cand_rank, mpi_rank);
+            // Execute on node of candidates
+            if(mpi_rank == cand_rank)
+            {
+                Index m = logits.get_tile_traits(src_offset).shape[0];
+                starpu::topk_maxsumexp::submit<T>(m, n, k,
+                        j*logits.basetile_shape[0], alpha, j == 0,
+                        src_handle, val_handle, idx_handle, mse_handle);
+            }
+        }
+        // Random numbers are indexed by the global index of the first column
+        // of the tile, so results do not depend on tiling along the last
+        // tiled axis of columns
+        Index col_offset = 0;
+        for(Index j = 0; j < tokens.ndim; ++j)
+        {
+            col_offset += tokens_tile_index[j] * tokens.basetile_shape[j]
+                * tokens.stride[j];
+        }
+        auto tokens_handle = tokens.get_tile_handle(i);
+        int tokens_rank = tokens_handle.mpi_get_rank();
+        val_handle.mpi_transfer(tokens_rank, mpi_rank);
+        idx_handle.mpi_transfer(tokens_rank, mpi_rank);
+        mse_handle.mpi_transfer(tokens_rank, mpi_rank);
+        if(mpi_rank == tokens_rank)
+        {
+            starpu::sample_topk::submit<T>(n, k, top_k, top_p, seed,
+                    col_offset, val_handle, idx_handle, mse_handle,
+                    tokens_handle);
+        }
+        // Flush cache for the output tiles on every node
+        val_handle.mpi_flush();
+        idx_handle.mpi_flush();
+        mse_handle.mpi_flush();
+        tokens_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void topk_sample(scal_t alpha, const Tensor<T> &logits,
+        const Tensor<T> &topk_val, const Tensor<Index> &topk_idx,
+        const Tensor<T> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens)
+{
+    topk_sample_async<T>(alpha, logits, topk_val, topk_idx, maxsumexp, top_k,
+            top_p, seed, tokens);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void topk_sample_async<fp32_t>(scal_t alpha, const Tensor<fp32_t> &logits,
+        const Tensor<fp32_t> &topk_val, const Tensor<Index> &topk_idx,
+        const Tensor<fp32_t> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens);
+
+template
+void topk_sample_async<fp32_fast_tf32_t>(scal_t alpha,
+        const Tensor<fp32_fast_tf32_t> &logits,
+        const Tensor<fp32_fast_tf32_t> &topk_val,
+        const Tensor<Index> &topk_idx,
+        const Tensor<fp32_fast_tf32_t> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens);
+
+template
+void topk_sample_async<fp64_t>(scal_t alpha, const Tensor<fp64_t> &logits,
+        const Tensor<fp64_t> &topk_val, const Tensor<Index> &topk_idx,
+        const Tensor<fp64_t> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens);
+
+// Explicit instantiation
+template
+void topk_sample<fp32_t>(scal_t alpha, const Tensor<fp32_t> &logits,
+        const Tensor<fp32_t> &topk_val, const Tensor<Index> &topk_idx,
+        const Tensor<fp32_t> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens);
+
+template
+void topk_sample<fp32_fast_tf32_t>(scal_t alpha,
+        const Tensor<fp32_fast_tf32_t> &logits,
+        const Tensor<fp32_fast_tf32_t> &topk_val,
+        const Tensor<Index> &topk_idx,
+        const Tensor<fp32_fast_tf32_t> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens);
+
+template
+void topk_sample<fp64_t>(scal_t alpha, const Tensor<fp64_t> &logits,
+        const Tensor<fp64_t> &topk_val, const Tensor<Index> &topk_idx,
+        const Tensor<fp64_t> &maxsumexp, Index top_k, scal_t top_p,
+        unsigned long long seed, const Tensor<Index> &tokens);
+
+} // namespace nntile::tensor
@@ -0,0 +1,205 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/view.cc
+ * Views of tensors, that share tiles without copying data
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/view.hh"
+
+namespace nntile::tensor
+{
+
+//! View of a slice of a tensor, aligned to borders of tiles
+/*! The view consists of tiles of the source tensor, so operations on the
+ * view read and update the source tensor without any copies. Each border of
+ * the slice shall be a border of tiles of the source tensor, as tiles are
+ * registered as contiguous buffers and can not be cut.
+ *
+ * @param[in] src: Source tensor
+ * @param[in] begin: Start of the slice in each dimension
+ * @param[in] end: End of the slice (exclusive) in each dimension
+ * */
+template<typename T>
+Tensor<T> slice_view(const Tensor<T> &src, const std::vector<Index> &begin,
+        const std::vector<Index> &end)
+{
+    // Check arguments
+    if(begin.size() != src.ndim)
+    {
+        throw std::runtime_error("begin.size() != src.ndim");
+    }
+    if(end.size() != src.ndim)
+    {
+        throw std::runtime_error("end.size() != src.ndim");
+    }
+    std::vector<Index> shape(src.ndim), tile_begin(src.ndim);
+    for(Index i = 0; i < src.ndim; ++i)
+    {
+        if(begin[i] < 0 or begin[i] >= end[i] or end[i] > src.shape[i])
+        {
+            throw std::runtime_error("Invalid slice");
+        }
+        if(begin[i] % src.basetile_shape[i] != 0
+                or (end[i] % src.basetile_shape[i] != 0
+                    and end[i] != src.shape[i]))
+        {
+            throw std::runtime_error("Slice is not aligned to tiles");
+        }
+        shape[i] = end[i] - begin[i];
+        tile_begin[i] = begin[i] / src.basetile_shape[i];
+    }
+    TensorTraits traits(shape, src.basetile_shape);
+    std::vector<starpu::VariableHandle> handles;
+    std::vector<int> distr;
+    handles.reserve(traits.grid.nelems);
+    distr.reserve(traits.grid.nelems);
+    std::vector<Index> src_tile_index(src.ndim);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        auto tile_index = traits.grid.linear_to_index(i);
+        for(Index j = 0; j < src.ndim; ++j)
+        {
+            src_tile_index[j] = tile_begin[j] + tile_index[j];
+        }
+        Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
+        handles.push_back(src.tile_handles[src_tile_offset]);
+        distr.push_back(src.tile_distr[src_tile_offset]);
+    }
+    return Tensor<T>(traits, handles, distr, src.next_tag);
+}
+
+//! View of a tensor with split or merged dimensions
+/*! Dimensions of the source and the view are split into groups of equal
+ * sizes, where either the source or the view has a single dimension. Such a
+ * reshape keeps the order of elements of each tile only if all the split
+ * dimensions of a group, except the last one, are not tiled and the merged
+ * dimension is tiled accordingly. For example, a tensor of shape
+ * (head_size*n_head) with base tile (head_size*n_head_tile) is viewed as a
+ * tensor of shape (head_size, n_head) with base tile (head_size,
+ * n_head_tile). The view consists of the same tiles as the source tensor.
+ *
+ * @param[in] src: Source tensor
+ * @param[in] shape: Shape of the view
+ * @param[in] basetile_shape: Shape of base tile of the view
+ * */
+template<typename T>
+Tensor<T> reshape_view(const Tensor<T> &src, const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape)
+{
+    TensorTraits traits(shape, basetile_shape);
+    if(traits.nelems != src.nelems)
+    {
+        throw std::runtime_error("Wrong number of elements");
+    }
+    // Check groups of dimensions
+    Index i = 0, j = 0;
+    while(i < src.ndim and j < traits.ndim)
+    {
+        // Find the next group of dimensions with equal sizes
+        Index i_end = i+1, j_end = j+1;
+        Index src_size = src.shape[i], dst_size = traits.shape[j];
+        while(src_size != dst_size)
+        {
+            if(src_size < dst_size)
+            {
+                src_size *= src.shape[i_end];
+                ++i_end;
+            }
+            else
+            {
+                dst_size *= traits.shape[j_end];
+                ++j_end;
+            }
+        }
+        if(i_end-i > 1 and j_end-j > 1)
+        {
+            throw std::runtime_error("Dimensions are neither split nor "
+                    "merged");
+        }
+        // Traits of the merged and split sides of the group
+        const TensorTraits &merged = (i_end-i == 1) ? src : traits;
+        const TensorTraits &split = (i_end-i == 1) ? traits : src;
+        Index merged_dim = (i_end-i == 1) ? i : j;
+        Index split_begin = (i_end-i == 1) ? j : i;
+        Index split_end = (i_end-i == 1) ? j_end : i_end;
+        Index inner = 1;
+        for(Index k = split_begin; k < split_end-1; ++k)
+        {
+            if(split.basetile_shape[k] != split.shape[k])
+            {
+                throw std::runtime_error("Inner split dimension is tiled");
+            }
+            inner *= split.shape[k];
+        }
+        if(merged.basetile_shape[merged_dim]
+                != inner*split.basetile_shape[split_end-1])
+        {
+            throw std::runtime_error("Tiles of split and merged dimensions "
+                    "do not match");
+        }
+        i = i_end;
+        j = j_end;
+    }
+    // Remaining dimensions are of size 1, so grids of tiles are the same up
+    // to dimensions with a single tile and tiles keep their order
+    std::vector<int> distr(src.tile_distr);
+    return Tensor<T>(traits, src.tile_handles, distr, src.next_tag);
+}
+
+// Explicit instantiation
+template
+Tensor<fp32_t> slice_view<fp32_t>(const Tensor<fp32_t> &src,
+        const std::vector<Index> &begin, const std::vector<Index> &end);
+
+template
+Tensor<fp32_fast_tf32_t> slice_view<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &src,
+        const std::vector<Index> &begin, const std::vector<Index> &end);
+
+template
+Tensor<fp64_t> slice_view<fp64_t>(const Tensor<fp64_t> &src,
+        const std::vector<Index> &begin, const std::vector<Index> &end);
+
+template
+Tensor<Index> slice_view<Index>(const Tensor<Index> &src,
+        const std::vector<Index> &begin, const std::vector<Index> &end);
+
+template
+Tensor<bool_t> slice_view<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<Index> &begin, const std::vector<Index> &end);
+
+template
+Tensor<fp32_t> reshape_view<fp32_t>(const Tensor<fp32_t> &src,
+        const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape);
+
+template
+Tensor<fp32_fast_tf32_t> reshape_view<fp32_fast_tf32_t>(
+        const Tensor<fp32_fast_tf32_t> &src,
+        const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape);
+
+template
+Tensor<fp64_t> reshape_view<fp64_t>(const Tensor<fp64_t> &src,
+        const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape);
+
+template
+Tensor<Index> reshape_view<Index>(const Tensor<Index> &src,
+        const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape);
+
+template
+Tensor<bool_t> reshape_view<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape);
+
+} // namespace nntile::tensor
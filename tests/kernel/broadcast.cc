@@ -0,0 +1,146 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/broadcast.cc
+ * Generic broadcasting elementwise loops for CPU kernels
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/kernel/broadcast.hh"
+#include "nntile/kernel/add_fiber.hh"
+#include "nntile/kernel/prod_slice.hh"
+#include "nntile/kernel/prod_fiber3.hh"
+#include "../testing.hh"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel;
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k, Index batch)
+{
+    using namespace broadcast;
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const Index shape[4] = {m, k, n, batch};
+    // Init test input
+    std::vector<T> full(m*k*n*batch), slice(m*n), fiber(k*batch);
+    for(Index i = 0; i < Index(full.size()); ++i)
+    {
+        full[i] = T(i%13) / T{7} - T{1};
+    }
+    for(Index i = 0; i < Index(slice.size()); ++i)
+    {
+        slice[i] = T(i%5+1) / T{3};
+    }
+    for(Index i = 0; i < Index(fiber.size()); ++i)
+    {
+        fiber[i] = T(i%3) - T{1};
+    }
+    // Fused bias and ReLU with a slice and a fiber
+    std::cout << "Run kernel::broadcast::apply<T>\n";
+    std::vector<T> dst(full.size());
+    apply(shape, [](T &y, T x, T s, T f)
+            {
+                T v = x + s*f;
+                y = v > 0 ? v : 0;
+            },
+            operand<FULL>(shape, &dst[0]), operand<FULL>(shape, &full[0]),
+            operand<M|N>(shape, &slice[0]), operand<K|B>(shape, &fiber[0]));
+    for(Index b = 0; b < batch; ++b)
+    {
+        for(Index i2 = 0; i2 < n; ++i2)
+        {
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                for(Index i0 = 0; i0 < m; ++i0)
+                {
+                    Index i = ((b*n+i2)*k+i1)*m + i0;
+                    T v = full[i] + slice[i2*m+i0]*fiber[b*k+i1];
+                    T val_ref = v > 0 ? v : 0;
+                    TEST_ASSERT(std::abs(dst[i]-val_ref) <= 10*eps);
+                }
+            }
+        }
+    }
+    // Reduction into a broadcasted output
+    std::vector<T> sum(k*batch, T{0});
+    apply(shape, [](T &y, T x){ y += x; }, operand<K|B>(shape, &sum[0]),
+            operand<FULL>(shape, &full[0]));
+    for(Index b = 0; b < batch; ++b)
+    {
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            T val_ref = 0, norm = 0;
+            for(Index i2 = 0; i2 < n; ++i2)
+            {
+                for(Index i0 = 0; i0 < m; ++i0)
+                {
+                    T x = full[((b*n+i2)*k+i1)*m+i0];
+                    val_ref += x;
+                    norm += std::abs(x);
+                }
+            }
+            TEST_ASSERT(std::abs(sum[b*k+i1]-val_ref) <= 10*eps*norm);
+        }
+    }
+    std::cout << "OK: kernel::broadcast::apply<T>\n";
+    // Kernels of slices and fibers, built on top of broadcasting loops
+    std::cout << "Run kernels of slices and fibers\n";
+    dst = full;
+    add_fiber::cpu<T>(m, n, k, batch, T{2}, &fiber[0], T{-1}, &dst[0]);
+    for(Index i = 0; i < Index(full.size()); ++i)
+    {
+        Index i1 = (i/m) % k, b = i / (m*k*n);
+        TEST_ASSERT(std::abs(dst[i]-T{2}*fiber[b*k+i1]+full[i]) <= 10*eps);
+    }
+    dst = full;
+    add_fiber::cpu<T>(m, n, k, batch, T{2}, &fiber[0], T{0}, &dst[0]);
+    for(Index i = 0; i < Index(full.size()); ++i)
+    {
+        Index i1 = (i/m) % k, b = i / (m*k*n);
+        TEST_ASSERT(std::abs(dst[i]-T{2}*fiber[b*k+i1]) <= 10*eps);
+    }
+    Index mkn = m * k * n;
+    dst.resize(mkn);
+    std::copy(full.begin(), full.begin()+mkn, dst.begin());
+    prod_slice::cpu<T>(m, n, k, T{3}, &slice[0], &dst[0]);
+    for(Index i = 0; i < mkn; ++i)
+    {
+        Index i0 = i % m, i2 = i / (m*k);
+        T val_ref = full[i] * T{3} * slice[i2*m+i0];
+        TEST_ASSERT(std::abs(dst[i]-val_ref) <= 10*eps);
+    }
+    prod_fiber3::cpu<T>(m, n, k, T{3}, &fiber[0], &full[0], &dst[0]);
+    for(Index i = 0; i < mkn; ++i)
+    {
+        Index i1 = (i/m) % k;
+        T val_ref = T{3} * fiber[i1] * full[i];
+        TEST_ASSERT(std::abs(dst[i]-val_ref) <= 10*eps);
+    }
+    std::cout << "OK: kernels of slices and fibers\n";
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 9, 10, 1);
+    validate<fp32_t>(8, 9, 1, 2);
+    validate<fp32_t>(8, 1, 10, 3);
+    validate<fp32_t>(4, 7, 8, 2);
+    validate<fp64_t>(1, 9, 10, 1);
+    validate<fp64_t>(8, 9, 1, 2);
+    validate<fp64_t>(8, 1, 10, 3);
+    validate<fp64_t>(4, 7, 8, 2);
+
+    return 0;
+}
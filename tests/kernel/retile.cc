@@ -0,0 +1,91 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/retile.cc
+ * Gathering of a tile from parts of other tiles
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/kernel/retile.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::retile;
+
+// Gather a box of shape (m1,n1) at (m0,n0) of (m,n) matrix, stored by tiles
+// of shape (mt,nt)
+template<typename T>
+void validate(Index m, Index n, Index mt, Index nt, Index m0, Index n0,
+        Index m1, Index n1)
+{
+    // Split matrix into source tiles
+    Index mg = (m-1)/mt + 1, ng = (n-1)/nt + 1;
+    std::vector<std::vector<T>> tiles(mg*ng);
+    for(Index i = 0; i < mg; ++i)
+    {
+        for(Index j = 0; j < ng; ++j)
+        {
+            Index tm = std::min(mt, m-i*mt), tn = std::min(nt, n-j*nt);
+            auto &tile = tiles[j*mg+i];
+            tile.resize(tm*tn);
+            for(Index jj = 0; jj < tn; ++jj)
+            {
+                for(Index ii = 0; ii < tm; ++ii)
+                {
+                    tile[jj*tm+ii] = T(Index(i*mt+ii + (j*nt+jj)*m));
+                }
+            }
+        }
+    }
+    // Describe parts of overlapping source tiles
+    std::vector<Index> info;
+    std::vector<const T *> src;
+    for(Index j = n0/nt; j*nt < n0+n1; ++j)
+    {
+        for(Index i = m0/mt; i*mt < m0+m1; ++i)
+        {
+            Index tm = std::min(mt, m-i*mt);
+            Index lo0 = std::max(m0, i*mt), hi0 = std::min(m0+m1, i*mt+tm);
+            Index lo1 = std::max(n0, j*nt);
+            Index hi1 = std::min(n0+n1, std::min(n, (j+1)*nt));
+            Index part[8] = {1, tm, lo0-i*mt, lo1-j*nt, lo0-m0, lo1-n0,
+                hi0-lo0, hi1-lo1};
+            info.insert(info.end(), part, part+8);
+            src.push_back(&tiles[j*mg+i][0]);
+        }
+    }
+    Index dst_stride[2] = {1, m1};
+    std::vector<T> dst(m1*n1, T(-1));
+    std::cout << "Run kernel::retile::cpu<T>\n";
+    cpu<T>(2, src.size(), dst_stride, &info[0], &src[0], &dst[0]);
+    for(Index j = 0; j < n1; ++j)
+    {
+        for(Index i = 0; i < m1; ++i)
+        {
+            TEST_ASSERT(dst[j*m1+i] == T(Index(m0+i + (n0+j)*m)));
+        }
+    }
+    std::cout << "OK: kernel::retile::cpu<T>\n";
+}
+
+int main(int argc, char **argv)
+{
+    // Parts are strided
+    validate<fp32_t>(6, 5, 4, 2, 1, 1, 5, 3);
+    validate<fp64_t>(6, 5, 4, 2, 1, 1, 5, 3);
+    validate<Index>(7, 7, 3, 3, 2, 0, 4, 7);
+    // Parts are contiguous
+    validate<fp32_t>(6, 5, 6, 2, 0, 1, 6, 3);
+    validate<Index>(6, 5, 6, 1, 0, 0, 6, 5);
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/sample_topk.cc
+ * Sample a token of each column from top-k candidates
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/kernel/sample_topk.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::sample_topk;
+
+// Templated validation
+template<typename T>
+void validate(Index n, Index k)
+{
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    unsigned long long seed = 100;
+    // Candidates of column j are k-j consecutive tokens with linearly
+    // decreasing values, column k and further have no candidates
+    std::vector<T> topk_val(k*n);
+    std::vector<Index> topk_idx(k*n);
+    std::vector<T> maxsumexp(2*n);
+    for(Index j = 0; j < n; ++j)
+    {
+        T max = 0, sum = 0;
+        for(Index l = 0; l < k; ++l)
+        {
+            if(l < k-j)
+            {
+                topk_val[j*k+l] = -T(l);
+                topk_idx[j*k+l] = 10*j + l;
+                sum += std::exp(-T(l));
+            }
+            else
+            {
+                topk_val[j*k+l] = -inf;
+                topk_idx[j*k+l] = -1;
+            }
+        }
+        // Half of probability is outside of candidates
+        maxsumexp[2*j] = max;
+        maxsumexp[2*j+1] = 2 * sum;
+    }
+    std::vector<Index> token(n), token2(n);
+    // Greedy choice
+    std::cout << "Run kernel::sample_topk::cpu<T>\n";
+    cpu<T>(n, k, 1, 1.0, seed, 0, &topk_val[0], &topk_idx[0],
+            &maxsumexp[0], &token[0]);
+    for(Index j = 0; j < n; ++j)
+    {
+        TEST_ASSERT(token[j] == topk_idx[j*k]);
+    }
+    cpu<T>(n, k, 0, 0.0, seed, 0, &topk_val[0], &topk_idx[0],
+            &maxsumexp[0], &token[0]);
+    for(Index j = 0; j < n; ++j)
+    {
+        TEST_ASSERT(token[j] == topk_idx[j*k]);
+    }
+    // Tiny nucleus consists of the first candidate only
+    cpu<T>(n, k, 0, 1e-3, seed, 0, &topk_val[0], &topk_idx[0],
+            &maxsumexp[0], &token[0]);
+    for(Index j = 0; j < n; ++j)
+    {
+        TEST_ASSERT(token[j] == topk_idx[j*k]);
+    }
+    // Sampled tokens are allowed candidates and do not depend on splitting
+    // of columns
+    Index top_k = 3;
+    cpu<T>(n, k, top_k, 1.0, seed, 0, &topk_val[0], &topk_idx[0],
+            &maxsumexp[0], &token[0]);
+    Index half = n / 2;
+    cpu<T>(half, k, top_k, 1.0, seed, 0, &topk_val[0], &topk_idx[0],
+            &maxsumexp[0], &token2[0]);
+    cpu<T>(n-half, k, top_k, 1.0, seed, half, &topk_val[half*k],
+            &topk_idx[half*k], &maxsumexp[2*half], &token2[half]);
+    for(Index j = 0; j < n; ++j)
+    {
+        TEST_ASSERT(token[j] == token2[j]);
+        if(j >= k)
+        {
+            TEST_ASSERT(token[j] == -1);
+            continue;
+        }
+        Index l = token[j] - 10*j;
+        TEST_ASSERT(l >= 0 and l < top_k and l < k-j);
+    }
+    std::cout << "OK: kernel::sample_topk::cpu<T>\n";
+    // Frequencies of sampled candidates over many seeds follow
+    // probabilities, renormalized within nucleus
+    Index nsamples = 10000;
+    std::vector<Index> count(k, 0);
+    for(Index s = 0; s < nsamples; ++s)
+    {
+        cpu<T>(1, k, 0, 1.0, s, 0, &topk_val[0], &topk_idx[0],
+                &maxsumexp[0], &token[0]);
+        ++count[token[0]];
+    }
+    T sum = maxsumexp[1] / 2;
+    for(Index l = 0; l < k; ++l)
+    {
+        T prob = std::exp(-T(l)) / sum;
+        T freq = T(count[l]) / T(nsamples);
+        TEST_ASSERT(std::abs(freq-prob) < 0.03);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(10, 5);
+    validate<fp32_t>(3, 4);
+    validate<fp64_t>(10, 5);
+    validate<fp64_t>(3, 4);
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/topk_maxsumexp.cc
+ * Running top-k and max and sum of exponents of columns
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/kernel/topk_maxsumexp.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::topk_maxsumexp;
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k, Index nchunks)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    scal_t alpha = 0.5;
+    // Init test input with repeated values and masked values
+    std::vector<T> src(m*n);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        src[i] = T(Index(i*i+7*i) % 13) - T{6};
+        if(i % 5 == 3)
+        {
+            src[i] = -inf;
+        }
+    }
+    std::vector<T> topk_val(k*n);
+    std::vector<Index> topk_idx(k*n);
+    std::vector<T> maxsumexp(2*n);
+    // Process input in chunks of rows
+    std::cout << "Run kernel::topk_maxsumexp::cpu<T>\n";
+    Index chunk = (m-1)/nchunks + 1;
+    for(Index start = 0; start < m; start += chunk)
+    {
+        Index size = std::min(chunk, m-start);
+        std::vector<T> src_chunk(size*n);
+        for(Index j = 0; j < n; ++j)
+        {
+            for(Index i = 0; i < size; ++i)
+            {
+                src_chunk[j*size+i] = src[j*m+start+i];
+            }
+        }
+        cpu<T>(size, n, k, start, alpha, start == 0, &src_chunk[0],
+                &topk_val[0], &topk_idx[0], &maxsumexp[0]);
+    }
+    // Compare against the reference
+    for(Index j = 0; j < n; ++j)
+    {
+        std::vector<Index> order;
+        for(Index i = 0; i < m; ++i)
+        {
+            if(not std::isinf(src[j*m+i]))
+            {
+                order.push_back(i);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(),
+                [&](Index a, Index b){return src[j*m+a] > src[j*m+b];});
+        for(Index l = 0; l < k; ++l)
+        {
+            if(l < Index(order.size()))
+            {
+                TEST_ASSERT(topk_idx[j*k+l] == order[l]);
+                TEST_ASSERT(topk_val[j*k+l] == T(alpha*src[j*m+order[l]]));
+            }
+            else
+            {
+                TEST_ASSERT(topk_idx[j*k+l] == -1);
+                TEST_ASSERT(topk_val[j*k+l] == -inf);
+            }
+        }
+        if(order.size() == 0)
+        {
+            TEST_ASSERT(maxsumexp[2*j+1] == 0);
+            continue;
+        }
+        T max = alpha * src[j*m+order[0]];
+        T sum = 0;
+        for(Index i: order)
+        {
+            sum += std::exp(alpha*src[j*m+i]-max);
+        }
+        TEST_ASSERT(maxsumexp[2*j] == max);
+        TEST_ASSERT(std::abs(maxsumexp[2*j+1]-sum) <= 10*eps*sum);
+    }
+    std::cout << "OK: kernel::topk_maxsumexp::cpu<T>\n";
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(100, 10, 5, 1);
+    validate<fp32_t>(100, 10, 5, 7);
+    validate<fp32_t>(3, 4, 5, 2);
+    validate<fp32_t>(1, 3, 1, 1);
+    validate<fp64_t>(100, 10, 5, 1);
+    validate<fp64_t>(100, 10, 5, 7);
+    validate<fp64_t>(3, 4, 5, 2);
+    validate<fp64_t>(1, 3, 1, 1);
+    return 0;
+}
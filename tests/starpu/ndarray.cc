@@ -0,0 +1,227 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/starpu/ndarray.cc
+ * StarPU data interface for multidimensional arrays
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/starpu/ndarray.hh"
+#include "nntile/starpu/clear.hh"
+#include "nntile/starpu/copy.hh"
+#include "../testing.hh"
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::starpu;
+
+void validate(const std::vector<Index> &shape)
+{
+    Index nelems = 1;
+    for(auto s: shape)
+    {
+        nelems *= s;
+    }
+    std::vector<fp64_t> data(nelems, -1);
+    // Array in user memory describes its shape and strides
+    NDArrayHandle data_handle(&data[0], shape, sizeof(fp64_t), STARPU_RW);
+    auto handle = static_cast<starpu_data_handle_t>(data_handle);
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(handle, STARPU_MAIN_RAM));
+    TEST_ASSERT(interface->ndim == Index(shape.size()));
+    TEST_ASSERT(Index(interface->elemsize) == nelems*Index(sizeof(fp64_t)));
+    Index stride = 1;
+    for(Index i = 0; i < interface->ndim; ++i)
+    {
+        TEST_ASSERT(interface->shape[i] == shape[i]);
+        TEST_ASSERT(interface->stride[i] == stride);
+        stride *= shape[i];
+    }
+    TEST_ASSERT(Index(starpu_data_get_size(handle))
+            == nelems*Index(sizeof(fp64_t)));
+    // Codelets for variables accept arrays
+    std::cout << "Run starpu::clear::submit on ndarray\n";
+    clear::submit(data_handle);
+    starpu_task_wait_for_all();
+    // Array, allocated by StarPU, is copied to and from user memory
+    NDArrayHandle tmp_handle(shape, sizeof(fp64_t), STARPU_R);
+    auto tmp = static_cast<starpu_data_handle_t>(tmp_handle);
+    auto local = data_handle.acquire(STARPU_W);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        reinterpret_cast<fp64_t *>(local.get_ptr())[i] = fp64_t(i);
+    }
+    local.release();
+    TEST_ASSERT(starpu_data_cpy(tmp, handle, 0, nullptr, nullptr) == 0);
+    clear::submit(data_handle);
+    TEST_ASSERT(starpu_data_cpy(handle, tmp, 0, nullptr, nullptr) == 0);
+    data_handle.unregister();
+    tmp_handle.unregister();
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(data[i] == fp64_t(i));
+    }
+    std::cout << "OK: starpu::clear::submit on ndarray\n";
+}
+
+void validate_strided()
+{
+    // Matrix 3x4 with leading dimension 5, padding is never touched
+    Index ld = 5, nrows = 3, ncols = 4;
+    std::vector<fp64_t> src(ld*ncols, -2), dst(ld*ncols, -2);
+    for(Index j = 0; j < ncols; ++j)
+    {
+        for(Index i = 0; i < nrows; ++i)
+        {
+            src[i+j*ld] = fp64_t(i+j*nrows);
+        }
+    }
+    NDArrayHandle src_handle(&src[0], {nrows, ncols}, sizeof(fp64_t),
+            STARPU_R, {1, ld});
+    NDArrayHandle dst_handle(&dst[0], {nrows, ncols}, sizeof(fp64_t),
+            STARPU_RW, {1, ld});
+    auto src_h = static_cast<starpu_data_handle_t>(src_handle);
+    auto interface = reinterpret_cast<NDArrayInterface *>(
+            starpu_data_get_interface_on_node(src_h, STARPU_MAIN_RAM));
+    TEST_ASSERT(interface->stride[1] == ld);
+    TEST_ASSERT(!interface->is_contiguous());
+    TEST_ASSERT(Index(interface->elemsize)
+            == nrows*ncols*Index(sizeof(fp64_t)));
+    // Strided array is copied to and from a contiguous one
+    NDArrayHandle tmp_handle({nrows, ncols}, sizeof(fp64_t), STARPU_RW);
+    auto tmp = static_cast<starpu_data_handle_t>(tmp_handle);
+    TEST_ASSERT(starpu_data_cpy(tmp, src_h, 0, nullptr, nullptr) == 0);
+    auto local = tmp_handle.acquire(STARPU_R);
+    for(Index i = 0; i < nrows*ncols; ++i)
+    {
+        TEST_ASSERT(reinterpret_cast<fp64_t *>(local.get_ptr())[i]
+                == fp64_t(i));
+    }
+    local.release();
+    // Codelets follow strides of both arrays
+    std::cout << "Run starpu::copy::submit on strided ndarray\n";
+    copy::submit(src_handle, dst_handle);
+    starpu_task_wait_for_all();
+    dst_handle.unregister();
+    for(Index j = 0; j < ncols; ++j)
+    {
+        for(Index i = 0; i < ld; ++i)
+        {
+            TEST_ASSERT(dst[i+j*ld] == (i < nrows ? src[i+j*ld] : -2));
+        }
+    }
+    std::cout << "OK: starpu::copy::submit on strided ndarray\n";
+    // Plain variable is a contiguous array of the same shape
+    std::cout << "Run starpu::copy::submit between ndarray and variable\n";
+    VariableHandle var_handle(sizeof(fp64_t)*nrows*ncols, STARPU_RW);
+    copy::submit(src_handle, var_handle);
+    auto var_local = var_handle.acquire(STARPU_R);
+    for(Index i = 0; i < nrows*ncols; ++i)
+    {
+        TEST_ASSERT(reinterpret_cast<fp64_t *>(var_local.get_ptr())[i]
+                == fp64_t(i));
+    }
+    var_local.release();
+    std::vector<fp64_t> dst2(ld*ncols, -2);
+    NDArrayHandle dst2_handle(&dst2[0], {nrows, ncols}, sizeof(fp64_t),
+            STARPU_RW, {1, ld});
+    copy::submit(var_handle, dst2_handle);
+    starpu_task_wait_for_all();
+    dst2_handle.unregister();
+    var_handle.unregister();
+    TEST_ASSERT(dst2 == dst);
+    std::cout << "OK: starpu::copy::submit between ndarray and variable\n";
+    std::cout << "Run starpu::clear::submit on strided ndarray\n";
+    NDArrayHandle clear_handle(&dst[0], {nrows, ncols}, sizeof(fp64_t),
+            STARPU_RW, {1, ld});
+    clear::submit(clear_handle);
+    clear_handle.unregister();
+    for(Index j = 0; j < ncols; ++j)
+    {
+        for(Index i = 0; i < ld; ++i)
+        {
+            TEST_ASSERT(dst[i+j*ld] == (i < nrows ? 0 : -2));
+        }
+    }
+    std::cout << "OK: starpu::clear::submit on strided ndarray\n";
+    src_handle.unregister();
+    tmp_handle.unregister();
+    // Strides must describe an array without overlaps
+    TEST_THROW(NDArrayHandle(&dst[0], {nrows, ncols}, sizeof(fp64_t),
+                STARPU_R, {1}));
+    TEST_THROW(NDArrayHandle(&dst[0], {nrows, ncols}, sizeof(fp64_t),
+                STARPU_R, {1, nrows-1}));
+}
+
+void validate_partition(Index axis)
+{
+    Index nrows = 7, ncols = 4, nparts = 3;
+    std::vector<fp64_t> data(nrows*ncols);
+    for(Index i = 0; i < nrows*ncols; ++i)
+    {
+        data[i] = fp64_t(i+1);
+    }
+    NDArrayHandle data_handle(&data[0], {nrows, ncols}, sizeof(fp64_t),
+            STARPU_RW);
+    auto handle = static_cast<starpu_data_handle_t>(data_handle);
+    auto blocks = ndarray_partition_plan(handle, axis, nparts);
+    TEST_ASSERT(Index(blocks.size()) == nparts);
+    TEST_THROW(ndarray_partition_plan(handle, 2, nparts));
+    TEST_THROW(ndarray_partition_plan(handle, axis, 0));
+    // Clear the second block only
+    std::cout << "Run starpu::clear::submit on block along axis " << axis
+        << "\n";
+    starpu_data_partition_submit(handle, nparts, &blocks[0]);
+    // Blocks are owned by the plan, so the handle must not unregister them
+    clear::submit(Handle(std::shared_ptr<_starpu_data_state>(blocks[1],
+                    [](starpu_data_handle_t){})));
+    starpu_data_unpartition_submit(handle, nparts, &blocks[0],
+            STARPU_MAIN_RAM);
+    starpu_data_partition_clean(handle, nparts, &blocks[0]);
+    data_handle.unregister();
+    Index size = axis == 0 ? nrows : ncols;
+    Index start = size/nparts + (size%nparts > 0);
+    Index end = start + size/nparts + (size%nparts > 1);
+    for(Index j = 0; j < ncols; ++j)
+    {
+        for(Index i = 0; i < nrows; ++i)
+        {
+            Index k = axis == 0 ? i : j;
+            fp64_t ref = (k >= start and k < end) ? 0 : fp64_t(i+j*nrows+1);
+            TEST_ASSERT(data[i+j*nrows] == ref);
+        }
+    }
+    std::cout << "OK: starpu::clear::submit on block along axis " << axis
+        << "\n";
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing
+    Config starpu(1, 0, 0);
+    // Init codelet
+    clear::init();
+    clear::restrict_where(STARPU_CPU);
+    copy::init();
+    copy::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate({});
+    validate({100});
+    validate({3, 4, 5});
+    validate_strided();
+    validate_partition(0);
+    validate_partition(1);
+    TEST_THROW(NDArrayHandle(std::vector<Index>(NDARRAY_MAX_NDIM+1, 1),
+                sizeof(fp64_t), STARPU_R));
+    TEST_THROW(NDArrayHandle({3, 0}, sizeof(fp64_t), STARPU_R));
+    return 0;
+}
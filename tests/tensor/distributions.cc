@@ -46,6 +46,49 @@ void validate()
     TEST_THROW(block_cyclic(tensor_grid3, mpi_grid2, start_rank, max_rank3));
     TEST_THROW(block_cyclic(tensor_grid2, mpi_grid2, -1, 1));
     TEST_THROW(block_cyclic(tensor_grid2, mpi_grid2, 1, 1));
+    // Distribution along selected axes
+    std::vector<Index> tensor_grid4({4, 3});
+    std::vector<int> distr4({0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0});
+    TEST_ASSERT(distr4 == block_cyclic_axes(tensor_grid4, {1}, {2}, 0, 2));
+    TEST_THROW(block_cyclic_axes(tensor_grid4, {2}, {2}, 0, 2));
+    TEST_THROW(block_cyclic_axes(tensor_grid4, {0, 1}, {2}, 0, 2));
+    // 2D distribution of a matrix view
+    std::vector<Index> tensor_grid5({2, 2, 3});
+    std::vector<int> distr5({0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3});
+    TEST_ASSERT(distr5 == matrix_block_cyclic(tensor_grid5, 1, 2, 2, 0, 4));
+    TEST_THROW(matrix_block_cyclic(tensor_grid5, 4, 2, 2, 0, 4));
+    // 2.5D distribution of a matrix view
+    std::vector<Index> tensor_grid6({4, 2});
+    std::vector<int> distr6({0, 2, 1, 3, 0, 2, 1, 3});
+    TEST_ASSERT(distr6 == matrix_block_cyclic_2_5d(tensor_grid6, 1, 2, 1, 2,
+                0, 0, 4));
+    TEST_THROW(matrix_block_cyclic_2_5d(tensor_grid6, 1, 2, 1, 2, 2, 0, 4));
+    TEST_THROW(matrix_block_cyclic_2_5d(tensor_grid6, 1, 0, 1, 2, 0, 0, 4));
+    // Distributions of gemm operands that follow distribution of C
+    TensorTraits A({4, 6}, {2, 2}), B({6, 4}, {2, 2}), C({4, 4}, {2, 2});
+    TransOp opN(TransOp::NoTrans);
+    std::vector<int> C_distr({0, 1, 2, 3});
+    auto AB_distr = gemm_owner_compute(opN, A, opN, B, C, C_distr, 1, 0);
+    std::vector<int> A_distr({0, 1, 2, 3, 0, 1}), B_distr({0, 1, 0, 2, 3, 2});
+    TEST_ASSERT(AB_distr.first == A_distr);
+    TEST_ASSERT(AB_distr.second == B_distr);
+    // Transfers within gemm_async
+    std::vector<Index> gemm_bytes({32, 48, 48, 64});
+    TEST_ASSERT(gemm_bytes == gemm_transfer_bytes(opN, A, A_distr, opN, B,
+                B_distr, C, C_distr, 1, 0, 4, 4));
+    std::vector<int> A_root(6, 0), B_root(6, 0), C_root(4, 0);
+    TEST_ASSERT(std::vector<Index>(1, 0) == gemm_transfer_bytes(opN, A,
+                A_root, opN, B, B_root, C, C_root, 1, 0, 4, 1));
+    TEST_THROW(gemm_transfer_bytes(opN, A, A_distr, opN, B, B_distr, C,
+                C_distr, 1, 0, 4, 2));
+    // Transfers within tile-wise operations and memory footprint
+    TensorTraits D({4}, {3});
+    std::vector<Index> tilewise_bytes({0, 24});
+    TEST_ASSERT(tilewise_bytes == tilewise_transfer_bytes(D, {0, 1}, {1, 1},
+                8, 2));
+    std::vector<Index> mem_bytes({12, 4});
+    TEST_ASSERT(mem_bytes == memory_bytes(D, {0, 1}, 4, 2));
+    TEST_THROW(memory_bytes(D, {0, 1, 0}, 4, 2));
 }
 
 int main(int argc, char ** argv)
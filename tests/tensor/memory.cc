@@ -0,0 +1,78 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/memory.cc
+ * Accounting of memory of tensors by categories
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/tensor.hh"
+#include "nntile/tensor/view.hh"
+#include "nntile/starpu/memory.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+using namespace nntile::starpu;
+
+template<typename T>
+void validate()
+{
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Index> shape{6, 8, 3}, basetile{6, 2, 2};
+    TensorTraits traits(shape, basetile);
+    std::vector<int> distr(traits.grid.nelems, 0);
+    Index nbytes = traits.nelems * sizeof(T);
+    auto stats0 = memory::get_stats();
+    memory::reset_peak();
+    // Tensors are tracked with the default category
+    memory::set_default_category(memory::ACTIVATION);
+    Tensor<T> A(traits, distr, last_tag);
+    memory::set_default_category(memory::OTHER);
+    Tensor<T> B(traits, distr, last_tag);
+    auto stats = memory::get_stats();
+    TEST_ASSERT(stats.live[memory::ACTIVATION]
+            == stats0.live[memory::ACTIVATION]+nbytes);
+    TEST_ASSERT(stats.live_total == stats0.live_total+2*nbytes);
+    // Views and copies of tensors share tiles and are not tracked again
+    Tensor<T> C(A);
+    auto view = slice_view(A, {0, 2, 0}, {6, 4, 3});
+    TEST_ASSERT(memory::get_stats().live_total == stats.live_total);
+    // Category of tiles can be changed
+    B.set_memory_category(memory::OPTIMIZER);
+    stats = memory::get_stats();
+    TEST_ASSERT(stats.live[memory::OPTIMIZER]
+            == stats0.live[memory::OPTIMIZER]+nbytes);
+    TEST_ASSERT(stats.live[memory::OTHER] == stats0.live[memory::OTHER]);
+    // Unregistered tiles are not live, but peak remains
+    B.unregister();
+    stats = memory::get_stats();
+    TEST_ASSERT(stats.live[memory::OPTIMIZER]
+            == stats0.live[memory::OPTIMIZER]);
+    TEST_ASSERT(stats.peak[memory::OPTIMIZER]
+            == stats0.live[memory::OPTIMIZER]+nbytes);
+    TEST_ASSERT(stats.peak_total == stats0.live_total+2*nbytes);
+    A.unregister();
+    TEST_ASSERT(memory::get_stats().live_total
+            == stats0.live_total+nbytes);
+    view.unregister();
+    C.unregister();
+    TEST_ASSERT(memory::get_stats().live_total == stats0.live_total);
+    TEST_THROW(memory::set_default_category(memory::NCATEGORIES));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
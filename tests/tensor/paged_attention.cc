@@ -0,0 +1,334 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/paged_attention.cc
+ * Attention of new positions to keys and values, stored in paged caches
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/paged_attention.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/starpu/clear.hh"
+#include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/mask_scalar.hh"
+#include "nntile/starpu/maxsumexp.hh"
+#include "nntile/starpu/softmax_inplace.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/tensor/gather.hh"
+#include "../testing.hh"
+#include <cmath>
+#include <limits>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void check(Index head_size, Index n_head, Index n_head_tile,
+        Index block_size, Index n_blocks,
+        const std::vector<std::vector<Index>> &block_table,
+        const std::vector<Index> &block_len, const std::vector<Index> &block,
+        const std::vector<Index> &offset)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Some preparation
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    std::vector<int> dist_root = {mpi_root};
+    Index n_batch = block_table.size(), max_blocks = 0;
+    for(Index b = 0; b < n_batch; ++b)
+    {
+        max_blocks = std::max<Index>(max_blocks, block_table[b].size());
+    }
+    // Mask of filled positions after the store of new positions
+    std::vector<bool> filled(block_size*n_blocks, false);
+    for(Index i = 0; i < n_blocks; ++i)
+    {
+        for(Index j = 0; j < block_len[i]; ++j)
+        {
+            filled[i*block_size+j] = true;
+        }
+    }
+    for(Index b = 0; b < n_batch; ++b)
+    {
+        if(block[b] >= 0)
+        {
+            filled[block[b]*block_size+offset[b]] = true;
+        }
+    }
+    // Generate single-tile tensors and init them
+    std::vector<Index> new_shape{head_size, 1, n_batch, n_head},
+        pool_shape{head_size, block_size, n_blocks, n_head},
+        mask_shape{block_size, n_blocks};
+    TensorTraits new_single_traits(new_shape, new_shape),
+                 pool_single_traits(pool_shape, pool_shape),
+                 mask_single_traits(mask_shape, mask_shape);
+    Tensor<T> Q_single(new_single_traits, dist_root, last_tag),
+        K_new_single(new_single_traits, dist_root, last_tag),
+        V_new_single(new_single_traits, dist_root, last_tag),
+        K_pool_single(pool_single_traits, dist_root, last_tag),
+        V_pool_single(pool_single_traits, dist_root, last_tag);
+    Tensor<bool_t> mask_single(mask_single_traits, dist_root, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto Q_tile = Q_single.get_tile(0);
+        auto Q_local = Q_tile.acquire(STARPU_W);
+        auto K_new_tile = K_new_single.get_tile(0);
+        auto K_new_local = K_new_tile.acquire(STARPU_W);
+        auto V_new_tile = V_new_single.get_tile(0);
+        auto V_new_local = V_new_tile.acquire(STARPU_W);
+        for(Index i = 0; i < Q_single.nelems; ++i)
+        {
+            Q_local[i] = T(std::sin(Index(i)));
+            K_new_local[i] = T(std::cos(Index(i)));
+            V_new_local[i] = T(Index(i%7) - 3);
+        }
+        Q_local.release();
+        K_new_local.release();
+        V_new_local.release();
+        auto K_pool_tile = K_pool_single.get_tile(0);
+        auto K_pool_local = K_pool_tile.acquire(STARPU_W);
+        auto V_pool_tile = V_pool_single.get_tile(0);
+        auto V_pool_local = V_pool_tile.acquire(STARPU_W);
+        for(Index i = 0; i < K_pool_single.nelems; ++i)
+        {
+            K_pool_local[i] = T(std::cos(Index(2*i+1)));
+            V_pool_local[i] = T(std::sin(Index(3*i+1)));
+        }
+        K_pool_local.release();
+        V_pool_local.release();
+        auto mask_tile = mask_single.get_tile(0);
+        auto mask_local = mask_tile.acquire(STARPU_W);
+        for(Index i = 0; i < mask_single.nelems; ++i)
+        {
+            mask_local[i] = bool_t(filled[i]);
+        }
+        mask_local.release();
+    }
+    // Scatter tensors
+    std::vector<Index> new_basetile{head_size, 1, 1, n_head_tile},
+        pool_basetile{head_size, block_size, 1, n_head_tile},
+        mask_basetile{block_size, 1};
+    TensorTraits new_traits(new_shape, new_basetile),
+        pool_traits(pool_shape, pool_basetile),
+        mask_traits(mask_shape, mask_basetile);
+    std::vector<int> new_distr(new_traits.grid.nelems),
+        pool_distr(pool_traits.grid.nelems),
+        mask_distr(mask_traits.grid.nelems);
+    for(Index i = 0; i < new_traits.grid.nelems; ++i)
+    {
+        new_distr[i] = (i+1) % mpi_size;
+    }
+    for(Index i = 0; i < pool_traits.grid.nelems; ++i)
+    {
+        pool_distr[i] = (i*i+1) % mpi_size;
+    }
+    for(Index i = 0; i < mask_traits.grid.nelems; ++i)
+    {
+        mask_distr[i] = i % mpi_size;
+    }
+    Tensor<T> Q(new_traits, new_distr, last_tag),
+        K_new(new_traits, new_distr, last_tag),
+        V_new(new_traits, new_distr, last_tag),
+        B(new_traits, new_distr, last_tag),
+        K_pool(pool_traits, pool_distr, last_tag),
+        V_pool(pool_traits, pool_distr, last_tag);
+    Tensor<bool_t> mask(mask_traits, mask_distr, last_tag);
+    scatter<T>(Q_single, Q);
+    scatter<T>(K_new_single, K_new);
+    scatter<T>(V_new_single, V_new);
+    scatter<T>(K_pool_single, K_pool);
+    scatter<T>(V_pool_single, V_pool);
+    scatter<bool_t>(mask_single, mask);
+    std::vector<Index> A_shape{block_size, 1, max_blocks, n_batch, n_head},
+        A_basetile{block_size, 1, 1, 1, n_head_tile},
+        maxsumexp_shape{2, 1, n_batch, n_head},
+        maxsumexp_basetile{2, 1, 1, n_head_tile};
+    TensorTraits A_traits(A_shape, A_basetile),
+        maxsumexp_traits(maxsumexp_shape, maxsumexp_basetile);
+    std::vector<int> A_distr(A_traits.grid.nelems),
+        maxsumexp_distr(maxsumexp_traits.grid.nelems);
+    for(Index i = 0; i < A_traits.grid.nelems; ++i)
+    {
+        A_distr[i] = (i+2) % mpi_size;
+    }
+    for(Index i = 0; i < maxsumexp_traits.grid.nelems; ++i)
+    {
+        maxsumexp_distr[i] = (i+3) % mpi_size;
+    }
+    Tensor<T> A(A_traits, A_distr, last_tag),
+        maxsumexp(maxsumexp_traits, maxsumexp_distr, last_tag);
+    // Store new keys and values and attend to all the blocks
+    scal_t alpha = 1.0 / std::sqrt(scal_t(head_size));
+    paged_kv_store<T>(K_new, K_pool, block, offset);
+    paged_kv_store<T>(V_new, V_pool, block, offset);
+    paged_attention<T>(alpha, Q, K_pool, V_pool, mask, block_table, A,
+            maxsumexp, B);
+    Tensor<T> B_single(new_single_traits, dist_root, last_tag);
+    gather<T>(B, B_single);
+    // Compare against the reference on the root node
+    if(mpi_rank == mpi_root)
+    {
+        auto Q_tile = Q_single.get_tile(0);
+        auto Q_local = Q_tile.acquire(STARPU_R);
+        auto K_new_tile = K_new_single.get_tile(0);
+        auto K_new_local = K_new_tile.acquire(STARPU_R);
+        auto V_new_tile = V_new_single.get_tile(0);
+        auto V_new_local = V_new_tile.acquire(STARPU_R);
+        auto K_pool_tile = K_pool_single.get_tile(0);
+        auto K_pool_local = K_pool_tile.acquire(STARPU_RW);
+        auto V_pool_tile = V_pool_single.get_tile(0);
+        auto V_pool_local = V_pool_tile.acquire(STARPU_RW);
+        auto B_tile = B_single.get_tile(0);
+        auto B_local = B_tile.acquire(STARPU_R);
+        // Reference store of new keys and values
+        for(Index b = 0; b < n_batch; ++b)
+        {
+            if(block[b] < 0)
+            {
+                continue;
+            }
+            for(Index h = 0; h < n_head; ++h)
+            {
+                for(Index d = 0; d < head_size; ++d)
+                {
+                    Index src = d + head_size*(b+n_batch*h);
+                    Index dst = d + head_size*(offset[b]
+                            + block_size*(block[b]+n_blocks*h));
+                    K_pool_local[dst] = K_new_local[src];
+                    V_pool_local[dst] = V_new_local[src];
+                }
+            }
+        }
+        // Reference attention
+        std::vector<double> score(max_blocks*block_size);
+        for(Index b = 0; b < n_batch; ++b)
+        {
+            for(Index h = 0; h < n_head; ++h)
+            {
+                double max = -std::numeric_limits<double>::infinity();
+                for(Index j = 0; j < block_table[b].size(); ++j)
+                {
+                    Index blk = block_table[b][j];
+                    for(Index p = 0; p < block_size; ++p)
+                    {
+                        double &s = score[j*block_size+p];
+                        if(!filled[blk*block_size+p])
+                        {
+                            s = -std::numeric_limits<double>::infinity();
+                            continue;
+                        }
+                        s = 0;
+                        for(Index d = 0; d < head_size; ++d)
+                        {
+                            s += double(Q_local[d+head_size*(b+n_batch*h)])
+                                * double(K_pool_local[d+head_size*(p
+                                    +block_size*(blk+n_blocks*h))]);
+                        }
+                        s *= double(alpha);
+                        max = std::max(max, s);
+                    }
+                }
+                double sum = 0;
+                for(Index j = 0; j < block_table[b].size()*block_size; ++j)
+                {
+                    sum += std::exp(score[j]-max);
+                }
+                for(Index d = 0; d < head_size; ++d)
+                {
+                    double val = 0;
+                    for(Index j = 0; j < block_table[b].size(); ++j)
+                    {
+                        Index blk = block_table[b][j];
+                        for(Index p = 0; p < block_size; ++p)
+                        {
+                            val += std::exp(score[j*block_size+p]-max) / sum
+                                * double(V_pool_local[d+head_size*(p
+                                    +block_size*(blk+n_blocks*h))]);
+                        }
+                    }
+                    double res = B_local[d+head_size*(b+n_batch*h)];
+                    TEST_ASSERT(std::abs(res-val)
+                            <= 100*std::numeric_limits<T>::epsilon()
+                            *(1+std::abs(val)));
+                }
+            }
+        }
+        Q_local.release();
+        K_new_local.release();
+        V_new_local.release();
+        K_pool_local.release();
+        V_pool_local.release();
+        B_local.release();
+    }
+}
+
+template<typename T>
+void validate()
+{
+    // Sequences with several partially filled blocks, an empty sequence and
+    // a sequence, that does not store its new position
+    check<T>(4, 4, 2, 3, 5, {{1, 3}, {}, {0, 4, 2}}, {3, 3, 0, 1, 3},
+            {3, -1, 2}, {1, 0, 0});
+    check<T>(8, 3, 3, 4, 3, {{2, 0, 1}}, {4, 2, 4}, {0}, {2});
+    // Sync to guarantee old data tags are cleaned up and can be reused
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Check throwing exceptions
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<int> dist0 = {0};
+    TensorTraits new_traits({4, 1, 1, 2}, {4, 1, 1, 2}),
+        pool_traits({4, 3, 2, 2}, {4, 3, 1, 2}),
+        mask_traits({3, 2}, {3, 1}),
+        A_traits({3, 1, 1, 1, 2}, {3, 1, 1, 1, 2}),
+        maxsumexp_traits({2, 1, 1, 2}, {2, 1, 1, 2});
+    std::vector<int> dist00 = {0, 0};
+    Tensor<T> Q(new_traits, dist0, last_tag), B(new_traits, dist0, last_tag),
+        K_pool(pool_traits, dist00, last_tag),
+        V_pool(pool_traits, dist00, last_tag),
+        A(A_traits, dist0, last_tag),
+        maxsumexp(maxsumexp_traits, dist0, last_tag);
+    Tensor<bool_t> mask(mask_traits, dist00, last_tag);
+    TEST_THROW(paged_kv_store<T>(Q, K_pool, {2}, {0}));
+    TEST_THROW(paged_kv_store<T>(Q, K_pool, {0}, {3}));
+    TEST_THROW(paged_kv_store<T>(Q, K_pool, {0, 1}, {0, 0}));
+    TEST_THROW(paged_kv_store<T>(Q, A, {0}, {0}));
+    TEST_THROW(paged_attention<T>(1.0, Q, K_pool, V_pool, mask, {{0, 1}}, A,
+                maxsumexp, B));
+    TEST_THROW(paged_attention<T>(1.0, Q, K_pool, V_pool, mask, {{2}}, A,
+                maxsumexp, B));
+    TEST_THROW(paged_attention<T>(1.0, Q, K_pool, V_pool, mask, {{0}, {1}},
+                A, maxsumexp, B));
+    TEST_THROW(paged_attention<T>(1.0, Q, K_pool, V_pool, mask, {{0}},
+                maxsumexp, maxsumexp, B));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::subcopy::init();
+    starpu::clear::init();
+    starpu::gemm::init();
+    starpu::mask_scalar::init();
+    starpu::maxsumexp::init();
+    starpu::softmax_inplace::init();
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    starpu::clear::restrict_where(STARPU_CPU);
+    starpu::gemm::restrict_where(STARPU_CPU);
+    starpu::mask_scalar::restrict_where(STARPU_CPU);
+    starpu::maxsumexp::restrict_where(STARPU_CPU);
+    starpu::softmax_inplace::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/retile.cc
+ * Conversion of a tensor into another tiling
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/retile.hh"
+#include "nntile/starpu/retile.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/tensor/gather.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+// Convert tensor from one tiling into another one and check result
+template<typename T>
+void check(const std::vector<Index> &shape,
+        const std::vector<Index> &src_basetile,
+        const std::vector<Index> &dst_basetile)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Some preparation
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    std::vector<int> dist_root = {mpi_root};
+    TensorTraits single_traits(shape, shape),
+                 src_traits(shape, src_basetile),
+                 dst_traits(shape, dst_basetile);
+    // Generate source data
+    Tensor<T> src_single(single_traits, dist_root, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = src_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_W);
+        for(Index i = 0; i < src_single.nelems; ++i)
+        {
+            tile_local[i] = T(i+1);
+        }
+        tile_local.release();
+    }
+    // Tiles of source and destination are distributed differently
+    std::vector<int> src_distr(src_traits.grid.nelems),
+        dst_distr(dst_traits.grid.nelems);
+    for(Index i = 0; i < src_traits.grid.nelems; ++i)
+    {
+        src_distr[i] = (i+1) % mpi_size;
+    }
+    for(Index i = 0; i < dst_traits.grid.nelems; ++i)
+    {
+        dst_distr[i] = (i+2) % mpi_size;
+    }
+    Tensor<T> src(src_traits, src_distr, last_tag),
+        dst(dst_traits, dst_distr, last_tag);
+    scatter<T>(src_single, src);
+    retile<T>(src, dst);
+    Tensor<T> dst_single(single_traits, dist_root, last_tag);
+    gather<T>(dst, dst_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = dst_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_R);
+        for(Index i = 0; i < dst_single.nelems; ++i)
+        {
+            TEST_ASSERT(tile_local[i] == T(i+1));
+        }
+        tile_local.release();
+    }
+}
+
+template<typename T>
+void validate()
+{
+    // Arbitrary tilings
+    check<T>({7, 5, 3}, {3, 2, 3}, {2, 4, 1});
+    // Coinciding tilings
+    check<T>({7, 5, 3}, {3, 2, 3}, {3, 2, 3});
+    // Contiguous parts
+    check<T>({7, 5, 3}, {7, 2, 1}, {7, 5, 2});
+    // Scalar
+    check<T>({}, {}, {});
+    // Check throwing exceptions
+    starpu_mpi_tag_t last_tag = 0;
+    TensorTraits traits({7, 5}, {3, 2}), traits2({5, 7}, {3, 2});
+    std::vector<int> distr(traits.grid.nelems, 0);
+    Tensor<T> A(traits, distr, last_tag), B(traits2, distr, last_tag);
+    TEST_THROW(retile<T>(A, B));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::retile::init();
+    starpu::subcopy::init();
+    starpu::retile::restrict_where(STARPU_CPU);
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    validate<Index>();
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/submitter.cc
+ * Parallel submission of tasks of tensor operations
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/add.hh"
+#include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/add.hh"
+#include "nntile/starpu/submitter.hh"
+#include "../testing.hh"
+#include <atomic>
+#include <stdexcept>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+// Check that every iteration of a parallel loop is processed exactly once
+void check_parallel_for()
+{
+    starpu::submitter::init(3);
+    starpu::submitter::set_min_tasks(1);
+    TEST_ASSERT(starpu::submitter::get_nthreads() == 3);
+    constexpr Index n = 1000;
+    std::vector<std::atomic<int>> count(n);
+    starpu::submitter::parallel_for(n, 1, [&](Index begin, Index end)
+            {
+                for(Index i = begin; i < end; ++i)
+                {
+                    // Nested loops are processed serially
+                    starpu::submitter::parallel_for(2, 1, [&](Index b, Index e)
+                            {
+                                count[i] += e - b;
+                            });
+                }
+            });
+    for(Index i = 0; i < n; ++i)
+    {
+        TEST_ASSERT(count[i] == 2);
+    }
+    // Exception of any thread is rethrown by the calling thread
+    TEST_THROW(starpu::submitter::parallel_for(n, 1, [](Index begin, Index end)
+            {
+                if(begin <= n/2 and n/2 < end)
+                {
+                    throw std::runtime_error("Error in a loop");
+                }
+            }));
+    TEST_THROW(starpu::submitter::init(-1));
+    TEST_THROW(starpu::submitter::set_min_tasks(-1));
+    starpu::submitter::shutdown();
+    TEST_ASSERT(starpu::submitter::get_nthreads() == 0);
+}
+
+template<typename T>
+void fill_tensor(const Tensor<T> &A, Index seed)
+{
+    for(Index i = 0; i < A.grid.nelems; ++i)
+    {
+        auto tile = A.get_tile(i);
+        auto tile_local = tile.acquire(STARPU_W);
+        for(Index j = 0; j < tile.nelems; ++j)
+        {
+            tile_local[j] = T((seed*31+i*7+j*3)%17) / T(4);
+        }
+        tile_local.release();
+    }
+}
+
+// Check that results of tensor operations do not depend on submission
+template<typename T>
+void validate()
+{
+    starpu_mpi_tag_t last_tag = 0;
+    TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+    TensorTraits A_traits({12, 10, 3}, {2, 3, 1}),
+        B_traits({14, 10, 3}, {4, 3, 1}), C_traits({12, 14, 3}, {2, 4, 1});
+    std::vector<int> A_distr(A_traits.grid.nelems, 0),
+        B_distr(B_traits.grid.nelems, 0), C_distr(C_traits.grid.nelems, 0);
+    Tensor<T> A(A_traits, A_distr, last_tag), B(B_traits, B_distr, last_tag),
+        C(C_traits, C_distr, last_tag), D(C_traits, C_distr, last_tag),
+        E(C_traits, C_distr, last_tag);
+    fill_tensor(A, 0);
+    fill_tensor(B, 1);
+    fill_tensor(C, 2);
+    fill_tensor(D, 2);
+    fill_tensor(E, 3);
+    // Serial submission
+    starpu::submitter::shutdown();
+    gemm<T>(1.0, opN, A, opT, B, 0.5, C, 1, 1, 0);
+    add<T>(2.0, E, -1.0, C);
+    // Parallel submission of every operation
+    starpu::submitter::init(3);
+    starpu::submitter::set_min_tasks(1);
+    gemm<T>(1.0, opN, A, opT, B, 0.5, D, 1, 1, 0);
+    add<T>(2.0, E, -1.0, D);
+    starpu::submitter::shutdown();
+    // Tasks of a single tile are submitted in the same order, so the results
+    // shall be the same bit by bit
+    for(Index i = 0; i < C.grid.nelems; ++i)
+    {
+        auto C_tile = C.get_tile(i), D_tile = D.get_tile(i);
+        auto C_local = C_tile.acquire(STARPU_R);
+        auto D_local = D_tile.acquire(STARPU_R);
+        for(Index j = 0; j < C_tile.nelems; ++j)
+        {
+            TEST_ASSERT(C_local[j] == D_local[j]);
+        }
+        C_local.release();
+        D_local.release();
+    }
+    A.unregister();
+    B.unregister();
+    C.unregister();
+    D.unregister();
+    E.unregister();
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::gemm::init();
+    starpu::add::init();
+    starpu::gemm::restrict_where(STARPU_CPU);
+    starpu::add::restrict_where(STARPU_CPU);
+    // Launch all tests
+    check_parallel_for();
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/tile_io.cc
+ * Write tiles of a tensor into a file and read them back
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/tile_io.hh"
+#include "nntile/starpu/tile_io.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/tensor/gather.hh"
+#include "../testing.hh"
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void validate(int fd)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Some preparation
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    std::vector<int> dist_root = {mpi_root};
+    std::vector<Index> shape{7, 5, 3}, basetile{3, 2, 3};
+    TensorTraits single_traits(shape, shape), traits(shape, basetile);
+    // Check offsets of tiles
+    Index alignment = 64;
+    auto offsets = tile_offsets(traits, sizeof(T), alignment, alignment);
+    TEST_ASSERT(Index(offsets.size()) == traits.grid.nelems+1);
+    TEST_ASSERT(offsets[0] == alignment);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        Index nbytes = traits.get_tile_traits(i).nelems * sizeof(T);
+        TEST_ASSERT(offsets[i+1] % alignment == 0);
+        TEST_ASSERT(offsets[i+1]-offsets[i] >= nbytes);
+        TEST_ASSERT(offsets[i+1]-offsets[i] < nbytes+alignment);
+    }
+    // Generate source data
+    Tensor<T> src_single(single_traits, dist_root, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = src_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_W);
+        for(Index i = 0; i < src_single.nelems; ++i)
+        {
+            tile_local[i] = T(i+1);
+        }
+        tile_local.release();
+    }
+    std::vector<int> distr(traits.grid.nelems);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        distr[i] = (i+1) % mpi_size;
+    }
+    Tensor<T> src(traits, distr, last_tag), dst(traits, distr, last_tag);
+    scatter<T>(src_single, src);
+    // Write tiles and read them back into another tensor
+    save_tiles<T>(src, fd, offsets);
+    load_tiles<T>(dst, fd, offsets);
+    Tensor<T> dst_single(single_traits, dist_root, last_tag);
+    gather<T>(dst, dst_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = dst_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_R);
+        for(Index i = 0; i < dst_single.nelems; ++i)
+        {
+            TEST_ASSERT(tile_local[i] == T(i+1));
+        }
+        tile_local.release();
+    }
+    // Check throwing exceptions
+    TEST_THROW(tile_offsets(traits, sizeof(T), 1, alignment));
+    TEST_THROW(tile_offsets(traits, 0, 0, alignment));
+    TEST_THROW(tile_offsets(traits, sizeof(T), 0, 0));
+    auto offsets_single = tile_offsets(single_traits, sizeof(T), 0,
+            alignment);
+    TEST_THROW(save_tiles<T>(src, fd, offsets_single));
+    TEST_THROW(load_tiles<T>(dst, fd, offsets_single));
+    std::vector<Index> offsets_overlap(offsets);
+    offsets_overlap[1] = offsets_overlap[0];
+    TEST_THROW(save_tiles<T>(src, fd, offsets_overlap));
+    // Reading beyond the end of file fails
+    auto offsets_far = tile_offsets(traits, sizeof(T),
+            1024*offsets.back(), alignment);
+    TEST_THROW(load_tiles<T>(dst, fd, offsets_far));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::tile_io::init();
+    starpu::subcopy::init();
+    starpu::tile_io::restrict_where(STARPU_CPU);
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    // Temporary file for all the tests
+    char filename[] = "/tmp/nntile_tile_io_XXXXXX";
+    int fd = mkstemp(filename);
+    TEST_ASSERT(fd >= 0);
+    // Launch all tests
+    validate<fp32_t>(fd);
+    validate<fp64_t>(fd);
+    validate<Index>(fd);
+    close(fd);
+    unlink(filename);
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/topk_sample.cc
+ * Sample tokens from logits through running top-k candidates
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/topk_sample.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/starpu/topk_maxsumexp.hh"
+#include "nntile/starpu/sample_topk.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/tensor/gather.hh"
+#include "../testing.hh"
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void check(Index vocab, Index vocab_tile, Index n_seq, Index n_seq_tile,
+        Index n_batch, Index n_batch_tile, Index k, Index top_k,
+        scal_t top_p)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Some preparation
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    std::vector<int> dist_root = {mpi_root};
+    unsigned long long seed = 42;
+    scal_t alpha = 2.0;
+    // Generate single-tile logits and init them
+    std::vector<Index> logits_shape{vocab, n_seq, n_batch},
+        topk_shape{k, n_seq, n_batch}, maxsumexp_shape{2, n_seq, n_batch},
+        tokens_shape{n_seq, n_batch};
+    TensorTraits logits_single_traits(logits_shape, logits_shape),
+        topk_single_traits(topk_shape, topk_shape),
+        maxsumexp_single_traits(maxsumexp_shape, maxsumexp_shape),
+        tokens_single_traits(tokens_shape, tokens_shape);
+    Tensor<T> logits_single(logits_single_traits, dist_root, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = logits_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_W);
+        for(Index i = 0; i < logits_single.nelems; ++i)
+        {
+            tile_local[i] = T(std::sin(Index(3*i+1)));
+        }
+        tile_local.release();
+    }
+    // Sample on the single tile
+    Tensor<T> topk_val_single(topk_single_traits, dist_root, last_tag),
+        maxsumexp_single(maxsumexp_single_traits, dist_root, last_tag);
+    Tensor<Index> topk_idx_single(topk_single_traits, dist_root, last_tag),
+        tokens_ref(tokens_single_traits, dist_root, last_tag);
+    topk_sample<T>(alpha, logits_single, topk_val_single, topk_idx_single,
+            maxsumexp_single, top_k, top_p, seed, tokens_ref);
+    // Scatter logits and sample on tiles
+    std::vector<Index> logits_basetile{vocab_tile, n_seq_tile, n_batch_tile},
+        topk_basetile{k, n_seq_tile, n_batch_tile},
+        maxsumexp_basetile{2, n_seq_tile, n_batch_tile},
+        tokens_basetile{n_seq_tile, n_batch_tile};
+    TensorTraits logits_traits(logits_shape, logits_basetile),
+        topk_traits(topk_shape, topk_basetile),
+        maxsumexp_traits(maxsumexp_shape, maxsumexp_basetile),
+        tokens_traits(tokens_shape, tokens_basetile);
+    std::vector<int> logits_distr(logits_traits.grid.nelems),
+        topk_distr(topk_traits.grid.nelems),
+        tokens_distr(tokens_traits.grid.nelems);
+    for(Index i = 0; i < logits_traits.grid.nelems; ++i)
+    {
+        logits_distr[i] = (i+1) % mpi_size;
+    }
+    for(Index i = 0; i < topk_traits.grid.nelems; ++i)
+    {
+        topk_distr[i] = (i+2) % mpi_size;
+        tokens_distr[i] = (i*i) % mpi_size;
+    }
+    Tensor<T> logits(logits_traits, logits_distr, last_tag),
+        topk_val(topk_traits, topk_distr, last_tag),
+        maxsumexp(maxsumexp_traits, topk_distr, last_tag);
+    Tensor<Index> topk_idx(topk_traits, topk_distr, last_tag),
+        tokens(tokens_traits, tokens_distr, last_tag);
+    scatter<T>(logits_single, logits);
+    topk_sample<T>(alpha, logits, topk_val, topk_idx, maxsumexp, top_k,
+            top_p, seed, tokens);
+    Tensor<Index> tokens_single(tokens_single_traits, dist_root, last_tag);
+    gather<Index>(tokens, tokens_single);
+    // Compare results on the root node
+    if(mpi_rank == mpi_root)
+    {
+        auto logits_tile = logits_single.get_tile(0);
+        auto logits_local = logits_tile.acquire(STARPU_R);
+        auto ref_tile = tokens_ref.get_tile(0);
+        auto ref_local = ref_tile.acquire(STARPU_R);
+        auto tokens_tile = tokens_single.get_tile(0);
+        auto tokens_local = tokens_tile.acquire(STARPU_R);
+        for(Index j = 0; j < tokens_single.nelems; ++j)
+        {
+            TEST_ASSERT(tokens_local[j] == ref_local[j]);
+            TEST_ASSERT(tokens_local[j] >= 0 and tokens_local[j] < vocab);
+            // Greedy choice is the first maximum of the column
+            if(top_k == 1)
+            {
+                Index argmax = 0;
+                for(Index i = 1; i < vocab; ++i)
+                {
+                    if(logits_local[j*vocab+i] > logits_local[j*vocab+argmax])
+                    {
+                        argmax = i;
+                    }
+                }
+                TEST_ASSERT(tokens_local[j] == argmax);
+            }
+        }
+        logits_local.release();
+        ref_local.release();
+        tokens_local.release();
+    }
+}
+
+template<typename T>
+void validate()
+{
+    // Greedy choice with tiles along all the axes
+    check<T>(50, 7, 3, 2, 4, 3, 4, 1, 1.0);
+    // Sampling with tiles along vocabulary and the last axis
+    check<T>(50, 7, 3, 3, 4, 1, 8, 5, 0.9);
+    check<T>(20, 20, 1, 1, 5, 2, 20, 0, 1.0);
+    // Sync to guarantee old data tags are cleaned up and can be reused
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Check throwing exceptions
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<int> dist0 = {0};
+    TensorTraits logits_traits({10, 3}, {10, 3}), topk_traits({4, 3}, {4, 3}),
+        topk_tiled_traits({4, 3}, {2, 3}), maxsumexp_traits({2, 3}, {2, 3}),
+        tokens_traits({3}, {3}), tokens_wrong_traits({4}, {4});
+    std::vector<int> dist00 = {0, 0};
+    Tensor<T> logits(logits_traits, dist0, last_tag),
+        topk_val(topk_traits, dist0, last_tag),
+        topk_val_tiled(topk_tiled_traits, dist00, last_tag),
+        maxsumexp(maxsumexp_traits, dist0, last_tag);
+    Tensor<Index> topk_idx(topk_traits, dist0, last_tag),
+        tokens(tokens_traits, dist0, last_tag),
+        tokens_wrong(tokens_wrong_traits, dist0, last_tag);
+    TEST_THROW(topk_sample<T>(1.0, logits, topk_val_tiled, topk_idx,
+                maxsumexp, 1, 1.0, 0, tokens));
+    TEST_THROW(topk_sample<T>(1.0, logits, topk_val, topk_idx, topk_val,
+                1, 1.0, 0, tokens));
+    TEST_THROW(topk_sample<T>(1.0, logits, topk_val, topk_idx, maxsumexp,
+                1, 1.0, 0, tokens_wrong));
+    TEST_THROW(topk_sample<T>(1.0, logits, topk_val, topk_idx, maxsumexp,
+                1, 1.0, 0, topk_idx));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::subcopy::init();
+    starpu::topk_maxsumexp::init();
+    starpu::sample_topk::init();
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    starpu::topk_maxsumexp::restrict_where(STARPU_CPU);
+    starpu::sample_topk::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*! @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+ *                              (Skoltech), Russia. All rights reserved.
+ *                 2023-present Artificial Intelligence Research Institute
+ *                              (AIRI), Russia. All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/view.cc
+ * Views of tensors, that share tiles without copying data
+ *
+ * @version 1.0.0
+ * */
+
+#include "nntile/tensor/view.hh"
+#include "nntile/tensor/clear.hh"
+#include "nntile/starpu/clear.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/tensor/gather.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void validate()
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Some preparation
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    std::vector<int> dist_root = {mpi_root};
+    std::vector<Index> shape{6, 8, 3}, basetile{6, 2, 2};
+    TensorTraits single_traits(shape, shape), traits(shape, basetile);
+    std::vector<int> distr(traits.grid.nelems);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        distr[i] = (i+1) % mpi_size;
+    }
+    // Generate source data
+    Tensor<T> src_single(single_traits, dist_root, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = src_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_W);
+        for(Index i = 0; i < src_single.nelems; ++i)
+        {
+            tile_local[i] = T(i+1);
+        }
+        tile_local.release();
+    }
+    Tensor<T> src(traits, distr, last_tag);
+    scatter<T>(src_single, src);
+    // Slice shares tiles of the source tensor
+    std::vector<Index> begin{0, 2, 2}, end{6, 6, 3};
+    auto slice = slice_view<T>(src, begin, end);
+    TEST_ASSERT(slice.shape == std::vector<Index>({6, 4, 1}));
+    TEST_ASSERT(slice.grid.nelems == 2);
+    std::vector<Index> slice_shape{6, 4, 1};
+    TensorTraits slice_single_traits(slice_shape, slice_shape);
+    Tensor<T> slice_single(slice_single_traits, dist_root, last_tag);
+    gather<T>(slice, slice_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = slice_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_R);
+        for(Index j = 0; j < 4; ++j)
+        {
+            for(Index i = 0; i < 6; ++i)
+            {
+                TEST_ASSERT(tile_local[j*6+i] == T(i+6*(j+2)+48*2+1));
+            }
+        }
+        tile_local.release();
+    }
+    // Updates of the slice are visible in the source tensor
+    clear<T>(slice);
+    Tensor<T> dst_single(single_traits, dist_root, last_tag);
+    gather<T>(src, dst_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = dst_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_R);
+        for(Index i = 0; i < dst_single.nelems; ++i)
+        {
+            Index j = (i/6) % 8, k = i / 48;
+            bool cleared = j >= 2 and j < 6 and k == 2;
+            TEST_ASSERT(tile_local[i] == (cleared ? T(0) : T(i+1)));
+        }
+        tile_local.release();
+    }
+    // Split and merge dimensions
+    auto split = reshape_view<T>(src, {6, 2, 4, 3}, {6, 2, 1, 2});
+    auto merged = reshape_view<T>(split, {48, 3}, {12, 2});
+    Tensor<T> merged_single(TensorTraits({48, 3}, {48, 3}), dist_root,
+            last_tag);
+    gather<T>(merged, merged_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = dst_single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_R);
+        auto tile2 = merged_single.get_tile(0);
+        auto tile2_local = tile2.acquire(STARPU_R);
+        for(Index i = 0; i < dst_single.nelems; ++i)
+        {
+            TEST_ASSERT(tile_local[i] == tile2_local[i]);
+        }
+        tile_local.release();
+        tile2_local.release();
+    }
+    // Check throwing exceptions
+    TEST_THROW(slice_view<T>(src, {0, 1, 0}, {6, 4, 3}));
+    TEST_THROW(slice_view<T>(src, {0, 0, 0}, {6, 3, 3}));
+    TEST_THROW(slice_view<T>(src, {0, 0}, {6, 4}));
+    TEST_THROW(slice_view<T>(src, {0, 2, 0}, {6, 2, 3}));
+    TEST_THROW(reshape_view<T>(src, {6, 8, 2}, {6, 2, 2}));
+    TEST_THROW(reshape_view<T>(src, {3, 2, 8, 3}, {1, 2, 2, 2}));
+    TEST_THROW(reshape_view<T>(src, {6, 2, 4, 3}, {6, 1, 2, 2}));
+    TEST_THROW(reshape_view<T>(src, {8, 6, 3}, {8, 6, 2}));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::clear::init();
+    starpu::subcopy::init();
+    starpu::clear::restrict_where(STARPU_CPU);
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    validate<Index>();
+    return 0;
+}
@@ -0,0 +1,168 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/examples/gpt2_continuous_batching.py
+# Load generator for continuous batching of GPT2 generation requests
+#
+# @version 1.0.0
+
+# Imports
+import torch
+import nntile
+import numpy as np
+import time
+import torch.nn as nn
+from transformers import GPT2LMHeadModel, GPT2Config
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
+        GPT2Model as GPT2Model_nntile
+from nntile.inference import GenerationRequest, ContinuousBatchingEngine
+import argparse
+import json
+
+# Create argument parser
+parser = argparse.ArgumentParser(prog="GPT2 continuous batching", \
+        description="This example generates a stream of requests with " \
+        "random prompt and output lengths, arriving as a Poisson process, " \
+        "and serves them by a continuous batching engine on top of a " \
+        "randomly initialized GPT2 model. It reports throughput of " \
+        "generated tokens and latency percentiles of requests.")
+
+parser.add_argument("--config-path", type=str, \
+        default="gpt2_default_config.json")
+parser.add_argument("--slots", type=int, default=8)
+parser.add_argument("--kv-cache-size", type=int, default=256)
+parser.add_argument("--kv-cache-tile", type=int, default=256)
+parser.add_argument("--kv-block-size", type=int, default=0, \
+        help="Size of blocks of paged caches, 0 for contiguous caches")
+parser.add_argument("--kv-num-blocks", type=int, default=0, \
+        help="Number of blocks of paged caches, 0 to fit all slots")
+parser.add_argument("--temperature", type=float, default=0.0, \
+        help="Temperature of sampling, 0 for greedy generation")
+parser.add_argument("--top-k", type=int, default=0, \
+        help="Number of candidates for sampling, 0 for all candidates")
+parser.add_argument("--top-p", type=float, default=1.0)
+parser.add_argument("--max-candidates", type=int, default=64)
+parser.add_argument("--num-requests", type=int, default=64)
+parser.add_argument("--rate", type=float, default=4.0, \
+        help="Mean number of arriving requests per second")
+parser.add_argument("--min-prompt", type=int, default=4)
+parser.add_argument("--max-prompt", type=int, default=64)
+parser.add_argument("--min-new-tokens", type=int, default=4)
+parser.add_argument("--max-new-tokens", type=int, default=64)
+parser.add_argument("--embd-tile", type=int, default=-1)
+parser.add_argument("--inner-tile", type=int, default=-1)
+parser.add_argument("--head-tile", type=int, default=-1)
+parser.add_argument("--restrict", choices=["cpu", "cuda", None], \
+        default=None)
+parser.add_argument("--seed", type=int, default=0)
+
+args = parser.parse_args()
+print(args)
+
+with open(args.config_path, "r") as fd:
+    conf_dict = json.load(fd)
+config = GPT2Config(**conf_dict)
+config.n_inner = 4 * config.n_embd
+config.attn_pdrop = 0
+config.embd_pdrop = 0
+config.resid_pdrop = 0
+if args.embd_tile == -1:
+    args.embd_tile = config.n_embd
+if args.inner_tile == -1:
+    args.inner_tile = config.n_inner
+if args.head_tile == -1:
+    args.head_tile = config.n_head
+assert config.n_head % args.head_tile == 0
+assert args.kv_cache_size <= config.n_positions
+assert args.max_prompt+args.max_new_tokens-1 <= args.kv_cache_size
+model_torch = GPT2LMHeadModel(config)
+model_torch.lm_head.weight = nn.Parameter(model_torch.lm_head \
+    .weight.detach().clone())
+
+# Set up StarPU+MPI and init codelets
+nntile_config = nntile.starpu.Config(-1, -1, 1)
+nntile.starpu.init()
+if args.restrict == "cuda":
+    nntile.starpu.restrict_cuda()
+elif args.restrict == "cpu":
+    nntile.starpu.restrict_cpu()
+next_tag = 0
+
+# Model processes as many positions, as caches hold
+model_nntile_config = GPT2Config_nntile(config.vocab_size, args.embd_tile, \
+        config.n_embd, args.embd_tile, config.max_position_embeddings, \
+        config.n_inner, args.inner_tile, config.layer_norm_epsilon, \
+        config.num_hidden_layers, config.n_head, args.head_tile, \
+        "gelutanh", False, False)
+model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, 1, 1, \
+        args.kv_cache_size, args.kv_cache_size, model_nntile_config, \
+        next_tag)
+del model_torch
+# Paged caches require a single sequence per tile
+if args.kv_block_size > 0:
+    batch_tile = 1
+else:
+    batch_tile = args.slots
+decoder, next_tag = model_nntile.generate_decoder(args.slots, batch_tile, \
+        args.kv_cache_tile, next_tag, kv_block_size=args.kv_block_size, \
+        kv_num_blocks=args.kv_num_blocks)
+# Generation does not stop at EOS to keep output lengths fixed
+engine = ContinuousBatchingEngine(decoder, next_tag, \
+        temperature=args.temperature, top_k=args.top_k, top_p=args.top_p, \
+        seed=args.seed, max_candidates=args.max_candidates)
+next_tag = engine.next_tag
+
+# Generate requests with Poisson arrivals
+rng = np.random.default_rng(args.seed)
+arrivals = np.cumsum(rng.exponential(1.0/args.rate, args.num_requests))
+prompt_lens = rng.integers(args.min_prompt, args.max_prompt+1, \
+        args.num_requests)
+new_tokens = rng.integers(args.min_new_tokens, args.max_new_tokens+1, \
+        args.num_requests)
+
+# Serve requests as they arrive
+time0 = time.perf_counter()
+requests = []
+i_request = 0
+while i_request < args.num_requests or engine.has_work():
+    now = time.perf_counter() - time0
+    while i_request < args.num_requests and arrivals[i_request] <= now:
+        prompt = rng.integers(config.vocab_size, size=prompt_lens[i_request])
+        request = GenerationRequest(prompt.tolist(), \
+                int(new_tokens[i_request]), time0+arrivals[i_request])
+        engine.submit(request)
+        requests.append(request)
+        i_request += 1
+    if engine.has_work():
+        engine.step()
+    elif i_request < args.num_requests:
+        time.sleep(max(0.0, arrivals[i_request]-now))
+nntile.starpu.wait_for_all()
+time1 = time.perf_counter() - time0
+
+# Report throughput and latency
+ntokens = sum(len(r.output) for r in requests)
+latency = np.array([r.latency() for r in requests])
+ttft = np.array([r.first_token_time-r.arrival_time for r in requests])
+print("Served {} requests in {} seconds and {} steps".format(len(requests), \
+        time1, engine.nsteps))
+print("Generated tokens/sec: {}".format(ntokens/time1))
+print("Mean batch occupancy: {}".format( \
+        sum(len(r.prompt)+len(r.output)-1 for r in requests) \
+        / (engine.nsteps*args.slots)))
+if args.kv_block_size > 0:
+    print("Positions of paged caches per layer: {}".format( \
+            decoder.kv_cache_size))
+print("Latency p50: {} seconds".format(np.percentile(latency, 50)))
+print("Latency p99: {} seconds".format(np.percentile(latency, 99)))
+print("Time to first token p50: {} seconds".format(np.percentile(ttft, 50)))
+print("Time to first token p99: {} seconds".format(np.percentile(ttft, 99)))
+
+engine.unregister()
+decoder.unregister()
+model_nntile.unregister()
@@ -59,6 +59,8 @@ parser.add_argument("--nwarmup", type=int, default=0)
 parser.add_argument("--input", choices=["text"], default="text")
 parser.add_argument("--input-path", default="input.txt")
 parser.add_argument("--ntokens", type=int, default=10)
+parser.add_argument("--kv-cache", action="store_true")
+parser.add_argument("--kv-cache-tile", type=int, default=-1)
 
 # Parse arguments
 args = parser.parse_args()
@@ -112,6 +114,9 @@ if args.head_tile == -1:
 assert args.head_tile > 0
 assert config.n_head % args.head_tile == 0
 assert args.nwarmup >= 0
+if args.kv_cache_tile == -1:
+    args.kv_cache_tile = args.seq_tile
+assert args.kv_cache_tile > 0
 
 # Print altered PyTorch model to be tested
 print("PyTorch model:")
@@ -182,6 +187,31 @@ if args.input == "text":
     input_tokens_start = input_tokens.shape[1]-1
     input_numpy[0, 0:input_tokens_start] = input_tokens[0, :-1]
 
+# Incremental decoding with caches of keys and values processes only new
+# positions and produces logits only for them
+if args.kv_cache:
+    decoder, next_tag = model_nntile.generate_decoder(1, 1, \
+            args.kv_cache_tile, next_tag)
+    output_numpy = np.zeros((config.vocab_size, 1, 1), dtype=np.float32, \
+            order='F')
+    time0 = time.time()
+    # Fill caches with the prompt
+    for i in range(input_tokens_start):
+        decoder.decode_async(input_numpy[:, i:i+1].T)
+    for i in range(args.ntokens):
+        decoder.activations[-1].value.to_array(output_numpy)
+        new_id = output_numpy[:50257, 0, 0].argmax()
+        input_numpy[0, input_tokens_start+i] = new_id
+        print(tokenizer.decode(input_numpy[0, 0:input_tokens_start+i+1]))
+        decoder.decode_async(input_numpy[:, input_tokens_start+i: \
+                input_tokens_start+i+1].T)
+    nntile.starpu.wait_for_all()
+    time1 = time.time() - time0
+    print("Generated {} tokens in {} seconds".format(args.ntokens, time1))
+    decoder.unregister()
+    model_nntile.unregister()
+    sys.exit(0)
+
 # Run forward 50 times autoregressively
 output_numpy = np.zeros((config.vocab_size, config.n_positions, 1), \
         dtype=np.float32, order='F')
@@ -83,6 +83,14 @@ parser.add_argument("--start-lr", type=float, default=0.0)
 parser.add_argument("--full-lr-iter", type=int, default=1)
 parser.add_argument("--nepochs", type=int, default=0)
 parser.add_argument("--nepochs-warmup", type=int, default=0)
+parser.add_argument("--async-checkpoint-every", type=int, default=0)
+parser.add_argument("--async-checkpoint-path", \
+        default="checkpoint_{step}.nntile")
+parser.add_argument("--trace-file", default="")
+parser.add_argument("--memory-timeline", default="")
+parser.add_argument("--submit-threads", type=int, default=0)
+parser.add_argument("--perfmodel-bundle", default="")
+parser.add_argument("--perfmodel-record", default="")
 
 # Parse arguments
 args = parser.parse_args()
@@ -180,6 +188,14 @@ nntile_config = nntile.starpu.Config(-1, -1, 1)
 nntile.starpu.profiling_init()
 nntile.starpu.profiling_disable()
 nntile.starpu.init()
+# Submit tasks of large tensor operations by several threads
+if args.submit_threads > 0:
+    nntile.starpu.submitter_init(args.submit_threads)
+# Install calibrated performance models before any task is submitted and
+# check that they cover all task shapes of the model
+if args.perfmodel_bundle:
+    nntile.perfmodel.import_bundle(args.perfmodel_bundle)
+    nntile.perfmodel.check(args.perfmodel_bundle)
 # Restrict computations to CUDA if possible
 if args.restrict == "cuda":
     nntile.starpu.restrict_cuda()
@@ -353,7 +369,29 @@ pipeline.train_async()
 nntile.starpu.wait_for_all()
 # Actual training
 pipeline.n_epochs = args.nepochs
+# Background snapshots of parameters and optimizer state
+checkpointer = None
+if args.async_checkpoint_every > 0:
+    ckpt_tensors = model_nntile.checkpoint_tensors()
+    if hasattr(optimizer, "checkpoint_tensors"):
+        ckpt_tensors.update(optimizer.checkpoint_tensors())
+    checkpointer = nntile.checkpoint.AsyncCheckpointer(ckpt_tensors, \
+            next_tag)
+    next_tag = checkpointer.next_tag
+    pipeline.set_checkpointer(checkpointer, args.async_checkpoint_every, \
+            args.async_checkpoint_path)
 nntile.starpu.profiling_enable()
+# Record executed tasks into a Chrome trace
+if args.trace_file:
+    nntile.starpu.trace_enable()
+# Record footprints of tasks to list them as required ones in a bundle
+if args.perfmodel_record:
+    nntile.perfmodel.record_enable()
+# Record memory of tensors by categories
+if args.memory_timeline:
+    nntile.memory.tag_model(model_nntile, optimizer)
+    nntile.memory.reset_peak()
+    nntile.memory.timeline_enable()
 #nntile.starpu.pause()
 time0 = time.time()
 pipeline.train_async()
@@ -362,6 +400,17 @@ nntile.starpu.wait_for_all()
 nntile.starpu.profiling_disable()
 time1 = time.time() - time0
 print("Training time: {} seconds".format(time1))
+if args.trace_file:
+    nntile.starpu.trace_disable()
+    nntile.starpu.trace_dump(args.trace_file)
+if args.perfmodel_record:
+    nntile.perfmodel.record_disable()
+    with open(args.perfmodel_record, "w") as fp:
+        json.dump(nntile.perfmodel.recorded(), fp)
+if args.memory_timeline:
+    nntile.memory.timeline_disable()
+    nntile.memory.report()
+    nntile.memory.dump_timeline(args.memory_timeline)
 print("Training throughput tokens/sec: {}".format( \
         args.nepochs * num_train_batches * args.batch \
         * config.n_positions / time1))
@@ -409,6 +458,8 @@ if args.save_optimizer is not None:
     optimizer.save_state(args.save_optimizer, dtype=args.save_optimizer_dtype)
 
 # Unregister all StarPU buffers
+if checkpointer is not None:
+    checkpointer.unregister()
 loss.unregister()
 optimizer.unregister()
 for batch in batch_input+batch_output:
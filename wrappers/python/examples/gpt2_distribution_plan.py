@@ -0,0 +1,69 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/examples/gpt2_distribution_plan.py
+# Print planned distributions of GPT2 tensors, per-rank memory and transfers
+#
+# @version 1.0.0
+
+import argparse
+import json
+from nntile.model.gpt2_distr import GPT2DistributionPlan
+
+# Create argument parser
+parser = argparse.ArgumentParser(prog="GPT2 distribution planner", \
+        description="This example selects distributions of all tensors of " \
+        "GPT2 model with a greedy cost model and prints expected amount of " \
+        "memory and received bytes of every MPI rank for a single training " \
+        "step.")
+parser.add_argument("--config-path", \
+        default="examples/gpt2_default_config.json")
+parser.add_argument("--mpi-size", type=int, default=4)
+parser.add_argument("--seq-len", type=int, default=1024)
+parser.add_argument("--seq-len-tile", type=int, default=1024)
+parser.add_argument("--minibatch-size", type=int, default=1)
+parser.add_argument("--minibatch-size-tile", type=int, default=1)
+parser.add_argument("--n-embd-tile", type=int, default=384)
+parser.add_argument("--n-inner-tile", type=int, default=1536)
+parser.add_argument("--n-head-tile", type=int, default=-1)
+parser.add_argument("--vocab-embd-tile", type=int, default=384)
+parser.add_argument("--dtype", choices=["fp32", "fp64"], default="fp32")
+parser.add_argument("--bandwidth", type=float, default=1e10)
+parser.add_argument("--flop-rate", type=float, default=1e13)
+parser.add_argument("--verbose", action="store_true")
+
+# Parse arguments
+args = parser.parse_args()
+print(args)
+
+# Read Huggingface config of GPT2
+with open(args.config_path, "r") as f:
+    hf_config = json.load(f)
+n_inner = hf_config.get("n_inner", None)
+if n_inner is None:
+    n_inner = 4 * hf_config["n_embd"]
+if args.n_head_tile == -1:
+    args.n_head_tile = hf_config["n_head"]
+config = {
+        "vocab_size": hf_config["vocab_size"],
+        "vocab_embed_dim_tile": args.vocab_embd_tile,
+        "embed_dim": hf_config["n_embd"],
+        "embed_dim_tile": args.n_embd_tile,
+        "inner_dim": n_inner,
+        "inner_dim_tile": args.n_inner_tile,
+        "num_hidden_layers": hf_config["n_layer"],
+        "n_head": hf_config["n_head"],
+        "n_head_tile": args.n_head_tile,
+        }
+elem_size = 4 if args.dtype == "fp32" else 8
+
+plan = GPT2DistributionPlan(config, args.minibatch_size, \
+        args.minibatch_size_tile, args.seq_len, args.seq_len_tile, \
+        args.mpi_size, elem_size, args.bandwidth, args.flop_rate)
+print(plan.report(args.verbose))
+print("Total received: {:.2f} MB".format(plan.transfer_bytes.sum() / 2**20))
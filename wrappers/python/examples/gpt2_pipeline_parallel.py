@@ -0,0 +1,166 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/examples/gpt2_pipeline_parallel.py
+# Throughput of pipeline-parallel training of GPT2 against sequential one
+#
+# @version 1.0.0
+
+# Imports
+import torch
+import nntile
+import numpy as np
+import time
+import torch.nn as nn
+from transformers import GPT2LMHeadModel, GPT2Config
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
+        GPT2Model as GPT2Model_nntile
+import argparse
+import json
+
+# Create argument parser
+parser = argparse.ArgumentParser(prog="GPT2 pipeline parallelism", \
+        description="This example trains a randomly initialized GPT2 model " \
+        "with a sequential pipeline, that processes minibatches one after " \
+        "another, and with a pipeline-parallel 1F1B schedule of " \
+        "micro-batches over stages of GPT2 blocks. It reports throughput of " \
+        "both approaches.")
+
+parser.add_argument("--config-path", type=str, \
+        default="gpt2_default_config.json")
+parser.add_argument("--pipeline-parallel", type=int, default=2)
+parser.add_argument("--seq-len-tile", type=int, default=1024)
+parser.add_argument("--num-samples", type=int, default=8)
+parser.add_argument("--batch-size", type=int, default=8)
+parser.add_argument("--minibatch-size", type=int, default=1)
+parser.add_argument("--minibatch-size-tile", type=int, default=1)
+parser.add_argument("--n-embd-tile", type=int, default=384)
+parser.add_argument("--n-inner-tile", type=int, default=1536)
+parser.add_argument("--n-head-tile", type=int, default=-1)
+parser.add_argument("--nntile-restrict", choices=["cpu", "cuda", None], \
+        default=None)
+parser.add_argument("--nntile-flashattention", action="store_true")
+parser.add_argument("--nntile-use-redux", action="store_true")
+parser.add_argument("--lr", type=float, default=0.0)
+parser.add_argument("--nepochs", type=int, default=1)
+
+args = parser.parse_args()
+print(args)
+
+assert args.num_samples % args.batch_size == 0
+assert args.batch_size % args.minibatch_size == 0
+assert args.minibatch_size % args.minibatch_size_tile == 0
+
+f = open(args.config_path)
+conf_dict = json.load(f)
+f.close()
+config = GPT2Config(**conf_dict)
+if args.n_head_tile == -1:
+    args.n_head_tile = config.n_head
+assert config.n_head % args.n_head_tile == 0
+assert config.n_positions % args.seq_len_tile == 0
+config.attn_pdrop = 0
+config.embd_pdrop = 0
+config.resid_pdrop = 0
+inner_dim = config.n_inner if config.n_inner is not None \
+    else 4 * config.hidden_size
+config.n_inner = inner_dim
+model_torch = GPT2LMHeadModel(config)
+model_torch.lm_head.weight = nn.Parameter(model_torch.lm_head \
+    .weight.detach().clone())
+
+# Set up StarPU+MPI and init codelets
+nntile_config = nntile.starpu.Config(-1, -1, 1)
+nntile.starpu.init()
+if args.nntile_restrict == "cuda":
+    nntile.starpu.restrict_cuda()
+elif args.nntile_restrict == "cpu":
+    nntile.starpu.restrict_cpu()
+next_tag = 0
+nntile_model_config = GPT2Config_nntile(config.vocab_size, args.n_embd_tile, \
+    config.n_embd, args.n_embd_tile, config.max_position_embeddings, \
+    config.n_inner, args.n_inner_tile, config.layer_norm_epsilon, \
+    config.num_hidden_layers, config.n_head, args.n_head_tile, \
+    "gelutanh", args.nntile_flashattention, args.nntile_use_redux, \
+    pipeline_parallel=args.pipeline_parallel)
+nntile_model, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+        args.minibatch_size, args.minibatch_size_tile, config.n_positions, \
+        args.seq_len_tile, nntile_model_config, next_tag)
+print("Stages of layers: {}".format(nntile_model.stages))
+
+# Create random dataset
+num_train_batches = args.num_samples // args.batch_size
+num_minibatch = args.batch_size // args.minibatch_size
+torch.manual_seed(0)
+random_dataset = torch.randint(config.vocab_size, \
+        (num_train_batches, num_minibatch, args.minibatch_size, \
+        config.n_positions+1), dtype=torch.int64)
+batch_input = []
+batch_output = []
+x_traits = nntile.tensor.TensorTraits( \
+        [config.n_positions, args.minibatch_size], \
+        [args.seq_len_tile, args.minibatch_size_tile])
+x_distr = [0] * x_traits.grid.nelems
+for i in range(num_train_batches):
+    minibatch_input = []
+    minibatch_output = []
+    for j in range(num_minibatch):
+        x = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+        next_tag = x.next_tag
+        x.from_array(np.asfortranarray(random_dataset[i, j, :, :-1].T))
+        minibatch_input.append(x)
+        y = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+        next_tag = y.next_tag
+        y.from_array(np.asfortranarray(random_dataset[i, j, :, 1:].T))
+        minibatch_output.append(y)
+    batch_input.append(minibatch_input)
+    batch_output.append(minibatch_output)
+
+# Set up optimizer and loss, shared by both pipelines
+nntile_optimizer = nntile.optimizer.FusedAdam(nntile_model.get_parameters(), \
+        args.lr, next_tag)
+next_tag = nntile_optimizer.get_next_tag()
+loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
+        nntile_model.activations[-1], next_tag)
+num_tokens = args.nepochs * args.num_samples * config.n_positions
+
+# Sequential pipeline
+pipeline = nntile.pipeline.Pipeline(batch_input, batch_output, \
+        nntile_model, nntile_optimizer, loss, args.nepochs)
+nntile.starpu.wait_for_all()
+time0 = time.time()
+pipeline.train_async()
+nntile.starpu.wait_for_all()
+time_seq = time.time() - time0
+print("Sequential training time: {} seconds".format(time_seq))
+print("Sequential training throughput tokens/sec: {}".format( \
+        num_tokens / time_seq))
+
+# Pipeline-parallel 1F1B schedule
+pipeline_parallel = nntile.pipeline.PipelineParallel(batch_input, \
+        batch_output, nntile_model, nntile_optimizer, loss, args.nepochs, \
+        next_tag)
+next_tag = pipeline_parallel.get_next_tag()
+nntile.starpu.wait_for_all()
+time0 = time.time()
+pipeline_parallel.train_async()
+nntile.starpu.wait_for_all()
+time_pp = time.time() - time0
+print("Pipeline-parallel training time: {} seconds".format(time_pp))
+print("Pipeline-parallel training throughput tokens/sec: {}".format( \
+        num_tokens / time_pp))
+print("Speedup of pipeline parallelism: {}".format(time_seq / time_pp))
+
+# Unregister all tensors
+pipeline_parallel.unregister()
+loss.unregister()
+nntile_optimizer.unregister()
+for batch in batch_input+batch_output:
+    for x in batch:
+        x.unregister()
+nntile_model.unregister()
@@ -12,4 +12,5 @@
 # @version 1.0.0
 
 from .nntile_core import starpu, tile, TransOp, trans, notrans
-from . import layer, loss, model, tensor, pipeline, optimizer
+from . import layer, loss, model, tensor, pipeline, optimizer, inference, \
+        checkpoint, counters, profiler, memory, perfmodel
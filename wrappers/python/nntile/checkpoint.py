@@ -0,0 +1,248 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/checkpoint.py
+# Binary tile-native checkpoints of tensors
+#
+# @version 1.0.0
+
+from nntile.nntile_core import tensor as core_tensor
+from nntile.nntile_core import starpu as core_starpu
+from nntile.tensor import TensorTraits, TensorFloatOrInt, \
+        save_tiles_async, load_tiles_async, retile_async
+import json
+import mmap
+import os
+import struct
+import threading
+import zlib
+from typing import Dict, Tuple
+
+# Layout of a checkpoint file:
+#  [0, 32): header of magic bytes, version, offset and size of the index
+#  [alignment, index offset): tiles of all tensors, each tile starts at an
+#      aligned offset (see nntile.tensor.tile_offsets)
+#  [index offset, end): JSON index with traits, type, offset of each tensor,
+#      checksums and user metadata
+# Tiles are written and read by StarPU tasks on nodes, that own them, so a
+# checkpoint is never gathered on a single node. The index is written last,
+# so a file without an index is an incomplete checkpoint.
+MAGIC = b"NNTILECK"
+VERSION = 1
+_HEADER = struct.Struct("<8sQQQ")
+
+_dtypes = {
+        core_tensor.Tensor_fp32: ("fp32", 4),
+        core_tensor.Tensor_fp32_fast_tf32: ("fp32_fast_tf32", 4),
+        core_tensor.Tensor_fp64: ("fp64", 8),
+        core_tensor.Tensor_int64: ("int64", 8),
+        core_tensor.Tensor_bool: ("bool", 1),
+        }
+
+def _dtype(x: TensorFloatOrInt) -> Tuple[str, int]:
+    if type(x) not in _dtypes:
+        raise TypeError("Unsupported type of tensor")
+    return _dtypes[type(x)]
+
+def _crc32(fd: int, start: int, end: int) -> int:
+    if start == end:
+        return 0
+    with mmap.mmap(fd, end, prot=mmap.PROT_READ) as buf:
+        return zlib.crc32(memoryview(buf)[start:end])
+
+# Plan offsets of tiles of all tensors
+def _layout(tensors: Dict[str, TensorFloatOrInt], alignment: int):
+    index = {}
+    offset = alignment
+    for name, x in tensors.items():
+        dtype, elemsize = _dtype(x)
+        traits = TensorTraits(x.shape, x.basetile_shape)
+        offsets = core_tensor.tile_offsets(traits, elemsize, offset, \
+                alignment)
+        index[name] = {"dtype": dtype, "shape": list(x.shape), \
+                "basetile_shape": list(x.basetile_shape), \
+                "offset": offset, "end": offsets[-1]}
+        offset = offsets[-1]
+    return index, offset
+
+# Save tensors and metadata into a checkpoint
+#
+# All the tiles are written in parallel and the function returns, when the
+# file is complete. The checkpoint is first written into a temporary file,
+# that replaces the target file only when it is complete, so an interrupted
+# save never destroys a previous checkpoint.
+def save(path: str, tensors: Dict[str, TensorFloatOrInt], \
+        metadata: dict=None, checksum: bool=True, alignment: int=4096):
+    index, end = _layout(tensors, alignment)
+    rank = core_starpu.mpi_world_rank()
+    tmp_path = path + ".tmp"
+    # Rank 0 creates the file before other ranks write their tiles into it
+    if rank == 0:
+        fd = os.open(tmp_path, os.O_RDWR | os.O_CREAT | os.O_TRUNC, 0o644)
+        os.ftruncate(fd, end)
+    core_starpu.mpi_barrier()
+    if rank != 0:
+        fd = os.open(tmp_path, os.O_RDWR)
+    try:
+        nerrors = core_starpu.tile_io_nerrors()
+        for name, x in tensors.items():
+            entry = index[name]
+            traits = TensorTraits(x.shape, x.basetile_shape)
+            offsets = core_tensor.tile_offsets(traits, _dtype(x)[1], \
+                    entry["offset"], alignment)
+            save_tiles_async(x, fd, offsets)
+        # Wait only for local tiles of saved tensors, as other tasks may
+        # still be running. Rank 0 finalizes the file only after all ranks
+        # wrote their tiles.
+        for x in tensors.values():
+            x.wait()
+        failed = core_starpu.tile_io_nerrors() != nerrors
+        core_starpu.mpi_barrier()
+        if failed:
+            raise IOError("Failed to write tiles into {}".format(tmp_path))
+        if rank == 0:
+            for entry in index.values():
+                entry["crc32"] = _crc32(fd, entry["offset"], entry["end"]) \
+                        if checksum else None
+            data = json.dumps({"alignment": alignment, "tensors": index, \
+                    "metadata": metadata or {}}).encode()
+            os.pwrite(fd, data, end)
+            os.pwrite(fd, _HEADER.pack(MAGIC, VERSION, end, len(data)), 0)
+            os.fsync(fd)
+    finally:
+        os.close(fd)
+    if rank == 0:
+        os.replace(tmp_path, path)
+    core_starpu.mpi_barrier()
+
+# Read the index of a checkpoint
+def read_index(path: str) -> dict:
+    with open(path, "rb") as fp:
+        magic, version, index_offset, index_size = \
+                _HEADER.unpack(fp.read(_HEADER.size))
+        if magic != MAGIC:
+            raise ValueError("{} is not an NNTile checkpoint".format(path))
+        if version != VERSION:
+            raise ValueError("Unsupported checkpoint version {}" \
+                    .format(version))
+        fp.seek(index_offset)
+        return json.loads(fp.read(index_size))
+
+# Load tensors from a checkpoint and return its metadata
+#
+# Tiles are read directly into tensors, if their tiling is the same as in
+# the checkpoint. Otherwise, tiles are read into a temporary tensor with the
+# stored tiling, that is copied into the target one. All the tensors must be
+# present in the checkpoint with the same shape and type. Checksums are
+# verified before reading, if requested.
+def load(path: str, tensors: Dict[str, TensorFloatOrInt], next_tag: int, \
+        verify: bool=True) -> Tuple[dict, int]:
+    index = read_index(path)
+    alignment = index["alignment"]
+    fd = os.open(path, os.O_RDONLY)
+    tmps = []
+    try:
+        entries = {}
+        for name, x in tensors.items():
+            if name not in index["tensors"]:
+                raise KeyError("{} is not in checkpoint".format(name))
+            entry = index["tensors"][name]
+            dtype, elemsize = _dtype(x)
+            if entry["dtype"] != dtype:
+                raise TypeError("Wrong type of {}".format(name))
+            if entry["shape"] != list(x.shape):
+                raise ValueError("Wrong shape of {}".format(name))
+            if verify and entry["crc32"] is not None and entry["crc32"] \
+                    != _crc32(fd, entry["offset"], entry["end"]):
+                raise ValueError("Checksum mismatch of {}".format(name))
+            entries[name] = entry
+        nerrors = core_starpu.tile_io_nerrors()
+        for name, x in tensors.items():
+            entry = entries[name]
+            elemsize = _dtype(x)[1]
+            traits = TensorTraits(entry["shape"], entry["basetile_shape"])
+            offsets = core_tensor.tile_offsets(traits, elemsize, \
+                    entry["offset"], alignment)
+            if entry["basetile_shape"] == list(x.basetile_shape):
+                load_tiles_async(x, fd, offsets)
+                continue
+            # Retile on load
+            tmp = type(x)(traits, [0]*traits.grid.nelems, next_tag)
+            next_tag = tmp.next_tag
+            load_tiles_async(tmp, fd, offsets)
+            retile_async(tmp, x)
+            tmps.append(tmp)
+        for x in tensors.values():
+            x.wait()
+        if core_starpu.tile_io_nerrors() != nerrors:
+            raise IOError("Failed to read tiles from {}".format(path))
+    finally:
+        for tmp in tmps:
+            tmp.unregister()
+        os.close(fd)
+    return index["metadata"], next_tag
+
+# Background checkpointing, that overlaps with training
+#
+# A snapshot submits copies of all tensors into staging tensors of the same
+# traits and distribution and returns immediately. Copies only read source
+# tensors, so the next update of a tensor waits only for its copy and not
+# for the disk. Staging tensors are written into a file by a background
+# thread while training goes on. Memory of staged tensors is doubled. A new
+# snapshot waits for the previous one to be written.
+class AsyncCheckpointer:
+    tensors: Dict[str, TensorFloatOrInt]
+    staging: Dict[str, TensorFloatOrInt]
+
+    def __init__(self, tensors: Dict[str, TensorFloatOrInt], next_tag: int, \
+            checksum: bool=True, alignment: int=4096):
+        self.tensors = tensors
+        self.staging = {}
+        for name, x in tensors.items():
+            _dtype(x)
+            traits = TensorTraits(x.shape, x.basetile_shape)
+            self.staging[name] = type(x)(traits, x.distribution, next_tag)
+            next_tag = self.staging[name].next_tag
+        self.next_tag = next_tag
+        self.checksum = checksum
+        self.alignment = alignment
+        self.thread = None
+        self.error = None
+
+    # Take a snapshot of current values of tensors and write it into a file
+    def snapshot(self, path: str, metadata: dict=None):
+        self.wait()
+        for name, x in self.tensors.items():
+            y = self.staging[name]
+            retile_async(x, y)
+        self.thread = threading.Thread(target=self._write, \
+                args=(path, metadata), daemon=True)
+        self.thread.start()
+
+    def _write(self, path: str, metadata: dict):
+        try:
+            save(path, self.staging, metadata, self.checksum, self.alignment)
+        except BaseException as e:
+            self.error = e
+
+    # Wait for the last snapshot to be written and raise its error, if any
+    def wait(self):
+        if self.thread is not None:
+            self.thread.join()
+            self.thread = None
+        if self.error is not None:
+            error = self.error
+            self.error = None
+            raise error
+
+    # Wait for the last snapshot and unregister staging tensors
+    def unregister(self):
+        self.wait()
+        for y in self.staging.values():
+            y.unregister()
+        self.staging = {}
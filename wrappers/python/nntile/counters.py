@@ -0,0 +1,98 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/counters.py
+# Report of FLOPs, bytes and time of executed tasks per codelet
+#
+# @version 1.0.0
+
+from nntile.nntile_core import starpu as core_starpu
+from contextlib import contextmanager
+import sys
+import time
+from typing import Dict, List, Optional
+
+# Every task adds its STARPU_FLOPS, an estimate of bytes of its buffers and
+# its execution time to counters of its codelet. Bytes are read (STARPU_R)
+# and written (STARPU_W) sizes of buffers, so a STARPU_RW buffer counts
+# twice. Counters are accumulated only when enabled.
+enable = core_starpu.counters_enable
+disable = core_starpu.counters_disable
+is_enabled = core_starpu.counters_is_enabled
+reset = core_starpu.counters_reset
+
+# Counters of all codelets with at least one executed task, sorted by time
+def get() -> List[Dict]:
+    records = core_starpu.counters_get()
+    records.sort(key=lambda rec: rec["seconds"], reverse=True)
+    return records
+
+class Measurement:
+    def __init__(self):
+        self.records = []
+        self.wall_time = 0.0
+
+    # Total over all codelets
+    def total(self) -> Dict:
+        res = {"name": "total", "ntasks": 0, "flops": 0.0, "bytes": 0.0, \
+                "seconds": 0.0}
+        for rec in self.records:
+            for key in ("ntasks", "flops", "bytes", "seconds"):
+                res[key] += rec[key]
+        return res
+
+    # Print a table of per-codelet counters. If machine balance (peak FLOP/s
+    # over peak bytes/s) is given, codelets with arithmetic intensity below
+    # it are marked as bandwidth-bound, others as compute-bound.
+    def report(self, balance: Optional[float]=None, file=sys.stdout):
+        print("{:<36} {:>8} {:>10} {:>10} {:>10} {:>9} {:>8} {:>8}".format( \
+                "codelet", "tasks", "GFLOP", "GB", "time, s", "GFLOP/s", \
+                "GB/s", "FLOP/B"), file=file)
+        for rec in self.records + [self.total()]:
+            seconds = rec["seconds"]
+            gflops = rec["flops"] * 1e-9
+            gbytes = rec["bytes"] * 1e-9
+            rate = gflops / seconds if seconds > 0 else 0.0
+            bandwidth = gbytes / seconds if seconds > 0 else 0.0
+            intensity = rec["flops"]/rec["bytes"] if rec["bytes"] > 0 \
+                    else 0.0
+            bound = ""
+            if balance is not None and rec["flops"] > 0:
+                bound = "compute" if intensity >= balance else "bandwidth"
+            print("{:<36} {:>8} {:>10.3f} {:>10.3f} {:>10.4f} {:>9.2f} " \
+                    "{:>8.2f} {:>8.2f} {}".format(rec["name"][:36], \
+                    rec["ntasks"], gflops, gbytes, seconds, rate, \
+                    bandwidth, intensity, bound), file=file)
+        # Sum of task times exceeds the wall time with several workers, so
+        # the achieved rate is computed over the wall time separately
+        if self.wall_time > 0:
+            total = self.total()
+            print("Wall time {:.4f} s, achieved {:.2f} GFLOP/s".format( \
+                    self.wall_time, total["flops"]*1e-9/self.wall_time), \
+                    file=file)
+
+# Measure counters of all tasks, submitted within a context, e.g. of a single
+# training step:
+#     with nntile.counters.measure() as m:
+#         pipeline.train_async()
+#     m.report()
+# All tasks are waited for at exit of the context.
+@contextmanager
+def measure():
+    res = Measurement()
+    core_starpu.wait_for_all()
+    reset()
+    enable()
+    time0 = time.time()
+    try:
+        yield res
+        core_starpu.wait_for_all()
+    finally:
+        res.wall_time = time.time() - time0
+        disable()
+        res.records = get()
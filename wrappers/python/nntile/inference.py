@@ -0,0 +1,344 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/inference.py
+# Inference engine with continuous batching of generation requests
+#
+# @version 1.0.0
+
+from nntile.model.gpt2 import GPT2Model
+from nntile.tensor import TensorTraits, Tensor, Tensor_int64, \
+        topk_sample_async
+import numpy as np
+import time
+from collections import deque
+from typing import List, Optional
+
+# Request to generate up to max_new_tokens tokens after a prompt
+class GenerationRequest(object):
+    prompt: List[int]
+    max_new_tokens: int
+    output: List[int]
+    # Timestamps of arrival, of the first generated token and of finish
+    arrival_time: float
+    first_token_time: Optional[float]
+    finish_time: Optional[float]
+
+    def __init__(self, prompt: List[int], max_new_tokens: int, \
+            arrival_time: float=None):
+        if len(prompt) == 0:
+            raise ValueError("Prompt shall not be empty")
+        self.prompt = list(prompt)
+        self.max_new_tokens = max_new_tokens
+        self.output = []
+        if arrival_time is None:
+            arrival_time = time.perf_counter()
+        self.arrival_time = arrival_time
+        self.first_token_time = None
+        self.finish_time = None
+
+    def latency(self) -> float:
+        return self.finish_time - self.arrival_time
+
+# Pool of blocks of paged caches of keys and values
+#
+# Blocks are handed out to sequences and returned back when sequences are
+# finished. The mask tells, which positions of blocks are filled.
+class BlockAllocator(object):
+    block_size: int
+    free_blocks: deque
+    mask: np.ndarray
+
+    def __init__(self, n_blocks: int, block_size: int):
+        self.block_size = block_size
+        self.free_blocks = deque(range(n_blocks))
+        self.mask = np.zeros((block_size, n_blocks), dtype=bool, order="F")
+
+    # Number of blocks to hold given number of positions
+    def blocks_needed(self, npositions: int) -> int:
+        return max(1, (npositions-1)//self.block_size+1)
+
+    def num_free(self) -> int:
+        return len(self.free_blocks)
+
+    def allocate(self, nblocks: int) -> List[int]:
+        if nblocks > len(self.free_blocks):
+            raise ValueError("Not enough free blocks")
+        return [self.free_blocks.popleft() for i in range(nblocks)]
+
+    def free(self, blocks: List[int]):
+        for block in blocks:
+            self.mask[:, block] = False
+            self.free_blocks.append(block)
+
+# Sampling of next tokens from logits of shape (vocab_size, ...)
+#
+# Logits are consumed tile by tile on nodes, that own them, keeping only
+# max_candidates largest values of each column along with the maximum and
+# the sum of exponents of the entire column (see topk_sample_async). Only
+# indices of sampled tokens are copied to the host instead of entire logits.
+# Zero temperature means greedy choice, otherwise a token is drawn from at
+# most top_k candidates, that form a nucleus of probability top_p. The
+# nucleus is exact as long as it fits into max_candidates.
+class SamplingHead(object):
+    topk_val: Tensor
+    topk_idx: Tensor_int64
+    maxsumexp: Tensor
+    tokens: Tensor_int64
+
+    def __init__(self, logits: Tensor, max_candidates: int, next_tag: int):
+        vocab_size = logits.shape[0]
+        k = min(max_candidates, vocab_size)
+        col_shape = logits.shape[1:]
+        col_basetile = logits.basetile_shape[1:]
+        # Outputs of a column tile are owned by the owner of its first
+        # tile of logits
+        distr = logits.distribution[::logits.grid.shape[0]]
+        topk_traits = TensorTraits([k]+col_shape, [k]+col_basetile)
+        maxsumexp_traits = TensorTraits([2]+col_shape, [2]+col_basetile)
+        tokens_traits = TensorTraits(col_shape, col_basetile)
+        self.topk_val = type(logits)(topk_traits, distr, next_tag)
+        next_tag = self.topk_val.next_tag
+        self.topk_idx = Tensor_int64(topk_traits, distr, next_tag)
+        next_tag = self.topk_idx.next_tag
+        self.maxsumexp = type(logits)(maxsumexp_traits, distr, next_tag)
+        next_tag = self.maxsumexp.next_tag
+        self.tokens = Tensor_int64(tokens_traits, distr, next_tag)
+        self.next_tag = self.tokens.next_tag
+        self.output = np.zeros(col_shape, dtype=np.int64, order="F")
+
+    # Sample tokens and copy them into self.output
+    def sample(self, logits: Tensor, temperature: float, top_k: int, \
+            top_p: float, seed: int) -> np.ndarray:
+        if temperature > 0:
+            topk_sample_async(1.0/temperature, logits, self.topk_val, \
+                    self.topk_idx, self.maxsumexp, top_k, top_p, seed, \
+                    self.tokens)
+        else:
+            topk_sample_async(1.0, logits, self.topk_val, self.topk_idx, \
+                    self.maxsumexp, 1, 1.0, seed, self.tokens)
+        self.topk_val.invalidate_submit()
+        self.topk_idx.invalidate_submit()
+        self.maxsumexp.invalidate_submit()
+        self.tokens.to_array(self.output)
+        return self.output
+
+    def unregister(self):
+        self.topk_val.unregister()
+        self.topk_idx.unregister()
+        self.maxsumexp.unregister()
+        self.tokens.unregister()
+
+# State of a sequence slot of the engine
+class _Slot(object):
+    request: GenerationRequest
+    # Position of the next token within the sequence
+    length: int
+    # Position of caches, where the first token of the sequence is stored
+    cache_start: int
+    # Blocks of paged caches, that are reserved for the sequence
+    blocks: List[int]
+    next_token: int
+
+    def __init__(self, request: GenerationRequest, cache_start: int, \
+            blocks: List[int]=None):
+        self.request = request
+        self.length = 0
+        self.cache_start = cache_start
+        self.blocks = blocks
+        self.next_token = request.prompt[0]
+
+# Number of positions, stored in caches for a request. The last generated
+# token is never fed back into the decoder.
+def _cache_positions(request: GenerationRequest) -> int:
+    return len(request.prompt) + request.max_new_tokens - 1
+
+# Generation for many requests with continuous batching
+#
+# The decoder (see GPT2Model.generate_decoder) processes a single new token
+# for each of its batch_size sequence slots per step. Requests are admitted
+# into free slots and evicted from them between steps, so finished sequences
+# never stall the batch. All slots store keys and values of a step at the
+# same position of caches, that is advanced cyclically, while the mask of
+# each slot allows only positions, written since admission of its request.
+# As a slot writes one position per step, its own positions are never
+# overwritten while its sequence fits into caches. Prompts are fed one token
+# per step along with generated tokens of other slots.
+#
+# If caches of the decoder are paged (see kv_block_size of
+# GPT2Model.generate_decoder), a request is admitted only when there are
+# enough free blocks for all its positions, and each slot attends only to
+# its own blocks. Blocks are returned to the pool as soon as the request is
+# finished, so the number of concurrent requests is limited by their actual
+# lengths instead of the maximal length of a sequence.
+#
+# Next tokens are sampled by SamplingHead, so logits never leave the nodes,
+# that compute them. Random numbers of a step depend only on seed, number of
+# the step and slot, so that generation is reproducible.
+class ContinuousBatchingEngine(object):
+    decoder: GPT2Model
+    slots: List[Optional[_Slot]]
+    queue: deque
+    finished: List[GenerationRequest]
+    cache_pos: int
+    max_seq_len: int
+    nsteps: int
+
+    def __init__(self, decoder: GPT2Model, next_tag: int, \
+            eos_token_id: int=None, temperature: float=0.0, top_k: int=0, \
+            top_p: float=1.0, seed: int=0, max_candidates: int=64):
+        if decoder.kv_cache_size == 0:
+            raise ValueError("Decoder shall have caches of keys and values")
+        seq_len, batch_size = decoder.activations[0].value.shape
+        if seq_len != 1:
+            raise ValueError("Decoder shall process a single token per step")
+        self.decoder = decoder
+        self.eos_token_id = eos_token_id
+        self.slots = [None] * batch_size
+        self.queue = deque()
+        self.finished = []
+        self.cache_pos = 0
+        self.max_seq_len = min(decoder.kv_cache_size, \
+                decoder.config["max_position_embeddings"])
+        if decoder.kv_block_size > 0:
+            self.allocator = BlockAllocator( \
+                    decoder.kv_cache_size // decoder.kv_block_size, \
+                    decoder.kv_block_size)
+            self.max_seq_len = min(self.max_seq_len, \
+                    decoder.max_blocks*decoder.kv_block_size)
+        else:
+            self.allocator = None
+        self.temperature = temperature
+        self.top_k = top_k
+        self.top_p = top_p
+        self.seed = seed
+        self.head = SamplingHead(decoder.activations[-1].value, \
+                max_candidates, next_tag)
+        self.next_tag = self.head.next_tag
+        self.nsteps = 0
+        decoder.reset_cache()
+
+    def submit(self, request: GenerationRequest):
+        if _cache_positions(request) > self.max_seq_len:
+            raise ValueError("Request does not fit into caches")
+        if self.allocator is not None and self.allocator.blocks_needed( \
+                _cache_positions(request)) > self.allocator.mask.shape[1]:
+            raise ValueError("Request does not fit into pool of blocks")
+        self.queue.append(request)
+
+    def num_active(self) -> int:
+        return sum(1 for slot in self.slots if slot is not None)
+
+    def has_work(self) -> bool:
+        return len(self.queue) > 0 or self.num_active() > 0
+
+    # Admit waiting requests into free slots in order of arrival
+    def _admit(self):
+        for i in range(len(self.slots)):
+            if len(self.queue) == 0:
+                break
+            if self.slots[i] is not None:
+                continue
+            blocks = None
+            if self.allocator is not None:
+                nblocks = self.allocator.blocks_needed( \
+                        _cache_positions(self.queue[0]))
+                if nblocks > self.allocator.num_free():
+                    break
+                blocks = self.allocator.allocate(nblocks)
+            self.slots[i] = _Slot(self.queue.popleft(), self.cache_pos, \
+                    blocks)
+
+    def _finish(self, i: int, now: float):
+        request = self.slots[i].request
+        request.finish_time = now
+        self.finished.append(request)
+        if self.allocator is not None:
+            self.allocator.free(self.slots[i].blocks)
+        self.slots[i] = None
+
+    # Submit decoding step with paged caches
+    def _decode_paged(self, input_ids: np.ndarray, \
+            positional_ids: np.ndarray):
+        block_size = self.allocator.block_size
+        n_slots = len(self.slots)
+        block_table = [[] for i in range(n_slots)]
+        slot_block = [-1] * n_slots
+        slot_offset = [0] * n_slots
+        for i, slot in enumerate(self.slots):
+            if slot is None:
+                continue
+            block_idx, offset = divmod(slot.length, block_size)
+            block_table[i] = slot.blocks[:block_idx+1]
+            slot_block[i] = slot.blocks[block_idx]
+            slot_offset[i] = offset
+            self.allocator.mask[offset, slot_block[i]] = True
+        self.decoder.decode_paged_step_async(input_ids, positional_ids, \
+                self.allocator.mask, block_table, slot_block, slot_offset)
+
+    # Single decoding step for all active slots
+    def step(self):
+        self._admit()
+        if self.num_active() == 0:
+            return
+        n_cache = self.decoder.kv_cache_size
+        batch_size = len(self.slots)
+        input_ids = np.zeros((1, batch_size), dtype=np.int64, order="F")
+        positional_ids = np.zeros((1, batch_size), dtype=np.int64, \
+                order="F")
+        for i, slot in enumerate(self.slots):
+            if slot is None:
+                continue
+            input_ids[0, i] = slot.next_token
+            positional_ids[0, i] = slot.length
+        if self.allocator is not None:
+            self._decode_paged(input_ids, positional_ids)
+        else:
+            # Empty slots attend only to the current position to keep
+            # softmax well defined
+            mask = np.zeros((n_cache, 1, batch_size), dtype=bool, order="F")
+            mask[self.cache_pos, 0, :] = True
+            for i, slot in enumerate(self.slots):
+                if slot is None:
+                    continue
+                idx = (slot.cache_start+np.arange(slot.length+1)) % n_cache
+                mask[idx, 0, i] = True
+            self.decoder.decode_step_async(input_ids, positional_ids, mask, \
+                    self.cache_pos)
+        tokens = self.head.sample(self.decoder.activations[-1].value, \
+                self.temperature, self.top_k, self.top_p, \
+                self.seed+self.nsteps)
+        now = time.perf_counter()
+        self.cache_pos = (self.cache_pos+1) % n_cache
+        self.nsteps += 1
+        for i, slot in enumerate(self.slots):
+            if slot is None:
+                continue
+            request = slot.request
+            slot.length += 1
+            # Continue feeding the prompt
+            if slot.length < len(request.prompt):
+                slot.next_token = request.prompt[slot.length]
+                continue
+            token = int(tokens[0, i])
+            request.output.append(token)
+            if request.first_token_time is None:
+                request.first_token_time = now
+            slot.next_token = token
+            if len(request.output) == request.max_new_tokens \
+                    or token == self.eos_token_id \
+                    or slot.length == self.max_seq_len:
+                self._finish(i, now)
+
+    # Run steps until all submitted requests are finished
+    def run(self):
+        while self.has_work():
+            self.step()
+
+    def unregister(self):
+        self.head.unregister()
@@ -17,6 +17,8 @@ from .linear import Linear
 from .attention import Attention
 from .flash_attention import FlashAttention
 from .attention_single_head import AttentionSingleHead
+from .attention_kv_cache import AttentionKVCache
+from .attention_paged_kv_cache import AttentionPagedKVCache
 from .embedding import Embedding
 from .layer_norm import LayerNorm
 from .fp32_to_fp16 import FP32_to_FP16
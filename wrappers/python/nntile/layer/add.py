@@ -26,9 +26,12 @@ class Add(BaseLayer):
         super().__init__([x, y], [res], [], [])
 
     @staticmethod
-    def generate_simple(x: TensorMoments, y: TensorMoments, next_tag: int):
+    def generate_simple(x: TensorMoments, y: TensorMoments, next_tag: int, \
+            res_distr: List[int]=None):
         res_traits = TensorTraits(y.value.shape, y.value.basetile_shape)
-        res_distr = [0] * res_traits.grid.nelems
+        # Result is stored where y is, unless another distribution is given
+        if res_distr is None:
+            res_distr = y.value.distribution
         res_value = type(y.value)(res_traits, res_distr, next_tag)
         next_tag = res_value.next_tag
         res_grad = type(y.value)(res_traits, res_distr, next_tag)
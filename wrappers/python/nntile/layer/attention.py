@@ -15,7 +15,7 @@ from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         TransOp, trans, notrans, clear_async, gemm_async, randn_async, \
         maxsumexp_async, softmax_inplace_async, sumprod_slice_async, \
         add_slice_async, prod_async, mask_scalar_async, add_fiber_async, \
-        sum_fiber_async, transpose_async, copy_async
+        sum_fiber_async, transpose_async, copy_async, distr_along_axis
 
 from nntile.layer.base_layer import BaseLayer
 import numpy as np
@@ -63,7 +63,7 @@ class Attention(BaseLayer):
             b: TensorMoments, b_transposed: TensorMoments, \
             in_proj_bias_q: TensorMoments, in_proj_bias_k: TensorMoments, \
             in_proj_bias_v: TensorMoments, out_proj_bias: TensorMoments, \
-            mask=None, redux: bool=False):
+            mask=None, redux: bool=False, redux_heads: bool=False):
         qkv_bias_list = []
         if in_proj_bias_q:
             qkv_bias_list.append(in_proj_bias_q)
@@ -141,12 +141,19 @@ class Attention(BaseLayer):
             self.redux = 1
         else:
             self.redux = 0
+        # Gemms, that sum up contributions of all heads, accumulate partial
+        # results of different ranks when heads are distributed
+        if redux or redux_heads:
+            self.redux_heads = 1
+        else:
+            self.redux_heads = 0
 
     # Simple generator for the linear layer
     @staticmethod
     def generate_simple(x_q: TensorMoments, x_k: TensorMoments, \
             x_v: TensorMoments, n_head: int, n_head_tile: int, next_tag: int, \
-            bias=False, mask=None, redux: bool=False):
+            bias=False, mask=None, redux: bool=False, \
+            head_distr: List[int]=None):
         # Get sizes
         n_emb, n_seq, n_batch = x_q.value.shape
         n_emb_tile, n_seq_tile, n_batch_tile = x_q.value.basetile_shape
@@ -218,26 +225,37 @@ class Attention(BaseLayer):
                 a_sumprod_slice_basetile)
         b_traits = TensorTraits(b_shape, b_basetile)
         b_transposed_traits = TensorTraits(b_transposed_shape, b_transposed_basetile)
-        # TODO change distribution
-        w_q_distr = [0] * w_q_traits.grid.nelems
-        w_k_distr = [0] * w_k_traits.grid.nelems
-        w_v_distr = [0] * w_v_traits.grid.nelems
-        w_distr = [0] * w_traits.grid.nelems
-        q_transposed_distr = [0] * q_transposed_traits.grid.nelems
-        q_distr = [0] * q_traits.grid.nelems
-        k_transposed_distr = [0] * k_transposed_traits.grid.nelems
-        k_distr = [0] * k_traits.grid.nelems
-        v_transposed_distr = [0] * v_transposed_traits.grid.nelems
-        v_distr = [0] * v_traits.grid.nelems
-        a_distr = [0] * a_traits.grid.nelems
-        a_maxsumexp_distr = [0] * a_maxsumexp_traits.grid.nelems
-        a_sumprod_slice_distr = [0] * a_sumprod_slice_traits.grid.nelems
-        b_distr = [0] * b_traits.grid.nelems
-        b_transposed_distr = [0] * b_transposed_traits.grid.nelems
+        # Tiles of all tensors are distributed along heads, while tiles of
+        # the same head tile are stored together
+        if head_distr is None:
+            head_distr = [0] * w_q_traits.grid.shape[0]
+        w_q_distr = distr_along_axis(w_q_traits, 0, head_distr)
+        w_k_distr = distr_along_axis(w_k_traits, 0, head_distr)
+        w_v_distr = distr_along_axis(w_v_traits, 0, head_distr)
+        w_distr = distr_along_axis(w_traits, 1, head_distr)
+        q_transposed_distr = distr_along_axis(q_transposed_traits, 0, \
+                head_distr)
+        q_distr = distr_along_axis(q_traits, 3, head_distr)
+        k_transposed_distr = distr_along_axis(k_transposed_traits, 0, \
+                head_distr)
+        k_distr = distr_along_axis(k_traits, 3, head_distr)
+        v_transposed_distr = distr_along_axis(v_transposed_traits, 0, \
+                head_distr)
+        v_distr = distr_along_axis(v_traits, 3, head_distr)
+        a_distr = distr_along_axis(a_traits, 3, head_distr)
+        a_maxsumexp_distr = distr_along_axis(a_maxsumexp_traits, 3, \
+                head_distr)
+        a_sumprod_slice_distr = distr_along_axis(a_sumprod_slice_traits, 2, \
+                head_distr)
+        b_distr = distr_along_axis(b_traits, 3, head_distr)
+        b_transposed_distr = distr_along_axis(b_transposed_traits, 0, \
+                head_distr)
+        redux_heads = len(set(head_distr)) > 1
         if bias:
             in_proj_bias_qkv_traits = TensorTraits([head_size, n_head], \
                     [head_size_tile, n_head_tile])
-            in_proj_bias_qkv_distr = [0] * in_proj_bias_qkv_traits.grid.nelems
+            in_proj_bias_qkv_distr = distr_along_axis( \
+                    in_proj_bias_qkv_traits, 1, head_distr)
         # Define all the lists
         # w_q
         w_q_value = type(x_q.value)(w_q_traits, w_q_distr, next_tag)
@@ -390,7 +408,7 @@ class Attention(BaseLayer):
                 q, k_transposed, k, v_transposed, v, a, a_maxsumexp, \
                 a_sumprod_slice, b, b_transposed, bias_inproj_q, \
                 bias_inproj_k, bias_inproj_v, out_proj_bias, mask, \
-                redux=redux)
+                redux=redux, redux_heads=redux_heads)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
@@ -501,7 +519,7 @@ class Attention(BaseLayer):
         # (n_head, head_size, n_seq, n_batch) into (n_emb, n_seq, n_batch)
         gemm_async(1.0, notrans, self.w.value, notrans, \
                     self.b_transposed.value, 0.0, self.y.value, 2, 0, \
-                    redux=self.redux)
+                    redux=self.redux_heads)
         # W, B and B_transposed can be offloaded from GPU
         self.w.value.wont_use()
         #self.b.value.wont_use()
@@ -621,7 +639,7 @@ class Attention(BaseLayer):
             # dX_V += einsum('jkl,jkmn->lmn', W_V, dV_transposed)
             gemm_async(1.0, trans, self.w_v.value, notrans, \
                         self.v_transposed.grad, 1.0, self.x_v.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux_heads)
         # W_V can be offloaded from GPU
         self.w_v.value.wont_use()
         # dX_V can be offloaded from GPU
@@ -657,7 +675,7 @@ class Attention(BaseLayer):
             # dX_K += einsum('jkl,jkmn->lmn', W_K, dK_transposed)
             gemm_async(1.0, trans, self.w_k.value, notrans, \
                         self.k_transposed.grad, 1.0, self.x_k.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux_heads)
         # W_K can be offloaded from GPU
         self.w_k.value.wont_use()
         # dX_K can be offloaded from GPU
@@ -693,7 +711,7 @@ class Attention(BaseLayer):
             # dX_Q += einsum('jkl,jkmn->lmn', W_Q, dQ_transposed)
             gemm_async(1.0, trans, self.w_q.value, notrans, \
                         self.q_transposed.grad, 1.0, self.x_q.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux_heads)
             self.x_q.grad.wont_use()
         # W_Q can be offloaded from GPU
         self.w_q.value.wont_use()
@@ -0,0 +1,361 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/attention_kv_cache.py
+# Multi-head attention with cache of keys and values for inference
+#
+# @version 1.0.0
+
+from nntile.tensor import TensorTraits, Tensor, TensorMoments, Tensor_bool, \
+        trans, notrans, clear_async, gemm_async, maxsumexp_async, \
+        softmax_inplace_async, mask_scalar_async, add_fiber_async, \
+        transpose_async, copy_intersection_async, distr_along_axis, \
+        slice_view
+from nntile.layer.base_layer import BaseLayer
+import numpy as np
+from typing import List
+
+# Multi-head attention for incremental decoding
+# Inputs:
+#  x: (n_emb, n_seq, n_batch) tensor of n_seq new positions
+# Output:
+#  y: (n_emb, n_seq, n_batch) tensor
+# Keys and values of new positions are stored into caches of shape
+# (head_size, n_cache, n_batch, n_head) starting from position cache_pos.
+# Queries of new positions attend to positions of the caches, allowed by
+# the mask of shape (n_cache, n_seq) or (n_cache, n_seq, n_batch), that is
+# set by the user before each forward pass. The latter allows different
+# sequences of a batch to use different positions of the caches. If the
+# mask allows only the first n_attend positions, queries attend only to
+# tiles of caches, that hold them, through views of caches, scores and mask.
+# Parameters are the same as of Attention and FlashAttention layers, so they
+# can be shared with a layer used for training. Backward pass is not
+# supported.
+class AttentionKVCache(BaseLayer):
+    x: TensorMoments
+    y: TensorMoments
+    w_q: TensorMoments
+    w_k: TensorMoments
+    w_v: TensorMoments
+    w: TensorMoments
+    q_transposed: Tensor
+    q: Tensor
+    k_transposed: Tensor
+    k: Tensor
+    v_transposed: Tensor
+    v: Tensor
+    k_cache: Tensor
+    v_cache: Tensor
+    a: Tensor
+    a_maxsumexp: Tensor
+    b: Tensor
+    b_transposed: Tensor
+    mask: Tensor_bool
+    n_head: int
+    head_size: int
+    cache_pos: int
+    n_attend: int
+
+    # Construct attention layer with all the provided data
+    def __init__(self, x: TensorMoments, y: TensorMoments, \
+            w_q: TensorMoments, w_k: TensorMoments, \
+            w_v: TensorMoments, w: TensorMoments, \
+            q_transposed: Tensor, q: Tensor, k_transposed: Tensor, k: Tensor, \
+            v_transposed: Tensor, v: Tensor, k_cache: Tensor, \
+            v_cache: Tensor, a: Tensor, a_maxsumexp: Tensor, b: Tensor, \
+            b_transposed: Tensor, in_proj_bias_q: TensorMoments, \
+            in_proj_bias_k: TensorMoments, in_proj_bias_v: TensorMoments, \
+            out_proj_bias: TensorMoments, mask: Tensor_bool, \
+            redux: bool=False, redux_heads: bool=False):
+        qkv_bias_list = []
+        if in_proj_bias_q:
+            qkv_bias_list.append(in_proj_bias_q)
+        if in_proj_bias_k:
+            qkv_bias_list.append(in_proj_bias_k)
+        if in_proj_bias_v:
+            qkv_bias_list.append(in_proj_bias_v)
+        if out_proj_bias:
+            bias_list_out_proj = [out_proj_bias]
+        else:
+            bias_list_out_proj = []
+        # Redirect to BaseClass initialization. Parameters are in the same
+        # order as in Attention and FlashAttention layers.
+        super().__init__([x], [y], [w_q, w_k, w_v] + qkv_bias_list + [w] + \
+                bias_list_out_proj, [q_transposed, q, k_transposed, k, \
+                v_transposed, v, k_cache, v_cache, a, a_maxsumexp, b, \
+                b_transposed])
+        self.x = x
+        self.y = y
+        self.y.value.set_reduction_add()
+        self.w_q = w_q
+        self.w_k = w_k
+        self.w_v = w_v
+        self.w = w
+        self.q_transposed = q_transposed
+        self.q_transposed.set_reduction_add()
+        self.q = q
+        self.k_transposed = k_transposed
+        self.k_transposed.set_reduction_add()
+        self.k = k
+        self.v_transposed = v_transposed
+        self.v_transposed.set_reduction_add()
+        self.v = v
+        self.k_cache = k_cache
+        self.v_cache = v_cache
+        self.a = a
+        self.a_maxsumexp = a_maxsumexp
+        self.a_maxsumexp.set_reduction_maxsumexp()
+        self.b = b
+        self.b.set_reduction_add()
+        self.b_transposed = b_transposed
+        self.in_proj_bias_q = in_proj_bias_q
+        self.in_proj_bias_k = in_proj_bias_k
+        self.in_proj_bias_v = in_proj_bias_v
+        self.out_proj_bias = out_proj_bias
+        self.mask = mask
+        self.val = -np.float32(np.inf)
+        self.n_head = w_q.value.shape[0]
+        self.head_size = x.value.shape[0] // self.n_head
+        self.cache_pos = 0
+        self.n_attend = None
+        if redux:
+            self.redux = 1
+        else:
+            self.redux = 0
+        if redux or redux_heads:
+            self.redux_heads = 1
+        else:
+            self.redux_heads = 0
+
+    # Parameters without gradients, distributed along heads. They are
+    # returned in the order w_q, w_k, w_v, w and biases of q, k, v and of
+    # the output projection.
+    @staticmethod
+    def _generate_parameters(x: TensorMoments, n_head: int, \
+            n_head_tile: int, bias: bool, head_distr: List[int], \
+            next_tag: int):
+        n_emb = x.value.shape[0]
+        n_emb_tile = x.value.basetile_shape[0]
+        head_size = n_emb // n_head
+        head_size_tile = head_size
+        w_q_traits = TensorTraits([n_head, head_size, n_emb], \
+                [n_head_tile, head_size_tile, n_emb_tile])
+        w_traits = TensorTraits([n_emb, n_head, head_size], \
+                [n_emb_tile, n_head_tile, head_size_tile])
+        w_q_distr = distr_along_axis(w_q_traits, 0, head_distr)
+        w_distr = distr_along_axis(w_traits, 1, head_distr)
+        params = []
+        for traits, distr in [(w_q_traits, w_q_distr)]*3:
+            value = type(x.value)(traits, distr, next_tag)
+            next_tag = value.next_tag
+            params.append(TensorMoments(value, None, False))
+        w_q, w_k, w_v = params
+        if bias:
+            bias_qkv_traits = TensorTraits([head_size, n_head], \
+                    [head_size_tile, n_head_tile])
+            bias_qkv_distr = distr_along_axis(bias_qkv_traits, 1, head_distr)
+            biases = []
+            for i in range(3):
+                value = type(x.value)(bias_qkv_traits, bias_qkv_distr, \
+                        next_tag)
+                next_tag = value.next_tag
+                biases.append(TensorMoments(value, None, False))
+            in_proj_bias_q, in_proj_bias_k, in_proj_bias_v = biases
+        else:
+            in_proj_bias_q, in_proj_bias_k, in_proj_bias_v = None, None, None
+        w_value = type(x.value)(w_traits, w_distr, next_tag)
+        next_tag = w_value.next_tag
+        w = TensorMoments(w_value, None, False)
+        if bias:
+            out_proj_bias_traits = TensorTraits([n_emb], [n_emb_tile])
+            out_proj_bias_distr = [0] * out_proj_bias_traits.grid.nelems
+            out_proj_bias_value = type(x.value)(out_proj_bias_traits, \
+                    out_proj_bias_distr, next_tag)
+            next_tag = out_proj_bias_value.next_tag
+            out_proj_bias = TensorMoments(out_proj_bias_value, None, False)
+        else:
+            out_proj_bias = None
+        return (w_q, w_k, w_v, w, in_proj_bias_q, in_proj_bias_k, \
+                in_proj_bias_v, out_proj_bias), next_tag
+
+    # Simple generator for the attention layer with cache
+    @staticmethod
+    def generate_simple(x: TensorMoments, n_head: int, n_head_tile: int, \
+            n_cache: int, n_cache_tile: int, mask: Tensor_bool, \
+            next_tag: int, bias=False, redux: bool=False, \
+            head_distr: List[int]=None):
+        # Get sizes
+        n_emb, n_seq, n_batch = x.value.shape
+        n_emb_tile, n_seq_tile, n_batch_tile = x.value.basetile_shape
+        head_size = n_emb // n_head
+        # Stupid check, that is not necessary, as the code shall work
+        if n_emb != head_size * n_head:
+            raise RuntimeError
+        mask_shape = [n_cache, n_seq, n_batch][:len(mask.shape)]
+        mask_basetile = [n_cache_tile, n_seq_tile, n_batch_tile] \
+                [:len(mask.shape)]
+        if len(mask.shape) < 2 or mask.shape != mask_shape:
+            raise ValueError("Invalid shape of mask")
+        if mask.basetile_shape != mask_basetile:
+            raise ValueError("Invalid basetile shape of mask")
+        head_size_tile = head_size
+        # Define traits of all tensors
+        qkv_transposed_traits = TensorTraits( \
+                [n_head, head_size, n_seq, n_batch], \
+                [n_head_tile, head_size_tile, n_seq_tile, n_batch_tile])
+        qkv_traits = TensorTraits([head_size, n_seq, n_batch, n_head], \
+                [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile])
+        cache_traits = TensorTraits([head_size, n_cache, n_batch, n_head], \
+                [head_size_tile, n_cache_tile, n_batch_tile, n_head_tile])
+        a_traits = TensorTraits([n_cache, n_seq, n_batch, n_head], \
+                [n_cache_tile, n_seq_tile, n_batch_tile, n_head_tile])
+        a_maxsumexp_traits = TensorTraits([2, n_seq, n_batch, n_head], \
+                [2, n_seq_tile, n_batch_tile, n_head_tile])
+        # Tiles of all tensors are distributed along heads
+        if head_distr is None:
+            head_distr = [0] * ((n_head-1)//n_head_tile+1)
+        qkv_transposed_distr = distr_along_axis(qkv_transposed_traits, 0, \
+                head_distr)
+        qkv_distr = distr_along_axis(qkv_traits, 3, head_distr)
+        cache_distr = distr_along_axis(cache_traits, 3, head_distr)
+        a_distr = distr_along_axis(a_traits, 3, head_distr)
+        a_maxsumexp_distr = distr_along_axis(a_maxsumexp_traits, 3, \
+                head_distr)
+        redux_heads = len(set(head_distr)) > 1
+        params, next_tag = AttentionKVCache._generate_parameters(x, n_head, \
+                n_head_tile, bias, head_distr, next_tag)
+        w_q, w_k, w_v, w, in_proj_bias_q, in_proj_bias_k, in_proj_bias_v, \
+                out_proj_bias = params
+        # Temporary tensors
+        temps = []
+        for traits, distr in [(qkv_transposed_traits, qkv_transposed_distr), \
+                (qkv_traits, qkv_distr)]*3 + [(cache_traits, cache_distr)]*2 \
+                + [(a_traits, a_distr), \
+                (a_maxsumexp_traits, a_maxsumexp_distr), \
+                (qkv_traits, qkv_distr), \
+                (qkv_transposed_traits, qkv_transposed_distr)]:
+            temps.append(type(x.value)(traits, distr, next_tag))
+            next_tag = temps[-1].next_tag
+        q_transposed, q, k_transposed, k, v_transposed, v, k_cache, \
+                v_cache, a, a_maxsumexp, b, b_transposed = temps
+        # Allocate tensor for output y
+        y_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
+        y_value = type(x.value)(y_traits, x.value.distribution, next_tag)
+        next_tag = y_value.next_tag
+        y = TensorMoments(y_value, None, False)
+        # Create attention layer with all the provided data
+        layer = AttentionKVCache(x, y, w_q, w_k, w_v, w, q_transposed, q, \
+                k_transposed, k, v_transposed, v, k_cache, v_cache, a, \
+                a_maxsumexp, b, b_transposed, in_proj_bias_q, \
+                in_proj_bias_k, in_proj_bias_v, out_proj_bias, mask, \
+                redux=redux, redux_heads=redux_heads)
+        # Return layer and next tag to be used
+        return (layer, next_tag)
+
+    # Forget all cached positions. Caches are cleared, as masked out
+    # positions still take part in computations.
+    def reset_cache(self):
+        clear_async(self.k_cache)
+        clear_async(self.v_cache)
+        self.cache_pos = 0
+
+    # Project new positions into heads and rotate axes into
+    # (head_size, n_seq, n_batch, n_head)
+    def _project_async(self, w: TensorMoments, bias: TensorMoments, \
+            dst_transposed: Tensor, dst: Tensor):
+        gemm_async(1.0, notrans, w.value, notrans, self.x.value, 0.0, \
+                dst_transposed, 1, 0, redux=self.redux)
+        transpose_async(1.0, dst_transposed, dst, 1)
+        dst_transposed.invalidate_submit()
+        w.value.wont_use()
+        if bias is not None:
+            add_fiber_async(1, bias.value, 1, dst, 0, 1)
+            bias.value.wont_use()
+
+    # Accumulate result from all the heads of B into the output
+    def _output_async(self):
+        transpose_async(1.0, self.b, self.b_transposed, 3)
+        self.b.invalidate_submit()
+        gemm_async(1.0, notrans, self.w.value, notrans, self.b_transposed, \
+                0.0, self.y.value, 2, 0, redux=self.redux_heads)
+        self.b_transposed.invalidate_submit()
+        self.w.value.wont_use()
+        if self.out_proj_bias is not None:
+            add_fiber_async(1.0, self.out_proj_bias.value, 1.0, \
+                    self.y.value, 0, 0)
+            self.out_proj_bias.value.wont_use()
+        self.y.value.wont_use()
+
+    # Caches, scores and mask restricted to tiles of the first n_attend
+    # positions of caches
+    def _attended_views(self):
+        n_cache = self.k_cache.shape[1]
+        n_cache_tile = self.k_cache.basetile_shape[1]
+        if self.n_attend is None:
+            return self.k_cache, self.v_cache, self.a, self.mask
+        n_attend = min(n_cache, -(-self.n_attend//n_cache_tile) \
+                * n_cache_tile)
+        if n_attend == n_cache:
+            return self.k_cache, self.v_cache, self.a, self.mask
+        cache_end = list(self.k_cache.shape)
+        cache_end[1] = n_attend
+        k_cache = slice_view(self.k_cache, [0]*4, cache_end)
+        v_cache = slice_view(self.v_cache, [0]*4, cache_end)
+        a = slice_view(self.a, [0]*4, [n_attend]+self.a.shape[1:])
+        mask = slice_view(self.mask, [0]*len(self.mask.shape), \
+                [n_attend]+self.mask.shape[1:])
+        return k_cache, v_cache, a, mask
+
+    # Forward propagation for new positions
+    def forward_async(self):
+        n_seq = self.x.value.shape[1]
+        n_cache = self.k_cache.shape[1]
+        if self.cache_pos+n_seq > n_cache:
+            raise ValueError("Cache is full")
+        # Get queries, keys and values of new positions
+        self._project_async(self.w_q, self.in_proj_bias_q, \
+                self.q_transposed, self.q)
+        self._project_async(self.w_k, self.in_proj_bias_k, \
+                self.k_transposed, self.k)
+        self._project_async(self.w_v, self.in_proj_bias_v, \
+                self.v_transposed, self.v)
+        self.x.value.wont_use()
+        # Put keys and values into caches
+        offset = [0, self.cache_pos, 0, 0]
+        copy_intersection_async(self.k, offset, self.k_cache, [0, 0, 0, 0])
+        copy_intersection_async(self.v, offset, self.v_cache, [0, 0, 0, 0])
+        self.k.invalidate_submit()
+        self.v.invalidate_submit()
+        k_cache, v_cache, a, mask = self._attended_views()
+        # A = 1.0/sqrt(head_size) * einsum('jklb,jmlb->kmlb', K_cache, Q)
+        # single batched gemm (head_size, n_cache, batch=n_batch,
+        # batch=n_head) by (head_size, n_seq, batch=n_batch, batch=n_head)
+        # into (n_cache, n_seq, batch=n_batch, batch=n_head)
+        gemm_async(1.0/self.head_size**0.5, trans, k_cache, notrans, \
+                self.q, 0.0, a, 1, 2, redux=self.redux)
+        self.q.invalidate_submit()
+        # Positions beyond the filled part of caches are masked out
+        mask_scalar_async(mask, self.val, a, 4-len(mask.shape))
+        self.mask.wont_use()
+        # A = softmax(A, axis=0)
+        clear_async(self.a_maxsumexp)
+        maxsumexp_async(a, self.a_maxsumexp, 0, redux=self.redux)
+        softmax_inplace_async(self.a_maxsumexp, 1.0, a, 0)
+        self.a_maxsumexp.invalidate_submit()
+        # B = einsum('jklb,kmlb->jmlb', V_cache, A)
+        gemm_async(1.0, notrans, v_cache, notrans, a, 0.0, self.b, 1, 2, \
+                redux=self.redux)
+        self.a.invalidate_submit()
+        self._output_async()
+        # Caches are kept for the next positions
+        self.k_cache.wont_use()
+        self.v_cache.wont_use()
+        self.cache_pos += n_seq
+
+    def backward_async(self):
+        raise NotImplementedError("Backward pass is not supported")
@@ -0,0 +1,176 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/attention_paged_kv_cache.py
+# Multi-head attention with paged cache of keys and values for inference
+#
+# @version 1.0.0
+
+from nntile.tensor import TensorTraits, Tensor, TensorMoments, Tensor_bool, \
+        paged_kv_store_async, paged_attention_async, distr_along_axis
+from nntile.layer.attention_kv_cache import AttentionKVCache
+from typing import List
+
+# Multi-head attention for incremental decoding with paged caches
+# Inputs:
+#  x: (n_emb, 1, n_batch) tensor of a new position of each sequence
+# Output:
+#  y: (n_emb, 1, n_batch) tensor
+# Keys and values are stored in pools of shape (head_size, block_size,
+# n_blocks, n_head), whose tiles are blocks of block_size positions. A block
+# table of a sequence lists its blocks in order of positions, so a sequence
+# occupies only as many blocks, as its length requires. Key and value of a
+# new position of sequence b are stored at position slot_offset[b] of block
+# slot_block[b], and the new position attends to filled positions of blocks
+# of the sequence, allowed by the mask of shape (block_size, n_blocks).
+# Block tables, slots and mask are shared by all layers of a model and are
+# set by the user before each forward pass (see nntile.inference). Each tile
+# of x holds a single sequence.
+class AttentionPagedKVCache(AttentionKVCache):
+    block_table: List[List[int]]
+    slot_block: List[int]
+    slot_offset: List[int]
+
+    # Construct attention layer with all the provided data
+    def __init__(self, x: TensorMoments, y: TensorMoments, \
+            w_q: TensorMoments, w_k: TensorMoments, \
+            w_v: TensorMoments, w: TensorMoments, \
+            q_transposed: Tensor, q: Tensor, k_transposed: Tensor, k: Tensor, \
+            v_transposed: Tensor, v: Tensor, k_pool: Tensor, \
+            v_pool: Tensor, a: Tensor, a_maxsumexp: Tensor, b: Tensor, \
+            b_transposed: Tensor, in_proj_bias_q: TensorMoments, \
+            in_proj_bias_k: TensorMoments, in_proj_bias_v: TensorMoments, \
+            out_proj_bias: TensorMoments, block_mask: Tensor_bool, \
+            redux: bool=False, redux_heads: bool=False):
+        # Pools take place of caches of the base layer
+        super().__init__(x, y, w_q, w_k, w_v, w, q_transposed, q, \
+                k_transposed, k, v_transposed, v, k_pool, v_pool, a, \
+                a_maxsumexp, b, b_transposed, in_proj_bias_q, \
+                in_proj_bias_k, in_proj_bias_v, out_proj_bias, block_mask, \
+                redux=redux, redux_heads=redux_heads)
+        self.block_size = k_pool.shape[1]
+        self.max_blocks = a.shape[2]
+        n_batch = x.value.shape[2]
+        self.block_table = [[] for i in range(n_batch)]
+        self.slot_block = [-1] * n_batch
+        self.slot_offset = [0] * n_batch
+
+    # Simple generator for the attention layer with paged cache
+    @staticmethod
+    def generate_simple(x: TensorMoments, n_head: int, n_head_tile: int, \
+            block_size: int, n_blocks: int, max_blocks: int, \
+            block_mask: Tensor_bool, next_tag: int, bias=False, \
+            redux: bool=False, head_distr: List[int]=None):
+        # Get sizes
+        n_emb, n_seq, n_batch = x.value.shape
+        n_emb_tile, n_seq_tile, n_batch_tile = x.value.basetile_shape
+        head_size = n_emb // n_head
+        # Stupid check, that is not necessary, as the code shall work
+        if n_emb != head_size * n_head:
+            raise RuntimeError
+        if n_seq != 1:
+            raise ValueError("Paged cache supports a single new position")
+        if n_batch_tile != 1:
+            raise ValueError("Each tile shall hold a single sequence")
+        if block_mask.shape != [block_size, n_blocks]:
+            raise ValueError("Invalid shape of mask")
+        if block_mask.basetile_shape != [block_size, 1]:
+            raise ValueError("Invalid basetile shape of mask")
+        # Define traits of all tensors
+        qkv_transposed_traits = TensorTraits( \
+                [n_head, head_size, 1, n_batch], \
+                [n_head_tile, head_size, 1, 1])
+        qkv_traits = TensorTraits([head_size, 1, n_batch, n_head], \
+                [head_size, 1, 1, n_head_tile])
+        pool_traits = TensorTraits([head_size, block_size, n_blocks, n_head], \
+                [head_size, block_size, 1, n_head_tile])
+        a_traits = TensorTraits([block_size, 1, max_blocks, n_batch, n_head], \
+                [block_size, 1, 1, 1, n_head_tile])
+        a_maxsumexp_traits = TensorTraits([2, 1, n_batch, n_head], \
+                [2, 1, 1, n_head_tile])
+        # Tiles of all tensors are distributed along heads
+        if head_distr is None:
+            head_distr = [0] * ((n_head-1)//n_head_tile+1)
+        qkv_transposed_distr = distr_along_axis(qkv_transposed_traits, 0, \
+                head_distr)
+        qkv_distr = distr_along_axis(qkv_traits, 3, head_distr)
+        pool_distr = distr_along_axis(pool_traits, 3, head_distr)
+        a_distr = distr_along_axis(a_traits, 4, head_distr)
+        a_maxsumexp_distr = distr_along_axis(a_maxsumexp_traits, 3, \
+                head_distr)
+        redux_heads = len(set(head_distr)) > 1
+        params, next_tag = AttentionKVCache._generate_parameters(x, n_head, \
+                n_head_tile, bias, head_distr, next_tag)
+        w_q, w_k, w_v, w, in_proj_bias_q, in_proj_bias_k, in_proj_bias_v, \
+                out_proj_bias = params
+        # Temporary tensors
+        temps = []
+        for traits, distr in [(qkv_transposed_traits, qkv_transposed_distr), \
+                (qkv_traits, qkv_distr)]*3 + [(pool_traits, pool_distr)]*2 \
+                + [(a_traits, a_distr), \
+                (a_maxsumexp_traits, a_maxsumexp_distr), \
+                (qkv_traits, qkv_distr), \
+                (qkv_transposed_traits, qkv_transposed_distr)]:
+            temps.append(type(x.value)(traits, distr, next_tag))
+            next_tag = temps[-1].next_tag
+        q_transposed, q, k_transposed, k, v_transposed, v, k_pool, \
+                v_pool, a, a_maxsumexp, b, b_transposed = temps
+        # Allocate tensor for output y
+        y_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
+        y_value = type(x.value)(y_traits, x.value.distribution, next_tag)
+        next_tag = y_value.next_tag
+        y = TensorMoments(y_value, None, False)
+        # Create attention layer with all the provided data
+        layer = AttentionPagedKVCache(x, y, w_q, w_k, w_v, w, q_transposed, \
+                q, k_transposed, k, v_transposed, v, k_pool, v_pool, a, \
+                a_maxsumexp, b, b_transposed, in_proj_bias_q, \
+                in_proj_bias_k, in_proj_bias_v, out_proj_bias, block_mask, \
+                redux=redux, redux_heads=redux_heads)
+        # Return layer and next tag to be used
+        return (layer, next_tag)
+
+    # Set blocks of each sequence and slots for new positions
+    def set_block_table(self, block_table: List[List[int]], \
+            slot_block: List[int], slot_offset: List[int]):
+        for blocks in block_table:
+            if len(blocks) > self.max_blocks:
+                raise ValueError("Sequence does not fit into max_blocks")
+        self.block_table = block_table
+        self.slot_block = slot_block
+        self.slot_offset = slot_offset
+
+    # Forward propagation for a new position of each sequence
+    def forward_async(self):
+        # Get queries, keys and values of new positions
+        self._project_async(self.w_q, self.in_proj_bias_q, \
+                self.q_transposed, self.q)
+        self._project_async(self.w_k, self.in_proj_bias_k, \
+                self.k_transposed, self.k)
+        self._project_async(self.w_v, self.in_proj_bias_v, \
+                self.v_transposed, self.v)
+        self.x.value.wont_use()
+        # Put keys and values into their blocks
+        paged_kv_store_async(self.k, self.k_cache, self.slot_block, \
+                self.slot_offset)
+        paged_kv_store_async(self.v, self.v_cache, self.slot_block, \
+                self.slot_offset)
+        self.k.invalidate_submit()
+        self.v.invalidate_submit()
+        # B = softmax(K^T Q / sqrt(head_size)) V over blocks of each sequence
+        paged_attention_async(1.0/self.head_size**0.5, self.q, \
+                self.k_cache, self.v_cache, self.mask, self.block_table, \
+                self.a, self.a_maxsumexp, self.b)
+        self.q.invalidate_submit()
+        self.a.invalidate_submit()
+        self.a_maxsumexp.invalidate_submit()
+        self.mask.wont_use()
+        # Accumulate result from all the heads
+        self._output_async()
+        # Pools are kept for the next positions
+        self.k_cache.wont_use()
+        self.v_cache.wont_use()
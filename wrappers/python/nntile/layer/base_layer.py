@@ -13,8 +13,25 @@
 
 from nntile.tensor import Tensor, TensorMoments, randn_async
 import numpy as np
+import functools
 from typing import List, Union
 
+# Active profiler of layers, that is set by nntile.profiler.LayerProfiler
+_profiler = None
+
+# Let the active profiler know that a given method of a layer submits tasks
+def _profiled(method, phase: str):
+    @functools.wraps(method)
+    def wrapper(self, *args, **kwargs):
+        if _profiler is None:
+            return method(self, *args, **kwargs)
+        _profiler.push(self, phase)
+        try:
+            return method(self, *args, **kwargs)
+        finally:
+            _profiler.pop()
+    return wrapper
+
 class BaseLayer(object):
     # Input activations with moments
     activations_input: List[TensorMoments]
@@ -34,6 +51,14 @@ class BaseLayer(object):
         self.parameters = parameters
         self.temporaries = temporaries
 
+    # Forward and backward of every derived layer are seen by the profiler
+    def __init_subclass__(cls, **kwargs):
+        super().__init_subclass__(**kwargs)
+        for name, phase in (("forward_async", "forward"), \
+                ("backward_async", "backward")):
+            if name in cls.__dict__:
+                setattr(cls, name, _profiled(cls.__dict__[name], phase))
+
     # Random initialization of parameters
     def init_randn_async(self):
         seed = 100
@@ -57,10 +82,38 @@ class BaseLayer(object):
         self.forward_async()
         starpu.wait_for_all()
 
+    # Use parameters of another layer of the same structure instead of own
+    # ones, that are unregistered. Shared parameters are not unregistered by
+    # this layer.
+    def share_parameters(self, other: 'BaseLayer'):
+        if len(self.parameters) != len(other.parameters):
+            raise ValueError("Layers have different number of parameters")
+        for p, q in zip(self.parameters, other.parameters):
+            if p.value.shape != q.value.shape:
+                raise ValueError("Layers have different shapes of parameters")
+            # Kernels of this layer are submitted for its own tiles
+            if p.value.basetile_shape != q.value.basetile_shape:
+                raise ValueError("Layers have different tiles of parameters")
+            if p.value.distribution != q.value.distribution:
+                raise ValueError("Layers have different distributions of " \
+                        "parameters")
+        own_parameters = self.parameters
+        mapping = {id(p): q for p, q in zip(own_parameters, other.parameters)}
+        for name, value in list(self.__dict__.items()):
+            if id(value) in mapping:
+                setattr(self, name, mapping[id(value)])
+            elif type(value) is list:
+                setattr(self, name, [mapping.get(id(v), v) for v in value])
+        for p in own_parameters:
+            p.unregister()
+        self.parameters = list(other.parameters)
+        self.shared_parameters = True
+
     # Unregister layer weights and temporary tensors
     def unregister(self):
-        for p in self.parameters:
-            p.unregister()
+        if not getattr(self, "shared_parameters", False):
+            for p in self.parameters:
+                p.unregister()
         for t in self.temporaries:
             if t is not None:
                 t.unregister()
@@ -83,7 +83,10 @@ class Linear(BaseLayer):
             in_features_ndim: int, out_features_shape: List[int], \
             out_features_basetile_shape: List[int], next_tag: int, \
             bias: bool=True, \
-            fp32_convert_fp16: bool=False, redux: bool=False):
+            fp32_convert_fp16: bool=False, redux: bool=False, \
+            w_distr: Optional[List[int]]=None, \
+            b_distr: Optional[List[int]]=None, \
+            y_distr: Optional[List[int]]=None):
         # Define shapes
         ndim = in_features_ndim
         add_shape = out_features_shape
@@ -112,8 +115,8 @@ class Linear(BaseLayer):
                 y_tile = add_basetile_shape + x.value.basetile_shape[:-ndim]
         # Define W
         w_traits = TensorTraits(w_shape, w_tile)
-        # TODO change distribution
-        w_distr = [0] * w_traits.grid.nelems
+        if w_distr is None:
+            w_distr = [0] * w_traits.grid.nelems
         w_value = type(x.value)(w_traits, w_distr, next_tag)
         next_tag = w_value.next_tag
         # Create gradient of W with the same traits and distribution as W
@@ -126,8 +129,8 @@ class Linear(BaseLayer):
                 raise ValueError("Bias is not yet supported for " \
                         "len(add_shape) > 1")
             b_traits = TensorTraits(add_shape, add_basetile_shape)
-            # TODO change distribution
-            b_distr = [0] * b_traits.grid.nelems
+            if b_distr is None:
+                b_distr = [0] * b_traits.grid.nelems
             b_value = type(x.value)(b_traits, b_distr, next_tag)
             next_tag = b_value.next_tag
             # Create gradient of b with the same traits and distribution as b
@@ -139,8 +142,8 @@ class Linear(BaseLayer):
             b = None
         # Define Y
         y_traits = TensorTraits(y_shape, y_tile)
-        # TODO change distribution
-        y_distr = [0] * y_traits.grid.nelems
+        if y_distr is None:
+            y_distr = [0] * y_traits.grid.nelems
         y_value = type(x.value)(y_traits, y_distr, next_tag)
         next_tag = y_value.next_tag
         # Create gradient of Y with the same traits and distribution as Y
@@ -72,7 +72,9 @@ class CrossEntropy:
         self.val.unregister()
         self.y.unregister()
 
+    # Wait only for the loss value without holding the GIL, then copy it
     def get_val(self, val_np):
+        self.val.wait()
         self.val.to_array(val_np)
 
     def get_grad(self, grad_np):
@@ -0,0 +1,100 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/memory.py
+# Live and peak memory of tensors by categories
+#
+# @version 1.0.0
+
+from nntile.nntile_core import starpu as core_starpu
+from contextlib import contextmanager
+import json
+import sys
+from typing import Dict, List
+
+# Tiles of every tensor are accounted from construction till unregister. A
+# tensor gets the default category at construction, that can be changed by
+# the category() context or by tag() afterwards.
+CATEGORIES = core_starpu.memory_category_names()
+
+reset_peak = core_starpu.memory_reset_peak
+timeline_enable = core_starpu.memory_timeline_enable
+timeline_disable = core_starpu.memory_timeline_disable
+
+def _category_id(name: str) -> int:
+    if name not in CATEGORIES:
+        raise ValueError("Unknown memory category {}".format(name))
+    return CATEGORIES.index(name)
+
+# Account tensors, constructed within the context, in a given category
+@contextmanager
+def category(name: str):
+    prev = core_starpu.memory_get_default_category()
+    core_starpu.memory_set_default_category(_category_id(name))
+    try:
+        yield
+    finally:
+        core_starpu.memory_set_default_category(prev)
+
+# Account tensors or values and gradients of TensorMoments in a category
+def tag(tensors, name: str):
+    cat = _category_id(name)
+    for x in tensors:
+        if x is None:
+            continue
+        if type(x) is list:
+            tag(x, name)
+        elif hasattr(x, "value"):
+            tag([x.value], name)
+            tag([x.grad], "grad" if name == "parameter" else name)
+        else:
+            x.set_memory_category(cat)
+
+# Account all tensors of a model and an optional optimizer. Activations
+# include their gradients and temporaries of layers are scratch.
+def tag_model(model, optimizer=None):
+    for layer in model.layers:
+        tag(layer.temporaries, "scratch")
+    tag(model.activations, "activation")
+    tag(model.parameters, "parameter")
+    if optimizer is not None:
+        for name in ("first_moments", "second_moments", \
+                "max_second_moments"):
+            tag(getattr(optimizer, name, []), "optimizer")
+
+# Live and peak bytes by categories
+def stats() -> Dict:
+    live, peak, live_total, peak_total = core_starpu.memory_stats()
+    return {"live": dict(zip(CATEGORIES, live)), \
+            "peak": dict(zip(CATEGORIES, peak)), \
+            "live_total": live_total, "peak_total": peak_total}
+
+# Memory, used and available on each memory node according to StarPU
+def nodes() -> List[Dict]:
+    return [{"node": node, "used": used, "total": total} \
+            for node, used, total in core_starpu.memory_nodes()]
+
+# Samples of live bytes by categories, recorded since the last call
+def timeline() -> List[Dict]:
+    return [dict(time=time, **dict(zip(CATEGORIES, live))) \
+            for time, live in core_starpu.memory_timeline_get()]
+
+# Write recorded samples into a JSON file
+def dump_timeline(filename: str):
+    with open(filename, "w") as fp:
+        json.dump(timeline(), fp)
+
+def report(file=sys.stdout):
+    s = stats()
+    print("{:<12} {:>12} {:>12}".format("category", "live, MB", \
+            "peak, MB"), file=file)
+    for name in CATEGORIES:
+        print("{:<12} {:>12.1f} {:>12.1f}".format(name, \
+                s["live"][name]/2**20, s["peak"][name]/2**20), file=file)
+    print("{:<12} {:>12.1f} {:>12.1f}".format("total", \
+            s["live_total"]/2**20, s["peak_total"]/2**20), file=file)
@@ -73,3 +73,8 @@ class BaseModel:
 
     def get_parameters(self):
         return self.parameters
+
+    # Parameters for nntile.checkpoint, named by their order in the model
+    def checkpoint_tensors(self):
+        return {"parameters.{}".format(i): p.value \
+                for i, p in enumerate(self.parameters)}
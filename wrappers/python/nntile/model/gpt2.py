@@ -12,10 +12,14 @@
 # @version 1.0.0
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
-        notrans, trans, Tensor_fp32, Tensor_fp32_fast_tf32, Tensor_int64, Tensor_bool
+        notrans, trans, Tensor_fp32, Tensor_fp32_fast_tf32, Tensor_int64, \
+        Tensor_bool, distr_along_axis
+from nntile.nntile_core.tensor import distributions
+from nntile.starpu import mpi_world_size
 from nntile.model.base_model import BaseModel
 from nntile.layer import Linear, Embedding, AddSlice, LayerNorm, Attention, Act
-from nntile.layer import FlashAttention, AttentionSingleHead
+from nntile.layer import FlashAttention, AttentionSingleHead, \
+        AttentionKVCache, AttentionPagedKVCache
 import numpy as np
 from typing import List, Dict
 from nntile.layer.add import Add
@@ -28,7 +32,8 @@ class GPT2Config(Dict):
             inner_dim: int, inner_dim_tile: int, \
             layer_norm_epsilon: float, num_hidden_layers: int, n_head: int, \
             n_head_tile: int, activation_function: str, \
-            flashattention: bool=True, use_redux: bool=False, dtype: str="fp32"):
+            flashattention: bool=True, use_redux: bool=False, dtype: str="fp32", \
+            tensor_parallel: int=1, pipeline_parallel: int=1):
         self["vocab_size"] = vocab_size
         self["vocab_embed_dim_tile"] = vocab_embed_dim_tile
         self["embed_dim"] = embed_dim
@@ -44,15 +49,30 @@ class GPT2Config(Dict):
         self["flashattention"] = flashattention
         self["redux"] = use_redux
         self["dtype"] = dtype
+        self["tensor_parallel"] = tensor_parallel
+        self["pipeline_parallel"] = pipeline_parallel
 
     def __getattr__(self, attr):
         return self[attr]
 
+# Ranks of tiles along a dimension, that is split among tensor-parallel ranks.
+# Tiles are assigned to tensor_parallel ranks in a cyclic manner, and the
+# ranks wrap around the actual number of MPI ranks, so that the same config
+# runs on any number of nodes.
+def tensor_parallel_distr(ntiles: int, tensor_parallel: int, \
+        start_rank: int=0) -> List[int]:
+    if tensor_parallel <= 0:
+        raise ValueError("tensor_parallel must be positive integer")
+    world_size = mpi_world_size()
+    return distributions.block_cyclic([ntiles], [tensor_parallel], \
+            start_rank % world_size, world_size)
+
 class GPT2MLP(BaseModel):
     next_tag: int
 
     # Construct model with all the provided data
-    def __init__(self, x: TensorMoments, config: GPT2Config, next_tag: int):
+    def __init__(self, x: TensorMoments, config: GPT2Config, next_tag: int, \
+            start_rank: int=0):
         # Init activations and list of layers
         activations = [x]
         layers = []
@@ -62,11 +82,34 @@ class GPT2MLP(BaseModel):
         inner_dim_tile = config["inner_dim_tile"]
         activation_function = config["activation_function"]
         redux = config["redux"]
+        tensor_parallel = config["tensor_parallel"]
         gemm_ndim = 1
+        # Tiles along inner dimension are split among tensor-parallel ranks,
+        # while output stays where the input is stored. With pipeline
+        # parallelism the output moves to the first rank of the stage instead
+        x_distr = x.value.distribution
+        inner_distr = tensor_parallel_distr( \
+                (inner_dim-1)//inner_dim_tile+1, tensor_parallel, start_rank)
+        if config["pipeline_parallel"] > 1:
+            y_distr = [start_rank % mpi_world_size()] * len(x_distr)
+        else:
+            y_distr = x_distr
+        fc_w_traits = TensorTraits([inner_dim, embed_dim], \
+                [inner_dim_tile, embed_dim_tile])
+        fc_y_traits = TensorTraits([inner_dim]+x.value.shape[1:], \
+                [inner_dim_tile]+x.value.basetile_shape[1:])
+        proj_w_traits = TensorTraits([embed_dim, inner_dim], \
+                [embed_dim_tile, inner_dim_tile])
+        # Only the projection contracts inner dimension in its forward pass,
+        # so only it accumulates partial results of tensor-parallel ranks
+        proj_redux = redux or len(set(inner_distr)) > 1
         # Initial linear layer that converts input to internal shape
         new_layer, next_tag = Linear.generate_simple(x, "R", notrans, \
                 gemm_ndim, [inner_dim], [inner_dim_tile], next_tag, \
-                redux=redux)
+                redux=redux, \
+                w_distr=distr_along_axis(fc_w_traits, 0, inner_distr), \
+                b_distr=inner_distr, \
+                y_distr=distr_along_axis(fc_y_traits, 0, inner_distr))
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
 
@@ -77,7 +120,9 @@ class GPT2MLP(BaseModel):
 
         new_layer, next_tag = Linear.generate_simple(activations[-1], \
                 "R", notrans, gemm_ndim, [embed_dim], [embed_dim_tile], \
-                next_tag, redux=redux)
+                next_tag, redux=proj_redux, \
+                w_distr=distr_along_axis(proj_w_traits, 1, inner_distr), \
+                b_distr=y_distr[:x.value.grid.shape[0]], y_distr=y_distr)
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
         self.next_tag = next_tag
@@ -104,10 +149,19 @@ class GPT2MLP(BaseModel):
 
 class GPT2Model(BaseModel):
     next_tag: int
-
-    # Construct model with all the provided data
+    # Contiguous ranges of layers of pipeline stages
+    stages: List[range]
+
+    # Construct model with all the provided data. Non-zero kv_cache_size
+    # makes an inference-only model for incremental decoding, where
+    # attention layers keep caches of keys and values of kv_cache_size
+    # positions (see generate_decoder). Non-zero kv_block_size makes caches
+    # paged: they are pools of kv_cache_size/kv_block_size blocks, that are
+    # assigned to sequences by block tables (see decode_paged_step_async).
     def __init__(self, input_ids: TensorMoments, \
-            positional_ids: TensorMoments, config: GPT2Config, next_tag: int):
+            positional_ids: TensorMoments, config: GPT2Config, next_tag: int, \
+            kv_cache_size: int=0, kv_cache_tile: int=0, \
+            kv_block_size: int=0):
         # Check parameter side
         vocab_size = config["vocab_size"]
         vocab_embed_dim_tile = config["vocab_embed_dim_tile"]
@@ -122,12 +176,33 @@ class GPT2Model(BaseModel):
         n_head_tile = config["n_head_tile"]
         flashattention = config["flashattention"]
         redux = config["redux"]
+        tensor_parallel = config["tensor_parallel"]
+        pipeline_parallel = config["pipeline_parallel"]
+        if pipeline_parallel <= 0 or pipeline_parallel > num_hidden_layers:
+            raise ValueError("pipeline_parallel must be in range " \
+                    "[1, num_hidden_layers]")
         self.dtype = config["dtype"]
 
         if self.dtype not in ["fp32", "tf32"]:
             raise TypeError("Only fp32 and tf32 are supported for weight type")
 
-        if self.n_head == 1:
+        self.config = config
+        self.kv_cache_size = kv_cache_size
+        self.kv_block_size = kv_block_size
+        self.cache_pos = 0
+        if kv_block_size > 0:
+            if kv_cache_size % kv_block_size != 0:
+                raise ValueError("kv_cache_size must be a multiple of " \
+                        "kv_block_size")
+            n_blocks = kv_cache_size // kv_block_size
+            # Blocks of a single sequence
+            self.max_blocks = (min(kv_cache_size, max_position_embeddings) \
+                    -1) // kv_block_size + 1
+        if kv_cache_size > 0:
+            if self.n_head == 1:
+                raise ValueError("Cache of keys and values requires n_head>1")
+            AttLayer = AttentionKVCache
+        elif self.n_head == 1:
             print("Set 1 head")
             AttLayer = AttentionSingleHead
         elif flashattention:
@@ -138,13 +213,34 @@ class GPT2Model(BaseModel):
         seq_len_tile = input_ids.value.basetile_shape[0]
         activations = [input_ids, positional_ids]
         layers = []
-        mask_traits = TensorTraits((seq_len, seq_len), \
-                (seq_len_tile, seq_len_tile))
+        if kv_block_size > 0:
+            # Mask of filled positions of blocks, that is updated by
+            # decode_paged_step_async
+            mask_traits = TensorTraits((kv_block_size, n_blocks), \
+                    (kv_block_size, 1))
+        elif kv_cache_size > 0:
+            # Mask of cached positions for each sequence of a batch, that is
+            # updated by decode_async
+            batch_size = input_ids.value.shape[1]
+            batch_size_tile = input_ids.value.basetile_shape[1]
+            mask_traits = TensorTraits((kv_cache_size, seq_len, batch_size), \
+                    (kv_cache_tile, seq_len_tile, batch_size_tile))
+        else:
+            mask_traits = TensorTraits((seq_len, seq_len), \
+                    (seq_len_tile, seq_len_tile))
         mask_distr = [0] * mask_traits.grid.nelems
         self.mask = Tensor_bool(mask_traits, mask_distr, next_tag)
         next_tag = self.mask.next_tag
-        mask_np = np.array(np.triu(np.ones((seq_len, seq_len))), dtype=bool, \
-                order="F")
+        if kv_block_size > 0:
+            mask_np = np.zeros((kv_block_size, n_blocks), dtype=bool, \
+                    order="F")
+        elif kv_cache_size > 0:
+            mask_np = np.repeat(GPT2Model.cache_mask(kv_cache_size, \
+                    seq_len, 0)[:, :, np.newaxis], batch_size, axis=2)
+            mask_np = np.asfortranarray(mask_np)
+        else:
+            mask_np = np.array(np.triu(np.ones((seq_len, seq_len))), \
+                    dtype=bool, order="F")
         self.mask.from_array(mask_np)
 
 
@@ -172,27 +268,59 @@ class GPT2Model(BaseModel):
         layers.append(wpe_layer)
         activations.extend(wpe_layer.activations_output)
 
-        add_slice_layer, next_tag = AddSlice.generate_simple(activations[-2], \
-                activations[-1], 2, next_tag, redux=redux)
+        # Positions can be different for each sequence of a batch
+        if len(positional_ids.value.shape) == 2:
+            add_slice_layer, next_tag = Add.generate_simple(activations[-2], \
+                    activations[-1], next_tag)
+        else:
+            add_slice_layer, next_tag = AddSlice.generate_simple( \
+                    activations[-2], activations[-1], 2, next_tag, \
+                    redux=redux)
         layers.append(add_slice_layer)
         activations.extend(add_slice_layer.activations_output)
 
+        # Each pipeline stage gets a contiguous range of blocks and its own
+        # group of tensor-parallel ranks
+        self.stages = []
+        stage_start = 0
         for h_idx in range(num_hidden_layers):
+            stage = h_idx * pipeline_parallel // num_hidden_layers
+            start_rank = stage * tensor_parallel
             l_norm, next_tag = LayerNorm.generate_simple(activations[-1], 0, \
                     layer_norm_epsilon, next_tag, redux=redux)
             layers.append(l_norm)
             activations.extend(l_norm.activations_output)
 
-            if self.n_head == 1:
+            if kv_block_size > 0:
+                head_distr = tensor_parallel_distr( \
+                        (self.n_head-1)//n_head_tile+1, tensor_parallel, \
+                        start_rank)
+                attn_layer, next_tag = AttentionPagedKVCache.generate_simple( \
+                        activations[-1], self.n_head, n_head_tile, \
+                        kv_block_size, n_blocks, self.max_blocks, self.mask, \
+                        next_tag, True, redux=redux, head_distr=head_distr)
+            elif kv_cache_size > 0:
+                head_distr = tensor_parallel_distr( \
+                        (self.n_head-1)//n_head_tile+1, tensor_parallel, \
+                        start_rank)
+                attn_layer, next_tag = AttLayer.generate_simple( \
+                        activations[-1], self.n_head, n_head_tile, \
+                        kv_cache_size, kv_cache_tile, self.mask, next_tag, \
+                        True, redux=redux, head_distr=head_distr)
+            elif self.n_head == 1:
                 attn_layer, next_tag = AttLayer.generate_simple( \
                         activations[-1], activations[-1], activations[-1], \
                         next_tag, True, self.mask, \
                         redux=redux)
             else:
+                # Head tiles are split among tensor-parallel ranks
+                head_distr = tensor_parallel_distr( \
+                        (self.n_head-1)//n_head_tile+1, tensor_parallel, \
+                        start_rank)
                 attn_layer, next_tag = AttLayer.generate_simple( \
                         activations[-1], activations[-1], activations[-1], \
                         self.n_head, n_head_tile, next_tag, True, self.mask, \
-                        redux=redux)
+                        redux=redux, head_distr=head_distr)
             layers.append(attn_layer)
             activations.extend(attn_layer.activations_output)
 
@@ -206,29 +334,53 @@ class GPT2Model(BaseModel):
             layers.append(l_norm)
             activations.extend(l_norm.activations_output)
 
-            gpt_block = GPT2MLP(activations[-1], config, next_tag)
+            gpt_block = GPT2MLP(activations[-1], config, next_tag, start_rank)
             next_tag = gpt_block.next_tag
 
             activations.extend(gpt_block.activations[1:])
             layers.extend(gpt_block.layers)
 
+            # Output of the last block of a stage lives on the first rank of
+            # the next stage, so that the next stage reads its input locally
+            next_stage = (h_idx+1) * pipeline_parallel // num_hidden_layers
+            res_distr = None
+            if next_stage != stage and next_stage < pipeline_parallel:
+                res_distr = [next_stage * tensor_parallel \
+                        % mpi_world_size()] \
+                        * len(activations[-1].value.distribution)
             new_layer, next_tag = Add.generate_simple(activations[-5], \
-                    activations[-1], next_tag)
+                    activations[-1], next_tag, res_distr)
             layers.append(new_layer)
             activations.extend(new_layer.activations_output)
 
+            # Close pipeline stage after its last block
+            if stage != next_stage:
+                self.stages.append(range(stage_start, len(layers)))
+                stage_start = len(layers)
+
         l_norm, next_tag = LayerNorm.generate_simple(activations[-1], 0, \
                 layer_norm_epsilon, next_tag, redux=redux)
 
         layers.append(l_norm)
         activations.extend(l_norm.activations_output)
 
+        # LM head is stored where the output of the last block is
+        lm_head_rank = activations[-1].value.distribution[0]
+        lm_head_w_traits = TensorTraits([vocab_size, self.embed_dim], \
+                [vocab_size, embed_dim_tile])
+        lm_head_y_traits = TensorTraits([vocab_size]+ \
+                activations[-1].value.shape[1:], [vocab_size]+ \
+                activations[-1].value.basetile_shape[1:])
         lm_head_layer, next_tag = Linear.generate_simple( \
                 activations[-1], "R", notrans, 1, [vocab_size], [vocab_size], \
-                next_tag, False, redux=redux)
+                next_tag, False, redux=redux, \
+                w_distr=[lm_head_rank]*lm_head_w_traits.grid.nelems, \
+                y_distr=[lm_head_rank]*lm_head_y_traits.grid.nelems)
 
         layers.append(lm_head_layer)
         activations.extend(lm_head_layer.activations_output)
+        # Final LayerNorm and LM head belong to the last pipeline stage
+        self.stages[-1] = range(self.stages[-1].start, len(layers))
 
         self.next_tag = next_tag
         # Fill Base Model with the generated data
@@ -381,6 +533,120 @@ class GPT2Model(BaseModel):
 
         return gpt2_nntile, gpt2_nntile.next_tag
 
+    # Model for incremental decoding of seq_len new positions at a time, that
+    # shares parameters with this model. Caches of keys and values of all
+    # attention layers hold as many positions, as this model processes.
+    # Non-zero kv_block_size makes caches paged with kv_num_blocks blocks
+    # per layer, that are shared by all sequences of a batch. By default,
+    # there are as many blocks, as needed for batch_size sequences of
+    # maximal length, while a smaller pool serves the same batch as long as
+    # the actual lengths of sequences fit into it. Paged caches require
+    # seq_len=1 and batch_size_tile=1.
+    def generate_decoder(self, batch_size: int, batch_size_tile: int, \
+            kv_cache_tile: int, next_tag: int, seq_len: int=1, \
+            kv_block_size: int=0, kv_num_blocks: int=0):
+        kv_cache_size = self.activations[0].value.shape[0]
+        if kv_block_size > 0:
+            if kv_num_blocks == 0:
+                kv_num_blocks = batch_size \
+                        * ((kv_cache_size-1)//kv_block_size+1)
+            kv_cache_size = kv_num_blocks * kv_block_size
+        x_traits = TensorTraits([seq_len, batch_size], \
+                [seq_len, batch_size_tile])
+        x_distr = [0] * x_traits.grid.nelems
+        # Each sequence of a batch has its own positions
+        positional_ids_value = Tensor_int64(x_traits, x_distr, next_tag)
+        next_tag = positional_ids_value.next_tag
+        positional_ids = TensorMoments(positional_ids_value, None, False)
+        x = Tensor_int64(x_traits, x_distr, next_tag)
+        next_tag = x.next_tag
+        x_moments = TensorMoments(x, None, False)
+        decoder = GPT2Model(x_moments, positional_ids, self.config, \
+                next_tag, kv_cache_size, kv_cache_tile, kv_block_size)
+        for decoder_layer, layer in zip(decoder.layers, self.layers):
+            decoder_layer.share_parameters(layer)
+        decoder.parameters = []
+        for l in decoder.layers:
+            decoder.parameters.extend(l.parameters)
+        decoder.reset_cache()
+        return decoder, decoder.next_tag
+
+    # Mask of allowed positions of caches for seq_len new positions, that
+    # start at position cache_pos
+    @staticmethod
+    def cache_mask(kv_cache_size: int, seq_len: int, cache_pos: int):
+        cache_idx = np.arange(kv_cache_size).reshape(-1, 1)
+        new_idx = cache_pos + np.arange(seq_len).reshape(1, -1)
+        return np.array(cache_idx <= new_idx, dtype=bool, order="F")
+
+    # Forget all positions, stored in caches of keys and values
+    def reset_cache(self):
+        for l in self.layers:
+            if isinstance(l, AttentionKVCache):
+                l.reset_cache()
+        self.cache_pos = 0
+
+    # Process new tokens of shape (seq_len, batch_size) against caches of
+    # keys and values. All sequences of a batch share the same positions.
+    # Logits of new positions are stored in activations[-1].
+    def decode_async(self, input_ids: np.ndarray):
+        seq_len, batch_size = self.activations[0].value.shape
+        if self.cache_pos+seq_len > self.kv_cache_size:
+            raise ValueError("Cache of keys and values is full")
+        positional_ids = np.repeat(np.arange(self.cache_pos, \
+                self.cache_pos+seq_len).reshape(-1, 1), batch_size, axis=1)
+        mask = np.repeat(GPT2Model.cache_mask(self.kv_cache_size, seq_len, \
+                self.cache_pos)[:, :, np.newaxis], batch_size, axis=2)
+        self.decode_step_async(input_ids, positional_ids, mask, \
+                self.cache_pos)
+        self.cache_pos += seq_len
+
+    # Process new tokens with positions of shape (seq_len, batch_size),
+    # whose keys and values are stored at cache_pos of caches. Each new
+    # position of each sequence attends to positions of caches, allowed by
+    # mask of shape (kv_cache_size, seq_len, batch_size).
+    def decode_step_async(self, input_ids: np.ndarray, \
+            positional_ids: np.ndarray, mask: np.ndarray, cache_pos: int):
+        if self.kv_cache_size == 0 or self.kv_block_size > 0:
+            raise ValueError("Model has no contiguous cache of keys and " \
+                    "values")
+        self.activations[0].value.from_array(np.asfortranarray(input_ids, \
+                dtype=np.int64))
+        self.activations[1].value.from_array(np.asfortranarray( \
+                positional_ids, dtype=np.int64))
+        self.mask.from_array(np.asfortranarray(mask, dtype=bool))
+        # Attention skips tiles of caches after the last allowed position
+        allowed = np.nonzero(np.reshape(mask, (mask.shape[0], -1), \
+                order="F").any(axis=1))[0]
+        n_attend = int(allowed[-1])+1 if len(allowed) > 0 else 1
+        for l in self.layers:
+            if type(l) is AttentionKVCache:
+                l.cache_pos = cache_pos
+                l.n_attend = n_attend
+        self.forward_async()
+
+    # Process a new token of each sequence with positions of shape
+    # (1, batch_size) against paged caches of keys and values. Sequence b
+    # consists of blocks block_table[b] and stores key and value of the new
+    # position at position slot_offset[b] of block slot_block[b]. Mask of
+    # shape (kv_block_size, n_blocks) tells filled positions of all blocks,
+    # including the new ones.
+    def decode_paged_step_async(self, input_ids: np.ndarray, \
+            positional_ids: np.ndarray, block_mask: np.ndarray, \
+            block_table: List[List[int]], slot_block: List[int], \
+            slot_offset: List[int]):
+        if self.kv_block_size == 0:
+            raise ValueError("Model has no paged cache of keys and values")
+        self.activations[0].value.from_array(np.asfortranarray(input_ids, \
+                dtype=np.int64))
+        self.activations[1].value.from_array(np.asfortranarray( \
+                positional_ids, dtype=np.int64))
+        self.mask.from_array(np.asfortranarray(block_mask, dtype=bool))
+        for l in self.layers:
+            if type(l) is AttentionPagedKVCache:
+                l.set_block_table(block_table, slot_block, slot_offset)
+        self.forward_async()
+
     def unregister(self):
         super().unregister()
         if self.mask:
@@ -0,0 +1,259 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/model/gpt2_distr.py
+# Planner of tile distributions for GPT2 model of NNTile Python package
+#
+# @version 1.0.0
+
+from nntile.tensor import TensorTraits, notrans, trans
+from nntile.nntile_core.tensor import distributions
+import numpy as np
+from typing import Dict, List, Tuple
+
+# Candidate distributions of a tensor, viewed as a matrix of tiles with
+# ndim_rows dimensions as rows and the rest as columns
+def candidate_distributions(traits: TensorTraits, ndim_rows: int, \
+        mpi_size: int) -> Dict[str, List[int]]:
+    grid = traits.grid.shape
+    nelems = traits.grid.nelems
+    res = {"root": [0] * nelems}
+    if mpi_size == 1:
+        return res
+    res["rows"] = distributions.matrix_block_cyclic(grid, ndim_rows, \
+            mpi_size, 1, 0, mpi_size)
+    res["cols"] = distributions.matrix_block_cyclic(grid, ndim_rows, 1, \
+            mpi_size, 0, mpi_size)
+    for p in range(2, mpi_size):
+        if mpi_size % p != 0:
+            continue
+        q = mpi_size // p
+        res["2d_{}x{}".format(p, q)] = distributions.matrix_block_cyclic( \
+                grid, ndim_rows, p, q, 0, mpi_size)
+    for c in range(2, mpi_size+1):
+        if mpi_size % c != 0:
+            continue
+        p = mpi_size // c
+        for layer_dim in range(2):
+            name = "2.5d_{}x1x{}_{}".format(p, c, "rc"[layer_dim])
+            res[name] = distributions.matrix_block_cyclic_2_5d(grid, \
+                    ndim_rows, p, 1, c, layer_dim, 0, mpi_size)
+    return res
+
+# Planned tensor: traits, distribution and name of its layout
+class PlannedTensor:
+    traits: TensorTraits
+    distr: List[int]
+    layout: str
+    # Parameters have moments of Adam, that also occupy memory
+    is_param: bool
+
+    def __init__(self, traits: TensorTraits, distr: List[int], layout: str, \
+            is_param: bool):
+        self.traits = traits
+        self.distr = distr
+        self.layout = layout
+        self.is_param = is_param
+
+# Greedy planner of distributions of all tensors of GPT2Model
+#
+# Linear layers of GPT2 are Y=W@X gemms with side="R". They are processed one
+# by one in the order of forward pass. For a fixed distribution of X, every
+# candidate distribution of Y is paired with every candidate distribution of W
+# and with the owner-compute distribution of W, derived from Y. Each gemm runs
+# on owners of tiles of its output, so a rank spends time on its own flops and
+# on received tiles. The pair with the minimal predicted time of the slowest
+# rank for forward gemm and both backward gemms is selected, ties are broken by
+# the total communication volume. Tile-wise operations (residual connections)
+# are charged for realignment of inputs to the distribution of their outputs.
+class GPT2DistributionPlan:
+    tensors: Dict[str, PlannedTensor]
+    transfer_bytes: np.ndarray
+    memory_bytes: np.ndarray
+    mpi_size: int
+    elem_size: int
+    bandwidth: float
+    flop_rate: float
+
+    def __init__(self, config: Dict, batch_size: int, batch_size_tile: int, \
+            seq_len: int, seq_len_tile: int, mpi_size: int, \
+            elem_size: int=4, bandwidth: float=1e10, flop_rate: float=1e13):
+        self.config = config
+        self.mpi_size = mpi_size
+        self.elem_size = elem_size
+        self.bandwidth = bandwidth
+        self.flop_rate = flop_rate
+        self.tensors = {}
+        self.transfer_bytes = np.zeros(mpi_size, dtype=np.int64)
+        self.memory_bytes = np.zeros(mpi_size, dtype=np.int64)
+        embed_dim = config["embed_dim"]
+        embed_dim_tile = config["embed_dim_tile"]
+        inner_dim = config["inner_dim"]
+        inner_dim_tile = config["inner_dim_tile"]
+        n_head = config["n_head"]
+        n_head_tile = config["n_head_tile"]
+        head_size = embed_dim // n_head
+        vocab_size = config["vocab_size"]
+        vocab_embed_dim_tile = config["vocab_embed_dim_tile"]
+        seq_shape = [seq_len, batch_size]
+        seq_tile = [seq_len_tile, batch_size_tile]
+        # Input embeddings are distributed in the most balanced way,
+        # preferably along the batch and sequence
+        x_traits = TensorTraits([embed_dim] + seq_shape, \
+                [embed_dim_tile] + seq_tile)
+        x_cand = candidate_distributions(x_traits, 1, mpi_size)
+        x_layout = min(x_cand, key=lambda layout: \
+                (max(distributions.memory_bytes(x_traits, x_cand[layout], 1, \
+                mpi_size)), layout != "cols"))
+        x = self._add("wte_output", x_traits, x_cand[x_layout], x_layout)
+        for i in range(config["num_hidden_layers"]):
+            prefix = "h{}_".format(i)
+            # Attention projections of q, k and v share the same layout
+            w_qkv_traits = TensorTraits([n_head, head_size, embed_dim], \
+                    [n_head_tile, head_size, embed_dim_tile])
+            q_traits = TensorTraits([n_head, head_size] + seq_shape, \
+                    [n_head_tile, head_size] + seq_tile)
+            w_q, q = self._plan_linear(prefix+"attn_q", w_qkv_traits, x, \
+                    q_traits, 1)
+            for name in ["k", "v"]:
+                self._add(prefix+"attn_w_"+name, w_qkv_traits, w_q.distr, \
+                        w_q.layout, True)
+                self._add(prefix+"attn_"+name, q_traits, q.distr, q.layout)
+                self.transfer_bytes += self._gemm_bytes(w_qkv_traits, \
+                        w_q.distr, x, q_traits, q.distr, 1)
+            # Attention core is computed head by head where q is stored
+            b = self._add(prefix+"attn_b", q_traits, q.distr, q.layout)
+            w_o_traits = TensorTraits([embed_dim, n_head, head_size], \
+                    [embed_dim_tile, n_head_tile, head_size])
+            _, y = self._plan_linear(prefix+"attn_o", w_o_traits, b, \
+                    x_traits, 2)
+            x = self._plan_residual(prefix+"attn_residual", x, y)
+            # MLP
+            w_fc_traits = TensorTraits([inner_dim, embed_dim], \
+                    [inner_dim_tile, embed_dim_tile])
+            h_traits = TensorTraits([inner_dim] + seq_shape, \
+                    [inner_dim_tile] + seq_tile)
+            _, h = self._plan_linear(prefix+"mlp_fc", w_fc_traits, x, \
+                    h_traits, 1)
+            w_proj_traits = TensorTraits([embed_dim, inner_dim], \
+                    [embed_dim_tile, inner_dim_tile])
+            _, y = self._plan_linear(prefix+"mlp_proj", w_proj_traits, h, \
+                    x_traits, 1)
+            x = self._plan_residual(prefix+"mlp_residual", x, y)
+        # Language modeling head
+        w_lm_traits = TensorTraits([vocab_size, embed_dim], \
+                [vocab_embed_dim_tile, embed_dim_tile])
+        logits_traits = TensorTraits([vocab_size] + seq_shape, \
+                [vocab_embed_dim_tile] + seq_tile)
+        self._plan_linear("lm_head", w_lm_traits, x, logits_traits, 1)
+        # Memory: values and gradients of all tensors plus two moments of
+        # Adam for parameters
+        for t in self.tensors.values():
+            nbufs = 4 if t.is_param else 2
+            self.memory_bytes += nbufs * np.array(distributions.memory_bytes( \
+                    t.traits, t.distr, elem_size, mpi_size))
+
+    def _add(self, name: str, traits: TensorTraits, distr: List[int], \
+            layout: str, is_param: bool=False) -> PlannedTensor:
+        t = PlannedTensor(traits, distr, layout, is_param)
+        self.tensors[name] = t
+        return t
+
+    # Bytes received by each rank within forward and backward gemms of
+    # Y=W@X, where the last ndim dimensions of W are contracted
+    def _gemm_bytes(self, w_traits: TensorTraits, w_distr: List[int], \
+            x: PlannedTensor, y_traits: TensorTraits, y_distr: List[int], \
+            ndim: int) -> np.ndarray:
+        mpi_size = self.mpi_size
+        elem_size = self.elem_size
+        # Forward Y = W @ X
+        res = np.array(distributions.gemm_transfer_bytes(notrans, w_traits, \
+                w_distr, notrans, x.traits, x.distr, y_traits, y_distr, ndim, \
+                0, elem_size, mpi_size))
+        # Backward dW = dY @ X^T
+        res += distributions.gemm_transfer_bytes(notrans, y_traits, y_distr, \
+                trans, x.traits, x.distr, w_traits, w_distr, \
+                x.traits.ndim-ndim, 0, elem_size, mpi_size)
+        # Backward dX = W^T @ dY
+        res += distributions.gemm_transfer_bytes(trans, w_traits, w_distr, \
+                notrans, y_traits, y_distr, x.traits, x.distr, \
+                w_traits.ndim-ndim, 0, elem_size, mpi_size)
+        return res
+
+    # Flops, performed by each rank within forward and backward gemms of Y=W@X
+    def _gemm_flops(self, w_traits: TensorTraits, w_distr: List[int], \
+            x: PlannedTensor, y_traits: TensorTraits, y_distr: List[int], \
+            ndim: int) -> np.ndarray:
+        w_ndim_rows = w_traits.ndim - ndim
+        nrows = np.prod(w_traits.shape[:w_ndim_rows])
+        ncontract = np.prod(w_traits.shape[w_ndim_rows:])
+        nbatch = np.prod(x.traits.shape[ndim:])
+        # Number of elements per rank of each output
+        y_nelems = np.array(distributions.memory_bytes(y_traits, y_distr, 1, \
+                self.mpi_size))
+        w_nelems = np.array(distributions.memory_bytes(w_traits, w_distr, 1, \
+                self.mpi_size))
+        x_nelems = np.array(distributions.memory_bytes(x.traits, x.distr, 1, \
+                self.mpi_size))
+        return 2 * (y_nelems*ncontract + w_nelems*nbatch + x_nelems*nrows)
+
+    # Select distributions of W and Y for a linear layer Y=W@X
+    def _plan_linear(self, name: str, w_traits: TensorTraits, \
+            x: PlannedTensor, y_traits: TensorTraits, ndim: int) \
+            -> Tuple[PlannedTensor, PlannedTensor]:
+        w_ndim_rows = w_traits.ndim - ndim
+        y_cand = candidate_distributions(y_traits, w_ndim_rows, \
+                self.mpi_size)
+        w_cand = candidate_distributions(w_traits, w_ndim_rows, \
+                self.mpi_size)
+        best = None
+        for y_layout, y_distr in y_cand.items():
+            w_owner, _ = distributions.gemm_owner_compute(notrans, w_traits, \
+                    notrans, x.traits, y_traits, y_distr, ndim, 0)
+            w_options = [("owner", w_owner)] + list(w_cand.items())
+            for w_layout, w_distr in w_options:
+                nbytes = self._gemm_bytes(w_traits, w_distr, x, y_traits, \
+                        y_distr, ndim)
+                nflops = self._gemm_flops(w_traits, w_distr, x, y_traits, \
+                        y_distr, ndim)
+                time = nbytes/self.bandwidth + nflops/self.flop_rate
+                score = (time.max(), nbytes.sum())
+                if best is None or score < best[0]:
+                    best = (score, nbytes, w_layout, w_distr, y_layout, \
+                            y_distr)
+        _, nbytes, w_layout, w_distr, y_layout, y_distr = best
+        self.transfer_bytes += nbytes
+        w = self._add(name+"_w", w_traits, w_distr, w_layout, True)
+        y = self._add(name+"_y", y_traits, y_distr, y_layout)
+        return w, y
+
+    # Residual connection Z=X+Y is stored where X is
+    def _plan_residual(self, name: str, x: PlannedTensor, y: PlannedTensor) \
+            -> PlannedTensor:
+        # Forward moves Y to X and backward moves dZ back to Y
+        self.transfer_bytes += distributions.tilewise_transfer_bytes( \
+                x.traits, y.distr, x.distr, self.elem_size, self.mpi_size)
+        self.transfer_bytes += distributions.tilewise_transfer_bytes( \
+                x.traits, x.distr, y.distr, self.elem_size, self.mpi_size)
+        return self._add(name, x.traits, x.distr, x.layout)
+
+    # Human-readable report on per-rank memory and communication
+    def report(self, layouts: bool=True) -> str:
+        lines = []
+        if layouts:
+            lines.append("Tensor layouts:")
+            for name, t in self.tensors.items():
+                lines.append("  {:<24} {:<16} grid={}".format(name, \
+                        t.layout, t.traits.grid.shape))
+        lines.append("{:>6} {:>16} {:>16}".format("rank", "memory (MB)", \
+                "received (MB)"))
+        for rank in range(self.mpi_size):
+            lines.append("{:>6} {:>16.2f} {:>16.2f}".format(rank, \
+                    self.memory_bytes[rank] / 2**20, \
+                    self.transfer_bytes[rank] / 2**20))
+        return "\n".join(lines)
@@ -20,47 +20,213 @@
 #include <sstream>
 #include <cstring>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
 
 using namespace nntile;
 namespace py = pybind11;
 
-constexpr auto _wait_for_all_sleep_time = std::chrono::milliseconds(1);
+// How often a waiting Python thread checks for signals
+constexpr auto _wait_signal_check_time = std::chrono::milliseconds(100);
+
+// Blocking call, executed by a helper thread
+struct BlockingCall
+{
+    std::function<void()> func;
+    // Call is dropped if it is cancelled before it is started
+    bool cancelled = false;
+    bool done = false;
+    std::exception_ptr error;
+};
+
+// Pool of helper threads, that execute blocking calls. Every call gets its
+// own thread, so that calls from different Python threads do not wait for
+// each other. Idle threads are reused and a new thread is started only if
+// all of them are busy. Threads are joined by shutdown(), that is done
+// before StarPU is shut down, so that no call outlives StarPU.
+class BlockingCaller
+{
+    std::mutex mutex;
+    std::condition_variable cv_work, cv_done;
+    std::deque<std::shared_ptr<BlockingCall>> queue;
+    std::vector<std::thread> threads;
+    std::size_t nidle = 0;
+    bool stop = false;
+    // Main loop of a helper thread. Queued calls are finished before the
+    // thread stops.
+    void loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while(true)
+        {
+            ++nidle;
+            cv_work.wait(lock, [this](){return stop or !queue.empty();});
+            --nidle;
+            if(queue.empty())
+            {
+                return;
+            }
+            auto call = queue.front();
+            queue.pop_front();
+            if(call->cancelled)
+            {
+                continue;
+            }
+            lock.unlock();
+            try
+            {
+                call->func();
+            }
+            catch(...)
+            {
+                call->error = std::current_exception();
+            }
+            // Captured data is released by the helper thread
+            call->func = nullptr;
+            lock.lock();
+            call->done = true;
+            cv_done.notify_all();
+        }
+    }
+public:
+    ~BlockingCaller()
+    {
+        shutdown();
+    }
+    std::shared_ptr<BlockingCall> submit(std::function<void()> func)
+    {
+        auto call = std::make_shared<BlockingCall>();
+        call->func = std::move(func);
+        std::lock_guard<std::mutex> lock(mutex);
+        if(stop)
+        {
+            throw std::runtime_error("Blocking call during shutdown");
+        }
+        queue.push_back(call);
+        // Start a new thread if there are more calls than idle threads
+        if(queue.size() > nidle)
+        {
+            threads.emplace_back(&BlockingCaller::loop, this);
+        }
+        cv_work.notify_one();
+        return call;
+    }
+    // Wait for a call to finish for a given time
+    template<typename Duration>
+    bool wait_for(const std::shared_ptr<BlockingCall> &call,
+            Duration duration)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv_done.wait_for(lock, duration,
+                [&call](){return call->done;});
+    }
+    // Cancel a call, that is not started yet. A running call is finished
+    // by its helper thread on its own.
+    void cancel(const std::shared_ptr<BlockingCall> &call)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        call->cancelled = true;
+    }
+    // Finish all queued calls and join all helper threads
+    void shutdown()
+    {
+        std::vector<std::thread> tmp;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(threads.empty())
+            {
+                return;
+            }
+            stop = true;
+            tmp.swap(threads);
+        }
+        cv_work.notify_all();
+        for(auto &thread: tmp)
+        {
+            thread.join();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = false;
+    }
+};
+
+static BlockingCaller blocking_caller;
+
+// Run a blocking call in a helper thread and wait for it without the GIL.
+// The Python thread is woken up as soon as the call returns and checks for
+// signals in between, so KeyboardInterrupt still works. In case of an
+// interrupt the call is cancelled if it has not started yet, while a
+// running call keeps its thread and does not delay other calls.
+void wait_interruptible(std::function<void()> func)
+{
+    auto call = blocking_caller.submit(std::move(func));
+    while(true)
+    {
+        {
+            py::gil_scoped_release release;
+            if(blocking_caller.wait_for(call, _wait_signal_check_time))
+            {
+                break;
+            }
+        }
+        if(PyErr_CheckSignals() != 0)
+        {
+            blocking_caller.cancel(call);
+            throw py::error_already_set();
+        }
+    }
+    if(call->error)
+    {
+        std::rethrow_exception(call->error);
+    }
+}
+
+// StarPU config, that joins the helper thread of blocking calls before
+// StarPU is shut down
+struct PyConfig: public starpu::Config
+{
+    using starpu::Config::Config;
+    ~PyConfig()
+    {
+        blocking_caller.shutdown();
+    }
+    void shutdown()
+    {
+        {
+            py::gil_scoped_release release;
+            blocking_caller.shutdown();
+        }
+        starpu::Config::shutdown();
+    }
+};
 
 // Extend (sub)module with nntile::starpu functionality
 void def_mod_starpu(py::module_ &m)
 {
     using namespace nntile::starpu;
     using namespace std::chrono_literals;
-    py::class_<Config>(m, "Config").
+    py::class_<PyConfig>(m, "Config").
         def(py::init<int, int, int>()).
-        def("shutdown", &Config::shutdown);
+        def("shutdown", &PyConfig::shutdown);
     m.def("init", init);
     m.def("pause", starpu_pause);
     m.def("resume", starpu_resume);
     m.def("wait_for_all", [](){
-            while(true)
-            {
-                int nsubmitted = starpu_task_nsubmitted();
-                //int nready = starpu_task_nready();
-                //std::cout << "S=" << nsubmitted << " R=" << nready << "\n";
-                //if (nready > nsubmitted)
-                //{
-                //    std::cout << "======================\n";
-                //}
-                std::this_thread::sleep_for(_wait_for_all_sleep_time);
-                if(nsubmitted == 0)
-                {
-                    break;
-                }
-                if(PyErr_CheckSignals() != 0)
-                {
-                    throw py::error_already_set();
-                }
-            }
-            starpu_mpi_wait_for_all(MPI_COMM_WORLD);});
+            wait_interruptible([](){
+                    starpu_task_wait_for_all();
+                    starpu_mpi_wait_for_all(MPI_COMM_WORLD);});});
+    m.def("mpi_world_size", [](){return starpu_mpi_world_size();});
+    m.def("mpi_world_rank", [](){return starpu_mpi_world_rank();});
+    m.def("mpi_barrier", [](){
+            wait_interruptible([](){starpu_mpi_barrier(MPI_COMM_WORLD);});});
     m.def("restrict_cuda", [](){restrict_where(STARPU_CUDA);});
     m.def("restrict_cpu", [](){restrict_where(STARPU_CPU);});
     m.def("restrict_restore", [](){restore_where();});
+    m.def("tile_io_nerrors", tile_io::get_nerrors);
     m.def("profiling_init", [](){
             //starpu_profiling_init();
             });
@@ -70,6 +236,93 @@ void def_mod_starpu(py::module_ &m)
     m.def("profiling_disable", [](){
             //starpu_profiling_status_set(STARPU_PROFILING_DISABLE);
             starpu_fxt_stop_profiling();});
+    m.def("trace_enable", trace::enable, py::arg("capacity")=65536);
+    m.def("trace_disable", trace::disable);
+    m.def("trace_dump", trace::dump);
+    m.def("memory_category_names", [](){
+            std::vector<std::string> names;
+            for(int i = 0; i < memory::NCATEGORIES; ++i)
+            {
+                names.push_back(memory::category_name(i));
+            }
+            return names;});
+    m.def("memory_set_default_category", memory::set_default_category);
+    m.def("memory_get_default_category", memory::get_default_category);
+    m.def("memory_stats", [](){
+            auto stats = memory::get_stats();
+            std::vector<Index> live(stats.live,
+                    stats.live+memory::NCATEGORIES);
+            std::vector<Index> peak(stats.peak,
+                    stats.peak+memory::NCATEGORIES);
+            return std::make_tuple(live, peak, stats.live_total,
+                    stats.peak_total);});
+    m.def("memory_reset_peak", memory::reset_peak);
+    m.def("memory_timeline_enable", memory::timeline_enable);
+    m.def("memory_timeline_disable", memory::timeline_disable);
+    m.def("memory_timeline_get", [](){
+            py::list res;
+            for(const auto &sample: memory::timeline_get())
+            {
+                std::vector<Index> live(sample.live,
+                        sample.live+memory::NCATEGORIES);
+                res.append(py::make_tuple(sample.time, live));
+            }
+            return res;});
+    m.def("memory_nodes", [](){
+            // Memory used by StarPU on each memory node
+            py::list res;
+            for(unsigned i = 0; i < starpu_memory_nodes_get_count(); ++i)
+            {
+                res.append(py::make_tuple(i, starpu_memory_get_used(i),
+                            starpu_memory_get_total(i)));
+            }
+            return res;});
+    m.def("submitter_init", submitter::init);
+    m.def("submitter_shutdown", submitter::shutdown);
+    m.def("submitter_get_nthreads", submitter::get_nthreads);
+    m.def("submitter_set_min_tasks", submitter::set_min_tasks);
+    m.def("submitter_get_min_tasks", submitter::get_min_tasks);
+    m.def("perfmodel_symbols", perfmodel::get_symbols);
+    m.def("perfmodel_path", perfmodel::get_path);
+    m.def("perfmodel_record_enable", perfmodel::record_enable);
+    m.def("perfmodel_record_disable", perfmodel::record_disable);
+    m.def("perfmodel_record_get", [](){
+            std::vector<std::tuple<std::string, std::uint32_t>> res;
+            for(const auto &entry: perfmodel::record_get())
+            {
+                res.emplace_back(entry.symbol, entry.footprint);
+            }
+            return res;});
+    m.def("perfmodel_find_missing", [](const std::vector<std::tuple<
+                std::string, std::uint32_t>> &entries){
+            std::vector<perfmodel::Entry> query;
+            for(const auto &entry: entries)
+            {
+                query.push_back({std::get<0>(entry), std::get<1>(entry)});
+            }
+            std::vector<std::tuple<std::string, std::uint32_t>> res;
+            for(const auto &entry: perfmodel::find_missing(query))
+            {
+                res.emplace_back(entry.symbol, entry.footprint);
+            }
+            return res;});
+    m.def("counters_enable", counters::enable);
+    m.def("counters_disable", counters::disable);
+    m.def("counters_is_enabled", counters::is_enabled);
+    m.def("counters_reset", counters::reset);
+    m.def("counters_get", [](){
+            py::list res;
+            for(const auto &rec: counters::get())
+            {
+                py::dict item;
+                item["name"] = rec.name;
+                item["ntasks"] = rec.ntasks;
+                item["flops"] = rec.flops;
+                item["bytes"] = rec.bytes;
+                item["seconds"] = rec.seconds;
+                res.append(item);
+            }
+            return res;});
 }
 
 // numpy.ndarray -> Tile
@@ -357,6 +610,10 @@ void def_class_tensor(py::module_ &m, const char *name)
         def("invalidate_submit", &Tensor<T>::invalidate_submit).
         //def("invalidate_submit", &Tensor<T>::wont_use).
         def("wont_use", &Tensor<T>::wont_use).
+        def("set_memory_category", &Tensor<T>::set_memory_category).
+        // Release GIL to let other Python threads run while waiting
+        def("wait", [](const Tensor<T> &tensor){
+                wait_interruptible([tensor](){tensor.wait();});}).
         // def("from_array", &tensor_from_array<T>).
         def("from_array", [](const tensor::Tensor<fp32_t> & t, const py::array_t<fp32_t, py::array::f_style | py::array::forcecast> & a) { return tensor_from_array<fp32_t>(t, a); } ).
         def("from_array", [](const tensor::Tensor<int64_t> & t, const py::array_t<int64_t, py::array::f_style | py::array::forcecast> & a) { return tensor_from_array<int64_t>(t, a); } ).
@@ -385,6 +642,13 @@ void def_tensor_distributions(py::module_ &m)
 {
     using namespace nntile::tensor::distributions;
     m.def("block_cyclic", &block_cyclic);
+    m.def("block_cyclic_axes", &block_cyclic_axes);
+    m.def("matrix_block_cyclic", &matrix_block_cyclic);
+    m.def("matrix_block_cyclic_2_5d", &matrix_block_cyclic_2_5d);
+    m.def("gemm_owner_compute", &gemm_owner_compute);
+    m.def("gemm_transfer_bytes", &gemm_transfer_bytes);
+    m.def("tilewise_transfer_bytes", &tilewise_transfer_bytes);
+    m.def("memory_bytes", &memory_bytes);
 }
 
 // Extend (sub)module with nntile::tensor functionality
@@ -635,10 +899,16 @@ void def_mod_tensor(py::module_ &m)
     m.def("copy_intersection_async_fp64", &copy_intersection_async<fp64_t>);
     m.def("copy_intersection_async_fp32", &copy_intersection_async<fp32_t>);
     m.def("copy_intersection_async_int64", &copy_intersection_async<Index>);
+    m.def("copy_intersection_async_bool", &copy_intersection_async<bool_t>);
+    m.def("copy_intersection_async_fp32_fast_tf32",
+            &copy_intersection_async<fp32_fast_tf32_t>);
 
     m.def("copy_intersection_fp64", &copy_intersection<fp64_t>);
     m.def("copy_intersection_fp32", &copy_intersection<fp32_t>);
     m.def("copy_intersection_int64", &copy_intersection<Index>);
+    m.def("copy_intersection_bool", &copy_intersection<bool_t>);
+    m.def("copy_intersection_fp32_fast_tf32",
+            &copy_intersection<fp32_fast_tf32_t>);
 
     m.def("copy_async_fp64", &copy_async<fp64_t>);
     m.def("copy_async_fp32", &copy_async<fp32_t>);
@@ -740,6 +1010,12 @@ void def_mod_tensor(py::module_ &m)
     m.def("adam_step_fp64", &adam_step<fp64_t>);
     m.def("adam_step_fp32", &adam_step<fp32_t>);
     m.def("adam_step_fp32_fast_tf32", &adam_step<fp32_fast_tf32_t>);
+    m.def("adam_step_sharded_async_fp64",
+            &adam_step_sharded_async<fp64_t>);
+    m.def("adam_step_sharded_async_fp32",
+            &adam_step_sharded_async<fp32_t>);
+    m.def("adam_step_sharded_async_fp32_fast_tf32",
+            &adam_step_sharded_async<fp32_fast_tf32_t>);
 
     m.def("adamw_step_async_fp64", &adamw_step_async<fp64_t>);
     m.def("adamw_step_async_fp32", &adamw_step_async<fp32_t>);
@@ -747,6 +1023,12 @@ void def_mod_tensor(py::module_ &m)
     m.def("adamw_step_fp64", &adamw_step<fp64_t>);
     m.def("adamw_step_fp32", &adamw_step<fp32_t>);
     m.def("adamw_step_fp32_fast_tf32", &adamw_step<fp32_fast_tf32_t>);
+    m.def("adamw_step_sharded_async_fp64",
+            &adamw_step_sharded_async<fp64_t>);
+    m.def("adamw_step_sharded_async_fp32",
+            &adamw_step_sharded_async<fp32_t>);
+    m.def("adamw_step_sharded_async_fp32_fast_tf32",
+            &adamw_step_sharded_async<fp32_fast_tf32_t>);
 
     m.def("scal_inplace_async_fp64", &scal_inplace_async<fp64_t>);
     m.def("scal_inplace_async_fp32", &scal_inplace_async<fp32_t>);
@@ -854,6 +1136,78 @@ void def_mod_tensor(py::module_ &m)
     m.def("transpose_fp64", &transpose<fp64_t>);
     m.def("transpose_fp32", &transpose<fp32_t>);
     m.def("transpose_fp32_fast_tf32", &transpose<fp32_fast_tf32_t>);
+
+    m.def("paged_kv_store_async_fp64", &paged_kv_store_async<fp64_t>);
+    m.def("paged_kv_store_async_fp32", &paged_kv_store_async<fp32_t>);
+    m.def("paged_kv_store_async_fp32_fast_tf32",
+            &paged_kv_store_async<fp32_fast_tf32_t>);
+    m.def("paged_kv_store_fp64", &paged_kv_store<fp64_t>);
+    m.def("paged_kv_store_fp32", &paged_kv_store<fp32_t>);
+    m.def("paged_kv_store_fp32_fast_tf32", &paged_kv_store<fp32_fast_tf32_t>);
+
+    m.def("paged_attention_async_fp64", &paged_attention_async<fp64_t>);
+    m.def("paged_attention_async_fp32", &paged_attention_async<fp32_t>);
+    m.def("paged_attention_async_fp32_fast_tf32",
+            &paged_attention_async<fp32_fast_tf32_t>);
+    m.def("paged_attention_fp64", &paged_attention<fp64_t>);
+    m.def("paged_attention_fp32", &paged_attention<fp32_t>);
+    m.def("paged_attention_fp32_fast_tf32",
+            &paged_attention<fp32_fast_tf32_t>);
+
+    m.def("topk_sample_async_fp64", &topk_sample_async<fp64_t>);
+    m.def("topk_sample_async_fp32", &topk_sample_async<fp32_t>);
+    m.def("topk_sample_async_fp32_fast_tf32",
+            &topk_sample_async<fp32_fast_tf32_t>);
+    m.def("topk_sample_fp64", &topk_sample<fp64_t>);
+    m.def("topk_sample_fp32", &topk_sample<fp32_t>);
+    m.def("topk_sample_fp32_fast_tf32", &topk_sample<fp32_fast_tf32_t>);
+
+    m.def("tile_offsets", &tile_offsets);
+    m.def("save_tiles_async_fp64", &save_tiles_async<fp64_t>);
+    m.def("save_tiles_async_fp32", &save_tiles_async<fp32_t>);
+    m.def("save_tiles_async_fp32_fast_tf32",
+            &save_tiles_async<fp32_fast_tf32_t>);
+    m.def("save_tiles_async_int64", &save_tiles_async<Index>);
+    m.def("save_tiles_async_bool", &save_tiles_async<bool_t>);
+    m.def("save_tiles_fp64", &save_tiles<fp64_t>);
+    m.def("save_tiles_fp32", &save_tiles<fp32_t>);
+    m.def("save_tiles_fp32_fast_tf32", &save_tiles<fp32_fast_tf32_t>);
+    m.def("save_tiles_int64", &save_tiles<Index>);
+    m.def("save_tiles_bool", &save_tiles<bool_t>);
+
+    m.def("load_tiles_async_fp64", &load_tiles_async<fp64_t>);
+    m.def("load_tiles_async_fp32", &load_tiles_async<fp32_t>);
+    m.def("load_tiles_async_fp32_fast_tf32",
+            &load_tiles_async<fp32_fast_tf32_t>);
+    m.def("load_tiles_async_int64", &load_tiles_async<Index>);
+    m.def("load_tiles_async_bool", &load_tiles_async<bool_t>);
+    m.def("load_tiles_fp64", &load_tiles<fp64_t>);
+    m.def("load_tiles_fp32", &load_tiles<fp32_t>);
+    m.def("load_tiles_fp32_fast_tf32", &load_tiles<fp32_fast_tf32_t>);
+    m.def("load_tiles_int64", &load_tiles<Index>);
+    m.def("load_tiles_bool", &load_tiles<bool_t>);
+    // Conversion into another tiling
+    m.def("retile_async_fp64", &retile_async<fp64_t>);
+    m.def("retile_async_fp32", &retile_async<fp32_t>);
+    m.def("retile_async_fp32_fast_tf32", &retile_async<fp32_fast_tf32_t>);
+    m.def("retile_async_int64", &retile_async<Index>);
+    m.def("retile_async_bool", &retile_async<bool_t>);
+    m.def("retile_fp64", &retile<fp64_t>);
+    m.def("retile_fp32", &retile<fp32_t>);
+    m.def("retile_fp32_fast_tf32", &retile<fp32_fast_tf32_t>);
+    m.def("retile_int64", &retile<Index>);
+    m.def("retile_bool", &retile<bool_t>);
+    // Views, that share tiles of tensors
+    m.def("slice_view_fp64", &slice_view<fp64_t>);
+    m.def("slice_view_fp32", &slice_view<fp32_t>);
+    m.def("slice_view_fp32_fast_tf32", &slice_view<fp32_fast_tf32_t>);
+    m.def("slice_view_int64", &slice_view<Index>);
+    m.def("slice_view_bool", &slice_view<bool_t>);
+    m.def("reshape_view_fp64", &reshape_view<fp64_t>);
+    m.def("reshape_view_fp32", &reshape_view<fp32_t>);
+    m.def("reshape_view_fp32_fast_tf32", &reshape_view<fp32_fast_tf32_t>);
+    m.def("reshape_view_int64", &reshape_view<Index>);
+    m.def("reshape_view_bool", &reshape_view<bool_t>);
 }
 
 // Main extension module with all wrappers
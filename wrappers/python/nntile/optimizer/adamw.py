@@ -14,27 +14,47 @@
 import nntile
 import numpy as np
 from nntile.tensor import TensorTraits
+from nntile.optimizer.adam import shard_distributions
 import pickle
 import torch
 
 class FusedAdamW:
     def __init__(self, params, lr, next_tag, beta1=0.9, beta2=0.999, \
             weight_decay=0., eps=1e-8, dtype=np.float32, start_lr=None, \
-            full_lr_iter=None):
+            full_lr_iter=None, sharded=False):
         self.params = params
         self.next_tag = next_tag
         self.num_iter = 1
         self.dtype=dtype
         self.first_moments = []
         self.second_moments = []
-        for p in self.params:
+        # In sharded mode tiles of optimizer states are balanced over all
+        # ranks (see shard_distributions). A tile, whose states are stored
+        # with the parameter tile, is updated in place. Other tiles are
+        # updated by owners of states, that keep master copies of such
+        # parameter tiles in value_shards. Tiles of value_shards for tiles,
+        # that are updated in place, are never accessed, so StarPU does not
+        # allocate memory for them.
+        self.sharded = sharded
+        self.value_shards = []
+        self.shards_synced = False
+        if self.sharded:
+            distrs = shard_distributions(self.params, \
+                    nntile.starpu.mpi_world_size())
+        else:
+            distrs = [p.value.distribution for p in self.params]
+        for p, distr in zip(self.params, distrs):
             p_traits = TensorTraits(p.value.shape, p.value.basetile_shape)
-            self.first_moments.append(type(p.value)(p_traits, \
-                    p.value.distribution, self.next_tag))
+            self.first_moments.append(type(p.value)(p_traits, distr, \
+                    self.next_tag))
             self.next_tag = self.first_moments[-1].next_tag
-            self.second_moments.append(type(p.value)(p_traits, \
-                    p.value.distribution, self.next_tag))
+            self.second_moments.append(type(p.value)(p_traits, distr, \
+                    self.next_tag))
             self.next_tag = self.second_moments[-1].next_tag
+            if self.sharded:
+                self.value_shards.append(type(p.value)(p_traits, distr, \
+                        self.next_tag))
+                self.next_tag = self.value_shards[-1].next_tag
         self.lr = lr
         self.start_lr = start_lr
         self.full_lr_iter = full_lr_iter
@@ -50,6 +70,8 @@ class FusedAdamW:
         for i in range(len(self.first_moments)):
             self.first_moments[i].unregister()
             self.second_moments[i].unregister()
+        for i in range(len(self.value_shards)):
+            self.value_shards[i].unregister()
 
     def step(self):
         cur_lr = self.lr
@@ -58,18 +80,52 @@ class FusedAdamW:
                 cur_lr = (self.lr-self.start_lr) / (self.full_lr_iter-1)
                 cur_lr = cur_lr*(self.num_iter-1) + self.start_lr
         for i, p in enumerate(self.params):
+            # Master copies of moved parameter tiles are taken before the
+            # first step and after the state is loaded, as parameters could
+            # be changed meanwhile
+            p_shard = self.value_shards[i] if self.sharded else None
             nntile.tensor.fused_adamw_step(p.value, p.grad, \
                     self.first_moments[i], self.second_moments[i], cur_lr, \
                     self.eps, self.beta1, self.beta2, self.weight_decay, \
-                    self.num_iter)
+                    self.num_iter, p_shard, not self.shards_synced)
+            if self.sharded:
+                p_shard.wont_use()
             # dP can be deleted
             p.grad.invalidate_submit()
             # Parameters and states can be offloaded from GPU
             p.value.wont_use()
             self.first_moments[i].wont_use()
             self.second_moments[i].wont_use()
+        self.shards_synced = self.sharded
         self.num_iter += 1
 
+    # Tensors of the state for nntile.checkpoint
+    def checkpoint_tensors(self):
+        tensors = {}
+        for i in range(len(self.first_moments)):
+            tensors["first_moments.{}".format(i)] = self.first_moments[i]
+            tensors["second_moments.{}".format(i)] = self.second_moments[i]
+        return tensors
+
+    # Scalars of the state for nntile.checkpoint
+    def checkpoint_metadata(self):
+        return {"num_iter": self.num_iter, "beta1": self.beta1, \
+                "beta2": self.beta2, "lr": self.lr, \
+                "start_lr": self.start_lr, \
+                "full_lr_iter": self.full_lr_iter, "eps": self.eps, \
+                "weight_decay": self.weight_decay}
+
+    def load_checkpoint_metadata(self, metadata):
+        self.num_iter = metadata["num_iter"]
+        self.beta1 = metadata["beta1"]
+        self.beta2 = metadata["beta2"]
+        self.lr = metadata["lr"]
+        self.start_lr = metadata["start_lr"]
+        self.full_lr_iter = metadata["full_lr_iter"]
+        self.eps = metadata["eps"]
+        self.weight_decay = metadata["weight_decay"]
+        self.shards_synced = False
+
     def save_state(self, path, dtype="fp32"):
         first_moments = []
         second_moments = []
@@ -113,6 +169,7 @@ class FusedAdamW:
         self.beta1 = stored_states["beta1"]
         self.beta2 = stored_states["beta2"]
         self.eps = stored_states["eps"]
+        self.shards_synced = False
         self.num_iter = stored_states["num_iter"]
         self.weight_decay = stored_states["weight_decay"]
 
@@ -0,0 +1,209 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/perfmodel.py
+# Bundles of calibrated performance models of codelets
+#
+# @version 1.0.0
+
+from nntile.nntile_core import starpu as core_starpu
+from contextlib import contextmanager
+import argparse
+import hashlib
+import json
+import os
+import shlex
+import shutil
+import socket
+import subprocess
+import sys
+import time
+from typing import Dict, List, Optional
+
+# Every codelet has a history-based performance model, that StarPU keeps in
+# a file per host. A bundle is a directory with a manifest.json and copies
+# of model files, so that models, calibrated on one node, can be installed
+# on other nodes with the same hardware. The manifest also lists footprints
+# of tasks, that are required by a model, to check calibration at startup.
+BUNDLE_VERSION = 1
+
+symbols = core_starpu.perfmodel_symbols
+path = core_starpu.perfmodel_path
+record_enable = core_starpu.perfmodel_record_enable
+record_disable = core_starpu.perfmodel_record_disable
+
+# Unique footprints of tasks, executed while recording was enabled. The list
+# of recorded footprints is cleared.
+def recorded() -> List[Dict]:
+    return [{"symbol": symbol, "footprint": footprint} \
+            for symbol, footprint in core_starpu.perfmodel_record_get()]
+
+# Paths to files of models of all initialized codelets on this host
+def paths() -> Dict[str, str]:
+    return {symbol: path(symbol) for symbol in symbols()}
+
+class Recording:
+    def __init__(self):
+        self.entries = []
+
+# Record footprints of all tasks, executed within a context, e.g. of a single
+# training step:
+#     with nntile.perfmodel.record() as rec:
+#         pipeline.train_async()
+#     json.dump(rec.entries, fp)
+@contextmanager
+def record():
+    res = Recording()
+    core_starpu.wait_for_all()
+    # Drop footprints of a previous recording
+    recorded()
+    record_enable()
+    try:
+        yield res
+        core_starpu.wait_for_all()
+    finally:
+        record_disable()
+        res.entries = recorded()
+
+# Footprints, that are not calibrated on all architectures of workers
+def find_missing(entries: List[Dict]) -> List[Dict]:
+    query = [(entry["symbol"], entry["footprint"]) for entry in entries]
+    return [{"symbol": symbol, "footprint": footprint} for symbol, \
+            footprint in core_starpu.perfmodel_find_missing(query)]
+
+def _sha256(filename: str) -> str:
+    with open(filename, "rb") as fp:
+        return hashlib.sha256(fp.read()).hexdigest()
+
+def read_manifest(dirname: str) -> Dict:
+    with open(os.path.join(dirname, "manifest.json")) as fp:
+        manifest = json.load(fp)
+    if manifest.get("version", 0) > BUNDLE_VERSION:
+        raise ValueError("Bundle {} has unsupported version {}".format( \
+                dirname, manifest.get("version")))
+    return manifest
+
+# Copy models of this host into a bundle. StarPU writes models into files
+# only at shutdown, so models shall be calibrated by a finished process.
+def export_bundle(dirname: str, required: List[Dict]=[], \
+        model_paths: Optional[Dict[str, str]]=None) -> Dict:
+    if model_paths is None:
+        model_paths = paths()
+    os.makedirs(os.path.join(dirname, "models"), exist_ok=True)
+    models = {}
+    for symbol, src in sorted(model_paths.items()):
+        if not os.path.isfile(src):
+            continue
+        dst = os.path.join("models", symbol)
+        shutil.copyfile(src, os.path.join(dirname, dst))
+        models[symbol] = {"file": dst, "sha256": _sha256(src)}
+    manifest = {"version": BUNDLE_VERSION, \
+            "hostname": socket.gethostname(), \
+            "created": time.strftime("%Y-%m-%dT%H:%M:%S"), \
+            "models": models, "required": list(required)}
+    with open(os.path.join(dirname, "manifest.json"), "w") as fp:
+        json.dump(manifest, fp, indent=1)
+    return manifest
+
+# Install models of a bundle as models of this host. Models are read by
+# StarPU at submission of the first task of a codelet, so a bundle shall be
+# imported before any task is submitted. Existing models are kept unless
+# overwrite is set. Returns symbols of installed models.
+def import_bundle(dirname: str, overwrite: bool=False, \
+        model_paths: Optional[Dict[str, str]]=None) -> List[str]:
+    manifest = read_manifest(dirname)
+    if model_paths is None:
+        model_paths = paths()
+    res = []
+    for symbol, model in sorted(manifest["models"].items()):
+        # Skip codelets, that are absent in this version of NNTile
+        if symbol not in model_paths:
+            continue
+        src = os.path.join(dirname, model["file"])
+        if _sha256(src) != model["sha256"]:
+            raise ValueError("Checksum mismatch for {}".format(src))
+        dst = model_paths[symbol]
+        if os.path.exists(dst) and not overwrite:
+            continue
+        os.makedirs(os.path.dirname(dst), exist_ok=True)
+        # Replace a model atomically, as other processes can read it
+        shutil.copyfile(src, dst + ".tmp")
+        os.replace(dst + ".tmp", dst)
+        res.append(symbol)
+    return res
+
+# Check that all footprints, required by a bundle or given explicitly, are
+# calibrated on this node. Missing footprints are reported and returned.
+def check(dirname: Optional[str]=None, entries: Optional[List[Dict]]=None, \
+        file=sys.stderr) -> List[Dict]:
+    if entries is None:
+        entries = read_manifest(dirname)["required"] if dirname else []
+    missing = find_missing(entries)
+    if missing:
+        symbols_missing = sorted(set(entry["symbol"] for entry in missing))
+        print("Performance models are not calibrated for {} of {} task " \
+                "shapes of codelets: {}".format(len(missing), len(entries), \
+                ", ".join(symbols_missing)), file=file)
+    return missing
+
+def _read_required(filename: Optional[str]) -> List[Dict]:
+    if not filename:
+        return []
+    with open(filename) as fp:
+        return json.load(fp)
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(prog="nntile.perfmodel", \
+            description="Export, import and verify bundles of performance " \
+            "models of NNTile codelets")
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("export", help="copy models of this host")
+    p.add_argument("bundle")
+    p.add_argument("--required", help="JSON list of recorded footprints")
+    p = sub.add_parser("import", help="install models of a bundle")
+    p.add_argument("bundle")
+    p.add_argument("--overwrite", action="store_true")
+    p = sub.add_parser("verify", help="check calibration of footprints")
+    p.add_argument("bundle")
+    p.add_argument("--required", help="JSON list of recorded footprints")
+    p = sub.add_parser("seed", help="calibrate models by nntile_bench and " \
+            "export them")
+    p.add_argument("bundle")
+    p.add_argument("--bench", default="nntile_bench", \
+            help="path to nntile_bench executable")
+    p.add_argument("--required", help="JSON list of recorded footprints")
+    p.add_argument("--bench-args", default="", \
+            help="arguments of nntile_bench, e.g. \"--shapes gpt2-small\"")
+    args = parser.parse_args(argv)
+    if args.command == "seed":
+        # Models are written by nntile_bench at its shutdown
+        subprocess.run([args.bench] + shlex.split(args.bench_args), \
+                check=True)
+    # Verification needs all workers, other commands only need paths. StarPU
+    # is shut down when config is destroyed.
+    if args.command == "verify":
+        config = core_starpu.Config(-1, -1, 0)
+    else:
+        config = core_starpu.Config(1, 0, 0)
+    core_starpu.init()
+    ret = 0
+    if args.command in ("export", "seed"):
+        manifest = export_bundle(args.bundle, _read_required(args.required))
+        print("Exported {} models into {}".format(len(manifest["models"]), \
+                args.bundle))
+    elif args.command == "import":
+        res = import_bundle(args.bundle, args.overwrite)
+        print("Imported {} models from {}".format(len(res), args.bundle))
+    else:
+        entries = _read_required(args.required) if args.required else None
+        missing = check(args.bundle, entries)
+        ret = 1 if missing else 0
+    return ret
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -12,11 +12,12 @@
 # @version 1.0.0
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
-        copy_async, axpy_async, clear_async
+        copy_async, axpy_async, clear_async, add_async, Tensor_fp32, \
+        Tensor_fp32_fast_tf32, Tensor_fp64, Tensor_int64, Tensor_fp16
 from nntile.layer.base_layer import BaseLayer
 from nntile.model.base_model import BaseModel
 import numpy as np
-from typing import List, Any
+from typing import List, Any, Dict, Tuple
 
 class Pipeline(object):
     x: List[List[Tensor]]
@@ -36,6 +37,26 @@ class Pipeline(object):
         self.loss = loss
         self.n_epochs = n_epochs
         self.loss_hist = []
+        self.checkpointer = None
+
+    # Take a background snapshot after every checkpoint_every batches
+    #
+    # Path may contain {step} field, that is replaced by a number of the
+    # batch, counting from 1.
+    def set_checkpointer(self, checkpointer, checkpoint_every: int, \
+            checkpoint_path: str):
+        self.checkpointer = checkpointer
+        self.checkpoint_every = checkpoint_every
+        self.checkpoint_path = checkpoint_path
+
+    def _checkpoint(self, step: int, i_epoch: int, i_batch: int):
+        if self.checkpointer is None or step % self.checkpoint_every != 0:
+            return
+        metadata = {"step": step, "epoch": i_epoch, "batch": i_batch}
+        if hasattr(self.opt, "checkpoint_metadata"):
+            metadata["optimizer"] = self.opt.checkpoint_metadata()
+        self.checkpointer.snapshot(self.checkpoint_path.format(step=step), \
+                metadata)
 
     def train_async(self):
         batch_counter = 0
@@ -76,6 +97,9 @@ class Pipeline(object):
                 # Apply optimizer after gradients for entire batch are
                 # accumulated
                 self.opt.step()
+                batch_counter += 1
+                # Snapshot is submitted before parameters are offloaded
+                self._checkpoint(batch_counter, i_epoch, i_batch)
                 # Invalidate gradients of parameters and hint to offload
                 # parameters
                 for p in self.model.parameters:
@@ -93,3 +117,425 @@ class Pipeline(object):
             # nntile_xentropy_np = np.zeros((1,), dtype=np.float32, order="F")
             # self.loss.get_val(nntile_xentropy_np)
             # print("Last batch loss after in {} epoch = {}".format(i_epoch, nntile_xentropy_np[0]))
+
+# Pipeline-parallel training with 1F1B schedule of micro-batches
+#
+# Layers of the model are split into contiguous stages, that are stored on
+# different ranks (see GPT2Model.stages). Minibatches of a batch are streamed
+# through the stages as micro-batches: every stage performs several forward
+# passes to fill the pipeline and then alternates one forward and one backward
+# pass. Gradients of parameters are accumulated over micro-batches in the same
+# way, as Pipeline does. All micro-batches share activations of a single
+# model, so values of activations and temporaries, produced by a stage, are
+# stashed after its forward pass and restored before its backward pass.
+# Gradients of activations, that cross stage boundaries, are stashed by
+# consuming stages and summed up by the producing stage.
+class PipelineParallel(Pipeline):
+    stages: List[range]
+    schedule: List[Tuple[int, bool, int]]
+    next_tag: int
+
+    def __init__(self, x: List[List[Tensor]], y: List[List[Tensor]], \
+            model: BaseModel, opt, loss, n_epochs, next_tag: int, \
+            stages: List[range]=None):
+        super().__init__(x, y, model, opt, loss, n_epochs)
+        if stages is None:
+            stages = getattr(model, "stages", [range(len(model.layers))])
+        # Check stages cover all the layers contiguously
+        if stages[0].start != 0 or stages[-1].stop != len(model.layers):
+            raise ValueError("Stages shall cover all layers of the model")
+        for prev, cur in zip(stages[:-1], stages[1:]):
+            if prev.stop != cur.start:
+                raise ValueError("Stages shall be contiguous")
+        self.stages = stages
+        nstages = len(stages)
+        n_micro = max(len(x_batch) for x_batch in x)
+        self.schedule = PipelineParallel.generate_schedule(nstages, n_micro)
+        # Positions of operations within the schedule
+        pos = {op: i for i, op in enumerate(self.schedule)}
+        # Find out which stage produces each activation
+        producer = {}
+        for s, stage in enumerate(stages):
+            for l in model.layers[stage.start:stage.stop]:
+                for t in l.activations_output:
+                    producer[id(t)] = s
+        self.produced = [[] for s in range(nstages)]
+        self.inputs = [[] for s in range(nstages)]
+        self.temporaries = [[] for s in range(nstages)]
+        # Consumers of each activation, that belong to other stages
+        self.consumers = {}
+        for s, stage in enumerate(stages):
+            for l in model.layers[stage.start:stage.stop]:
+                for t in l.activations_output:
+                    if all(t is not u for u in self.produced[s]):
+                        self.produced[s].append(t)
+                for t in l.activations_input:
+                    if producer.get(id(t), None) == s:
+                        continue
+                    if any(t is u for u in self.inputs[s]):
+                        continue
+                    self.inputs[s].append(t)
+                    if id(t) in producer:
+                        self.consumers.setdefault(id(t), []).append(s)
+                for t in l.temporaries:
+                    if type(t) is TensorMoments:
+                        t = t.value
+                    if type(t) in (Tensor_fp32, Tensor_fp32_fast_tf32, \
+                            Tensor_fp64, Tensor_int64):
+                        self.temporaries[s].append(t)
+        self.producer = producer
+        # Stash of values of a stage lives from its forward pass to its
+        # backward pass
+        self.value_nslots = []
+        self.value_stash = []
+        for s in range(nstages):
+            nslots = PipelineParallel._max_overlap( \
+                    [(pos[(s, False, k)], pos[(s, True, k)]) \
+                    for k in range(n_micro)])
+            self.value_nslots.append(nslots)
+            slots = []
+            for i in range(nslots):
+                slot = {}
+                for t in self.produced[s]:
+                    slot[id(t.value)], next_tag = \
+                            PipelineParallel._stash_like(t.value, next_tag)
+                for t in self.temporaries[s]:
+                    slot[id(t)], next_tag = PipelineParallel._stash_like(t, \
+                            next_tag)
+                slots.append(slot)
+            self.value_stash.append(slots)
+        # Stash of gradients, computed by a consumer, lives from backward
+        # pass of the consumer to backward pass of the producer
+        self.grad_nslots = {}
+        self.grad_stash = {}
+        for s in range(nstages):
+            for t in self.inputs[s]:
+                if id(t) not in producer or not t.grad_required:
+                    continue
+                p = producer[id(t)]
+                nslots = PipelineParallel._max_overlap( \
+                        [(pos[(s, True, k)], pos[(p, True, k)]) \
+                        for k in range(n_micro)])
+                slots = []
+                for i in range(nslots):
+                    stash, next_tag = PipelineParallel._stash_like(t.grad, \
+                            next_tag)
+                    slots.append(stash)
+                self.grad_nslots[(id(t), s)] = nslots
+                self.grad_stash[(id(t), s)] = slots
+        self.next_tag = next_tag
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    # 1F1B schedule as a list of (stage, is_backward, micro-batch) operations
+    # in the order of submission
+    @staticmethod
+    def generate_schedule(nstages: int, n_micro: int) \
+            -> List[Tuple[int, bool, int]]:
+        # Sequence of operations of each stage
+        ops = []
+        for s in range(nstages):
+            nwarmup = min(nstages-s-1, n_micro)
+            stage_ops = [(s, False, k) for k in range(nwarmup)]
+            for k in range(n_micro-nwarmup):
+                stage_ops.append((s, False, nwarmup+k))
+                stage_ops.append((s, True, k))
+            for k in range(n_micro-nwarmup, n_micro):
+                stage_ops.append((s, True, k))
+            ops.append(stage_ops)
+        # Simulate synchronous steps, where each stage performs at most one
+        # operation, whose dependencies are already satisfied
+        done = set()
+        next_op = [0] * nstages
+        schedule = []
+        while len(schedule) < 2*nstages*n_micro:
+            step = []
+            for s in range(nstages):
+                if next_op[s] == len(ops[s]):
+                    continue
+                _, is_backward, k = ops[s][next_op[s]]
+                if is_backward:
+                    ready = s == nstages-1 or (s+1, True, k) in done
+                else:
+                    ready = s == 0 or (s-1, False, k) in done
+                if ready:
+                    step.append(ops[s][next_op[s]])
+                    next_op[s] += 1
+            if len(step) == 0:
+                raise RuntimeError("Deadlock in pipeline schedule")
+            done.update(step)
+            schedule.extend(step)
+        return schedule
+
+    # Maximal number of simultaneously alive intervals
+    @staticmethod
+    def _max_overlap(intervals: List[Tuple[int, int]]) -> int:
+        return max(sum(1 for start, end in intervals \
+                if start <= point <= end) for point, _ in intervals)
+
+    @staticmethod
+    def _stash_like(t: Tensor, next_tag: int):
+        traits = TensorTraits(t.shape, t.basetile_shape)
+        stash = type(t)(traits, t.distribution, next_tag)
+        return stash, stash.next_tag
+
+    # Restore values of inputs of a stage for a micro-batch
+    def _restore_inputs(self, s: int, k: int, x_minibatch: Tensor):
+        for t in self.inputs[s]:
+            if id(t) in self.producer:
+                p = self.producer[id(t)]
+                slot = self.value_stash[p][k % self.value_nslots[p]]
+                copy_async(slot[id(t.value)], t.value)
+            elif t is self.model.activations[0]:
+                copy_async(x_minibatch, t.value)
+
+    def _forward_async(self, s: int, k: int, x_minibatch: Tensor):
+        self._restore_inputs(s, k, x_minibatch)
+        stage = self.stages[s]
+        for l in self.model.layers[stage.start:stage.stop]:
+            l.forward_async()
+        slot = self.value_stash[s][k % self.value_nslots[s]]
+        for t in self.produced[s]:
+            copy_async(t.value, slot[id(t.value)])
+        for t in self.temporaries[s]:
+            copy_async(t, slot[id(t)])
+
+    def _backward_async(self, s: int, k: int, x_minibatch: Tensor, \
+            y_minibatch: Tensor):
+        self._restore_inputs(s, k, x_minibatch)
+        slot = self.value_stash[s][k % self.value_nslots[s]]
+        for t in self.produced[s]:
+            copy_async(slot[id(t.value)], t.value)
+        for t in self.temporaries[s]:
+            copy_async(slot[id(t)], t)
+        # Gradients of inputs are accumulated by this stage from scratch
+        for t in self.inputs[s]:
+            if t.grad is not None and t.grad_required:
+                clear_async(t.grad)
+        # Gradients of produced activations are sums of gradients, computed
+        # by consumers
+        for t in self.produced[s]:
+            if t.grad is None or not t.grad_required:
+                continue
+            clear_async(t.grad)
+            for c in self.consumers.get(id(t), []):
+                stash = self.grad_stash[(id(t), c)][ \
+                        k % self.grad_nslots[(id(t), c)]]
+                add_async(1, stash, 1, t.grad)
+        if s == len(self.stages)-1:
+            copy_async(y_minibatch, self.loss.y)
+            self.loss.calc_async()
+        stage = self.stages[s]
+        for l in reversed(self.model.layers[stage.start:stage.stop]):
+            l.backward_async()
+        # Send gradients of inputs to their producers
+        for t in self.inputs[s]:
+            if (id(t), s) in self.grad_stash:
+                stash = self.grad_stash[(id(t), s)][ \
+                        k % self.grad_nslots[(id(t), s)]]
+                copy_async(t.grad, stash)
+                t.grad.invalidate_submit()
+        # Values and gradients of produced activations are not needed anymore
+        for t in self.produced[s]:
+            t.value.invalidate_submit()
+            if t.grad is not None and t.grad_required:
+                t.grad.invalidate_submit()
+
+    def train_async(self):
+        for i_epoch in range(self.n_epochs):
+            num_batches = len(self.x)
+            for i_batch, (x_batch, y_batch) in enumerate(zip(self.x, self.y)):
+                # Zero out gradients of all weights
+                self.model.clear_parameters_grads()
+                clear_async(self.loss.val)
+                # Stream micro-batches through stages
+                for s, is_backward, k in self.schedule:
+                    if k >= len(x_batch):
+                        continue
+                    if is_backward:
+                        self._backward_async(s, k, x_batch[k], y_batch[k])
+                    else:
+                        self._forward_async(s, k, x_batch[k])
+                # Apply optimizer after gradients for entire batch are
+                # accumulated
+                self.opt.step()
+                for p in self.model.parameters:
+                    p.value.wont_use()
+                    if p.grad_required:
+                        p.grad.invalidate_submit()
+                # Limit parallelism through value of loss
+                loss_np = np.zeros((1,), dtype=np.float32, order="F")
+                self.loss.get_val(loss_np)
+                self.loss_hist.append(loss_np[0])
+                print("Batch={}/{} Epoch={}/{} Loss={}".format( \
+                        i_batch+1, num_batches, i_epoch+1, self.n_epochs, \
+                        loss_np[0]), flush=True)
+
+    def unregister(self):
+        for slots in self.value_stash:
+            for slot in slots:
+                for t in slot.values():
+                    t.unregister()
+        for slots in self.grad_stash.values():
+            for t in slots:
+                t.unregister()
+
+# Data-parallel training over replicas of a model
+#
+# Every replica is a separate model with the same parameters, built by the
+# user on its own set of ranks, and every replica has its own loss. Minibatches
+# of a batch are dealt to replicas in a round-robin manner. Gradients of
+# parameters are grouped into buckets of a limited size in the order, they are
+# produced by backward pass. As soon as backward pass of all replicas produced
+# a bucket in the last round of minibatches, gradients of the bucket are
+# reduced into the first replica by a binary tree of add_async calls. StarPU
+# starts the reduction when the gradients are ready, so it overlaps with the
+# rest of the backward pass. The optimizer updates parameters of the first
+# replica and updated parameters are broadcasted back by a binary tree of
+# copy_async calls. This way, the all-reduce of gradients is split into reduce
+# of gradients and broadcast of parameters, and optimizer states are stored
+# only once.
+class DataParallel(Pipeline):
+    models: List[BaseModel]
+    losses: List[Any]
+    buckets: List[List[int]]
+    bucket_size: int
+
+    def __init__(self, x: List[List[Tensor]], y: List[List[Tensor]], \
+            models: List[BaseModel], opt, losses: List[Any], n_epochs, \
+            bucket_size: int=25*2**20):
+        super().__init__(x, y, models[0], opt, losses[0], n_epochs)
+        if len(models) != len(losses):
+            raise ValueError("Each replica shall have its own loss")
+        nparams = len(models[0].parameters)
+        nlayers = len(models[0].layers)
+        for m in models[1:]:
+            if len(m.layers) != nlayers or len(m.parameters) != nparams:
+                raise ValueError("Replicas shall have the same structure")
+        self.models = models
+        self.losses = losses
+        self.bucket_size = bucket_size
+        # Index of each parameter within the list of parameters of a model
+        param_index = {id(p): i for i, p in \
+                enumerate(models[0].parameters)}
+        # Split gradients into buckets in the order of backward pass. Each
+        # bucket is ready after backward pass of its last layer.
+        self.buckets = []
+        self.bucket_ready = {}
+        bucket = []
+        bucket_bytes = 0
+        for l_idx in reversed(range(nlayers)):
+            for p in models[0].layers[l_idx].parameters:
+                if not p.grad_required or id(p) not in param_index:
+                    continue
+                bucket.append(param_index[id(p)])
+                bucket_bytes += DataParallel._nbytes(p.grad)
+                if bucket_bytes >= bucket_size:
+                    self.bucket_ready.setdefault(l_idx, []).append( \
+                            len(self.buckets))
+                    self.buckets.append(bucket)
+                    bucket = []
+                    bucket_bytes = 0
+            if len(bucket) > 0 and l_idx == 0:
+                self.bucket_ready.setdefault(l_idx, []).append( \
+                        len(self.buckets))
+                self.buckets.append(bucket)
+
+    @staticmethod
+    def _nbytes(t: Tensor) -> int:
+        if type(t) is Tensor_fp64:
+            elem_size = 8
+        elif type(t) is Tensor_fp16:
+            elem_size = 2
+        else:
+            elem_size = 4
+        return int(np.prod(t.shape)) * elem_size
+
+    # Reduce gradients of a bucket into the first replica
+    def reduce_bucket_async(self, bucket: List[int]):
+        nreplicas = len(self.models)
+        step = 1
+        while step < nreplicas:
+            for r in range(0, nreplicas-step, 2*step):
+                for i in bucket:
+                    src = self.models[r+step].parameters[i].grad
+                    dst = self.models[r].parameters[i].grad
+                    add_async(1.0, src, 1.0, dst)
+                    src.invalidate_submit()
+            step *= 2
+
+    # Broadcast parameters of the first replica to other replicas
+    def broadcast_parameters_async(self):
+        nreplicas = len(self.models)
+        step = 1
+        while 2*step < nreplicas:
+            step *= 2
+        while step > 0:
+            for r in range(0, nreplicas-step, 2*step):
+                for src_p, dst_p in zip(self.models[r].parameters, \
+                        self.models[r+step].parameters):
+                    copy_async(src_p.value, dst_p.value)
+            step //= 2
+
+    def train_async(self):
+        nreplicas = len(self.models)
+        nlayers = len(self.model.layers)
+        for i_epoch in range(self.n_epochs):
+            num_batches = len(self.x)
+            for i_batch, (x_batch, y_batch) in enumerate(zip(self.x, self.y)):
+                # Zero out gradients of all weights
+                for m, loss in zip(self.models, self.losses):
+                    m.clear_parameters_grads()
+                    clear_async(loss.val)
+                # Each round processes one minibatch per replica
+                nrounds = (len(x_batch)-1) // nreplicas + 1
+                for i_round in range(nrounds):
+                    replicas = []
+                    for r in range(nreplicas):
+                        i_minibatch = i_round*nreplicas + r
+                        if i_minibatch >= len(x_batch):
+                            break
+                        m = self.models[r]
+                        loss = self.losses[r]
+                        replicas.append(r)
+                        m.clear_activations_grads()
+                        copy_async(x_batch[i_minibatch], \
+                                m.activations[0].value)
+                        m.forward_async()
+                        copy_async(y_batch[i_minibatch], loss.y)
+                        loss.calc_async()
+                    # Backward passes of replicas are submitted layer by
+                    # layer to reduce buckets as soon as they are ready
+                    last_round = i_round == nrounds-1
+                    for l_idx in reversed(range(nlayers)):
+                        for r in replicas:
+                            self.models[r].layers[l_idx].backward_async()
+                        if last_round:
+                            for b in self.bucket_ready.get(l_idx, []):
+                                self.reduce_bucket_async(self.buckets[b])
+                    for r in replicas:
+                        m = self.models[r]
+                        for t in m.activations[2:]:
+                            t.value.invalidate_submit()
+                        for t in m.activations:
+                            if t.grad_required:
+                                t.grad.invalidate_submit()
+                # Apply optimizer to the first replica and share the result
+                self.opt.step()
+                self.broadcast_parameters_async()
+                for m in self.models:
+                    for p in m.parameters:
+                        p.value.wont_use()
+                        if p.grad_required:
+                            p.grad.invalidate_submit()
+                # Limit parallelism through value of loss
+                loss_total = 0.0
+                loss_np = np.zeros((1,), dtype=np.float32, order="F")
+                for loss in self.losses:
+                    loss.get_val(loss_np)
+                    loss_total += loss_np[0]
+                self.loss_hist.append(loss_total)
+                print("Batch={}/{} Epoch={}/{} Loss={}".format( \
+                        i_batch+1, num_batches, i_epoch+1, self.n_epochs, \
+                        loss_total), flush=True)
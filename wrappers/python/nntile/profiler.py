@@ -0,0 +1,142 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/profiler.py
+# Profiler of time, FLOPs and memory of layers of a model
+#
+# @version 1.0.0
+
+from nntile.nntile_core import starpu as core_starpu
+from nntile.nntile_core import tensor as core_tensor
+from nntile.layer import base_layer
+from nntile import counters
+import sys
+import time
+from typing import Dict, List, Optional, Tuple
+
+_itemsize = {
+        core_tensor.Tensor_fp32: 4,
+        core_tensor.Tensor_fp32_fast_tf32: 4,
+        core_tensor.Tensor_fp64: 8,
+        core_tensor.Tensor_fp16: 2,
+        core_tensor.Tensor_int64: 8,
+        core_tensor.Tensor_bool: 1,
+        }
+
+# Bytes of tiles of a tensor or of a value and a gradient of TensorMoments
+def _nbytes(x) -> int:
+    if x is None:
+        return 0
+    if hasattr(x, "value"):
+        return _nbytes(x.value) + _nbytes(x.grad)
+    return x.nelems * _itemsize.get(type(x), 0)
+
+# Bytes of parameters, temporaries and output activations of a layer
+def layer_nbytes(layer: base_layer.BaseLayer) -> int:
+    tensors = layer.parameters + layer.temporaries + layer.activations_output
+    return sum(_nbytes(x) for x in tensors)
+
+# Sum of counters of all codelets
+def _counters_total() -> Tuple[float, float, float]:
+    flops = nbytes = seconds = 0.0
+    for rec in counters.get():
+        flops += rec["flops"]
+        nbytes += rec["bytes"]
+        seconds += rec["seconds"]
+    return flops, nbytes, seconds
+
+# Tasks of all layers interleave asynchronously, so the profiler waits for
+# all tasks when a layer starts and finishes submitting its tasks. All tasks
+# executed in between belong to the layer. This removes overlap of layers,
+# so the profiled step is slower than a normal one, but time, FLOPs and
+# bytes are attributed to layers exactly. Tasks of a layer, nested into
+# another one, are attributed to the inner layer only. Usage:
+#     with nntile.profiler.LayerProfiler(model) as prof:
+#         pipeline.train_async()
+#     prof.report()
+class LayerProfiler:
+    def __init__(self, model=None):
+        self.names = {}
+        if model is not None:
+            for i, layer in enumerate(model.layers):
+                self.names[id(layer)] = "{}:{}".format(i, \
+                        type(layer).__name__)
+        self.stats = {}
+        self.stack = []
+
+    # Name of a layer, used as a row of the report
+    def name(self, layer: base_layer.BaseLayer) -> str:
+        if id(layer) not in self.names:
+            self.names[id(layer)] = type(layer).__name__
+        return self.names[id(layer)]
+
+    # Attribute everything since the last snapshot to the top of the stack
+    def _snapshot(self):
+        core_starpu.wait_for_all()
+        now = time.time()
+        flops, nbytes, seconds = _counters_total()
+        key = self.stack[-1][1:] if self.stack else ("(other)", "")
+        stat = self.stats.setdefault(key, {"calls": 0, "wall": 0.0, \
+                "busy": 0.0, "flops": 0.0, "bytes": 0.0, "memory": 0})
+        stat["wall"] += now - self.last[0]
+        stat["flops"] += flops - self.last[1]
+        stat["bytes"] += nbytes - self.last[2]
+        stat["busy"] += seconds - self.last[3]
+        self.last = (now, flops, nbytes, seconds)
+
+    def push(self, layer: base_layer.BaseLayer, phase: str):
+        self._snapshot()
+        self.stack.append((layer, self.name(layer), phase))
+
+    def pop(self):
+        self._snapshot()
+        layer, name, phase = self.stack.pop()
+        stat = self.stats[(name, phase)]
+        stat["calls"] += 1
+        stat["memory"] = layer_nbytes(layer)
+
+    def __enter__(self):
+        if base_layer._profiler is not None:
+            raise RuntimeError("Another layer profiler is active")
+        core_starpu.wait_for_all()
+        counters.reset()
+        counters.enable()
+        self.last = (time.time(), 0.0, 0.0, 0.0)
+        base_layer._profiler = self
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        try:
+            self._snapshot()
+        finally:
+            base_layer._profiler = None
+            counters.disable()
+        return False
+
+    # Rows of the report, sorted by wall time
+    def rows(self) -> List[Dict]:
+        res = [dict(layer=name, phase=phase, **stat) \
+                for (name, phase), stat in self.stats.items()]
+        res.sort(key=lambda row: row["wall"], reverse=True)
+        return res
+
+    # Print a table of time, FLOPs, bytes moved by tasks and memory of
+    # tensors of each layer
+    def report(self, file=sys.stdout):
+        rows = self.rows()
+        total_wall = sum(row["wall"] for row in rows)
+        print("{:<28} {:<9} {:>6} {:>10} {:>6} {:>10} {:>9} {:>9} " \
+                "{:>10}".format("layer", "phase", "calls", "wall, s", \
+                "%", "busy, s", "GFLOP", "GB", "memory,MB"), file=file)
+        for row in rows:
+            share = 100 * row["wall"] / total_wall if total_wall > 0 else 0
+            print("{:<28} {:<9} {:>6} {:>10.4f} {:>6.1f} {:>10.4f} " \
+                    "{:>9.3f} {:>9.3f} {:>10.1f}".format(row["layer"][:28], \
+                    row["phase"], row["calls"], row["wall"], share, \
+                    row["busy"], row["flops"]*1e-9, row["bytes"]*1e-9, \
+                    row["memory"]/2**20), file=file)
@@ -46,6 +46,15 @@ class TensorMoments(object):
         if self.grad is not None:
             self.grad.unregister()
 
+# Distribution of a tensor, where all tiles with the same index along the
+# given axis are stored on the same rank axis_distr[index]
+def distr_along_axis(traits: TensorTraits, axis: int, \
+        axis_distr: List[int]) -> List[int]:
+    grid = traits.grid
+    if len(axis_distr) != grid.shape[axis]:
+        raise ValueError("len(axis_distr) != grid.shape[axis]")
+    return [axis_distr[(i//grid.stride[axis]) % grid.shape[axis]] \
+            for i in range(grid.nelems)]
 
 # Wrapper for multiprecision gemm
 def gemm_async(alpha: float, trans_A: TransOp, A: Tensor, trans_B: TransOp, \
@@ -587,8 +596,13 @@ def copy_intersection_async(x: TensorFloatOrInt, x_offset: List[int], \
         core_tensor.copy_intersection_async_fp32(x, x_offset, y, y_offset)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.copy_intersection_async_fp64(x, x_offset, y, y_offset)
+    elif type(x) is core_tensor.Tensor_fp32_fast_tf32:
+        core_tensor.copy_intersection_async_fp32_fast_tf32(x, x_offset, y, \
+                y_offset)
     elif type(x) is core_tensor.Tensor_int64:
         core_tensor.copy_intersection_async_int64(x, x_offset, y, y_offset)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.copy_intersection_async_bool(x, x_offset, y, y_offset)
     else:
         raise TypeError
 
@@ -852,14 +866,36 @@ def hypot_scalar_inverse_async(eps: float, alpha: float, x: Tensor) -> None:
     else:
         raise TypeError
 
+# Moments can be distributed differently from parameters if p_shard, a
+# tensor for master copies of moved tiles, is provided (see
+# adam_step_sharded_async)
 def fused_adam_step(p: Tensor, grad: Tensor, first_moment: Tensor, second_moment: Tensor,
-                   lr: float, eps: float, beta1: float, beta2: float, weight_decay: float, num_iter: int):
+                   lr: float, eps: float, beta1: float, beta2: float, weight_decay: float, num_iter: int,
+                   p_shard: TensorOrNone=None, sync_shard: bool=False):
     if type(p) is not type(grad):
         raise TypeError
     if type(p) is not type(first_moment):
         raise TypeError
     if type(p) is not type(second_moment):
         raise TypeError
+    if p_shard is not None:
+        if type(p) is not type(p_shard):
+            raise TypeError
+        if type(p) is core_tensor.Tensor_fp32:
+            core_tensor.adam_step_sharded_async_fp32(num_iter, beta1, \
+                    beta2, eps, lr, weight_decay, grad, first_moment, \
+                    second_moment, p, p_shard, sync_shard)
+        elif type(p) is core_tensor.Tensor_fp32_fast_tf32:
+            core_tensor.adam_step_sharded_async_fp32_fast_tf32(num_iter, \
+                    beta1, beta2, eps, lr, weight_decay, grad, \
+                    first_moment, second_moment, p, p_shard, sync_shard)
+        elif type(p) is core_tensor.Tensor_fp64:
+            core_tensor.adam_step_sharded_async_fp64(num_iter, beta1, \
+                    beta2, eps, lr, weight_decay, grad, first_moment, \
+                    second_moment, p, p_shard, sync_shard)
+        else:
+            raise TypeError
+        return
     if type(p) is core_tensor.Tensor_fp32:
         core_tensor.adam_step_async_fp32(num_iter, beta1, beta2, eps, lr, weight_decay,
                                          grad, first_moment, second_moment, p)
@@ -872,14 +908,36 @@ def fused_adam_step(p: Tensor, grad: Tensor, first_moment: Tensor, second_moment
     else:
         raise TypeError
 
+# Moments can be distributed differently from parameters if p_shard, a
+# tensor for master copies of moved tiles, is provided (see
+# adamw_step_sharded_async)
 def fused_adamw_step(p: Tensor, grad: Tensor, first_moment: Tensor, second_moment: Tensor,
-                   lr: float, eps: float, beta1: float, beta2: float, weight_decay: float, num_iter: int):
+                   lr: float, eps: float, beta1: float, beta2: float, weight_decay: float, num_iter: int,
+                   p_shard: TensorOrNone=None, sync_shard: bool=False):
     if type(p) is not type(grad):
         raise TypeError
     if type(p) is not type(first_moment):
         raise TypeError
     if type(p) is not type(second_moment):
         raise TypeError
+    if p_shard is not None:
+        if type(p) is not type(p_shard):
+            raise TypeError
+        if type(p) is core_tensor.Tensor_fp32:
+            core_tensor.adamw_step_sharded_async_fp32(num_iter, beta1, \
+                    beta2, eps, lr, weight_decay, grad, first_moment, \
+                    second_moment, p, p_shard, sync_shard)
+        elif type(p) is core_tensor.Tensor_fp32_fast_tf32:
+            core_tensor.adamw_step_sharded_async_fp32_fast_tf32(num_iter, \
+                    beta1, beta2, eps, lr, weight_decay, grad, \
+                    first_moment, second_moment, p, p_shard, sync_shard)
+        elif type(p) is core_tensor.Tensor_fp64:
+            core_tensor.adamw_step_sharded_async_fp64(num_iter, beta1, \
+                    beta2, eps, lr, weight_decay, grad, first_moment, \
+                    second_moment, p, p_shard, sync_shard)
+        else:
+            raise TypeError
+        return
     if type(p) is core_tensor.Tensor_fp32:
         core_tensor.adamw_step_async_fp32(num_iter, beta1, beta2, eps, lr, weight_decay,
                                          grad, first_moment, second_moment, p)
@@ -904,3 +962,140 @@ def transpose_async(alpha: float, src: Tensor, dst: Tensor, ndim: int) -> None:
         core_tensor.transpose_async_fp64(alpha, src, dst, ndim)
     else:
         raise TypeError
+
+# Wrapper for multiprecision store into blocks of a paged cache
+def paged_kv_store_async(src: Tensor, pool: Tensor, block: List[int], \
+        offset: List[int]) -> None:
+    if type(src) is not type(pool):
+        raise TypeError
+    if type(src) is core_tensor.Tensor_fp32:
+        core_tensor.paged_kv_store_async_fp32(src, pool, block, offset)
+    elif type(src) is core_tensor.Tensor_fp32_fast_tf32:
+        core_tensor.paged_kv_store_async_fp32_fast_tf32(src, pool, block, \
+                offset)
+    elif type(src) is core_tensor.Tensor_fp64:
+        core_tensor.paged_kv_store_async_fp64(src, pool, block, offset)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision attention to keys and values in paged caches
+def paged_attention_async(alpha: float, q: Tensor, k_pool: Tensor, \
+        v_pool: Tensor, block_mask: Tensor_bool, \
+        block_table: List[List[int]], a: Tensor, a_maxsumexp: Tensor, \
+        b: Tensor) -> None:
+    if type(q) is not type(k_pool) or type(q) is not type(v_pool) \
+            or type(q) is not type(a) or type(q) is not type(a_maxsumexp) \
+            or type(q) is not type(b):
+        raise TypeError
+    if type(q) is core_tensor.Tensor_fp32:
+        core_tensor.paged_attention_async_fp32(alpha, q, k_pool, v_pool, \
+                block_mask, block_table, a, a_maxsumexp, b)
+    elif type(q) is core_tensor.Tensor_fp32_fast_tf32:
+        core_tensor.paged_attention_async_fp32_fast_tf32(alpha, q, k_pool, \
+                v_pool, block_mask, block_table, a, a_maxsumexp, b)
+    elif type(q) is core_tensor.Tensor_fp64:
+        core_tensor.paged_attention_async_fp64(alpha, q, k_pool, v_pool, \
+                block_mask, block_table, a, a_maxsumexp, b)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision topk_sample
+def topk_sample_async(alpha: float, logits: Tensor, topk_val: Tensor, \
+        topk_idx: Tensor_int64, maxsumexp: Tensor, top_k: int, \
+        top_p: float, seed: int, tokens: Tensor_int64) -> None:
+    if type(logits) is not type(topk_val) \
+            or type(logits) is not type(maxsumexp):
+        raise TypeError
+    if type(logits) is core_tensor.Tensor_fp32:
+        core_tensor.topk_sample_async_fp32(alpha, logits, topk_val, \
+                topk_idx, maxsumexp, top_k, top_p, seed, tokens)
+    elif type(logits) is core_tensor.Tensor_fp32_fast_tf32:
+        core_tensor.topk_sample_async_fp32_fast_tf32(alpha, logits, \
+                topk_val, topk_idx, maxsumexp, top_k, top_p, seed, tokens)
+    elif type(logits) is core_tensor.Tensor_fp64:
+        core_tensor.topk_sample_async_fp64(alpha, logits, topk_val, \
+                topk_idx, maxsumexp, top_k, top_p, seed, tokens)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision save_tiles
+def save_tiles_async(x: TensorFloatOrInt, fd: int, offsets: List[int]) \
+        -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.save_tiles_async_fp32(x, fd, offsets)
+    elif type(x) is core_tensor.Tensor_fp32_fast_tf32:
+        core_tensor.save_tiles_async_fp32_fast_tf32(x, fd, offsets)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.save_tiles_async_fp64(x, fd, offsets)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.save_tiles_async_int64(x, fd, offsets)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.save_tiles_async_bool(x, fd, offsets)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision load_tiles
+def load_tiles_async(x: TensorFloatOrInt, fd: int, offsets: List[int]) \
+        -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.load_tiles_async_fp32(x, fd, offsets)
+    elif type(x) is core_tensor.Tensor_fp32_fast_tf32:
+        core_tensor.load_tiles_async_fp32_fast_tf32(x, fd, offsets)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.load_tiles_async_fp64(x, fd, offsets)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.load_tiles_async_int64(x, fd, offsets)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.load_tiles_async_bool(x, fd, offsets)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision retile
+def retile_async(x: TensorFloatOrInt, y: TensorFloatOrInt) -> None:
+    if type(x) is not type(y):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.retile_async_fp32(x, y)
+    elif type(x) is core_tensor.Tensor_fp32_fast_tf32:
+        core_tensor.retile_async_fp32_fast_tf32(x, y)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.retile_async_fp64(x, y)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.retile_async_int64(x, y)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.retile_async_bool(x, y)
+    else:
+        raise TypeError
+
+# View of a slice of a tensor, aligned to tiles, without copying data
+def slice_view(x: TensorFloatOrInt, begin: List[int], end: List[int]) \
+        -> TensorFloatOrInt:
+    if type(x) is core_tensor.Tensor_fp32:
+        return core_tensor.slice_view_fp32(x, begin, end)
+    elif type(x) is core_tensor.Tensor_fp32_fast_tf32:
+        return core_tensor.slice_view_fp32_fast_tf32(x, begin, end)
+    elif type(x) is core_tensor.Tensor_fp64:
+        return core_tensor.slice_view_fp64(x, begin, end)
+    elif type(x) is core_tensor.Tensor_int64:
+        return core_tensor.slice_view_int64(x, begin, end)
+    elif type(x) is core_tensor.Tensor_bool:
+        return core_tensor.slice_view_bool(x, begin, end)
+    else:
+        raise TypeError
+
+# View of a tensor with split or merged dimensions without copying data
+def reshape_view(x: TensorFloatOrInt, shape: List[int], \
+        basetile_shape: List[int]) -> TensorFloatOrInt:
+    if type(x) is core_tensor.Tensor_fp32:
+        return core_tensor.reshape_view_fp32(x, shape, basetile_shape)
+    elif type(x) is core_tensor.Tensor_fp32_fast_tf32:
+        return core_tensor.reshape_view_fp32_fast_tf32(x, shape, \
+                basetile_shape)
+    elif type(x) is core_tensor.Tensor_fp64:
+        return core_tensor.reshape_view_fp64(x, shape, basetile_shape)
+    elif type(x) is core_tensor.Tensor_int64:
+        return core_tensor.reshape_view_int64(x, shape, basetile_shape)
+    elif type(x) is core_tensor.Tensor_bool:
+        return core_tensor.reshape_view_bool(x, shape, basetile_shape)
+    else:
+        raise TypeError
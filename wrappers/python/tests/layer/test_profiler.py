@@ -0,0 +1,63 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_profiler.py
+# Test for profiler of layers
+#
+# @version 1.0.0
+
+# All necesary imports
+import nntile
+import numpy as np
+import io
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Helper function returns bool value true if test passes
+def helper():
+    # Describe single-tile tensor, located at node 0
+    A_shape = [4, 5, 6]
+    A_traits = nntile.tensor.TensorTraits(A_shape, A_shape)
+    mpi_distr = [0]
+    next_tag = 0
+    A = nntile.tensor.Tensor_fp32(A_traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    A_grad = nntile.tensor.Tensor_fp32(A_traits, mpi_distr, next_tag)
+    next_tag = A_grad.next_tag
+    A_moments = nntile.tensor.TensorMoments(A, A_grad, True)
+    A.from_array(np.ones(A_shape, dtype=np.float32, order='F'))
+    # Two layers of a chain
+    relu, next_tag = nntile.layer.Act.generate_simple(A_moments, "relu", \
+            next_tag)
+    gelu, next_tag = nntile.layer.Act.generate_simple(relu.y, "gelutanh", \
+            next_tag)
+    class Model:
+        layers = [relu, gelu]
+    with nntile.profiler.LayerProfiler(Model) as prof:
+        relu.forward_async()
+        gelu.forward_async()
+    rows = {(row["layer"], row["phase"]): row for row in prof.rows()}
+    ok = set(rows) == {("0:Act", "forward"), ("1:Act", "forward"), \
+            ("(other)", "")}
+    # Output of gelutanh is 4*5*6 values and 11 operations per value
+    ok = ok and rows[("1:Act", "forward")]["flops"] == 11*120
+    ok = ok and rows[("1:Act", "forward")]["memory"] == 2*4*120
+    prof.report(file=io.StringIO())
+    A_moments.unregister()
+    relu.unregister()
+    gelu.unregister()
+    return ok and nntile.layer.base_layer._profiler is None
+
+# Test runner
+def test():
+    assert helper()
+
+if __name__ == "__main__":
+    test()
@@ -24,7 +24,8 @@ from typing import Dict
 def run_test(input_dim: int, hidden_dim: int, n_classes: int, bias: bool,
              n_layers: int, device: str, lr: float, n_epoch: int,
              optimizer: str, optimizer_params: Dict[str, float],
-             n_samples: int, batch_size: int, minibatch_size: int):
+             n_samples: int, batch_size: int, minibatch_size: int,
+             data_parallel: int=1):
 
 
 
@@ -124,14 +125,31 @@ def run_test(input_dim: int, hidden_dim: int, n_classes: int, bias: bool,
                                                             next_tag)
     nntile_loss_hist = []
 
+    # Replicas of the model for data-parallel training
+    replicas = [nntile_model]
+    replica_losses = [loss]
+    for i in range(1, data_parallel):
+        replica, next_tag = nntile.model.DeepReLU.from_torch(init_torch_mlp,
+                minibatch_size, n_classes, "relu", next_tag)
+        replica_loss, next_tag = nntile.loss.CrossEntropy.generate_simple(
+                replica.activations[-1], next_tag)
+        replicas.append(replica)
+        replica_losses.append(replica_loss)
+
     if optimizer == "adam":
         nntile_optimizer = nntile.optimizer.FusedAdam(nntile_model.get_parameters(), lr, next_tag)
     elif optimizer == "sgd":
         nntile_optimizer = nntile.optimizer.SGD(nntile_model.get_parameters(), lr, next_tag)
     next_tag = nntile_optimizer.get_next_tag()
 
-    pipeline = nntile.pipeline.Pipeline(batch_data, batch_labels, nntile_model, nntile_optimizer,
-                                        loss, n_epoch)
+    if data_parallel == 1:
+        pipeline = nntile.pipeline.Pipeline(batch_data, batch_labels, nntile_model, nntile_optimizer,
+                                            loss, n_epoch)
+    else:
+        # Small buckets to check reduction of several buckets
+        pipeline = nntile.pipeline.DataParallel(batch_data, batch_labels,
+                replicas, nntile_optimizer, replica_losses, n_epoch,
+                bucket_size=4*hidden_dim*hidden_dim)
     pipeline.train_async()
 
     nntile.starpu.wait_for_all()
@@ -146,6 +164,9 @@ def run_test(input_dim: int, hidden_dim: int, n_classes: int, bias: bool,
         for x in batch:
             x.unregister()
     nntile_optimizer.unregister()
+    for replica, replica_loss in zip(replicas[1:], replica_losses[1:]):
+        replica_loss.unregister()
+        replica.unregister()
     nntile_model.unregister()
 
 if __name__ == "__main__":
@@ -187,3 +208,10 @@ if __name__ == "__main__":
              n_epoch=n_epoch, optimizer="sgd", optimizer_params={},
              n_samples=n_samples, batch_size=batch_size,
              minibatch_size=minibatch_size)
+
+    run_test(input_dim=input_dim, hidden_dim=hidden_dim,
+             n_classes=n_classes, bias=True,
+             n_layers=n_layers, device="cpu", lr=lr,
+             n_epoch=n_epoch, optimizer="adam", optimizer_params={},
+             n_samples=n_samples, batch_size=batch_size,
+             minibatch_size=minibatch_size, data_parallel=3)
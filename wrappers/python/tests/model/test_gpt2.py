@@ -224,7 +224,8 @@ def check_params(model_torch, nntile_model):
                 diff/norm))
 
 def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
-             seq_len_tile, device, optimizer, lr, nepochs):
+             seq_len_tile, device, optimizer, lr, nepochs, tensor_parallel=1,
+             pipeline_parallel=1, num_layers=1):
 
     assert num_samples % batch_size == 0
     assert batch_size % minibatch_size == 0
@@ -236,8 +237,10 @@ def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
     conf_dict = json.load(f)
     f.close()
     config = GPT2Config(**conf_dict)
+    config.n_layer = num_layers
 
-    n_head_tile = config.n_head
+    # Split heads into tiles to distribute them among tensor-parallel ranks
+    n_head_tile = config.n_head // tensor_parallel
     assert config.n_positions % seq_len_tile == 0
     config.attn_pdrop = 0
     config.embd_pdrop = 0
@@ -245,6 +248,8 @@ def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
     inner_dim = config.n_inner if config.n_inner is not None \
         else 4 * config.hidden_size
     config.n_inner = inner_dim
+    # Fixed seed makes the same initial model for different parallel setups
+    torch.manual_seed(0)
     model_torch = GPT2LMHeadModel(config).to(device)
     model_torch.lm_head.weight = nn.Parameter(model_torch.lm_head \
         .weight.detach().clone())
@@ -270,7 +275,8 @@ def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
         config.n_embd, n_embd_tile, config.max_position_embeddings, \
         config.n_inner, n_inner_tile, config.layer_norm_epsilon, \
         config.num_hidden_layers, config.n_head, n_head_tile, \
-        "gelutanh", nntile_flashattention, nntile_use_redux)
+        "gelutanh", nntile_flashattention, nntile_use_redux, \
+        tensor_parallel=tensor_parallel, pipeline_parallel=pipeline_parallel)
     nntile_model, next_tag = GPT2Model_nntile.from_torch(model_torch, \
             minibatch_size, minibatch_size_tile, config.n_positions, \
             seq_len_tile, nntile_model_config, next_tag)
@@ -346,8 +352,14 @@ def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
 
 
 # Set up training pipeline
-    pipeline = nntile.pipeline.Pipeline(batch_input, batch_output, \
-            nntile_model, nntile_optimizer, nntile_loss_func, nepochs)
+    if pipeline_parallel > 1:
+        pipeline = nntile.pipeline.PipelineParallel(batch_input, \
+                batch_output, nntile_model, nntile_optimizer, \
+                nntile_loss_func, nepochs, next_tag)
+        next_tag = pipeline.get_next_tag()
+    else:
+        pipeline = nntile.pipeline.Pipeline(batch_input, batch_output, \
+                nntile_model, nntile_optimizer, nntile_loss_func, nepochs)
     pipeline.train_async()
     nntile.starpu.wait_for_all()
     for i in range(len(torch_loss_hist)):
@@ -355,6 +367,16 @@ def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
         # print(abs(torch_loss_hist[i] - pipeline.loss_hist[i]) / torch_loss_hist[i])
         assert abs(torch_loss_hist[i] - pipeline.loss_hist[i]) / torch_loss_hist[i] < 1e-4
 
+    # Trained parameters for comparison of different parallel setups
+    params = []
+    for p in nntile_model.parameters:
+        p_np = np.zeros(p.value.shape, order="F", dtype=np.float32)
+        p.value.to_array(p_np)
+        params.append(p_np)
+    loss_hist = list(pipeline.loss_hist)
+
+    if pipeline_parallel > 1:
+        pipeline.unregister()
     nntile_loss_func.unregister()
     nntile_optimizer.unregister()
     for batch in batch_input+batch_output:
@@ -363,6 +385,212 @@ def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
 
     # Unregister all tensors related to model
     nntile_model.unregister()
+    return loss_hist, params
+
+# Tensor-parallel sharding of heads and inner dimension of MLP shall not
+# change losses and trained parameters
+def test_tensor_parallel():
+    kwargs = dict(num_samples=4, batch_size=2, minibatch_size=1, \
+            minibatch_size_tile=1, seq_len_tile=1024, device="cpu", \
+            optimizer="adam", lr=1e-4, nepochs=2)
+    loss_ref, params_ref = run_test(**kwargs, tensor_parallel=1)
+    loss, params = run_test(**kwargs, tensor_parallel=2)
+    assert np.allclose(loss, loss_ref, rtol=1e-5, atol=0)
+    for p, p_ref in zip(params, params_ref):
+        assert np.linalg.norm(p-p_ref) <= 1e-5*np.linalg.norm(p_ref)
+
+# A single rank stores all the tiles, so the layout of a model for two
+# tensor-parallel ranks is checked directly by pretending, that the model is
+# created on two MPI ranks. Heads and inner dimension of MLP shall be split
+# among ranks, and partial results shall be reduced only where the split
+# dimension is contracted.
+def test_tensor_parallel_layout():
+    import nntile.model.gpt2 as gpt2
+    f = open("./wrappers/python/tests/model/gpt2_test_config.json")
+    conf_dict = json.load(f)
+    f.close()
+    config = GPT2Config(**conf_dict)
+    config.n_inner = 4 * config.hidden_size
+    tensor_parallel = 2
+    n_head_tile = config.n_head // tensor_parallel
+    n_inner_tile = config.n_inner // tensor_parallel
+    model_torch = GPT2LMHeadModel(config)
+    nntile_config = nntile.starpu.Config(-1, -1, 1)
+    nntile.starpu.init()
+    nntile_model_config = GPT2Config_nntile(config.vocab_size, 384, \
+        config.n_embd, 384, config.max_position_embeddings, \
+        config.n_inner, n_inner_tile, config.layer_norm_epsilon, \
+        config.num_hidden_layers, config.n_head, n_head_tile, \
+        "gelutanh", False, False, tensor_parallel=tensor_parallel)
+    mpi_world_size = gpt2.mpi_world_size
+    gpt2.mpi_world_size = lambda: tensor_parallel
+    try:
+        nntile_model, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+                1, 1, config.n_positions, config.n_positions, \
+                nntile_model_config, 0)
+    finally:
+        gpt2.mpi_world_size = mpi_world_size
+    # Attention: tiles of heads alternate between ranks, heads are reduced
+    attn = [l for l in nntile_model.layers \
+            if type(l) is nntile.layer.Attention]
+    assert len(attn) == 1
+    w_q = attn[0].w_q.value
+    for i, rank in enumerate(w_q.distribution):
+        assert rank == np.unravel_index(i, w_q.grid.shape, order="F")[0] \
+                % tensor_parallel
+    assert attn[0].redux_heads == 1
+    assert attn[0].redux == 0
+    # MLP: only the projection contracts the split inner dimension
+    linear = [l for l in nntile_model.layers if type(l) is nntile.layer.Linear]
+    fc = [l for l in linear if l.w.value.shape == [config.n_inner, \
+            config.n_embd]]
+    proj = [l for l in linear if l.w.value.shape == [config.n_embd, \
+            config.n_inner]]
+    assert len(fc) == 1 and len(proj) == 1
+    fc, proj = fc[0], proj[0]
+    for i, rank in enumerate(fc.w.value.distribution):
+        assert rank == np.unravel_index(i, fc.w.value.grid.shape, \
+                order="F")[0] % tensor_parallel
+    for i, rank in enumerate(proj.w.value.distribution):
+        assert rank == np.unravel_index(i, proj.w.value.grid.shape, \
+                order="F")[1] % tensor_parallel
+    assert fc.redux == 0
+    assert proj.redux == 1
+    # Output of MLP stays where its input is
+    assert proj.activations_output[0].value.distribution \
+            == proj.x.value.distribution
+    nntile_model.unregister()
+
+# 1F1B schedule of micro-batches over pipeline stages shall produce the same
+# losses and trained parameters, as sequential accumulation of gradients over
+# minibatches
+def test_pipeline_parallel():
+    kwargs = dict(num_samples=4, batch_size=4, minibatch_size=1, \
+            minibatch_size_tile=1, seq_len_tile=1024, device="cpu", \
+            optimizer="adam", lr=1e-4, nepochs=2, num_layers=2)
+    loss_ref, params_ref = run_test(**kwargs, pipeline_parallel=1)
+    loss, params = run_test(**kwargs, pipeline_parallel=2)
+    assert np.allclose(loss, loss_ref, rtol=1e-5, atol=0)
+    for p, p_ref in zip(params, params_ref):
+        assert np.linalg.norm(p-p_ref) <= 1e-5*np.linalg.norm(p_ref)
+
+def run_test_kv_cache(ntokens, batch_size, kv_cache_tile, device):
+    f = open("./wrappers/python/tests/model/gpt2_test_config.json")
+    conf_dict = json.load(f)
+    f.close()
+    config = GPT2Config(**conf_dict)
+    config.attn_pdrop = 0
+    config.embd_pdrop = 0
+    config.resid_pdrop = 0
+    inner_dim = config.n_inner if config.n_inner is not None \
+        else 4 * config.hidden_size
+    config.n_inner = inner_dim
+    assert ntokens <= config.n_positions
+    model_torch = GPT2LMHeadModel(config).to(device)
+    model_torch.lm_head.weight = nn.Parameter(model_torch.lm_head \
+        .weight.detach().clone())
+    model_torch.eval()
+
+    nntile_config = nntile.starpu.Config(-1, -1, 1)
+    nntile.starpu.init()
+    if device == "cuda":
+        nntile.starpu.restrict_cuda()
+    elif device == "cpu":
+        nntile.starpu.restrict_cpu()
+    next_tag = 0
+    n_embd_tile = 384
+    n_inner_tile = 1536
+    nntile_model_config = GPT2Config_nntile(config.vocab_size, n_embd_tile, \
+        config.n_embd, n_embd_tile, config.max_position_embeddings, \
+        config.n_inner, n_inner_tile, config.layer_norm_epsilon, \
+        config.num_hidden_layers, config.n_head, config.n_head, \
+        "gelutanh", False, False)
+    nntile_model, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+            batch_size, batch_size, config.n_positions, config.n_positions, \
+            nntile_model_config, next_tag)
+    decoder, next_tag = nntile_model.generate_decoder(batch_size, \
+            batch_size, kv_cache_tile, next_tag)
+
+    # Feed tokens one by one and compare logits of the last position
+    torch.manual_seed(0)
+    input_ids = torch.randint(config.vocab_size, (batch_size, ntokens), \
+            dtype=torch.int64, device=device)
+    logits_np = np.zeros((config.vocab_size, 1, batch_size), order="F", \
+            dtype=np.float32)
+    for i in range(ntokens):
+        decoder.decode_async(input_ids[:, i:i+1].cpu().numpy().T)
+        decoder.activations[-1].value.to_array(logits_np)
+        with torch.no_grad():
+            logits_torch = model_torch(input_ids[:, :i+1]).logits[:, -1, :]
+        logits_torch_np = logits_torch.cpu().numpy().T
+        assert np.linalg.norm(logits_np[:, 0, :]-logits_torch_np) <= \
+                1e-4*np.linalg.norm(logits_torch_np)
+
+    # Cache can be reused for another sequence
+    decoder.reset_cache()
+    decoder.decode_async(input_ids[:, 0:1].cpu().numpy().T)
+    decoder.activations[-1].value.to_array(logits_np)
+    with torch.no_grad():
+        logits_torch = model_torch(input_ids[:, :1]).logits[:, -1, :]
+    logits_torch_np = logits_torch.cpu().numpy().T
+    assert np.linalg.norm(logits_np[:, 0, :]-logits_torch_np) <= \
+            1e-4*np.linalg.norm(logits_torch_np)
+
+    # Requests of different lengths, served by fewer slots, shall produce
+    # the same greedy outputs as PyTorch
+    def check_engine(engine):
+        requests = []
+        for i in range(2*batch_size+1):
+            prompt = torch.randint(config.vocab_size, (i+1,)).tolist()
+            requests.append(nntile.inference.GenerationRequest(prompt, \
+                    ntokens-i))
+            engine.submit(requests[-1])
+        engine.run()
+        for request in requests:
+            tokens = torch.tensor([request.prompt], dtype=torch.int64, \
+                    device=device)
+            for i in range(request.max_new_tokens):
+                with torch.no_grad():
+                    logits_torch = model_torch(tokens).logits[0, -1, :]
+                new_token = logits_torch.argmax().reshape(1, 1)
+                tokens = torch.cat([tokens, new_token], dim=1)
+            assert tokens[0, len(request.prompt):].tolist() == request.output
+
+    engine = nntile.inference.ContinuousBatchingEngine(decoder, next_tag)
+    next_tag = engine.next_tag
+    check_engine(engine)
+    engine.unregister()
+
+    # Sampled tokens shall be among top_k tokens of PyTorch
+    top_k = 3
+    engine = nntile.inference.ContinuousBatchingEngine(decoder, next_tag, \
+            temperature=0.8, top_k=top_k, top_p=0.95, seed=1)
+    next_tag = engine.next_tag
+    request = nntile.inference.GenerationRequest([1, 2, 3], ntokens-2)
+    engine.submit(request)
+    engine.run()
+    tokens = torch.tensor([request.prompt+request.output], \
+            dtype=torch.int64, device=device)
+    with torch.no_grad():
+        logits_torch = model_torch(tokens).logits[0]
+    for i, token in enumerate(request.output):
+        pos = len(request.prompt) + i - 1
+        assert token in logits_torch[pos].topk(top_k).indices.tolist()
+    engine.unregister()
+    decoder.unregister()
+
+    # Paged caches with fewer blocks, than slots need at once
+    block_size = 4
+    paged_decoder, next_tag = nntile_model.generate_decoder(batch_size, 1, \
+            kv_cache_tile, next_tag, kv_block_size=block_size, \
+            kv_num_blocks=(ntokens-1)//block_size+2)
+    engine = nntile.inference.ContinuousBatchingEngine(paged_decoder, \
+            next_tag)
+    next_tag = engine.next_tag
+    check_engine(engine)
+    engine.unregister()
+    paged_decoder.unregister()
+    nntile_model.unregister()
 
 if __name__ == "__main__":
     run_test(num_samples=8, batch_size=4, minibatch_size=2,
@@ -378,3 +606,10 @@ if __name__ == "__main__":
     run_test(num_samples=8, batch_size=4, minibatch_size=2,
             minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
             optimizer="sgd", lr=1e-4, nepochs=3)
+
+    test_tensor_parallel()
+    test_tensor_parallel_layout()
+    test_pipeline_parallel()
+
+    run_test_kv_cache(ntokens=8, batch_size=2, kv_cache_tile=256, \
+            device="cpu")
@@ -0,0 +1,43 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_gpt2_distr.py
+# Test for planner of distributions of GPT2 model
+#
+# @version 1.0.0
+
+from nntile.model.gpt2_distr import GPT2DistributionPlan
+
+config = {
+        "vocab_size": 100,
+        "vocab_embed_dim_tile": 50,
+        "embed_dim": 64,
+        "embed_dim_tile": 32,
+        "inner_dim": 256,
+        "inner_dim_tile": 64,
+        "num_hidden_layers": 2,
+        "n_head": 4,
+        "n_head_tile": 2,
+        }
+
+def test_gpt2_distr():
+    plan1 = GPT2DistributionPlan(config, 4, 2, 32, 16, 1)
+    # Everything is on a single rank and nothing is transferred
+    assert plan1.transfer_bytes.sum() == 0
+    for mpi_size in [2, 4]:
+        plan = GPT2DistributionPlan(config, 4, 2, 32, 16, mpi_size)
+        # Total memory does not depend on distribution
+        assert plan.memory_bytes.sum() == plan1.memory_bytes.sum()
+        # Memory is split among ranks
+        assert plan.memory_bytes.max() < plan1.memory_bytes.sum()
+        for t in plan.tensors.values():
+            assert len(t.distr) == t.traits.grid.nelems
+            assert min(t.distr) >= 0 and max(t.distr) < mpi_size
+
+if __name__ == "__main__":
+    test_gpt2_distr()
@@ -0,0 +1,62 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_counters.py
+# Test for counters of FLOPs and bytes of executed tasks
+#
+# @version 1.0.0
+
+# All necesary imports
+import nntile
+import numpy as np
+import io
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Helper function returns bool value true if test passes
+def helper():
+    # Describe tensor of 2 tiles, located at node 0
+    shape = [4, 6]
+    basetile = [4, 3]
+    mpi_distr = [0, 0]
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    np_A = np.ones(shape, dtype=np.float32, order='F')
+    A.from_array(np_A)
+    B.from_array(np_A)
+    # Tasks out of the measurement are not counted
+    nntile.tensor.add_async(2.0, A, -1.0, B)
+    with nntile.counters.measure() as m:
+        nntile.tensor.add_async(2.0, A, -1.0, B)
+    A.unregister()
+    B.unregister()
+    add = [rec for rec in m.records if rec["name"] == "nntile_add_fp32"]
+    if len(add) != 1 or add[0]["ntasks"] != 2:
+        return False
+    # 3 operations per element, src is read and dst is read and written
+    if add[0]["flops"] != 3*24 or add[0]["bytes"] != 3*24*4:
+        return False
+    m.report(balance=10.0, file=io.StringIO())
+    return not nntile.counters.is_enabled()
+
+# Test runner
+def test():
+    assert helper()
+
+# Repeat tests
+def test_repeat():
+    assert helper()
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
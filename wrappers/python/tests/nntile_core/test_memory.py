@@ -0,0 +1,57 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_memory.py
+# Test for memory accounting of tensors by categories
+#
+# @version 1.0.0
+
+# All necesary imports
+import nntile
+import io
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Helper function returns bool value true if test passes
+def helper():
+    shape = [4, 6]
+    basetile = [4, 3]
+    mpi_distr = [0, 0]
+    next_tag = 0
+    nbytes = 4 * 24
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    stats0 = nntile.memory.stats()
+    nntile.memory.timeline()
+    nntile.memory.timeline_enable()
+    with nntile.memory.category("parameter"):
+        A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+        next_tag = A.next_tag
+    A_grad = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    next_tag = A_grad.next_tag
+    A_moments = nntile.tensor.TensorMoments(A, A_grad, True)
+    nntile.memory.tag([A_moments], "parameter")
+    stats = nntile.memory.stats()
+    ok = stats["live"]["parameter"] == stats0["live"]["parameter"]+nbytes
+    ok = ok and stats["live"]["grad"] == stats0["live"]["grad"]+nbytes
+    ok = ok and stats["live_total"] == stats0["live_total"]+2*nbytes
+    A_moments.unregister()
+    nntile.memory.timeline_disable()
+    ok = ok and nntile.memory.stats()["live_total"] == stats0["live_total"]
+    # Two tiles of A and A_grad, retagging of A_grad and unregister of all
+    ok = ok and len(nntile.memory.timeline()) == 10
+    nntile.memory.report(file=io.StringIO())
+    return ok
+
+# Test runner
+def test():
+    assert helper()
+
+if __name__ == "__main__":
+    test()
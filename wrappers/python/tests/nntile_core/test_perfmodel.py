@@ -0,0 +1,140 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_perfmodel.py
+# Test for bundles of performance models of codelets
+#
+# @version 1.0.0
+
+# All necesary imports
+import nntile
+import numpy as np
+import io
+import os
+import tempfile
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Helper function returns bool value true if test passes
+def helper():
+    # Describe tensor of 2 tiles, located at node 0
+    shape = [4, 6]
+    basetile = [4, 3]
+    mpi_distr = [0, 0]
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    np_A = np.ones(shape, dtype=np.float32, order='F')
+    A.from_array(np_A)
+    B.from_array(np_A)
+    # Both tiles have the same shape and thus the same footprint
+    with nntile.perfmodel.record() as rec:
+        nntile.tensor.add_async(2.0, A, -1.0, B)
+    A.unregister()
+    B.unregister()
+    add = [e for e in rec.entries if e["symbol"] == "nntile_add_fp32"]
+    if len(add) != 1:
+        return False
+    if "nntile_add_fp32" not in nntile.perfmodel.symbols():
+        return False
+    # Missing footprints are a subset of the given ones
+    missing = nntile.perfmodel.check(entries=rec.entries, file=io.StringIO())
+    if any(e not in rec.entries for e in missing):
+        return False
+    # Export a fake model and import it into another location
+    with tempfile.TemporaryDirectory() as tmpdir:
+        src = os.path.join(tmpdir, "src", "nntile_add_fp32.host")
+        dst = os.path.join(tmpdir, "dst", "nntile_add_fp32.node")
+        os.makedirs(os.path.dirname(src))
+        with open(src, "w") as fp:
+            fp.write("model")
+        bundle = os.path.join(tmpdir, "bundle")
+        manifest = nntile.perfmodel.export_bundle(bundle, rec.entries, \
+                {"nntile_add_fp32": src, "nntile_prod_fp32": src + "0"})
+        if list(manifest["models"]) != ["nntile_add_fp32"]:
+            return False
+        if nntile.perfmodel.read_manifest(bundle)["required"] != rec.entries:
+            return False
+        paths = {"nntile_add_fp32": dst}
+        if nntile.perfmodel.import_bundle(bundle, False, paths) \
+                != ["nntile_add_fp32"]:
+            return False
+        # Existing models are kept without overwrite
+        if nntile.perfmodel.import_bundle(bundle, False, paths) != []:
+            return False
+        with open(dst) as fp:
+            if fp.read() != "model":
+                return False
+        # Corrupted models are not imported
+        with open(os.path.join(bundle, "models", "nntile_add_fp32"), \
+                "w") as fp:
+            fp.write("corrupted")
+        try:
+            nntile.perfmodel.import_bundle(bundle, True, paths)
+            return False
+        except ValueError:
+            pass
+    return True
+
+# Recorded footprints of gemm shall match calibrated history of its model.
+# Models are written at shutdown of StarPU, so StarPU is restarted.
+def helper_calibrated():
+    global config
+    shape = [32, 32]
+    traits = nntile.tensor.TensorTraits(shape, shape)
+    config.shutdown()
+    os.environ["STARPU_CALIBRATE"] = "1"
+    try:
+        config = nntile.starpu.Config(1, 0, 0)
+        nntile.starpu.init()
+        next_tag = 0
+        tensors = []
+        for i in range(3):
+            tensors.append(nntile.tensor.Tensor_fp32(traits, [0], next_tag))
+            next_tag = tensors[-1].next_tag
+            tensors[-1].from_array(np.ones(shape, dtype=np.float32, \
+                    order='F'))
+        A, B, C = tensors
+        # Enough executions to calibrate the model
+        with nntile.perfmodel.record() as rec:
+            for i in range(20):
+                nntile.tensor.gemm_async(1.0, nntile.notrans, A, \
+                        nntile.notrans, B, 0.0, C, 1, 0)
+                nntile.starpu.wait_for_all()
+        for x in tensors:
+            x.unregister()
+        config.shutdown()
+    finally:
+        del os.environ["STARPU_CALIBRATE"]
+    config = nntile.starpu.Config(1, 0, 0)
+    nntile.starpu.init()
+    gemm = [e for e in rec.entries if e["symbol"] == "nntile_gemm_NN_fp32"]
+    if len(gemm) != 1:
+        return False
+    return nntile.perfmodel.find_missing(gemm) == []
+
+# Test runner
+def test():
+    assert helper()
+
+# Repeat tests
+def test_repeat():
+    assert helper()
+
+# Test of calibration, that restarts StarPU
+def test_calibrated():
+    assert helper_calibrated()
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
+    test_calibrated()
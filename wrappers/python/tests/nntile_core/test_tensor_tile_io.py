@@ -0,0 +1,100 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_tile_io.py
+# Test for tensor::save_tiles<T> and tensor::load_tiles<T> through
+# nntile.checkpoint and its background snapshots
+#
+# @version 1.0.0
+
+# All necesary imports
+import nntile
+import numpy as np
+import os
+import pytest
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64, np.int64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64,
+        np.int64: nntile.tensor.Tensor_int64}
+
+# Helper function returns bool value true if test passes
+def helper(dtype, path):
+    shape = [7, 5, 3]
+    traits = nntile.tensor.TensorTraits(shape, [3, 2, 3])
+    other_traits = nntile.tensor.TensorTraits(shape, [4, 5, 1])
+    next_tag = 0
+    A = Tensor[dtype](traits, [0]*traits.grid.nelems, next_tag)
+    next_tag = A.next_tag
+    B = Tensor[dtype](traits, [0]*traits.grid.nelems, next_tag)
+    next_tag = B.next_tag
+    C = Tensor[dtype](other_traits, [0]*other_traits.grid.nelems, next_tag)
+    next_tag = C.next_tag
+    np_A = np.array(np.random.randn(*shape)*100, dtype=dtype, order='F')
+    A.from_array(np_A)
+    # Save and load with the same and with another tiling
+    nntile.checkpoint.save(path, {"A": A}, {"step": 10})
+    metadata, next_tag = nntile.checkpoint.load(path, {"A": B}, next_tag)
+    assert metadata == {"step": 10}
+    np_B = np.zeros_like(np_A)
+    B.to_array(np_B)
+    metadata, next_tag = nntile.checkpoint.load(path, {"A": C}, next_tag)
+    np_C = np.zeros_like(np_A)
+    C.to_array(np_C)
+    # Corrupted checkpoint is detected
+    index = nntile.checkpoint.read_index(path)
+    with open(path, "r+b") as fp:
+        fp.seek(index["tensors"]["A"]["offset"])
+        fp.write(b"\xff"*8)
+    with pytest.raises(ValueError):
+        nntile.checkpoint.load(path, {"A": B}, next_tag)
+    with pytest.raises(KeyError):
+        nntile.checkpoint.load(path, {"B": B}, next_tag)
+    A.unregister()
+    B.unregister()
+    C.unregister()
+    return (np_A == np_B).all() and (np_A == np_C).all()
+
+# Snapshot keeps values at the moment it was taken
+def helper_async(dtype, path):
+    shape = [7, 5, 3]
+    traits = nntile.tensor.TensorTraits(shape, [3, 2, 3])
+    next_tag = 0
+    A = Tensor[dtype](traits, [0]*traits.grid.nelems, next_tag)
+    next_tag = A.next_tag
+    B = Tensor[dtype](traits, [0]*traits.grid.nelems, next_tag)
+    next_tag = B.next_tag
+    checkpointer = nntile.checkpoint.AsyncCheckpointer({"A": A}, next_tag)
+    next_tag = checkpointer.next_tag
+    np_A = np.array(np.random.randn(*shape)*100, dtype=dtype, order='F')
+    A.from_array(np_A)
+    checkpointer.snapshot(path, {"step": 1})
+    # Overwrite source while the snapshot is being written
+    A.from_array(np.zeros_like(np_A))
+    checkpointer.wait()
+    metadata, next_tag = nntile.checkpoint.load(path, {"A": B}, next_tag)
+    np_B = np.zeros_like(np_A)
+    B.to_array(np_B)
+    checkpointer.unregister()
+    A.unregister()
+    B.unregister()
+    return metadata == {"step": 1} and (np_A == np_B).all()
+
+# Test runner for different precisions
+def test(tmp_path):
+    for dtype in dtypes:
+        assert helper(dtype, os.path.join(tmp_path, "checkpoint.nnt"))
+        assert helper_async(dtype, os.path.join(tmp_path, "snapshot.nnt"))
+
+if __name__ == "__main__":
+    test("/tmp")
@@ -0,0 +1,72 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_trace.py
+# Test for Chrome trace of executed tasks
+#
+# @version 1.0.0
+
+# All necesary imports
+import nntile
+import numpy as np
+import json
+import os
+import tempfile
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Helper function returns bool value true if test passes
+def helper(capacity):
+    # Describe tensor of 3 tiles, located at node 0
+    shape = [4, 9]
+    basetile = [4, 3]
+    mpi_distr = [0, 0, 0]
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    np_A = np.ones(shape, dtype=np.float32, order='F')
+    A.from_array(np_A)
+    B.from_array(np_A)
+    nntile.starpu.wait_for_all()
+    nntile.starpu.trace_enable(capacity)
+    nntile.tensor.add_async(2.0, A, -1.0, B)
+    nntile.starpu.wait_for_all()
+    nntile.starpu.trace_disable()
+    A.unregister()
+    B.unregister()
+    with tempfile.TemporaryDirectory() as tmp:
+        filename = os.path.join(tmp, "trace.json")
+        nntile.starpu.trace_dump(filename)
+        with open(filename) as fp:
+            events = json.load(fp)["traceEvents"]
+    tasks = [e for e in events if e["ph"] == "X"]
+    # Ring buffer of a single worker keeps only the last events
+    if len(tasks) != min(3, capacity):
+        return False
+    for e in tasks:
+        if e["name"] != "nntile_add_fp32" or e["dur"] < 0:
+            return False
+        if e["args"]["bytes"] != [48, 48]:
+            return False
+    return True
+
+# Test runner
+def test():
+    assert helper(100)
+
+# Overflow of ring buffers
+def test_overflow():
+    assert helper(2)
+
+if __name__ == "__main__":
+    test()
+    test_overflow()
@@ -0,0 +1,57 @@
+# @copyright (c) 2022-present Skolkovo Institute of Science and Technology
+#                              (Skoltech), Russia. All rights reserved.
+#                2023-present Artificial Intelligence Research Institute
+#                              (AIRI), Russia. All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_wait.py
+# Test for waiting for all tasks and for a single tensor
+#
+# @version 1.0.0
+
+# All necesary imports
+import nntile
+import numpy as np
+import time
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Helper function returns bool value true if test passes
+def helper():
+    shape = [40, 60]
+    basetile = [40, 3]
+    mpi_distr = [0] * 20
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    np_A = np.ones(shape, dtype=np.float32, order='F')
+    A.from_array(np_A)
+    B.from_array(np_A)
+    for i in range(10):
+        nntile.tensor.add_async(1.0, A, 1.0, B)
+    # Wait only for B
+    B.wait()
+    np_B = np.zeros(shape, dtype=np.float32, order='F')
+    B.to_array(np_B)
+    ok = (np_B == 11).all()
+    # Waiting for nothing returns immediately
+    time0 = time.time()
+    for i in range(100):
+        nntile.starpu.wait_for_all()
+    ok = ok and time.time()-time0 < 1.0
+    A.unregister()
+    B.unregister()
+    return ok
+
+# Test runner
+def test():
+    assert helper()
+
+if __name__ == "__main__":
+    test()
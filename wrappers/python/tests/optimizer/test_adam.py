@@ -22,12 +22,15 @@ import numpy as np
 nntile_config = nntile.starpu.Config(1, 0, 0)
 nntile.starpu.init()
 
-def run_test(dim, num_steps, device, lr, tol=1e-5):
+def run_test(dim, num_steps, device, lr, tol=1e-5, dim_tile=None, \
+        sharded=False):
+    if dim_tile is None:
+        dim_tile = dim
     torch_param = torch.randn((dim, ), device=device, requires_grad=True, dtype=torch.float32)
     next_tag = 0
     x_traits = nntile.tensor.TensorTraits( \
                 [dim], \
-                [dim])
+                [dim_tile])
     x_distr = [0] * x_traits.grid.nelems
     x = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
     next_tag = x.next_tag
@@ -35,7 +38,8 @@ def run_test(dim, num_steps, device, lr, tol=1e-5):
     x_grad = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
     next_tag = x_grad.next_tag
     nntile_param = nntile.tensor.TensorMoments(x, x_grad, True)
-    nntile_optimizer = nntile.optimizer.FusedAdam([nntile_param], lr, next_tag)
+    nntile_optimizer = nntile.optimizer.FusedAdam([nntile_param], lr, next_tag, \
+            sharded=sharded)
     next_tag = nntile_optimizer.get_next_tag()
 
     torch_optimizer = optim.Adam([torch_param], lr=lr)
@@ -53,6 +57,54 @@ def run_test(dim, num_steps, device, lr, tol=1e-5):
     nntile_optimizer.unregister()
     nntile_param.unregister()
 
+# Sharded and unsharded optimizers shall produce identical parameters
+def test_sharded(dim=1000, dim_tile=300, num_steps=10, lr=1e-1):
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits([dim], [dim_tile])
+    distr = [0] * traits.grid.nelems
+    params = []
+    for i in range(2):
+        x = nntile.tensor.Tensor_fp32(traits, distr, next_tag)
+        next_tag = x.next_tag
+        x_grad = nntile.tensor.Tensor_fp32(traits, distr, next_tag)
+        next_tag = x_grad.next_tag
+        params.append(nntile.tensor.TensorMoments(x, x_grad, True))
+    optimizers = []
+    for p, sharded in zip(params, [False, True]):
+        optimizers.append(nntile.optimizer.FusedAdam([p], lr, next_tag, \
+                sharded=sharded))
+        next_tag = optimizers[-1].get_next_tag()
+    rng = np.random.default_rng(0)
+    value_np = np.array(rng.standard_normal(dim), dtype=np.float32)
+    for p in params:
+        p.value.from_array(value_np)
+    values_np = [np.zeros(dim, dtype=np.float32) for p in params]
+    for i_step in range(num_steps):
+        grad_np = np.array(rng.standard_normal(dim), dtype=np.float32)
+        for p, opt, p_np in zip(params, optimizers, values_np):
+            p.grad.from_array(grad_np)
+            opt.step()
+            p.value.to_array(p_np)
+        assert (values_np[0] == values_np[1]).all()
+    for p, opt in zip(params, optimizers):
+        opt.unregister()
+        p.unregister()
+
+# States stay with parameters until ranks keep even shares of elements
+def test_shard_distributions():
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits([1000], [300])
+    x = nntile.tensor.Tensor_fp32(traits, [0] * 4, next_tag)
+    p = nntile.tensor.TensorMoments(x, None, False)
+    distrs = nntile.optimizer.adam.shard_distributions([p], 1)
+    assert distrs == [[0, 0, 0, 0]]
+    distrs = nntile.optimizer.adam.shard_distributions([p], 2)
+    load = [0, 0]
+    for nelems, rank in zip([300, 300, 300, 100], distrs[0]):
+        load[rank] += nelems
+    assert load == [400, 600]
+    x.unregister()
+
 if __name__ == "__main__":
 
     run_test(dim=1000, num_steps=100, device="cpu", lr=1)
@@ -66,3 +118,8 @@ if __name__ == "__main__":
 
     run_test(dim=1000, num_steps=100, device="cpu", lr=1e-4)
     #run_test(dim=1000, num_steps=100, device="cuda", lr=1e-4)
+
+    run_test(dim=1000, num_steps=10, device="cpu", lr=1e-1, dim_tile=300, \
+            sharded=True)
+    test_sharded()
+    test_shard_distributions()